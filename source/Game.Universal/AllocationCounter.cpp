@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	atomic<uint64_t> AllocationCounter::sCount(0);
+
+	/************************************************************************/
+	uint64_t AllocationCounter::Count()
+	{
+		return sCount.load(memory_order_relaxed);
+	}
+
+	/************************************************************************/
+	void AllocationCounter::Increment()
+	{
+		sCount.fetch_add(1, memory_order_relaxed);
+	}
+}
+
+// the array and nothrow forms of the standard library forward to these two
+/************************************************************************/
+void* operator new(size_t size)
+{
+	DirectXGame::AllocationCounter::Increment();
+
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+/************************************************************************/
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+/************************************************************************/
+void operator delete(void* memory, size_t size) noexcept
+{
+	UNREFERENCED_PARAMETER(size);
+	free(memory);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace DirectXGame
+{
+	/** Class counting the heap allocations made through the global operator new, by every thread.
+	 * The counter is a constant initialized atomic, so allocations made before main, static initializers included,
+	 * are counted without depending on any initialization order. Counting costs one relaxed increment per allocation.
+	 *@see MetricsRegistry
+	*/
+	class AllocationCounter final
+	{
+	public:
+
+		AllocationCounter() = delete;
+
+		static uint64_t Count();
+		static void Increment();
+
+	private:
+
+		static std::atomic<uint64_t> sCount;
+	};
+}
@@ -1,6 +1,7 @@
 ﻿#include "pch.h"
 #include "App.h"
 #include "GameMain.h"
+#include "HeadlessTools.h"
 
 using namespace DX;
 using namespace std;
@@ -16,12 +17,19 @@ using namespace Windows::Graphics::Display;
 
 // The main function is only used to initialize our IFrameworkView class.
 [Platform::MTAThread]
-int main(Platform::Array<Platform::String^>^)
+int main(Platform::Array<Platform::String^>^ arguments)
 {
 #if defined(DEBUG) | defined(_DEBUG)
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
 
+	// Headless tools run instead of the game when asked for on the command line.
+	int32_t exitCode = 0;
+	if (DirectXGame::HeadlessTools::GetInstance().TryRun(DirectXGame::HeadlessTools::ToArguments(arguments), exitCode))
+	{
+		return exitCode;
+	}
+
 	auto direct3DApplicationSource = ref new Direct3DApplicationSource();
 	CoreApplication::Run(direct3DApplicationSource);
 	return 0;
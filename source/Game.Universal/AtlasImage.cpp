@@ -0,0 +1,138 @@
+#include "pch.h"
+#include "AtlasImage.h"
+
+using namespace std;
+using namespace DX;
+using namespace Microsoft::WRL;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	AtlasImage::AtlasImage() :
+		mWidth(0), mHeight(0)
+	{
+	}
+
+	/************************************************************************/
+	AtlasImage::AtlasImage(uint32_t width, uint32_t height) :
+		mWidth(width), mHeight(height), mPixels(width * height, 0)
+	{
+	}
+
+	/************************************************************************/
+	void AtlasImage::Load(const string& filePath)
+	{
+		ComPtr<IWICImagingFactory> factory = CreateImagingFactory();
+
+		ComPtr<IWICBitmapDecoder> decoder;
+		ThrowIfFailed(factory->CreateDecoderFromFilename(ToWidePath(filePath).c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf()));
+
+		ComPtr<IWICBitmapFrameDecode> frame;
+		ThrowIfFailed(decoder->GetFrame(0, frame.GetAddressOf()));
+
+		ComPtr<IWICFormatConverter> converter;
+		ThrowIfFailed(factory->CreateFormatConverter(converter.GetAddressOf()));
+		ThrowIfFailed(converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0, WICBitmapPaletteTypeCustom));
+
+		UINT width;
+		UINT height;
+		ThrowIfFailed(converter->GetSize(&width, &height));
+
+		mWidth = width;
+		mHeight = height;
+		mPixels.resize(mWidth * mHeight);
+		ThrowIfFailed(converter->CopyPixels(nullptr, static_cast<UINT>(mWidth * sizeof(uint32_t)), static_cast<UINT>(mPixels.size() * sizeof(uint32_t)), reinterpret_cast<BYTE*>(mPixels.data())));
+	}
+
+	/************************************************************************/
+	void AtlasImage::Save(const string& filePath) const
+	{
+		ComPtr<IWICImagingFactory> factory = CreateImagingFactory();
+
+		ComPtr<IWICStream> stream;
+		ThrowIfFailed(factory->CreateStream(stream.GetAddressOf()));
+		ThrowIfFailed(stream->InitializeFromFilename(ToWidePath(filePath).c_str(), GENERIC_WRITE));
+
+		ComPtr<IWICBitmapEncoder> encoder;
+		ThrowIfFailed(factory->CreateEncoder(GUID_ContainerFormatPng, nullptr, encoder.GetAddressOf()));
+		ThrowIfFailed(encoder->Initialize(stream.Get(), WICBitmapEncoderNoCache));
+
+		ComPtr<IWICBitmapFrameEncode> frame;
+		ThrowIfFailed(encoder->CreateNewFrame(frame.GetAddressOf(), nullptr));
+		ThrowIfFailed(frame->Initialize(nullptr));
+		ThrowIfFailed(frame->SetSize(mWidth, mHeight));
+
+		// the encoder answers with the closest format it supports
+		WICPixelFormatGUID format = GUID_WICPixelFormat32bppRGBA;
+		ThrowIfFailed(frame->SetPixelFormat(&format));
+		if (format != GUID_WICPixelFormat32bppRGBA)
+		{
+			throw runtime_error("the png encoder does not take rgba pixels, " + filePath + " was not written");
+		}
+
+		ThrowIfFailed(frame->WritePixels(mHeight, static_cast<UINT>(mWidth * sizeof(uint32_t)), static_cast<UINT>(mPixels.size() * sizeof(uint32_t)),
+			reinterpret_cast<BYTE*>(const_cast<uint32_t*>(mPixels.data()))));
+		ThrowIfFailed(frame->Commit());
+		ThrowIfFailed(encoder->Commit());
+	}
+
+	/************************************************************************/
+	void AtlasImage::Blit(const AtlasImage& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height,
+						  uint32_t x, uint32_t y, uint32_t extrusion)
+	{
+		if (sourceX + width > source.mWidth || sourceY + height > source.mHeight ||
+			x < extrusion || y < extrusion || x + width + extrusion > mWidth || y + height + extrusion > mHeight)
+		{
+			throw runtime_error("the sprite and its extruded border do not fit the images");
+		}
+
+		// the border repeats the edge pixels, so filtering at the edge of the sprite never reads its neighbors
+		const int32_t lastX = static_cast<int32_t>(width) - 1;
+		const int32_t lastY = static_cast<int32_t>(height) - 1;
+		const int32_t border = static_cast<int32_t>(extrusion);
+		for (int32_t row = -border; row <= lastY + border; ++row)
+		{
+			const int32_t clampedRow = row < 0 ? 0 : (row > lastY ? lastY : row);
+			const uint32_t* sourceRow = &source.mPixels[(sourceY + clampedRow) * source.mWidth + sourceX];
+			uint32_t* targetRow = &mPixels[(y + row) * mWidth + x];
+
+			for (int32_t column = -border; column <= lastX + border; ++column)
+			{
+				const int32_t clampedColumn = column < 0 ? 0 : (column > lastX ? lastX : column);
+				targetRow[column] = sourceRow[clampedColumn];
+			}
+		}
+	}
+
+	/************************************************************************/
+	uint32_t AtlasImage::Width() const
+	{
+		return mWidth;
+	}
+
+	/************************************************************************/
+	uint32_t AtlasImage::Height() const
+	{
+		return mHeight;
+	}
+
+	/************************************************************************/
+	ComPtr<IWICImagingFactory> AtlasImage::CreateImagingFactory()
+	{
+		ComPtr<IWICImagingFactory> factory;
+		ThrowIfFailed(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(factory.GetAddressOf())));
+		return factory;
+	}
+
+	/************************************************************************/
+	wstring AtlasImage::ToWidePath(const string& filePath)
+	{
+		// asset and tool paths are plain ascii
+		wstring widePath;
+		for (char character : filePath)
+		{
+			widePath.push_back(static_cast<wchar_t>(character));
+		}
+		return widePath;
+	}
+}
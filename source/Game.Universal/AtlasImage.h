@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Class holding an RGBA image in memory, to assemble a texture atlas from sprite sheets.
+	 * Images are read and written as PNG through WIC, every pixel is one RGBA value of 8 bits per channel.
+	 *@see AtlasPacker
+	*/
+	class AtlasImage final
+	{
+	public:
+
+		AtlasImage();
+		AtlasImage(uint32_t width, uint32_t height);
+
+		void Load(const std::string& filePath);
+		void Save(const std::string& filePath) const;
+
+		void Blit(const AtlasImage& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height,
+				  uint32_t x, uint32_t y, uint32_t extrusion);
+
+		uint32_t Width() const;
+		uint32_t Height() const;
+
+	private:
+
+		static Microsoft::WRL::ComPtr<IWICImagingFactory> CreateImagingFactory();
+		static std::wstring ToWidePath(const std::string& filePath);
+
+		uint32_t mWidth;
+		uint32_t mHeight;
+		std::vector<uint32_t> mPixels; // rows from the top
+	};
+}
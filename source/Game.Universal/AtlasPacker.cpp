@@ -0,0 +1,169 @@
+#include "pch.h"
+#include "AtlasPacker.h"
+#include "AtlasImage.h"
+#include <algorithm>
+#include <document.h>
+#include <istreamwrapper.h>
+#include <ostreamwrapper.h>
+#include <prettywriter.h>
+
+using namespace std;
+using namespace rapidjson;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	AtlasPacker& AtlasPacker::GetInstance()
+	{
+		static AtlasPacker sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	AtlasPackerReport AtlasPacker::Pack(const AtlasPackerOptions& options)
+	{
+		vector<unique_ptr<Document>> sheets;
+		vector<AtlasImage> images(options.SheetJSONPaths.size());
+		vector<PackedSprite> sprites;
+
+		for (uint32_t sheet = 0; sheet < options.SheetJSONPaths.size(); ++sheet)
+		{
+			const string& path = options.SheetJSONPaths[sheet];
+			ifstream ifs(path);
+			IStreamWrapper ist(ifs);
+
+			sheets.push_back(make_unique<Document>());
+			Document& document = *sheets.back();
+			document.ParseStream(ist);
+			if (document.HasParseError() || !document.IsObject() || !document.HasMember("frames") || !document.HasMember("meta"))
+			{
+				throw runtime_error(path + " is not a TexturePacker sprite sheet");
+			}
+
+			images[sheet].Load(options.ImageDirectory + document["meta"]["image"].GetString());
+
+			const Value& frames = document["frames"];
+			for (uint32_t frame = 0; frame < frames.Size(); ++frame)
+			{
+				if (frames[frame].HasMember("rotated") && frames[frame]["rotated"].GetBool())
+				{
+					throw runtime_error(path + " has rotated sprites, which the renderables cannot draw");
+				}
+
+				const Value& rectangle = frames[frame]["frame"];
+				PackedSprite sprite = { sheet, frame, rectangle["x"].GetUint(), rectangle["y"].GetUint(), rectangle["w"].GetUint(), rectangle["h"].GetUint(), 0, 0 };
+				sprites.push_back(sprite);
+			}
+		}
+
+		uint32_t width;
+		uint32_t height;
+		PlaceOnShelves(sprites, options.MaxWidth, options.Extrusion, width, height);
+
+		AtlasImage atlas(width, height);
+		uint64_t spritePixelCount = 0;
+		for (auto& sprite : sprites)
+		{
+			atlas.Blit(images[sprite.Sheet], sprite.SourceX, sprite.SourceY, sprite.Width, sprite.Height, sprite.X, sprite.Y, options.Extrusion);
+			spritePixelCount += sprite.Width * sprite.Height;
+
+			Value& rectangle = (*sheets[sprite.Sheet])["frames"][sprite.Frame]["frame"];
+			rectangle["x"].SetUint(sprite.X);
+			rectangle["y"].SetUint(sprite.Y);
+		}
+		atlas.Save(options.OutputImagePath);
+
+		// the sheets keep their animations, sorting layers and file names, only the rectangles and the image change
+		const string imageName = GetFileName(options.OutputImagePath);
+		for (uint32_t sheet = 0; sheet < sheets.size(); ++sheet)
+		{
+			Document& document = *sheets[sheet];
+			Value& meta = document["meta"];
+			meta["image"].SetString(imageName.c_str(), static_cast<SizeType>(imageName.size()), document.GetAllocator());
+			meta["size"]["w"].SetUint(width);
+			meta["size"]["h"].SetUint(height);
+
+			const string jsonPath = options.OutputJSONDirectory + GetFileName(options.SheetJSONPaths[sheet]);
+			ofstream ofs(jsonPath, ios::trunc);
+			OStreamWrapper wrapper(ofs);
+			PrettyWriter<OStreamWrapper> writer(wrapper);
+			writer.SetIndent(' ', 2);
+			document.Accept(writer);
+
+			// closing flushes the last bytes, which can fail as well
+			ofs.close();
+			if (!ofs)
+			{
+				throw runtime_error("could not write the sprite sheet " + jsonPath);
+			}
+		}
+
+		AtlasPackerReport report;
+		report.SheetCount = static_cast<uint32_t>(sheets.size());
+		report.SpriteCount = static_cast<uint32_t>(sprites.size());
+		report.Width = width;
+		report.Height = height;
+		report.Occupancy = static_cast<double_t>(spritePixelCount) / (static_cast<double_t>(width) * height);
+
+		return report;
+	}
+
+	/************************************************************************/
+	void AtlasPacker::PlaceOnShelves(vector<PackedSprite>& sprites, uint32_t maxWidth, uint32_t extrusion, uint32_t& width, uint32_t& height)
+	{
+		// tallest first, the sprites of a sheet stay in order within a height
+		stable_sort(sprites.begin(), sprites.end(), [](const PackedSprite& lhs, const PackedSprite& rhs)
+		{
+			return lhs.Height > rhs.Height;
+		});
+
+		uint32_t shelfX = 0;
+		uint32_t shelfY = 0;
+		uint32_t shelfHeight = 0;
+		width = 0;
+
+		for (auto& sprite : sprites)
+		{
+			const uint32_t cellWidth = sprite.Width + 2 * extrusion;
+			const uint32_t cellHeight = sprite.Height + 2 * extrusion;
+			if (cellWidth > maxWidth)
+			{
+				throw runtime_error("a sprite " + to_string(sprite.Width) + " pixels wide does not fit an atlas " + to_string(maxWidth) + " pixels wide");
+			}
+
+			if (shelfX + cellWidth > maxWidth)
+			{
+				shelfY += shelfHeight;
+				shelfX = 0;
+				shelfHeight = 0;
+			}
+
+			sprite.X = shelfX + extrusion;
+			sprite.Y = shelfY + extrusion;
+			shelfX += cellWidth;
+			shelfHeight = cellHeight > shelfHeight ? cellHeight : shelfHeight;
+			width = shelfX > width ? shelfX : width;
+		}
+
+		width = GetPowerOfTwo(width);
+		height = GetPowerOfTwo(shelfY + shelfHeight);
+	}
+
+	/************************************************************************/
+	uint32_t AtlasPacker::GetPowerOfTwo(uint32_t value)
+	{
+		uint32_t powerOfTwo = 1;
+		while (powerOfTwo < value)
+		{
+			powerOfTwo <<= 1;
+		}
+		return powerOfTwo;
+	}
+
+	/************************************************************************/
+	string AtlasPacker::GetFileName(const string& filePath)
+	{
+		const size_t separator = filePath.find_last_of("/\\");
+		return separator == string::npos ? filePath : filePath.substr(separator + 1);
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Structure holding the options of a texture atlas packing run.
+	*/
+	struct AtlasPackerOptions
+	{
+		AtlasPackerOptions() :
+			SheetJSONPaths({ "Assets/JSONS/Props.json", "Assets/JSONS/MC.json", "Assets/JSONS/Bomb.json", "Assets/JSONS/BombAE.json", "Assets/JSONS/Barom.json" }),
+			ImageDirectory("Assets/SpriteSheets/"), MaxWidth(2048), Extrusion(1)
+		{
+		}
+
+		std::vector<std::string> SheetJSONPaths; // TexturePacker sprite sheets, their images are in ImageDirectory
+		std::string ImageDirectory;
+		std::string OutputJSONDirectory;         // gets one sprite sheet per input, with the same name
+		std::string OutputImagePath;
+		uint32_t MaxWidth;
+		uint32_t Extrusion;                      // edge pixels repeated around every sprite
+	};
+
+	/** Structure holding the numbers of a texture atlas packing run.
+	*/
+	struct AtlasPackerReport
+	{
+		uint32_t SheetCount;
+		uint32_t SpriteCount;
+		uint32_t Width;
+		uint32_t Height;
+		std::double_t Occupancy; // part of the atlas covered by sprites
+	};
+
+	/** Singleton merging the sprite sheets of the game into one texture atlas, offline.
+	 * Sprites are packed on shelves, tallest first, each one surrounded by its extruded edge so linear filtering never
+	 * reads a neighbor. The atlas is sized to powers of two. Every input sprite sheet is written again with the
+	 * rectangles of its sprites in the atlas and the atlas as its image, everything else kept as is, so SpriteSheetParser
+	 * loads it like any other sheet and the renderables all sample the same texture.
+	 *@see AtlasImage
+	 *@see SpriteSheetParser
+	*/
+	class AtlasPacker final
+	{
+	public:
+
+		AtlasPacker(const AtlasPacker& rhs) = delete;
+		AtlasPacker(const AtlasPacker&& rhs) = delete;
+		AtlasPacker& operator=(const AtlasPacker& rhs) = delete;
+		AtlasPacker& operator=(const AtlasPacker&& rhs) = delete;
+
+		static AtlasPacker& GetInstance();
+
+		AtlasPackerReport Pack(const AtlasPackerOptions& options);
+
+	private:
+
+		/** Structure representing a sprite to place in the atlas.
+		*/
+		struct PackedSprite
+		{
+			uint32_t Sheet;
+			uint32_t Frame;
+			uint32_t SourceX;
+			uint32_t SourceY;
+			uint32_t Width;
+			uint32_t Height;
+			uint32_t X;
+			uint32_t Y;
+		};
+
+		AtlasPacker() = default;
+		~AtlasPacker() = default;
+
+		static void PlaceOnShelves(std::vector<PackedSprite>& sprites, uint32_t maxWidth, uint32_t extrusion, uint32_t& width, uint32_t& height);
+		static uint32_t GetPowerOfTwo(uint32_t value);
+		static std::string GetFileName(const std::string& filePath);
+	};
+}
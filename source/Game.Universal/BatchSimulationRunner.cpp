@@ -0,0 +1,190 @@
+#include "pch.h"
+#include "BatchSimulationRunner.h"
+#include "RandomInputScript.h"
+#include "LevelGenerator.h"
+#include "MapParser.h"
+#include "Profiler.h"
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	BatchSimulationRunner& BatchSimulationRunner::GetInstance()
+	{
+		static BatchSimulationRunner sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	BatchSimulationReport BatchSimulationRunner::Run(const BatchSimulationOptions& options)
+	{
+		if (options.InputReplay != nullptr)
+		{
+			const GameSimulationOptions& replayOptions = options.InputReplay->Options();
+			if (replayOptions.Seed != options.FirstSeed || replayOptions.PlayerCount != options.PlayerCount || replayOptions.EnemyCount != options.EnemyCount)
+			{
+				throw runtime_error("the replay was recorded on seed " + to_string(replayOptions.Seed) + " with " + to_string(replayOptions.PlayerCount) +
+									" players and " + to_string(replayOptions.EnemyCount) + " enemies");
+			}
+		}
+
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+
+		uint32_t threadCount = options.ThreadCount > 0 ? options.ThreadCount : max(thread::hardware_concurrency(), 1U);
+		threadCount = max(min(threadCount, options.MatchCount), 1U);
+
+		vector<ThreadResult> results(threadCount);
+		atomic<uint32_t> nextMatch(0);
+		vector<thread> workers;
+
+		auto start = chrono::high_resolution_clock::now();
+
+		for (uint32_t t = 0; t < threadCount; ++t)
+		{
+			workers.emplace_back([this, &basicMap, &options, &results, &nextMatch, t]()
+			{
+				// everything a match touches is owned by the thread, nothing is shared until the end
+				Profiler::GetInstance().SetThreadName("Batch worker " + to_string(t));
+
+				ThreadResult result = {};
+				result.EscapesOfEachPlayer.assign(options.PlayerCount, 0);
+				result.DeathsOfEachPlayer.assign(options.PlayerCount, 0);
+				GameSimulation simulation;
+				vector<PlayerInput> inputs(options.PlayerCount);
+
+				auto workerStart = chrono::high_resolution_clock::now();
+				for (uint32_t match = nextMatch++; match < options.MatchCount; match = nextMatch++)
+				{
+					PlayMatch(basicMap, options, options.FirstSeed + match, simulation, inputs, result);
+				}
+				result.ElapsedSeconds = chrono::duration<double_t>(chrono::high_resolution_clock::now() - workerStart).count();
+
+				results[t] = move(result);
+			});
+		}
+
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+
+		BatchSimulationReport report = {};
+		report.ElapsedSeconds = chrono::duration<double_t>(chrono::high_resolution_clock::now() - start).count();
+		report.ThreadCount = threadCount;
+		report.EscapesOfEachPlayer.assign(options.PlayerCount, 0);
+		report.DeathsOfEachPlayer.assign(options.PlayerCount, 0);
+
+		double_t busySeconds = 0;
+		for (auto& result : results)
+		{
+			report.MatchCount += result.MatchCount;
+			report.EscapedMatchCount += result.EscapedMatchCount;
+			report.LostMatchCount += result.LostMatchCount;
+			report.TimedOutMatchCount += result.TimedOutMatchCount;
+			for (uint32_t player = 0; player < options.PlayerCount; ++player)
+			{
+				report.EscapesOfEachPlayer[player] += result.EscapesOfEachPlayer[player];
+				report.DeathsOfEachPlayer[player] += result.DeathsOfEachPlayer[player];
+			}
+			report.KilledEnemyCount += result.KilledEnemyCount;
+			report.TickCount += result.TickCount;
+			report.TicksPerSecondOfEachThread.push_back(result.ElapsedSeconds > 0 ? result.TickCount / result.ElapsedSeconds : 0);
+			busySeconds += result.ElapsedSeconds;
+		}
+
+		report.MeanTicksPerMatch = report.MatchCount > 0 ? static_cast<double_t>(report.TickCount) / report.MatchCount : 0;
+		report.TicksPerSecond = report.ElapsedSeconds > 0 ? report.TickCount / report.ElapsedSeconds : 0;
+		report.TicksPerSecondPerCore = report.TicksPerSecond / threadCount;
+		report.ParallelEfficiency = report.ElapsedSeconds > 0 ? busySeconds / (report.ElapsedSeconds * threadCount) : 0;
+
+		return report;
+	}
+
+	/************************************************************************/
+	void BatchSimulationRunner::PlayMatch(const Map& basicMap, const BatchSimulationOptions& options, uint32_t seed, GameSimulation& simulation, 
+										  vector<PlayerInput>& inputs, ThreadResult& result) const
+	{
+		// the inputs of a replay are only played on the level they were recorded on
+		const Replay* replay = options.InputReplay;
+		GameSimulationOptions simulationOptions;
+		simulationOptions.Seed = seed;
+		simulationOptions.PlayerCount = options.PlayerCount;
+		simulationOptions.EnemyCount = options.EnemyCount;
+		simulation.Initialize(basicMap, replay != nullptr ? replay->Options() : simulationOptions);
+
+		const uint32_t spawnedEnemyCount = simulation.GetEnemies().Count();
+
+		vector<RandomInputScript> scripts;
+		if (replay == nullptr)
+		{
+			for (uint32_t player = 0; player < options.PlayerCount; ++player)
+			{
+				scripts.push_back(RandomInputScript(seed * LevelGenerator::kMaxPlayerCount + player + 1));
+			}
+		}
+
+		uint32_t run = 0;
+		uint32_t runTicksLeft = replay != nullptr && replay->RunCount() > 0 ? replay->GetRunLength(0) : 0;
+
+		while (!simulation.IsOver() && simulation.CurrentTick() < options.MaxTicksPerMatch)
+		{
+			if (replay == nullptr)
+			{
+				for (uint32_t player = 0; player < options.PlayerCount; ++player)
+				{
+					inputs[player] = scripts[player].Next();
+				}
+				simulation.Tick(inputs.data());
+			}
+			else
+			{
+				if (runTicksLeft == 0)
+				{
+					if (++run >= replay->RunCount())
+					{
+						break;
+					}
+					runTicksLeft = replay->GetRunLength(run);
+				}
+				simulation.Tick(replay->GetRunInputs(run));
+				--runTicksLeft;
+			}
+		}
+
+		++result.MatchCount;
+		result.TickCount += simulation.CurrentTick();
+		result.KilledEnemyCount += spawnedEnemyCount - simulation.GetEnemies().Count();
+
+		bool hasEscaped = false;
+		const vector<SimulatedPlayer>& players = simulation.Players();
+		for (uint32_t player = 0; player < options.PlayerCount; ++player)
+		{
+			if (players[player].HasEscaped)
+			{
+				hasEscaped = true;
+				++result.EscapesOfEachPlayer[player];
+			}
+			else if (players[player].State == PlayerState::Dead)
+			{
+				++result.DeathsOfEachPlayer[player];
+			}
+		}
+
+		if (hasEscaped)
+		{
+			++result.EscapedMatchCount;
+		}
+		else if (simulation.IsOver())
+		{
+			++result.LostMatchCount;
+		}
+		else
+		{
+			++result.TimedOutMatchCount;
+		}
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Replay.h"
+
+namespace DirectXGame
+{
+	/** Structure holding the options of a batch of simulated matches.
+	*/
+	struct BatchSimulationOptions
+	{
+		BatchSimulationOptions() :
+			FirstSeed(0), MatchCount(1000), MaxTicksPerMatch(7200), PlayerCount(2), EnemyCount(6), ThreadCount(0), InputReplay(nullptr)
+		{
+		}
+
+		uint32_t FirstSeed;
+		uint32_t MatchCount;
+		uint32_t MaxTicksPerMatch;
+		uint32_t PlayerCount;
+		uint32_t EnemyCount;
+		uint32_t ThreadCount;        // 0 means one thread per core
+		const Replay* InputReplay;   // when set, every match plays the game of this replay again, from its seed and with its inputs
+	};
+
+	/** Structure holding the aggregated outcomes and the speed of a batch of simulated matches.
+	*/
+	struct BatchSimulationReport
+	{
+		uint32_t MatchCount;
+		uint32_t EscapedMatchCount;  // at least one player reached the door
+		uint32_t LostMatchCount;     // every player died
+		uint32_t TimedOutMatchCount; // still running after MaxTicksPerMatch, or when the replay ran out of inputs
+		std::vector<uint32_t> EscapesOfEachPlayer;
+		std::vector<uint32_t> DeathsOfEachPlayer;
+		uint64_t KilledEnemyCount;
+		uint64_t TickCount;
+		std::double_t MeanTicksPerMatch;
+		uint32_t ThreadCount;
+		std::double_t ElapsedSeconds;
+		std::double_t TicksPerSecond;
+		std::double_t TicksPerSecondPerCore;
+		std::vector<std::double_t> TicksPerSecondOfEachThread;
+		std::double_t ParallelEfficiency; // time the threads spent simulating over the elapsed time of all of them, 1 when scaling linearly
+	};
+
+	/** Singleton that plays many independent matches on headless simulations, as fast as the cores allow.
+	 * Each thread owns one simulation and starts it again for every match it takes. Matches are handed out one at a
+	 * time from a shared counter, since their lengths vary a lot, and the threads only share their results once done,
+	 * so the throughput grows with the cores. Match i is generated from the seed FirstSeed + i and played by scripted
+	 * bots seeded from it, so a batch gives the same outcomes on every run. With a replay, every match is the game the
+	 * replay recorded: the inputs only make sense on its level, so the options must have its seed and player and enemy counts.
+	 *@see GameSimulation
+	 *@see RandomInputScript
+	*/
+	class BatchSimulationRunner final
+	{
+	public:
+
+		BatchSimulationRunner(const BatchSimulationRunner& rhs) = delete;
+		BatchSimulationRunner(const BatchSimulationRunner&& rhs) = delete;
+		BatchSimulationRunner& operator=(const BatchSimulationRunner& rhs) = delete;
+		BatchSimulationRunner& operator=(const BatchSimulationRunner&& rhs) = delete;
+
+		static BatchSimulationRunner& GetInstance();
+
+		BatchSimulationReport Run(const BatchSimulationOptions& options);
+
+	private:
+
+		/** Structure holding what one thread played, merged into the report once all the threads are done.
+		*/
+		struct ThreadResult
+		{
+			uint32_t MatchCount;
+			uint32_t EscapedMatchCount;
+			uint32_t LostMatchCount;
+			uint32_t TimedOutMatchCount;
+			std::vector<uint32_t> EscapesOfEachPlayer;
+			std::vector<uint32_t> DeathsOfEachPlayer;
+			uint64_t KilledEnemyCount;
+			uint64_t TickCount;
+			std::double_t ElapsedSeconds;
+		};
+
+		BatchSimulationRunner() = default;
+		~BatchSimulationRunner() = default;
+
+		void PlayMatch(const Map& basicMap, const BatchSimulationOptions& options, uint32_t seed, GameSimulation& simulation, 
+					   std::vector<PlayerInput>& inputs, ThreadResult& result) const;
+	};
+}
@@ -0,0 +1,92 @@
+#include "pch.h"
+#include "BlastPropagation.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	BlastPropagation& BlastPropagation::GetInstance()
+	{
+		static BlastPropagation sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	void BlastPropagation::Propagate(const Map& map, const XMUINT2& center, uint32_t range,
+									 vector<BlastTile>& flames, vector<XMUINT2>& destroyedBlocks) const
+	{
+		struct Direction
+		{
+			int32_t X;
+			int32_t Y;
+			BlastTileType SegmentType;
+			BlastTileType EndType;
+		};
+
+		// left, right, bottom, top
+		static const Direction kDirections[4] =
+		{
+			{ -1, 0, BlastTileType::Horizontal, BlastTileType::Left },
+			{ 1, 0, BlastTileType::Horizontal, BlastTileType::Right },
+			{ 0, -1, BlastTileType::Vertical, BlastTileType::Bottom },
+			{ 0, 1, BlastTileType::Vertical, BlastTileType::Top }
+		};
+
+		flames.clear();
+		destroyedBlocks.clear();
+
+		// center
+		flames.push_back(BlastTile(center, BlastTileType::Center));
+
+		// segments
+		bool canAddEnd[4];
+		for (uint32_t d = 0; d < 4; ++d)
+		{
+			canAddEnd[d] = true;
+			for (uint32_t i = 1; i <= range; ++i)
+			{
+				XMUINT2 tile(center.x + kDirections[d].X * i, center.y + kDirections[d].Y * i);
+				if (!TryAddFlame(map, BlastTile(tile, kDirections[d].SegmentType), flames, destroyedBlocks))
+				{
+					canAddEnd[d] = false;
+					break;
+				}
+			}
+		}
+
+		// ends
+		for (uint32_t d = 0; d < 4; ++d)
+		{
+			if (canAddEnd[d])
+			{
+				XMUINT2 tile(center.x + kDirections[d].X * (range + 1), center.y + kDirections[d].Y * (range + 1));
+				TryAddFlame(map, BlastTile(tile, kDirections[d].EndType), flames, destroyedBlocks);
+			}
+		}
+	}
+
+	/************************************************************************/
+	bool BlastPropagation::TryAddFlame(const Map& map, const BlastTile& flame, vector<BlastTile>& flames, vector<XMUINT2>& destroyedBlocks) const
+	{
+		const XMUINT2& tile = flame.Tile;
+		if (tile.x >= map.MapWidth || tile.y >= map.MapHeight)
+		{
+			return false;
+		}
+
+		// most tiles are free, the occupancy mask tells without reading the layer
+		if (!map.Chunks.IsBlocked(tile))
+		{
+			flames.push_back(flame);
+			return true;
+		}
+
+		if (map.BlocksLayer[tile.x][tile.y] == static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock))
+		{
+			destroyedBlocks.push_back(tile);
+		}
+		return false;
+	}
+}
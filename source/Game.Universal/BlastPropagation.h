@@ -0,0 +1,60 @@
+#pragma once
+
+#include "RenderingDataStructures.h"
+
+namespace DirectXGame
+{
+	/** Enumeration representing the part of a blast covering a tile, each part has its own explosion animation.
+	*@see BlastPropagation
+	*/
+	enum class BlastTileType
+	{
+		Center,
+		Horizontal,
+		Vertical,
+		Left,
+		Right,
+		Bottom,
+		Top
+	};
+
+	/** Structure representing a tile covered by the flames of a blast.
+	*/
+	struct BlastTile
+	{
+		BlastTile(const DirectX::XMUINT2& tile = DirectX::XMUINT2(0, 0), const BlastTileType type = BlastTileType::Center) :
+			Tile(tile), Type(type)
+		{
+		}
+
+		DirectX::XMUINT2 Tile;
+		BlastTileType Type;
+	};
+
+	/** Singleton holding the rules of how a bomb blast spreads over the map.
+	 * The flames go range tiles in each direction, plus an end tile if nothing stopped them.
+	 * Any block stops the flames, a soft block is destroyed by them.
+	 * The map is not modified, the blocks to destroy are returned instead.
+	*/
+	class BlastPropagation final
+	{
+	public:
+
+		BlastPropagation(const BlastPropagation& rhs) = delete;
+		BlastPropagation(const BlastPropagation&& rhs) = delete;
+		BlastPropagation& operator=(const BlastPropagation& rhs) = delete;
+		BlastPropagation& operator=(const BlastPropagation&& rhs) = delete;
+
+		static BlastPropagation& GetInstance();
+
+		void Propagate(const Map& map, const DirectX::XMUINT2& center, uint32_t range,
+					   std::vector<BlastTile>& flames, std::vector<DirectX::XMUINT2>& destroyedBlocks) const;
+
+	private:
+
+		BlastPropagation() = default;
+		~BlastPropagation() = default;
+
+		bool TryAddFlame(const Map& map, const BlastTile& flame, std::vector<BlastTile>& flames, std::vector<DirectX::XMUINT2>& destroyedBlocks) const;
+	};
+}
@@ -4,6 +4,9 @@
 #include "SpriteSheetParser.h"
 #include "LevelManager.h"
 #include "MapRenderable.h"
+#include "BlastPropagation.h"
+#include "StateHash.h"
+#include "Profiler.h"
 
 using namespace std;
 using namespace DX;
@@ -14,10 +17,9 @@ namespace DirectXGame
 	const double_t Bomb::kBombExplosionTime = 3;
 
 	// rendering
-	const string Bomb::kBombJSONFilePath = "Assets/JSONS/Bomb.json";
-	const wstring Bomb::kBombTextureMapPath = L"Assets/SpriteSheets/BombSpriteSheet.png";
-	const string Bomb::kBombAEJSONFilePath = "Assets/JSONS/BombAE.json";
-	const wstring Bomb::kBombAETextureMapPath = L"Assets/SpriteSheets/BombAESpriteSheet.png";
+	const string Bomb::kBombJSONFilePath = "Assets/JSONS/Atlas/Bomb.json";
+	const wstring Bomb::kBombTextureMapPath = L"Assets/SpriteSheets/Atlas.png";
+	const string Bomb::kBombAEJSONFilePath = "Assets/JSONS/Atlas/BombAE.json";
 
 	// animation
 	const double_t Bomb::kBombAnimationTime = 0.2;
@@ -40,11 +42,12 @@ namespace DirectXGame
 		mCurrentState(BombState::Ticking),
 		mExplosionTimer(0),
 		mIsRemoteControlled(player.GetPerks().Remote),
+		mTickingAnimation(GetSharedResources().BombSpriteSheet.Animations.at(kBombTickingAnimationName).get()),
+		mTickingSpriteIndex(0),
 		mTickingAnimationTimer(0)
 	{
 		mPosition = GetPositionFromTile(GetTileFromPosition(mPlayer.Position()));
 		CreateDeviceDependentResources();
-		InitializeSprites();
 	}
 
 	/************************************************************************/
@@ -115,7 +118,7 @@ namespace DirectXGame
 		{
 			case DirectXGame::BombState::Ticking:
 			{
-				auto sprite = mTickingAnimation->Sprites[mTickingAnimation->CurrentSpriteIndex];
+				const auto& sprite = mTickingAnimation->Sprites[mTickingSpriteIndex];
 				Transform2D transform(mPosition, 0, SpriteScale);
 
 				DrawSprite(*sprite, transform);
@@ -125,7 +128,7 @@ namespace DirectXGame
 			{
 				for (auto& explosionAE : mExplosionAEs)
 				{
-					auto sprite = explosionAE.Anim.Sprites[explosionAE.Anim.CurrentSpriteIndex];
+					const auto& sprite = explosionAE.Anim->Sprites[explosionAE.CurrentSpriteIndex];
 					Transform2D transform(explosionAE.Position, 0, SpriteScale);
 
 					DrawSprite(*sprite, transform);
@@ -144,140 +147,101 @@ namespace DirectXGame
 	/************************************************************************/
 	void Bomb::Explode()
 	{
-		uint32_t range = mPlayer.GetPerks().Fire;
+		ProfileScope scope("Bomb::Explode");
 
 		XMUINT2 centerTile = GetTileFromPosition(mPosition);
 
-		// center
-		ExplosionAE centerExplosionAE(mBombAESpriteSheet.Animations[kBombAECenterAnimationName], GetPositionFromTile(centerTile));
-		mExplosionAEs.push_back(centerExplosionAE);
+		SharedResources& shared = GetSharedResources();
+		BlastPropagation::GetInstance().Propagate(mPlayer.GetMap(), centerTile, GetRange(), shared.Flames, shared.DestroyedBlocks);
 
-		// left horiz
-		bool canAddLeft = true;
-		for (uint32_t i = 1; i <= range; ++i)
+		// the center comes first, its animation tells when the whole explosion ended
+		for (auto& flame : shared.Flames)
 		{
-			XMUINT2 leftHorizTile(centerTile.x - i, centerTile.y);
-
-			ExplosionAE leftHorizExplosionAE(mBombAESpriteSheet.Animations[kBombAEHorizAnimationName], GetPositionFromTile(leftHorizTile));
-
-			if (!AddExplosionAE(leftHorizExplosionAE))
-			{
-				canAddLeft = false;
-				break;
-			}
-		}
-
-		// right horiz
-		bool canAddRight = true;
-		for (uint32_t i = 1; i <= range; ++i)
-		{
-			XMUINT2 rightHorizTile(centerTile.x + i, centerTile.y);
-
-			ExplosionAE rightHorizExplosionAE(mBombAESpriteSheet.Animations[kBombAEHorizAnimationName], GetPositionFromTile(rightHorizTile));
-
-			if (!AddExplosionAE(rightHorizExplosionAE))
-			{
-				canAddRight = false;
-				break;
-			}
+			ExplosionAE explosionAE(*shared.BombAESpriteSheet.Animations.at(GetExplosionAnimationName(flame.Type)), GetPositionFromTile(flame.Tile));
+			mExplosionAEs.push_back(explosionAE);
 		}
 
-		// bottom vert
-		bool canAddBottom = true;
-		for (uint32_t i = 1; i <= range; ++i)
+		for (auto& block : shared.DestroyedBlocks)
 		{
-			XMUINT2 bottomVertTile(centerTile.x, centerTile.y - i);
-
-			ExplosionAE bottomVertExplosionAE(mBombAESpriteSheet.Animations[kBombAEVertAnimationName], GetPositionFromTile(bottomVertTile));
-
-			if (!AddExplosionAE(bottomVertExplosionAE))
-			{
-				canAddBottom = false;
-				break;
-			}
+			mPlayer.GetMapRenderable().AddFadingBlock(block);
 		}
 
-		// top vert
-		bool canAddTop = true;
-		for (uint32_t i = 1; i <= range; ++i)
+		// add them to level manager
+		for (auto& ae : mExplosionAEs)
 		{
-			XMUINT2 topVertTile(centerTile.x, centerTile.y + i);
-
-			ExplosionAE topVertExplosionAE(mBombAESpriteSheet.Animations[kBombAEVertAnimationName], GetPositionFromTile(topVertTile));
-
-			if (!AddExplosionAE(topVertExplosionAE))
-			{
-				canAddTop = false;
-				break;
-			}
+			LevelManager::GetInstance().AddBombAE(GetTileFromPosition(ae.Position));
 		}
 
-		// left
-		if (canAddLeft)
-		{
-			XMUINT2 leftTile(centerTile.x - (range + 1), centerTile.y);
-			ExplosionAE leftExplosionAE(mBombAESpriteSheet.Animations[kBombAELeftAnimationName], GetPositionFromTile(leftTile));
-
-			AddExplosionAE(leftExplosionAE);
-		}
+		LevelManager::GetInstance().OnBombExploded(*this);
 
-		// right
-		if (canAddRight)
-		{
-			XMUINT2 rightTile(centerTile.x + (range + 1), centerTile.y);
-			ExplosionAE rightExplosionAE(mBombAESpriteSheet.Animations[kBombAERightAnimationName], GetPositionFromTile(rightTile));
+		mPlayer.RemoveBomb(*this);
+		mCurrentState = BombState::Exploding;
+	}
 
-			AddExplosionAE(rightExplosionAE);
-		}
+	/************************************************************************/
+	uint32_t Bomb::GetRange() const
+	{
+		return mPlayer.GetPerks().Fire;
+	}
 
-		// bottom
-		if (canAddBottom)
+	/************************************************************************/
+	double_t Bomb::GetTimeLeft() const
+	{
+		// a remote controlled bomb can go off at any time
+		if (mIsRemoteControlled || mCurrentState != BombState::Ticking)
 		{
-			XMUINT2 bottomTile(centerTile.x, centerTile.y - (range + 1));
-			ExplosionAE bottomExplosionAE(mBombAESpriteSheet.Animations[kBombAEBottomAnimationName], GetPositionFromTile(bottomTile));
-
-			AddExplosionAE(bottomExplosionAE);
+			return 0;
 		}
 
-		// top
-		if (canAddTop)
-		{
-			XMUINT2 topTile(centerTile.x, centerTile.y + (range + 1));
-			ExplosionAE topExplosionAE(mBombAESpriteSheet.Animations[kBombAETopAnimationName], GetPositionFromTile(topTile));
-
-			AddExplosionAE(topExplosionAE);
-		}
+		return max(kBombExplosionTime - mExplosionTimer, 0.0);
+	}
 
-		// add them to level manager
-		for (auto& ae : mExplosionAEs)
+	/************************************************************************/
+	uint64_t Bomb::GetStateHash() const
+	{
+		StateHash hash;
+		hash.Add(mPosition);
+		hash.Add(mCurrentState);
+		hash.Add(mExplosionTimer);
+		hash.Add(mIsRemoteControlled);
+		hash.Add(mTickingAnimationTimer);
+		for (auto& explosionAE : mExplosionAEs)
 		{
-			LevelManager::GetInstance().AddBombAE(GetTileFromPosition(ae.Position));
+			hash.Add(explosionAE.Position);
+			hash.Add(explosionAE.AnimTimer);
+			hash.Add(explosionAE.AnimEnded);
 		}
-
-		// update assets
-		mPlayer.RemoveBomb(*this);
-		mRenderableSpriteSheet = mBombAESpriteSheet;
-		mTextureMapFilePath = kBombAETextureMapPath;
-		ReleaseDeviceDependentResources();
-		CreateDeviceDependentResources();
-		mCurrentState = BombState::Exploding;
+		return hash.Value();
 	}
 
 	/************************************************************************/
 	void Bomb::InitializeSprites()
 	{
-		// set ticking animation
-		mBombSpriteSheet = SpriteSheetParser::GetInstance().ParseSpriteSheet(kBombJSONFilePath);
-		mRenderableSpriteSheet = mBombSpriteSheet;
-		mTickingAnimation = mRenderableSpriteSheet.Animations[kBombTickingAnimationName];
-		mTickingAnimation->AnimationLength = kBombAnimationTime;
-
-		// set explosion ae animations
-		mBombAESpriteSheet = SpriteSheetParser::GetInstance().ParseSpriteSheet(kBombAEJSONFilePath);
-		for (auto& anim : mBombAESpriteSheet.Animations)
+		// the sprites come from the shared sprite sheets, taken in the constructor so Update never depends on the
+		// loading task, which runs on another thread
+	}
+
+	/************************************************************************/
+	Bomb::SharedResources& Bomb::GetSharedResources()
+	{
+		static SharedResources sInstance = []()
 		{
-			anim.second->AnimationLength = kBombAEAnimationTime;
-		}
+			SharedResources resources;
+
+			// ticking animation
+			resources.BombSpriteSheet = SpriteSheetParser::GetInstance().ParseSpriteSheet(kBombJSONFilePath);
+			resources.BombSpriteSheet.Animations.at(kBombTickingAnimationName)->AnimationLength = kBombAnimationTime;
+
+			// explosion ae animations
+			resources.BombAESpriteSheet = SpriteSheetParser::GetInstance().ParseSpriteSheet(kBombAEJSONFilePath);
+			for (auto& anim : resources.BombAESpriteSheet.Animations)
+			{
+				anim.second->AnimationLength = kBombAEAnimationTime;
+			}
+
+			return resources;
+		}();
+		return sInstance;
 	}
 
 	/************************************************************************/
@@ -312,7 +276,7 @@ namespace DirectXGame
 		if (mTickingAnimationTimer > mTickingAnimation->AnimationLength)
 		{
 			mTickingAnimationTimer -= mTickingAnimation->AnimationLength;
-			mTickingAnimation->CurrentSpriteIndex = (mTickingAnimation->CurrentSpriteIndex + 1) % mTickingAnimation->Sprites.size();
+			mTickingSpriteIndex = (mTickingSpriteIndex + 1) % static_cast<uint32_t>(mTickingAnimation->Sprites.size());
 		}
 	}
 
@@ -323,18 +287,18 @@ namespace DirectXGame
 		{
 			explosionAE.AnimTimer += timer.GetElapsedSeconds();
 
-			if (explosionAE.AnimTimer > explosionAE.Anim.AnimationLength)
+			if (explosionAE.AnimTimer > explosionAE.Anim->AnimationLength)
 			{
 				// last sprite
-				if (explosionAE.Anim.CurrentSpriteIndex == explosionAE.Anim.Sprites.size() - 1)
+				if (explosionAE.CurrentSpriteIndex == explosionAE.Anim->Sprites.size() - 1)
 				{
 					explosionAE.AnimEnded = true;
-					explosionAE.Anim.CurrentSpriteIndex = 0;
+					explosionAE.CurrentSpriteIndex = 0;
 				}
 				else
 				{
-					explosionAE.AnimTimer -= explosionAE.Anim.AnimationLength;
-					++explosionAE.Anim.CurrentSpriteIndex;
+					explosionAE.AnimTimer -= explosionAE.Anim->AnimationLength;
+					++explosionAE.CurrentSpriteIndex;
 				}
 			}
 		}
@@ -352,24 +316,25 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	bool Bomb::AddExplosionAE(const ExplosionAE& explosionAE)
+	const string& Bomb::GetExplosionAnimationName(BlastTileType type)
 	{
-		const Map& map = mPlayer.GetMap();
-		XMUINT2 tile = GetTileFromPosition(explosionAE.Position);
-
-		if (map.BlocksLayer[tile.x][tile.y] != static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock) &&
-			map.BlocksLayer[tile.x][tile.y] != static_cast<uint8_t>(SpriteIndicesInMap::SolidBlock))
+		switch (type)
 		{
-			mExplosionAEs.push_back(explosionAE);
-			return true;
-		}
-		else
-		{
-			if (map.BlocksLayer[tile.x][tile.y] == static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock))
-			{
-				mPlayer.GetMapRenderable().AddFadingBlock(tile);
-			}
-			return false;
+			case DirectXGame::BlastTileType::Horizontal:
+				return kBombAEHorizAnimationName;
+			case DirectXGame::BlastTileType::Vertical:
+				return kBombAEVertAnimationName;
+			case DirectXGame::BlastTileType::Left:
+				return kBombAELeftAnimationName;
+			case DirectXGame::BlastTileType::Right:
+				return kBombAERightAnimationName;
+			case DirectXGame::BlastTileType::Bottom:
+				return kBombAEBottomAnimationName;
+			case DirectXGame::BlastTileType::Top:
+				return kBombAETopAnimationName;
+			case DirectXGame::BlastTileType::Center:
+			default:
+				return kBombAECenterAnimationName;
 		}
 	}
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Renderable.h"
+#include "BlastPropagation.h"
+#include "TrackingAllocator.h"
 
 namespace DirectXGame
 {
@@ -15,6 +17,7 @@ namespace DirectXGame
 	};
 
 	/** Structure representing a renderable bomb explosion after effect.
+	 * The animation belongs to the sprite sheet every bomb shares, only the sprite shown is kept here.
 	*/
 	struct ExplosionAE
 	{
@@ -22,20 +25,23 @@ namespace DirectXGame
 		{
 		}
 
-		ExplosionAE(const std::shared_ptr<Animation>& anim, const DirectX::XMFLOAT2 position):
-			Anim(*anim), Position(position), AnimTimer(0), AnimEnded(false)
+		ExplosionAE(const Animation& anim, const DirectX::XMFLOAT2 position):
+			Anim(&anim), Position(position), AnimTimer(0), CurrentSpriteIndex(0), AnimEnded(false)
 		{
 		}
 
-		Animation Anim;
+		const Animation* Anim;
 		DirectX::XMFLOAT2 Position;
 		double_t AnimTimer;
+		uint32_t CurrentSpriteIndex;
 		bool AnimEnded;
 	};
 
 	class Player;
 
 	/** Class representing a renderable bomb in the game.
+	 * Bombs come and go all game long, so what they can share is made once for all of them: the sprite sheets are
+	 * parsed by the first bomb, and explosions propagate into the same scratch vectors.
 	*/
 	class Bomb final : public Renderable
 	{
@@ -50,18 +56,36 @@ namespace DirectXGame
 
 		void Explode();
 
+		uint32_t GetRange() const;
+		double_t GetTimeLeft() const;
+		uint64_t GetStateHash() const;
+
 	protected:
 
 		virtual void InitializeSprites() override;
 
 	private:
 
+		/** Structure holding what every bomb shares.
+		*/
+		struct SharedResources
+		{
+			SpriteSheet BombSpriteSheet;
+			SpriteSheet BombAESpriteSheet;
+
+			// explosion scratch
+			std::vector<BlastTile> Flames;
+			std::vector<DirectX::XMUINT2> DestroyedBlocks;
+		};
+
+		static SharedResources& GetSharedResources();
+
 		void UpdateAnimation(const DX::StepTimer& timer);
 		void UpdateTickingAnimation(const DX::StepTimer& timer);
 		void UpdateExplosionAnimation(const DX::StepTimer& timer);
 		void Vanish();
 
-		bool AddExplosionAE(const ExplosionAE& explosionAE);
+		static const std::string& GetExplosionAnimationName(BlastTileType type);
 
 		Player& mPlayer;
 		BombState mCurrentState;
@@ -74,14 +98,12 @@ namespace DirectXGame
 		static const std::string kBombJSONFilePath;
 		static const std::wstring kBombTextureMapPath;
 		static const std::string kBombAEJSONFilePath;
-		static const std::wstring kBombAETextureMapPath;
-		SpriteSheet mBombSpriteSheet;
-		SpriteSheet mBombAESpriteSheet;
 
 		// animation
-		std::shared_ptr<Animation> mTickingAnimation;
+		const Animation* mTickingAnimation;
+		uint32_t mTickingSpriteIndex;
 		double_t mTickingAnimationTimer;
-		std::vector<ExplosionAE> mExplosionAEs;
+		TrackedVector<ExplosionAE, AllocationSubsystem::Bombs> mExplosionAEs;
 
 		static const double_t kBombAnimationTime;
 		static const double_t kBombAEAnimationTime;
@@ -2,7 +2,9 @@
 #include "CollisionManager.h"
 #include "Renderable.h"
 #include "MapRenderable.h"
+#include "EnemyManager.h"
 #include "LevelManager.h"
+#include "Profiler.h"
 
 using namespace std;
 using namespace DirectX;
@@ -28,37 +30,74 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	PlayerCollisionType CollisionManager::PlayerCollisionCheck(const XMFLOAT2& playerPosition, const XMFLOAT2& playerVelocity, VelocityRestrictions& velocityRestrictions)
+	void CollisionManager::SetEnemies(const shared_ptr<EnemyManager>& enemies)
 	{
-		if (CharacterCollisionWithBombsAE(playerPosition))
+		mEnemies = enemies;
+	}
+
+	/************************************************************************/
+	void CollisionManager::PlayersCollisionCheck(vector<PlayerCollisionQuery>& queries)
+	{
+		// what the players collide with is fetched once for all of them
+		auto mapRenderable = mMap.lock();
+		auto enemies = mEnemies.lock();
+		PlayersCollisionCheck(mapRenderable->GetMap(), LevelManager::GetInstance().GetNavigationGrid(), enemies.get(), queries);
+	}
+
+	/************************************************************************/
+	void CollisionManager::PlayersCollisionCheck(const Map& map, const NavigationGrid& grid, const EnemyManager* enemies, vector<PlayerCollisionQuery>& queries)
+	{
+		ProfileScope scope("CollisionManager::PlayersCollisionCheck");
+
+		for (auto& query : queries)
+		{
+			PlayerCollisionCheck(map, grid, enemies, query);
+		}
+	}
+
+	/************************************************************************/
+	void CollisionManager::PlayerCollisionCheck(const Map& map, const NavigationGrid& grid, const EnemyManager* enemies, PlayerCollisionQuery& query)
+	{
+		if (CharacterCollisionWithBombsAE(grid, query.Position))
 		{
-			return PlayerCollisionType::BombAE;
+			query.Type = PlayerCollisionType::BombAE;
+			return;
 		}
 
-		if (PlayerCollisionWithDoor(playerPosition))
+		if (PlayerCollisionWithEnemies(enemies, query.Position))
 		{
-			velocityRestrictions.CanMoveOnX = true;
-			velocityRestrictions.CanMoveOnY = true;
-			return PlayerCollisionType::Door;
+			query.Type = PlayerCollisionType::Enemy;
+			return;
 		}
 
-		if (PlayerCollisionWithPerk(playerPosition))
+		if (PlayerCollisionWithDoor(map, query.Position))
 		{
-			velocityRestrictions.CanMoveOnX = true;
-			velocityRestrictions.CanMoveOnY = true;
-			return PlayerCollisionType::Perk;
+			query.Restrictions.CanMoveOnX = true;
+			query.Restrictions.CanMoveOnY = true;
+			query.Type = PlayerCollisionType::Door;
+			return;
 		}
 
-		if (CharacterCollisionWithMap(playerPosition, playerVelocity, velocityRestrictions))
+		if (PlayerCollisionWithPerk(map, query.Position))
 		{
-			return PlayerCollisionType::Map;
+			query.Restrictions.CanMoveOnX = true;
+			query.Restrictions.CanMoveOnY = true;
+			query.Type = PlayerCollisionType::Perk;
+			return;
 		}
 
-		return PlayerCollisionType::None;
+		if (CharacterCollisionWithMap(map, grid, query.Position, query.Velocity, query.Restrictions))
+		{
+			query.Type = PlayerCollisionType::Map;
+			return;
+		}
+
+		query.Type = PlayerCollisionType::None;
 	}
 
 	/************************************************************************/
-	bool CollisionManager::CharacterCollisionWithMap(const DirectX::XMFLOAT2 & characterPosition, const XMFLOAT2& characterVelocity, VelocityRestrictions& velocityRestrictions)
+	bool CollisionManager::CharacterCollisionWithMap(const Map& map, const NavigationGrid& grid, const XMFLOAT2& characterPosition, 
+													 const XMFLOAT2& characterVelocity, VelocityRestrictions& velocityRestrictions)
 	{
 		if (characterVelocity.x == 0 && characterVelocity.y == 0)
 		{
@@ -101,25 +140,36 @@ namespace DirectXGame
 			++oppositeTile3.x;
 		}
 
-		vector<BoundingBox> vect = GetSurroundingBlocks(characterTile);
-		auto vect2 = LevelManager::GetInstance().GetBombsTiles();
-		for (auto& tile : vect2)
+		auto& vect = mBoxes;
+		GetSurroundingBlocks(map, characterTile, vect);
+
+		// a bomb further than the surrounding tiles cannot touch the character
+		for (uint32_t y = characterTile.y - 1; y != characterTile.y + 2; ++y)
 		{
-			if (tile.x == oppositeTile1.x && tile.y == oppositeTile1.y || 
-				tile.x == oppositeTile2.x && tile.y == oppositeTile2.y ||
-				tile.x == oppositeTile3.x && tile.y == oppositeTile3.y ||
-				tile.x == characterTile.x && tile.y == characterTile.y)
+			for (uint32_t x = characterTile.x - 1; x != characterTile.x + 2; ++x)
 			{
-				continue;
-			}
+				XMUINT2 tile(x, y);
+				if (!grid.IsInside(tile) || !grid.HasFlag(grid.GetIndex(tile), NavigationCellFlags::Bomb))
+				{
+					continue;
+				}
+
+				if (tile.x == oppositeTile1.x && tile.y == oppositeTile1.y || 
+					tile.x == oppositeTile2.x && tile.y == oppositeTile2.y ||
+					tile.x == oppositeTile3.x && tile.y == oppositeTile3.y ||
+					tile.x == characterTile.x && tile.y == characterTile.y)
+				{
+					continue;
+				}
 
-			XMFLOAT2 position = Renderable::GetPositionFromTile(tile);
-			XMFLOAT2 center = Renderable::GetCenterPositionOfSprite(position);
-			XMFLOAT3 bbCenter(center.x, center.y, 0.1f);
-			XMFLOAT3 bbExtents(extents.x, extents.y, 0.1f);
-			BoundingBox boundingBox(bbCenter, bbExtents);
+				XMFLOAT2 position = Renderable::GetPositionFromTile(tile);
+				XMFLOAT2 center = Renderable::GetCenterPositionOfSprite(position);
+				XMFLOAT3 bbCenter(center.x, center.y, 0.1f);
+				XMFLOAT3 bbExtents(extents.x, extents.y, 0.1f);
+				BoundingBox boundingBox(bbCenter, bbExtents);
 
-			vect.push_back(boundingBox);
+				vect.push_back(boundingBox);
+			}
 		}
 
 		bool collided = false;
@@ -171,61 +221,77 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	bool CollisionManager::CharacterCollisionWithBombsAE(const XMFLOAT2& characterPosition)
+	bool CollisionManager::PlayerCollisionWithEnemies(const EnemyManager* enemies, const XMFLOAT2& playerPosition)
+	{
+		// the enemies are bucketed by tile, so this only looks at the enemies around the player
+		return enemies != nullptr && enemies->CollidesWithPlayer(playerPosition);
+	}
+
+	/************************************************************************/
+	bool CollisionManager::CharacterCollisionWithBombsAE(const NavigationGrid& grid, const XMFLOAT2& characterPosition)
 	{
 		XMFLOAT2 center = Renderable::GetCenterPositionOfSprite(characterPosition);
 		XMFLOAT2 extents = Renderable::GetSpriteExtents();
 		BoundingBox characterBoundingBox({ center.x, center.y, 0.1f },
 		{ extents.x - sMarginForBombAECollision, extents.y - sMarginForBombAECollision, 0.1f });
 
-		auto vect = LevelManager::GetInstance().GetBombsAETiles();
-
-		for (auto& ae : vect)
+		// an explosion further than the surrounding tiles cannot touch the character
+		XMUINT2 characterTile = Renderable::GetTileFromPosition(characterPosition);
+		for (uint32_t y = characterTile.y - 1; y != characterTile.y + 2; ++y)
 		{
-			XMFLOAT2 aePosition = Renderable::GetPositionFromTile(ae);
-			XMFLOAT2 aeCenter = Renderable::GetCenterPositionOfSprite(aePosition);
-			BoundingBox aeBoundingBox({ aeCenter.x, aeCenter.y, 0.1f }, { extents.x, extents.y, 0.1f });
-
-			if (characterBoundingBox.Intersects(aeBoundingBox))
+			for (uint32_t x = characterTile.x - 1; x != characterTile.x + 2; ++x)
 			{
-				return true;
+				XMUINT2 ae(x, y);
+				if (!grid.IsInside(ae) || !grid.HasFlag(grid.GetIndex(ae), NavigationCellFlags::Explosion))
+				{
+					continue;
+				}
+
+				XMFLOAT2 aePosition = Renderable::GetPositionFromTile(ae);
+				XMFLOAT2 aeCenter = Renderable::GetCenterPositionOfSprite(aePosition);
+				BoundingBox aeBoundingBox({ aeCenter.x, aeCenter.y, 0.1f }, { extents.x, extents.y, 0.1f });
+
+				if (characterBoundingBox.Intersects(aeBoundingBox))
+				{
+					return true;
+				}
 			}
 		}
 		return false;
 	}
 
 	/************************************************************************/
-	bool CollisionManager::PlayerCollisionWithDoor(const XMFLOAT2& playerPosition)
+	bool CollisionManager::PlayerCollisionWithDoor(const Map& map, const XMFLOAT2& playerPosition)
 	{
 		XMFLOAT2 playerCenter = Renderable::GetCenterPositionOfSprite(playerPosition);
 		XMFLOAT2 extents = Renderable::GetSpriteExtents();
 		BoundingBox playerBoundingBox({ playerCenter.x, playerCenter.y, 0.1f },
 		{ extents.x - sMarginForDoorCollision, extents.y - sMarginForDoorCollision, 0.1f });
 
-		XMFLOAT2 doorCenter = Renderable::GetCenterPositionOfSprite(Renderable::GetPositionFromTile(mMap.lock()->GetMap().DoorTile.Tile));
+		XMFLOAT2 doorCenter = Renderable::GetCenterPositionOfSprite(Renderable::GetPositionFromTile(map.DoorTile.Tile));
 		BoundingBox doorBoundingBox({ doorCenter.x, doorCenter.y, 0.1f }, { extents.x, extents.y, 0.1f });
 
 		return playerBoundingBox.Intersects(doorBoundingBox);
 	}
 
 	/************************************************************************/
-	bool CollisionManager::PlayerCollisionWithPerk(const XMFLOAT2& playerPosition)
+	bool CollisionManager::PlayerCollisionWithPerk(const Map& map, const XMFLOAT2& playerPosition)
 	{
 		XMFLOAT2 playerCenter = Renderable::GetCenterPositionOfSprite(playerPosition);
 		XMFLOAT2 extents = Renderable::GetSpriteExtents();
 		BoundingBox playerBoundingBox({ playerCenter.x, playerCenter.y, 0.1f },
 		{ extents.x - sMarginForPerksCollision, extents.y - sMarginForPerksCollision, 0.1f });
 
-		XMFLOAT2 perkCenter = Renderable::GetCenterPositionOfSprite(Renderable::GetPositionFromTile(mMap.lock()->GetMap().PerkTile.Tile));
+		XMFLOAT2 perkCenter = Renderable::GetCenterPositionOfSprite(Renderable::GetPositionFromTile(map.PerkTile.Tile));
 		BoundingBox perkBoundingBox({ perkCenter.x, perkCenter.y, 0.1f }, { extents.x, extents.y, 0.1f });
 
 		return playerBoundingBox.Intersects(perkBoundingBox);
 	}
 
 	/************************************************************************/
-	vector<BoundingBox> CollisionManager::GetSurroundingBlocks(const XMUINT2& tile)
+	void CollisionManager::GetSurroundingBlocks(const Map& map, const XMUINT2& tile, TrackedVector<BoundingBox, AllocationSubsystem::Collision>& vect)
 	{
-		vector<BoundingBox> vect;
+		vect.clear();
 
 		for (uint32_t y = tile.y - 1; y <= tile.y + 1; ++y)
 		{
@@ -238,8 +304,7 @@ namespace DirectXGame
 
 				XMUINT2 currentTile(x, y);
 
-				if (mMap.lock()->GetMap().BlocksLayer[x][y] == static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock) ||
-					mMap.lock()->GetMap().BlocksLayer[x][y] == static_cast<uint8_t>(SpriteIndicesInMap::SolidBlock))
+				if (map.Chunks.IsBlocked(currentTile))
 				{
 					XMFLOAT2 position = Renderable::GetPositionFromTile(currentTile);
 					XMFLOAT2 center = Renderable::GetCenterPositionOfSprite(position);
@@ -252,7 +317,5 @@ namespace DirectXGame
 				}
 			}
 		}
-
-		return move(vect);
 	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "TrackingAllocator.h"
 #include <DirectXCollision.h>
 #include <memory>
 #include <vector>
@@ -36,10 +37,30 @@ namespace DirectXGame
 		float_t YVel;
 	};
 
+	/** Structure holding the collision query of one player for a frame, and its result.
+	 *@see CollisionManager
+	*/
+	struct PlayerCollisionQuery
+	{
+		PlayerCollisionQuery(const DirectX::XMFLOAT2& position = DirectX::XMFLOAT2(0, 0), const DirectX::XMFLOAT2& velocity = DirectX::XMFLOAT2(0, 0)) :
+			Position(position), Velocity(velocity), Type(PlayerCollisionType::None)
+		{
+		}
+
+		DirectX::XMFLOAT2 Position;
+		DirectX::XMFLOAT2 Velocity;
+		VelocityRestrictions Restrictions;
+		PlayerCollisionType Type;
+	};
+
+	struct Map;
 	class MapRenderable;
+	class EnemyManager;
+	class NavigationGrid;
 
 	/** Singleton that handles the collisions in the game.
 	 * This Manager interfaces with the level manager to get the elements in the map.
+	 * Bombs and explosions are looked up in the navigation grid around each player, so a check does not depend on how many there are.
 	 * @see LevelManager
 	*/
 	class CollisionManager final
@@ -54,22 +75,29 @@ namespace DirectXGame
 		static CollisionManager& GetInstance();
 
 		void SetMap(const std::shared_ptr<MapRenderable>& map);
-		PlayerCollisionType PlayerCollisionCheck(const DirectX::XMFLOAT2& playerPosition, const DirectX::XMFLOAT2& playerVelocity, VelocityRestrictions& velocityRestrictions);
+		void SetEnemies(const std::shared_ptr<EnemyManager>& enemies);
+		void PlayersCollisionCheck(std::vector<PlayerCollisionQuery>& queries);
+		void PlayersCollisionCheck(const Map& map, const NavigationGrid& grid, const EnemyManager* enemies, std::vector<PlayerCollisionQuery>& queries);
 
 	private:
 
 		CollisionManager() = default;
 		~CollisionManager() = default;
 
-		bool CharacterCollisionWithMap(const DirectX::XMFLOAT2& characterPosition, const DirectX::XMFLOAT2& characterVelocity, VelocityRestrictions& velocityRestrictions);
-		//bool PlayerCollisionWithEnemies(const DirectX::BoundingBox& playerBoundingBox);
-		bool CharacterCollisionWithBombsAE(const DirectX::XMFLOAT2& characterPosition);
-		bool PlayerCollisionWithDoor(const DirectX::XMFLOAT2& playerPosition);
-		bool PlayerCollisionWithPerk(const DirectX::XMFLOAT2& playerPosition);
+		void PlayerCollisionCheck(const Map& map, const NavigationGrid& grid, const EnemyManager* enemies, PlayerCollisionQuery& query);
+
+		bool CharacterCollisionWithMap(const Map& map, const NavigationGrid& grid, const DirectX::XMFLOAT2& characterPosition, 
+									   const DirectX::XMFLOAT2& characterVelocity, VelocityRestrictions& velocityRestrictions);
+		bool PlayerCollisionWithEnemies(const EnemyManager* enemies, const DirectX::XMFLOAT2& playerPosition);
+		bool CharacterCollisionWithBombsAE(const NavigationGrid& grid, const DirectX::XMFLOAT2& characterPosition);
+		bool PlayerCollisionWithDoor(const Map& map, const DirectX::XMFLOAT2& playerPosition);
+		bool PlayerCollisionWithPerk(const Map& map, const DirectX::XMFLOAT2& playerPosition);
 
-		std::vector<DirectX::BoundingBox> GetSurroundingBlocks(const DirectX::XMUINT2& tile);
+		void GetSurroundingBlocks(const Map& map, const DirectX::XMUINT2& tile, TrackedVector<DirectX::BoundingBox, AllocationSubsystem::Collision>& boxes);
 
 		std::weak_ptr<MapRenderable> mMap;
+		std::weak_ptr<EnemyManager> mEnemies;
+		TrackedVector<DirectX::BoundingBox, AllocationSubsystem::Collision> mBoxes; // scratch, reused by every map check
 
 		static const float_t sMarginForMapCollision;
 		static const float_t sMarginForBombAECollision;
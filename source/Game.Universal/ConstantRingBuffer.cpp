@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "ConstantRingBuffer.h"
+
+using namespace std;
+using namespace DX;
+
+namespace DirectXGame
+{
+	const uint32_t ConstantRingBuffer::kCapacityBytes = 1024 * 1024; // 4096 sprites before the ring starts over
+	const uint32_t ConstantRingBuffer::kConstantSize = 16;
+	const uint32_t ConstantRingBuffer::kRangeAlignment = 256;        // 16 constants, for the offsets of VSSetConstantBuffers1
+
+	/************************************************************************/
+	ConstantRingBuffer& ConstantRingBuffer::GetInstance()
+	{
+		static ConstantRingBuffer sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	ConstantRingBuffer::ConstantRingBuffer() :
+		mRing(kCapacityBytes, kRangeAlignment), mMappedData(nullptr), mMappedSize(0), mMappedStride(0), mMappedCount(0), mWrittenCount(0),
+		mFirstConstant(0)
+	{
+	}
+
+	/************************************************************************/
+	void ConstantRingBuffer::CreateDeviceDependentResources(ID3D11Device* device)
+	{
+		mBuffer.Reset();
+
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options = { 0 };
+		ThrowIfFailed(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)));
+		if (!options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer)
+		{
+			return;
+		}
+
+		CD3D11_BUFFER_DESC bufferDesc(kCapacityBytes, D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
+		ThrowIfFailed(device->CreateBuffer(&bufferDesc, nullptr, mBuffer.ReleaseAndGetAddressOf()));
+
+		// the contents of a new buffer are undefined, the first upload discards them
+		mRing.BeginFrame();
+	}
+
+	/************************************************************************/
+	void ConstantRingBuffer::ReleaseDeviceDependentResources()
+	{
+		mBuffer.Reset();
+	}
+
+	/************************************************************************/
+	void ConstantRingBuffer::BeginFrame()
+	{
+		mRing.BeginFrame();
+	}
+
+	/************************************************************************/
+	uint32_t ConstantRingBuffer::Map(ID3D11DeviceContext* context, uint32_t size, uint32_t count)
+	{
+		assert(mMappedData == nullptr);
+
+		// the ring aligns every range, rounding the size up stays inside the buffer
+		const uint32_t stride = (size + kRangeAlignment - 1) & ~(kRangeAlignment - 1);
+		if (mBuffer == nullptr || size == 0 || count == 0 || stride > kCapacityBytes)
+		{
+			return 0;
+		}
+
+		// as many as fit before the ring starts over, or as many as the whole buffer holds when it starts over now
+		uint32_t mappedCount = mRing.FreeBytes() / stride;
+		if (mappedCount == 0)
+		{
+			mappedCount = kCapacityBytes / stride;
+		}
+		mappedCount = count < mappedCount ? count : mappedCount;
+
+		UploadRingAllocation allocation;
+		mRing.Allocate(mappedCount * stride, allocation);
+
+		D3D11_MAPPED_SUBRESOURCE mappedBuffer;
+		ThrowIfFailed(context->Map(mBuffer.Get(), 0, allocation.IsDiscard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedBuffer));
+
+		mMappedData = static_cast<uint8_t*>(mappedBuffer.pData) + allocation.Offset;
+		mMappedSize = size;
+		mMappedStride = stride;
+		mMappedCount = mappedCount;
+		mWrittenCount = 0;
+		mFirstConstant = allocation.Offset / kConstantSize;
+		return mappedCount;
+	}
+
+	/************************************************************************/
+	void ConstantRingBuffer::Write(const void* data, ConstantBufferRange& range)
+	{
+		assert(mMappedData != nullptr && mWrittenCount < mMappedCount);
+
+		memcpy(mMappedData + mWrittenCount * mMappedStride, data, mMappedSize);
+
+		range.Buffer = mBuffer.Get();
+		range.FirstConstant = mFirstConstant + mWrittenCount * mMappedStride / kConstantSize;
+		range.ConstantCount = mMappedStride / kConstantSize;
+		++mWrittenCount;
+	}
+
+	/************************************************************************/
+	void ConstantRingBuffer::Unmap(ID3D11DeviceContext* context)
+	{
+		assert(mMappedData != nullptr);
+
+		context->Unmap(mBuffer.Get(), 0);
+		mMappedData = nullptr;
+	}
+
+	/************************************************************************/
+	bool ConstantRingBuffer::IsAvailable() const
+	{
+		return mBuffer != nullptr;
+	}
+
+	/************************************************************************/
+	const UploadRing& ConstantRingBuffer::Ring() const
+	{
+		return mRing;
+	}
+}
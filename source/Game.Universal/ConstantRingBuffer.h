@@ -0,0 +1,67 @@
+#pragma once
+
+#include "UploadRing.h"
+
+namespace DirectXGame
+{
+	/** Structure representing constant data uploaded to the ring buffer, the way VSSetConstantBuffers1 binds it.
+	*/
+	struct ConstantBufferRange
+	{
+		ID3D11Buffer* Buffer;
+		UINT FirstConstant; // in 16 byte constants, a multiple of 16
+		UINT ConstantCount; // a multiple of 16
+	};
+
+	/** Singleton owning one dynamic constant buffer that every sprite of a frame writes its constants to.
+	 * Map takes the ranges of as many uploads as fit before the ring starts over from an UploadRing, in one block, and
+	 * maps the buffer once for all of them, with NO_OVERWRITE, or with WRITE_DISCARD when the ring starts over, instead
+	 * of UpdateSubresource copying the data aside for the driver. Write copies the data of each upload to its range and
+	 * the draws bind their own range with a constant buffer offset once the buffer is unmapped. Offsets and NO_OVERWRITE
+	 * on constant buffers are optional before feature level 11.1: without them no buffer is created, Map takes nothing
+	 * and the caller falls back to a constant buffer of its own.
+	 *@see Renderable
+	*/
+	class ConstantRingBuffer final
+	{
+	public:
+
+		ConstantRingBuffer(const ConstantRingBuffer& rhs) = delete;
+		ConstantRingBuffer(const ConstantRingBuffer&& rhs) = delete;
+		ConstantRingBuffer& operator=(const ConstantRingBuffer& rhs) = delete;
+		ConstantRingBuffer& operator=(const ConstantRingBuffer&& rhs) = delete;
+
+		static ConstantRingBuffer& GetInstance();
+
+		void CreateDeviceDependentResources(ID3D11Device* device);
+		void ReleaseDeviceDependentResources();
+
+		void BeginFrame();
+		uint32_t Map(ID3D11DeviceContext* context, uint32_t size, uint32_t count);
+		void Write(const void* data, ConstantBufferRange& range);
+		void Unmap(ID3D11DeviceContext* context);
+
+		bool IsAvailable() const;
+		const UploadRing& Ring() const;
+
+		static const uint32_t kCapacityBytes;
+		static const uint32_t kConstantSize;
+		static const uint32_t kRangeAlignment;
+
+	private:
+
+		ConstantRingBuffer();
+		~ConstantRingBuffer() = default;
+
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mBuffer;
+		UploadRing mRing;
+
+		// mapped block
+		uint8_t* mMappedData;     // at the first range
+		uint32_t mMappedSize;     // of each upload
+		uint32_t mMappedStride;   // between ranges
+		uint32_t mMappedCount;
+		uint32_t mWrittenCount;
+		UINT mFirstConstant;
+	};
+}
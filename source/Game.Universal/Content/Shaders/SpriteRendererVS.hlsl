@@ -1,7 +1,7 @@
 cbuffer CBufferPerObject
 {
 	float4x4 WorldViewProjection;
-	float4x4 TextureTransform;
+	float4 UVRect; // top left corner in xy, size in zw
 }
 
 struct VS_INPUT
@@ -21,7 +21,7 @@ VS_OUTPUT main(VS_INPUT IN)
 	VS_OUTPUT OUT = (VS_OUTPUT)0;
 
 	OUT.Position = mul(IN.ObjectPosition, WorldViewProjection);
-	OUT.TextureCoordinates = mul(float4(IN.TextureCoordinates, 0, 1), TextureTransform).xy;
+	OUT.TextureCoordinates = UVRect.xy + IN.TextureCoordinates * UVRect.zw;
 
 	return OUT;
 }
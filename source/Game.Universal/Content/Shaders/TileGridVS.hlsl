@@ -0,0 +1,57 @@
+cbuffer CBufferPerFrame
+{
+	float4x4 ViewProjection;
+	float2 Origin;     // center of the tile (0, 0)
+	float2 TileStep;   // distance between the centers of neighboring tiles
+	float2 TileExtent; // half size of a tile quad
+	uint2 GridSize;    // tiles per row, rows per layer
+	uint2 FirstTile;   // of the visible tiles, the instances go over them layer after layer
+	uint2 VisibleSize;
+}
+
+Buffer<uint> TileSprites : register(t0);    // sprite index + 1 of every tile of every layer, 0 for none
+Buffer<float4> SpriteRects : register(t1);  // top left corner in xy, size in zw
+
+// the two triangles of the sprite quad, one instance per tile
+static const float2 Corners[6] =
+{
+	float2(-1, -1), float2(-1, 1), float2(1, 1),
+	float2(-1, -1), float2(1, 1), float2(1, -1)
+};
+
+static const float2 TextureCoordinates[6] =
+{
+	float2(0, 1), float2(0, 0), float2(1, 0),
+	float2(0, 1), float2(1, 0), float2(1, 1)
+};
+
+struct VS_OUTPUT
+{
+	float4 Position: SV_Position;
+	float2 TextureCoordinates : TEXCOORD;
+};
+
+VS_OUTPUT main(uint vertexId : SV_VertexID, uint instanceId : SV_InstanceID)
+{
+	VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+	uint layer = instanceId / (VisibleSize.x * VisibleSize.y);
+	uint tileInRange = instanceId % (VisibleSize.x * VisibleSize.y);
+	uint2 tileIndex = FirstTile + uint2(tileInRange % VisibleSize.x, tileInRange / VisibleSize.x);
+
+	// empty tiles collapse to a point and draw nothing
+	uint sprite = TileSprites[(layer * GridSize.y + tileIndex.y) * GridSize.x + tileIndex.x];
+	if (sprite == 0)
+	{
+		return OUT;
+	}
+
+	float2 tile = float2(tileIndex);
+	float2 position = Origin + tile * TileStep + Corners[vertexId] * TileExtent;
+	float4 spriteRect = SpriteRects[sprite - 1];
+
+	OUT.Position = mul(float4(position, 0, 1), ViewProjection);
+	OUT.TextureCoordinates = spriteRect.xy + TextureCoordinates[vertexId] * spriteRect.zw;
+
+	return OUT;
+}
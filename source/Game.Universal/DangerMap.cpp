@@ -0,0 +1,183 @@
+#include "pch.h"
+#include "DangerMap.h"
+#include <cfloat>
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	const double_t DangerMap::kNoDanger = DBL_MAX;
+
+	/************************************************************************/
+	DangerMap::DangerMap() :
+		mWidth(0), mHeight(0), mTime(0)
+	{
+	}
+
+	/************************************************************************/
+	void DangerMap::Initialize(const Map& map)
+	{
+		mWidth = map.MapWidth;
+		mHeight = map.MapHeight;
+		mDangerTimes.assign(mWidth * mHeight, kNoDanger);
+		mExplosionCounts.assign(mWidth * mHeight, 0);
+		mBlasts.clear();
+	}
+
+	/************************************************************************/
+	void DangerMap::SetTime(double_t time)
+	{
+		mTime = time;
+	}
+
+	/************************************************************************/
+	double_t DangerMap::Time() const
+	{
+		return mTime;
+	}
+
+	/************************************************************************/
+	void DangerMap::AddBomb(const void* bombKey, const Map& map, const XMUINT2& tile, uint32_t range, double_t detonationTime)
+	{
+		BombBlast blast;
+		blast.Key = bombKey;
+		blast.Tile = tile;
+		blast.Range = range;
+		blast.DetonationTime = detonationTime;
+
+		ComputeFootprint(map, blast);
+		ApplyBlast(blast);
+		mBlasts.push_back(move(blast));
+	}
+
+	/************************************************************************/
+	void DangerMap::UpdateBombRange(const void* bombKey, const Map& map, uint32_t range)
+	{
+		for (auto& blast : mBlasts)
+		{
+			if (blast.Key == bombKey && blast.Range != range)
+			{
+				blast.Range = range;
+				RefreshBlasts(map);
+				return;
+			}
+		}
+	}
+
+	/************************************************************************/
+	bool DangerMap::RemoveBomb(const void* bombKey)
+	{
+		for (auto it = mBlasts.begin(); it != mBlasts.end(); ++it)
+		{
+			if (it->Key == bombKey)
+			{
+				ClearBlast(*it);
+				mBlasts.erase(it);
+
+				// the other bombs covering the cleared tiles set them again
+				for (auto& blast : mBlasts)
+				{
+					ApplyBlast(blast);
+				}
+
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/************************************************************************/
+	void DangerMap::RefreshBlasts(const Map& map)
+	{
+		// a destroyed block lets the flames go further, this only happens when a bomb explodes so all blasts are computed again
+		for (auto& blast : mBlasts)
+		{
+			ClearBlast(blast);
+		}
+
+		for (auto& blast : mBlasts)
+		{
+			ComputeFootprint(map, blast);
+			ApplyBlast(blast);
+		}
+	}
+
+	/************************************************************************/
+	void DangerMap::AddExplosion(const XMUINT2& tile)
+	{
+		if (tile.x < mWidth && tile.y < mHeight)
+		{
+			++mExplosionCounts[tile.y * mWidth + tile.x];
+		}
+	}
+
+	/************************************************************************/
+	void DangerMap::RemoveExplosion(const XMUINT2& tile)
+	{
+		if (tile.x < mWidth && tile.y < mHeight && mExplosionCounts[tile.y * mWidth + tile.x] > 0)
+		{
+			--mExplosionCounts[tile.y * mWidth + tile.x];
+		}
+	}
+
+	/************************************************************************/
+	double_t DangerMap::GetDangerTime(const XMUINT2& tile) const
+	{
+		if (tile.x >= mWidth || tile.y >= mHeight)
+		{
+			return kNoDanger;
+		}
+
+		uint32_t index = tile.y * mWidth + tile.x;
+		return mExplosionCounts[index] > 0 ? mTime : mDangerTimes[index];
+	}
+
+	/************************************************************************/
+	double_t DangerMap::GetTimeToDanger(const XMUINT2& tile) const
+	{
+		double_t dangerTime = GetDangerTime(tile);
+		if (dangerTime == kNoDanger)
+		{
+			return kNoDanger;
+		}
+
+		return dangerTime > mTime ? dangerTime - mTime : 0;
+	}
+
+	/************************************************************************/
+	bool DangerMap::IsSafe(const XMUINT2& tile, double_t seconds) const
+	{
+		return GetTimeToDanger(tile) > seconds;
+	}
+
+	/************************************************************************/
+	void DangerMap::ComputeFootprint(const Map& map, BombBlast& blast)
+	{
+		BlastPropagation::GetInstance().Propagate(map, blast.Tile, blast.Range, mFlames, mDestroyedBlocks);
+
+		blast.Footprint.clear();
+		for (auto& flame : mFlames)
+		{
+			blast.Footprint.push_back(flame.Tile.y * mWidth + flame.Tile.x);
+		}
+	}
+
+	/************************************************************************/
+	void DangerMap::ApplyBlast(const BombBlast& blast)
+	{
+		for (auto index : blast.Footprint)
+		{
+			mDangerTimes[index] = min(mDangerTimes[index], blast.DetonationTime);
+		}
+	}
+
+	/************************************************************************/
+	void DangerMap::ClearBlast(const BombBlast& blast)
+	{
+		for (auto index : blast.Footprint)
+		{
+			mDangerTimes[index] = kNoDanger;
+		}
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "BlastPropagation.h"
+
+namespace DirectXGame
+{
+	/** Class holding, for every tile of the map, the earliest time a flame will cover it.
+	 * It is updated when bombs are placed or explode and when blocks are destroyed, never per query,
+	 * so enemies and bots can read it in constant time as often as they need.
+	 * Times are absolute level times, in seconds, tiles covered by a live explosion are in danger right now.
+	 *@see BlastPropagation
+	*/
+	class DangerMap final
+	{
+	public:
+
+		DangerMap();
+
+		void Initialize(const Map& map);
+		void SetTime(double_t time);
+		double_t Time() const;
+
+		void AddBomb(const void* bombKey, const Map& map, const DirectX::XMUINT2& tile, uint32_t range, double_t detonationTime);
+		void UpdateBombRange(const void* bombKey, const Map& map, uint32_t range);
+		bool RemoveBomb(const void* bombKey);
+		void RefreshBlasts(const Map& map);
+
+		void AddExplosion(const DirectX::XMUINT2& tile);
+		void RemoveExplosion(const DirectX::XMUINT2& tile);
+
+		double_t GetDangerTime(const DirectX::XMUINT2& tile) const;
+		double_t GetTimeToDanger(const DirectX::XMUINT2& tile) const;
+		bool IsSafe(const DirectX::XMUINT2& tile, double_t seconds) const;
+
+		static const double_t kNoDanger;
+
+	private:
+
+		/** Structure representing the tiles a ticking bomb will cover when it explodes.
+		*/
+		struct BombBlast
+		{
+			const void* Key;
+			DirectX::XMUINT2 Tile;
+			uint32_t Range;
+			double_t DetonationTime;
+			std::vector<uint32_t> Footprint;
+		};
+
+		void ComputeFootprint(const Map& map, BombBlast& blast);
+		void ApplyBlast(const BombBlast& blast);
+		void ClearBlast(const BombBlast& blast);
+
+		uint32_t mWidth;
+		uint32_t mHeight;
+		double_t mTime;
+		std::vector<double_t> mDangerTimes;
+		std::vector<uint8_t> mExplosionCounts;
+		std::vector<BombBlast> mBlasts;
+
+		// propagation scratch
+		std::vector<BlastTile> mFlames;
+		std::vector<DirectX::XMUINT2> mDestroyedBlocks;
+	};
+}
@@ -0,0 +1,65 @@
+#include "pch.h"
+#include "EnemyBenchmark.h"
+#include "LevelGenerator.h"
+#include "MapParser.h"
+#include <chrono>
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	const double_t EnemyBenchmark::kTickSeconds = 1.0 / 60;
+	const float_t EnemyBenchmark::kCollisionDistance = 0.6f;
+
+	/************************************************************************/
+	EnemyBenchmark& EnemyBenchmark::GetInstance()
+	{
+		static EnemyBenchmark sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	EnemyBenchmarkReport EnemyBenchmark::Run(const EnemyBenchmarkOptions& options)
+	{
+		EnemyBenchmarkReport report = {};
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+
+		NavigationGrid grid;
+		chrono::duration<double_t> elapsed(0);
+
+		for (uint32_t level = 0; level < options.LevelCount; ++level)
+		{
+			default_random_engine generator(options.FirstSeed + level);
+			Map map = LevelGenerator::GetInstance().GenerateLevel(basicMap, generator);
+			grid.Initialize(map);
+
+			EnemySimulation simulation(options.FirstSeed + level);
+			simulation.SpawnRandom(grid, options.EnemyCount, map.PlayerSpawnTiles, 0);
+
+			// the probe stands where the player spawns
+			const XMFLOAT2 probe(static_cast<float_t>(map.PlayerSpawnTile.x), static_cast<float_t>(map.PlayerSpawnTile.y));
+
+			for (uint32_t tick = 0; tick < options.TicksPerLevel; ++tick)
+			{
+				auto tickStart = chrono::high_resolution_clock::now();
+
+				report.EnemyUpdateCount += simulation.Count();
+				simulation.Update(kTickSeconds, grid);
+				simulation.Overlaps(probe, kCollisionDistance);
+				++report.CollisionQueryCount;
+
+				chrono::duration<double_t> tickDuration = chrono::high_resolution_clock::now() - tickStart;
+				elapsed += tickDuration;
+				report.WorstTickMilliseconds = max(report.WorstTickMilliseconds, tickDuration.count() * 1000);
+				++report.TickCount;
+			}
+		}
+
+		report.ElapsedSeconds = elapsed.count();
+		report.EnemyUpdatesPerSecond = report.ElapsedSeconds > 0 ? report.EnemyUpdateCount / report.ElapsedSeconds : 0;
+		report.MillisecondsPerTick = report.TickCount > 0 ? report.ElapsedSeconds * 1000 / report.TickCount : 0;
+
+		return report;
+	}
+}
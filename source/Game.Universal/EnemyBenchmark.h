@@ -0,0 +1,61 @@
+#pragma once
+
+#include "EnemySimulation.h"
+
+namespace DirectXGame
+{
+	/** Structure holding the options of an enemy benchmark run.
+	*/
+	struct EnemyBenchmarkOptions
+	{
+		EnemyBenchmarkOptions() :
+			FirstSeed(0), LevelCount(10), EnemyCount(1000), TicksPerLevel(600)
+		{
+		}
+
+		uint32_t FirstSeed;
+		uint32_t LevelCount;
+		uint32_t EnemyCount;
+		uint32_t TicksPerLevel;
+	};
+
+	/** Structure holding the numbers of an enemy benchmark run.
+	*/
+	struct EnemyBenchmarkReport
+	{
+		uint64_t TickCount;
+		uint64_t EnemyUpdateCount;
+		uint64_t CollisionQueryCount;
+		std::double_t ElapsedSeconds;
+		std::double_t EnemyUpdatesPerSecond;
+		std::double_t MillisecondsPerTick;
+		std::double_t WorstTickMilliseconds;
+	};
+
+	/** Singleton that measures the enemy simulation with far more enemies than a level ever has.
+	 * Every generated level is filled with enemies and played for a number of ticks at 60 ticks per second,
+	 * each tick also runs a player collision query against the enemies.
+	 *@see EnemySimulation
+	*/
+	class EnemyBenchmark final
+	{
+	public:
+
+		EnemyBenchmark(const EnemyBenchmark& rhs) = delete;
+		EnemyBenchmark(const EnemyBenchmark&& rhs) = delete;
+		EnemyBenchmark& operator=(const EnemyBenchmark& rhs) = delete;
+		EnemyBenchmark& operator=(const EnemyBenchmark&& rhs) = delete;
+
+		static EnemyBenchmark& GetInstance();
+
+		EnemyBenchmarkReport Run(const EnemyBenchmarkOptions& options);
+
+	private:
+
+		EnemyBenchmark() = default;
+		~EnemyBenchmark() = default;
+
+		static const std::double_t kTickSeconds;
+		static const std::float_t kCollisionDistance;
+	};
+}
@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "EnemyManager.h"
+#include "SpriteSheetParser.h"
+#include "LevelManager.h"
+#include "MapRenderable.h"
+#include "MathHelper.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace DX;
+
+namespace DirectXGame
+{
+	// rendering
+	const string EnemyManager::kJSONFilePath = "Assets/JSONS/Atlas/Barom.json";
+	const wstring EnemyManager::kTextureMapPath = L"Assets/SpriteSheets/Atlas.png";
+
+	// animation
+	const double_t EnemyManager::kWalkingAnimationLength = 0.2;
+	const string EnemyManager::kDeathAnimationName = "Death";
+	const string EnemyManager::kWalkingLeftAnimationName = "WalkingLeft";
+	const string EnemyManager::kWalkingRightAnimationName = "WalkingRight";
+
+	// collision
+	const uint32_t EnemyManager::kMinSpawnDistance = 4;    // in tiles, so the players are not killed right away
+	const float_t EnemyManager::kCollisionDistance = 0.6f; // in tiles, on both axes
+
+	/************************************************************************/
+	EnemyManager::EnemyManager(const shared_ptr<DX::DeviceResources>& deviceResources, const shared_ptr<Camera>& camera, MapRenderable& map,
+							   uint32_t enemyCount, const string& jsonPath, const wstring& textureMapPath) :
+		Renderable(deviceResources, camera, jsonPath, textureMapPath),
+		mMap(map),
+		mSimulation(static_cast<uint32_t>(MathHelper::GetInstance().GetGenerator()()))
+	{
+		mSimulation.SpawnRandom(LevelManager::GetInstance().GetNavigationGrid(), enemyCount, mMap.GetMap().PlayerSpawnTiles, kMinSpawnDistance);
+	}
+
+	/************************************************************************/
+	void EnemyManager::Update(const StepTimer& timer)
+	{
+		Renderable::Update(timer);
+
+		mSimulation.Update(timer.GetElapsedSeconds(), LevelManager::GetInstance().GetNavigationGrid());
+	}
+
+	/************************************************************************/
+	void EnemyManager::Render(const StepTimer& timer)
+	{
+		// Loading is asynchronous. Only draw geometry after it's loaded.
+		if (!mLoadingComplete)
+		{
+			return;
+		}
+
+		Renderable::Render(timer);
+
+		const MapLayout& mapLayout = LevelManager::GetInstance().GetMapLayout();
+		const auto& coordinates = mSimulation.Coordinates();
+		for (uint32_t i = 0; i < mSimulation.Count(); ++i)
+		{
+			XMFLOAT2 position = mapLayout.GetPositionFromTileCoordinates(coordinates[i]);
+			Transform2D transform(position, 0, SpriteScale);
+
+			DrawSprite(GetSprite(i), transform);
+		}
+	}
+
+	/************************************************************************/
+	bool EnemyManager::CollidesWithPlayer(const XMFLOAT2& playerPosition) const
+	{
+		return mSimulation.Overlaps(GetTileCoordinatesFromPosition(playerPosition), kCollisionDistance);
+	}
+
+	/************************************************************************/
+	const EnemySimulation& EnemyManager::GetSimulation() const
+	{
+		return mSimulation;
+	}
+
+	/************************************************************************/
+	void EnemyManager::InitializeSprites()
+	{
+		mRenderableSpriteSheet = SpriteSheetParser::GetInstance().ParseSpriteSheet(kJSONFilePath);
+
+		// the death animation is played once over the dying time of the simulation
+		mDeathAnimation = mRenderableSpriteSheet.Animations[kDeathAnimationName];
+		mDeathAnimation->AnimationLength = EnemySimulation::kDyingTime / mDeathAnimation->Sprites.size();
+		mWalkingLeftAnimation = mRenderableSpriteSheet.Animations[kWalkingLeftAnimationName];
+		mWalkingLeftAnimation->AnimationLength = kWalkingAnimationLength;
+		mWalkingRightAnimation = mRenderableSpriteSheet.Animations[kWalkingRightAnimationName];
+		mWalkingRightAnimation->AnimationLength = kWalkingAnimationLength;
+	}
+
+	/************************************************************************/
+	const Sprite& EnemyManager::GetSprite(uint32_t enemy) const
+	{
+		// enemies share their animations, the frame comes from each enemy own timer
+		const bool isDying = mSimulation.States()[enemy] != EnemyState::Walking;
+		const Animation& animation = isDying ? *mDeathAnimation :
+			mSimulation.Facings()[enemy] == EnemyDirection::Left ? *mWalkingLeftAnimation : *mWalkingRightAnimation;
+
+		const uint32_t spriteCount = static_cast<uint32_t>(animation.Sprites.size());
+		uint32_t frame = static_cast<uint32_t>(mSimulation.AnimationTimers()[enemy] / animation.AnimationLength);
+		frame = isDying ? min(frame, spriteCount - 1) : frame % spriteCount;
+
+		return *animation.Sprites[frame];
+	}
+
+	/************************************************************************/
+	XMFLOAT2 EnemyManager::GetTileCoordinatesFromPosition(const XMFLOAT2& position)
+	{
+		return LevelManager::GetInstance().GetMapLayout().GetTileCoordinatesFromPosition(position);
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Renderable.h"
+#include "EnemySimulation.h"
+
+namespace DirectXGame
+{
+	class MapRenderable;
+
+	/** Class rendering and updating all the enemies of a level.
+	 * The enemies themselves live in an EnemySimulation, this component only feeds it the navigation grid every frame,
+	 * and draws every enemy with the same sprite sheet, binding the pipeline once for all of them.
+	 *@see EnemySimulation
+	*/
+	class EnemyManager final : public Renderable
+	{
+	public:
+
+		EnemyManager(const std::shared_ptr<DX::DeviceResources>& deviceResources, const std::shared_ptr<DX::Camera>& camera, MapRenderable& map,
+					 uint32_t enemyCount, const std::string& jsonPath = kJSONFilePath, const std::wstring& textureMapPath = kTextureMapPath);
+
+		virtual void Update(const DX::StepTimer& timer) override;
+		virtual void Render(const DX::StepTimer& timer) override;
+
+		bool CollidesWithPlayer(const DirectX::XMFLOAT2& playerPosition) const;
+		const EnemySimulation& GetSimulation() const;
+
+	protected:
+
+		virtual void InitializeSprites() override;
+
+	private:
+
+		const Sprite& GetSprite(uint32_t enemy) const;
+
+		static DirectX::XMFLOAT2 GetTileCoordinatesFromPosition(const DirectX::XMFLOAT2& position);
+
+		MapRenderable& mMap;
+		EnemySimulation mSimulation;
+
+		// rendering
+		static const std::string kJSONFilePath;
+		static const std::wstring kTextureMapPath;
+
+		// animation
+		std::shared_ptr<Animation> mDeathAnimation;
+		std::shared_ptr<Animation> mWalkingLeftAnimation;
+		std::shared_ptr<Animation> mWalkingRightAnimation;
+
+		static const double_t kWalkingAnimationLength;
+		static const std::string kDeathAnimationName;
+		static const std::string kWalkingLeftAnimationName;
+		static const std::string kWalkingRightAnimationName;
+
+		// collision
+		static const uint32_t kMinSpawnDistance;
+		static const float_t kCollisionDistance;
+	};
+}
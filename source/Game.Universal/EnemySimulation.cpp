@@ -0,0 +1,474 @@
+#include "pch.h"
+#include "EnemySimulation.h"
+#include "Profiler.h"
+#include <algorithm>
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	const float_t EnemySimulation::kSpeed = 1.f;      // tiles per second
+	const float_t EnemySimulation::kDyingTime = 0.6f; // seconds
+	const uint32_t EnemySimulation::kTurnChance = 4;  // one chance out of 4 to turn at a crossing
+
+	/************************************************************************/
+	EnemySimulation::EnemySimulation(uint32_t seed) :
+		mBucketWidth(0), mBucketHeight(0), mRandomState(seed != 0 ? seed : 1)
+	{
+	}
+
+	/************************************************************************/
+	void EnemySimulation::Clear()
+	{
+		mCoordinates.clear();
+		mTargets.clear();
+		mDirections.clear();
+		mFacings.clear();
+		mStates.clear();
+		mAnimationTimers.clear();
+		mBucketStarts.clear();
+		mBucketEnemies.clear();
+		mBucketWidth = 0;
+		mBucketHeight = 0;
+	}
+
+	/************************************************************************/
+	void EnemySimulation::Spawn(const XMUINT2& tile)
+	{
+		mCoordinates.push_back(XMFLOAT2(static_cast<float_t>(tile.x), static_cast<float_t>(tile.y)));
+		mTargets.push_back(tile);
+		mDirections.push_back(EnemyDirection::None);
+		mFacings.push_back(EnemyDirection::Left);
+		mStates.push_back(EnemyState::Walking);
+		mAnimationTimers.push_back(0);
+	}
+
+	/************************************************************************/
+	uint32_t EnemySimulation::SpawnRandom(const NavigationGrid& grid, uint32_t count, const vector<XMUINT2>& avoidedTiles, uint32_t minDistance)
+	{
+		vector<XMUINT2> candidates;
+		for (uint32_t index = 0; index < grid.CellCount(); ++index)
+		{
+			if (grid.GetCell(index) != static_cast<uint8_t>(NavigationCellFlags::None))
+			{
+				continue;
+			}
+
+			const XMUINT2& tile = grid.GetTile(index);
+			bool isFarEnough = true;
+			for (auto& avoidedTile : avoidedTiles)
+			{
+				uint32_t distance = (tile.x > avoidedTile.x ? tile.x - avoidedTile.x : avoidedTile.x - tile.x) +
+					(tile.y > avoidedTile.y ? tile.y - avoidedTile.y : avoidedTile.y - tile.y);
+				isFarEnough = isFarEnough && distance >= minDistance;
+			}
+
+			if (isFarEnough)
+			{
+				candidates.push_back(tile);
+			}
+		}
+
+		if (candidates.empty())
+		{
+			return 0;
+		}
+
+		// when there are more enemies than free tiles, some of them share a tile
+		for (uint32_t i = static_cast<uint32_t>(candidates.size()) - 1; i > 0; --i)
+		{
+			swap(candidates[i], candidates[GetRandom(i + 1)]);
+		}
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			Spawn(candidates[i % candidates.size()]);
+		}
+
+		return count;
+	}
+
+	/************************************************************************/
+	void EnemySimulation::Update(double_t elapsedSeconds, const NavigationGrid& grid)
+	{
+		ProfileScope scope("EnemySimulation::Update");
+
+		const float_t seconds = static_cast<float_t>(elapsedSeconds);
+
+		DecisionPass(grid);
+		MovementPass(seconds);
+		ExplosionPass(grid);
+		AnimationPass(seconds);
+		RemoveDead();
+		BucketPass(grid);
+	}
+
+	/************************************************************************/
+	uint32_t EnemySimulation::Count() const
+	{
+		return static_cast<uint32_t>(mCoordinates.size());
+	}
+
+	/************************************************************************/
+	bool EnemySimulation::Overlaps(const XMFLOAT2& coordinates, float_t distance) const
+	{
+		if (mBucketWidth == 0 || coordinates.x < -0.5f || coordinates.y < -0.5f)
+		{
+			return false;
+		}
+
+		// an enemy closer than a tile is either on the same tile or on one of the 8 around it
+		XMUINT2 tile = GetTile(coordinates);
+		for (uint32_t y = tile.y - 1; y != tile.y + 2; ++y)
+		{
+			for (uint32_t x = tile.x - 1; x != tile.x + 2; ++x)
+			{
+				if (x >= mBucketWidth || y >= mBucketHeight)
+				{
+					continue;
+				}
+
+				uint32_t bucket = y * mBucketWidth + x;
+				for (uint32_t i = mBucketStarts[bucket]; i < mBucketStarts[bucket + 1]; ++i)
+				{
+					const XMFLOAT2& enemy = mCoordinates[mBucketEnemies[i]];
+					if (abs(enemy.x - coordinates.x) < distance && abs(enemy.y - coordinates.y) < distance)
+					{
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/************************************************************************/
+	void EnemySimulation::AddToHash(StateHash& hash) const
+	{
+		hash.Add(mCoordinates);
+		hash.Add(mTargets);
+		hash.Add(mDirections);
+		hash.Add(mFacings);
+		hash.Add(mStates);
+		hash.Add(mAnimationTimers);
+		hash.Add(mRandomState);
+	}
+
+	/************************************************************************/
+	void EnemySimulation::Save(SnapshotWriter& writer) const
+	{
+		writer.Write(mCoordinates);
+		writer.Write(mTargets);
+		writer.Write(mDirections);
+		writer.Write(mFacings);
+		writer.Write(mStates);
+		writer.Write(mAnimationTimers);
+		writer.Write(mRandomState);
+	}
+
+	/************************************************************************/
+	void EnemySimulation::Restore(SnapshotReader& reader, const NavigationGrid& grid)
+	{
+		reader.Read(mCoordinates);
+		reader.Read(mTargets);
+		reader.Read(mDirections);
+		reader.Read(mFacings);
+		reader.Read(mStates);
+		reader.Read(mAnimationTimers);
+		reader.Read(mRandomState);
+
+		const size_t count = mCoordinates.size();
+		if (mTargets.size() != count || mDirections.size() != count || mFacings.size() != count ||
+			mStates.size() != count || mAnimationTimers.size() != count)
+		{
+			throw runtime_error("snapshot enemy arrays do not match");
+		}
+
+		// the buckets are derived from the positions
+		BucketPass(grid);
+	}
+
+	/************************************************************************/
+	const vector<XMFLOAT2>& EnemySimulation::Coordinates() const
+	{
+		return mCoordinates;
+	}
+
+	/************************************************************************/
+	const vector<EnemyState>& EnemySimulation::States() const
+	{
+		return mStates;
+	}
+
+	/************************************************************************/
+	const vector<EnemyDirection>& EnemySimulation::Facings() const
+	{
+		return mFacings;
+	}
+
+	/************************************************************************/
+	const vector<float_t>& EnemySimulation::AnimationTimers() const
+	{
+		return mAnimationTimers;
+	}
+
+	/************************************************************************/
+	void EnemySimulation::DecisionPass(const NavigationGrid& grid)
+	{
+		const uint32_t count = Count();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (mStates[i] != EnemyState::Walking)
+			{
+				continue;
+			}
+
+			const XMUINT2 target = mTargets[i];
+			bool isOnTarget = mCoordinates[i].x == static_cast<float_t>(target.x) && mCoordinates[i].y == static_cast<float_t>(target.y);
+
+			if (isOnTarget)
+			{
+				mDirections[i] = ChooseDirection(grid, target, mDirections[i]);
+				if (mDirections[i] != EnemyDirection::None)
+				{
+					mTargets[i] = Step(target, mDirections[i]);
+				}
+			}
+			else if (!IsWalkable(grid, target))
+			{
+				// something was dropped in the way, go back to the previous tile
+				mDirections[i] = Reverse(mDirections[i]);
+				mTargets[i] = Step(target, mDirections[i]);
+			}
+
+			if (mDirections[i] == EnemyDirection::Left || mDirections[i] == EnemyDirection::Right)
+			{
+				mFacings[i] = mDirections[i];
+			}
+		}
+	}
+
+	/************************************************************************/
+	void EnemySimulation::MovementPass(float_t elapsedSeconds)
+	{
+		const float_t distance = kSpeed * elapsedSeconds;
+		const uint32_t count = Count();
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (mStates[i] != EnemyState::Walking)
+			{
+				continue;
+			}
+
+			XMFLOAT2& coordinates = mCoordinates[i];
+			const float_t dx = static_cast<float_t>(mTargets[i].x) - coordinates.x;
+			const float_t dy = static_cast<float_t>(mTargets[i].y) - coordinates.y;
+
+			// enemies only move on one axis at a time, and stop exactly on the target
+			coordinates.x = abs(dx) <= distance ? static_cast<float_t>(mTargets[i].x) : coordinates.x + (dx > 0 ? distance : -distance);
+			coordinates.y = abs(dy) <= distance ? static_cast<float_t>(mTargets[i].y) : coordinates.y + (dy > 0 ? distance : -distance);
+		}
+	}
+
+	/************************************************************************/
+	void EnemySimulation::ExplosionPass(const NavigationGrid& grid)
+	{
+		const uint32_t count = Count();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (mStates[i] != EnemyState::Walking)
+			{
+				continue;
+			}
+
+			XMUINT2 tile = GetTile(mCoordinates[i]);
+			if (grid.IsInside(tile) && grid.HasFlag(grid.GetIndex(tile), NavigationCellFlags::Explosion))
+			{
+				mStates[i] = EnemyState::Dying;
+				mAnimationTimers[i] = 0;
+			}
+		}
+	}
+
+	/************************************************************************/
+	void EnemySimulation::AnimationPass(float_t elapsedSeconds)
+	{
+		const uint32_t count = Count();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			mAnimationTimers[i] += elapsedSeconds;
+			if (mStates[i] == EnemyState::Dying && mAnimationTimers[i] >= kDyingTime)
+			{
+				mStates[i] = EnemyState::Dead;
+			}
+		}
+	}
+
+	/************************************************************************/
+	void EnemySimulation::RemoveDead()
+	{
+		uint32_t i = 0;
+		while (i < Count())
+		{
+			if (mStates[i] == EnemyState::Dead)
+			{
+				RemoveAt(i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	/************************************************************************/
+	void EnemySimulation::BucketPass(const NavigationGrid& grid)
+	{
+		mBucketWidth = grid.Width();
+		mBucketHeight = grid.Height();
+		mBucketStarts.assign(grid.CellCount() + 1, 0);
+		mBucketEnemies.resize(Count());
+
+		// counting sort of the walking enemies by tile
+		uint32_t bucketedCount = 0;
+		for (uint32_t i = 0; i < Count(); ++i)
+		{
+			XMUINT2 tile = GetTile(mCoordinates[i]);
+			if (mStates[i] == EnemyState::Walking && grid.IsInside(tile))
+			{
+				++mBucketStarts[grid.GetIndex(tile)];
+				++bucketedCount;
+			}
+		}
+
+		for (uint32_t bucket = 1; bucket < grid.CellCount(); ++bucket)
+		{
+			mBucketStarts[bucket] += mBucketStarts[bucket - 1];
+		}
+		mBucketStarts[grid.CellCount()] = bucketedCount;
+
+		for (uint32_t i = 0; i < Count(); ++i)
+		{
+			XMUINT2 tile = GetTile(mCoordinates[i]);
+			if (mStates[i] == EnemyState::Walking && grid.IsInside(tile))
+			{
+				mBucketEnemies[--mBucketStarts[grid.GetIndex(tile)]] = i;
+			}
+		}
+	}
+
+	/************************************************************************/
+	EnemyDirection EnemySimulation::ChooseDirection(const NavigationGrid& grid, const XMUINT2& tile, EnemyDirection current)
+	{
+		bool canGoOn = current != EnemyDirection::None && IsWalkable(grid, Step(tile, current));
+		if (canGoOn && GetRandom(kTurnChance) != 0)
+		{
+			return current;
+		}
+
+		// any free direction but going back, unless it is a dead end
+		EnemyDirection options[4];
+		uint32_t optionCount = 0;
+		for (uint8_t d = 0; d < 4; ++d)
+		{
+			EnemyDirection direction = static_cast<EnemyDirection>(d);
+			if (direction != Reverse(current) && IsWalkable(grid, Step(tile, direction)))
+			{
+				options[optionCount++] = direction;
+			}
+		}
+
+		if (optionCount == 0)
+		{
+			return current != EnemyDirection::None && IsWalkable(grid, Step(tile, Reverse(current))) ? Reverse(current) : EnemyDirection::None;
+		}
+
+		return options[GetRandom(optionCount)];
+	}
+
+	/************************************************************************/
+	uint32_t EnemySimulation::GetRandom(uint32_t count)
+	{
+		// xorshift, the same sequence on every platform, unlike the standard distributions
+		mRandomState ^= mRandomState << 13;
+		mRandomState ^= mRandomState >> 17;
+		mRandomState ^= mRandomState << 5;
+
+		return mRandomState % count;
+	}
+
+	/************************************************************************/
+	bool EnemySimulation::IsWalkable(const NavigationGrid& grid, const XMUINT2& tile) const
+	{
+		static const uint8_t kBlockingFlags = static_cast<uint8_t>(NavigationCellFlags::SolidBlock) |
+			static_cast<uint8_t>(NavigationCellFlags::SoftBlock) | static_cast<uint8_t>(NavigationCellFlags::Bomb);
+
+		return grid.IsInside(tile) && (grid.GetCell(grid.GetIndex(tile)) & kBlockingFlags) == 0;
+	}
+
+	/************************************************************************/
+	void EnemySimulation::RemoveAt(uint32_t index)
+	{
+		// swap with the last enemy, the order of the enemies does not matter
+		uint32_t last = Count() - 1;
+		mCoordinates[index] = mCoordinates[last];
+		mTargets[index] = mTargets[last];
+		mDirections[index] = mDirections[last];
+		mFacings[index] = mFacings[last];
+		mStates[index] = mStates[last];
+		mAnimationTimers[index] = mAnimationTimers[last];
+
+		mCoordinates.pop_back();
+		mTargets.pop_back();
+		mDirections.pop_back();
+		mFacings.pop_back();
+		mStates.pop_back();
+		mAnimationTimers.pop_back();
+	}
+
+	/************************************************************************/
+	XMUINT2 EnemySimulation::Step(const XMUINT2& tile, EnemyDirection direction)
+	{
+		switch (direction)
+		{
+			case DirectXGame::EnemyDirection::Left:
+				return XMUINT2(tile.x - 1, tile.y);
+			case DirectXGame::EnemyDirection::Right:
+				return XMUINT2(tile.x + 1, tile.y);
+			case DirectXGame::EnemyDirection::Down:
+				return XMUINT2(tile.x, tile.y - 1);
+			case DirectXGame::EnemyDirection::Up:
+				return XMUINT2(tile.x, tile.y + 1);
+			case DirectXGame::EnemyDirection::None:
+			default:
+				return tile;
+		}
+	}
+
+	/************************************************************************/
+	EnemyDirection EnemySimulation::Reverse(EnemyDirection direction)
+	{
+		switch (direction)
+		{
+			case DirectXGame::EnemyDirection::Left:
+				return EnemyDirection::Right;
+			case DirectXGame::EnemyDirection::Right:
+				return EnemyDirection::Left;
+			case DirectXGame::EnemyDirection::Down:
+				return EnemyDirection::Up;
+			case DirectXGame::EnemyDirection::Up:
+				return EnemyDirection::Down;
+			case DirectXGame::EnemyDirection::None:
+			default:
+				return EnemyDirection::None;
+		}
+	}
+
+	/************************************************************************/
+	XMUINT2 EnemySimulation::GetTile(const XMFLOAT2& coordinates)
+	{
+		return XMUINT2(static_cast<uint32_t>(coordinates.x + 0.5f), static_cast<uint32_t>(coordinates.y + 0.5f));
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "NavigationGrid.h"
+#include "StateHash.h"
+#include "SnapshotStream.h"
+
+namespace DirectXGame
+{
+	/** Enumeration representing the states of an enemy.
+	*@see EnemySimulation
+	*/
+	enum class EnemyState : uint8_t
+	{
+		Walking,
+		Dying,
+		Dead
+	};
+
+	/** Enumeration representing the direction an enemy is walking to.
+	*@see EnemySimulation
+	*/
+	enum class EnemyDirection : uint8_t
+	{
+		Left,
+		Right,
+		Down,
+		Up,
+		None
+	};
+
+	/** Class simulating all the enemies of a level, stored as a structure of arrays.
+	 * Enemies walk from tile center to tile center, and only take a decision when they reach one.
+	 * Every update runs the same batched passes over the arrays: decisions against the navigation grid, movement,
+	 * explosions, animation timers, removal of the dead ones, then a per tile bucketing used by the collision queries.
+	 * Positions are in tile coordinates, an enemy standing on the center of the tile (x, y) is at (x, y).
+	 * It does not render anything, so it can run headless, and it owns its random generator: given the same seed and the same grids,
+	 * two simulations stay identical.
+	 *@see EnemyManager
+	*/
+	class EnemySimulation final
+	{
+	public:
+
+		explicit EnemySimulation(uint32_t seed = 0);
+
+		void Clear();
+		void Spawn(const DirectX::XMUINT2& tile);
+		uint32_t SpawnRandom(const NavigationGrid& grid, uint32_t count, const std::vector<DirectX::XMUINT2>& avoidedTiles, uint32_t minDistance);
+		void Update(std::double_t elapsedSeconds, const NavigationGrid& grid);
+
+		uint32_t Count() const;
+		bool Overlaps(const DirectX::XMFLOAT2& coordinates, std::float_t distance) const;
+		void AddToHash(StateHash& hash) const;
+		void Save(SnapshotWriter& writer) const;
+		void Restore(SnapshotReader& reader, const NavigationGrid& grid);
+
+		const std::vector<DirectX::XMFLOAT2>& Coordinates() const;
+		const std::vector<EnemyState>& States() const;
+		const std::vector<EnemyDirection>& Facings() const;
+		const std::vector<std::float_t>& AnimationTimers() const;
+
+		static const std::float_t kSpeed;
+		static const std::float_t kDyingTime;
+
+	private:
+
+		void DecisionPass(const NavigationGrid& grid);
+		void MovementPass(std::float_t elapsedSeconds);
+		void ExplosionPass(const NavigationGrid& grid);
+		void AnimationPass(std::float_t elapsedSeconds);
+		void RemoveDead();
+		void BucketPass(const NavigationGrid& grid);
+
+		EnemyDirection ChooseDirection(const NavigationGrid& grid, const DirectX::XMUINT2& tile, EnemyDirection current);
+		uint32_t GetRandom(uint32_t count);
+		bool IsWalkable(const NavigationGrid& grid, const DirectX::XMUINT2& tile) const;
+		void RemoveAt(uint32_t index);
+
+		static DirectX::XMUINT2 Step(const DirectX::XMUINT2& tile, EnemyDirection direction);
+		static EnemyDirection Reverse(EnemyDirection direction);
+		static DirectX::XMUINT2 GetTile(const DirectX::XMFLOAT2& coordinates);
+
+		// one entry per enemy in every array
+		std::vector<DirectX::XMFLOAT2> mCoordinates;
+		std::vector<DirectX::XMUINT2> mTargets;
+		std::vector<EnemyDirection> mDirections;
+		std::vector<EnemyDirection> mFacings;
+		std::vector<EnemyState> mStates;
+		std::vector<std::float_t> mAnimationTimers;
+
+		// enemies sorted by tile, the enemies of tile i are mBucketEnemies[mBucketStarts[i]] to mBucketEnemies[mBucketStarts[i + 1] - 1]
+		std::vector<uint32_t> mBucketStarts;
+		std::vector<uint32_t> mBucketEnemies;
+		uint32_t mBucketWidth;
+		uint32_t mBucketHeight;
+
+		uint32_t mRandomState;
+
+		static const uint32_t kTurnChance;
+	};
+}
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "FollowCamera.h"
+#include "PlayerManager.h"
+#include "Player.h"
+#include "LevelManager.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace DX;
+
+namespace DirectXGame
+{
+	const float_t FollowCamera::kFollowSharpness = 6.0f; // per second, the camera covers about 95% of the way in half a second
+
+	/************************************************************************/
+	FollowCamera::FollowCamera(const shared_ptr<DX::DeviceResources>& deviceResources) :
+		OrthographicCamera(deviceResources), mPlayers(nullptr), mIsPlaced(false)
+	{
+	}
+
+	/************************************************************************/
+	void FollowCamera::SetPlayers(const PlayerManager& players)
+	{
+		mPlayers = &players;
+		mIsPlaced = false;
+	}
+
+	/************************************************************************/
+	void FollowCamera::Update(const StepTimer& timer)
+	{
+		if (mPlayers != nullptr)
+		{
+			mPlayerPositions.clear();
+			for (auto& player : mPlayers->Players())
+			{
+				if (player->IsPlaying())
+				{
+					mPlayerPositions.push_back(player->Position());
+				}
+			}
+
+			const XMFLOAT2 target = GetTarget(mPlayerPositions, LevelManager::GetInstance().GetMapLayout().Bounds(), XMFLOAT2(mViewWidth, mViewHeight));
+			const float_t blend = mIsPlaced ? 1.0f - expf(-kFollowSharpness * static_cast<float_t>(timer.GetElapsedSeconds())) : 1.0f;
+			SetPosition(mPosition.x + (target.x - mPosition.x) * blend, mPosition.y + (target.y - mPosition.y) * blend, mPosition.z);
+			mIsPlaced = true;
+		}
+
+		OrthographicCamera::Update(timer);
+	}
+
+	/************************************************************************/
+	XMFLOAT2 FollowCamera::GetTarget(const vector<XMFLOAT2>& playerPositions, const XMFLOAT4& mapBounds, const XMFLOAT2& viewSize)
+	{
+		// the box around the players, the whole map when nobody is playing
+		XMFLOAT4 followed = mapBounds;
+		if (!playerPositions.empty())
+		{
+			followed = XMFLOAT4(playerPositions.front().x, playerPositions.front().y, playerPositions.front().x, playerPositions.front().y);
+			for (auto& position : playerPositions)
+			{
+				followed.x = position.x < followed.x ? position.x : followed.x;
+				followed.y = position.y < followed.y ? position.y : followed.y;
+				followed.z = position.x > followed.z ? position.x : followed.z;
+				followed.w = position.y > followed.w ? position.y : followed.w;
+			}
+		}
+
+		return XMFLOAT2(GetTargetOnAxis(followed.x, followed.z, mapBounds.x, mapBounds.z, viewSize.x),
+						GetTargetOnAxis(followed.y, followed.w, mapBounds.y, mapBounds.w, viewSize.y));
+	}
+
+	/************************************************************************/
+	float_t FollowCamera::GetTargetOnAxis(float_t followedMin, float_t followedMax, float_t mapMin, float_t mapMax, float_t viewSize)
+	{
+		if (mapMax - mapMin <= viewSize)
+		{
+			return (mapMin + mapMax) / 2;
+		}
+
+		const float_t target = (followedMin + followedMax) / 2;
+		const float_t lowest = mapMin + viewSize / 2;
+		const float_t highest = mapMax - viewSize / 2;
+		return target < lowest ? lowest : (target > highest ? highest : target);
+	}
+}
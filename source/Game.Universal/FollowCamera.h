@@ -0,0 +1,39 @@
+#pragma once
+
+#include "OrthographicCamera.h"
+#include <vector>
+
+namespace DirectXGame
+{
+	class PlayerManager;
+
+	/** Class representing the game camera, an orthographic camera following the players over the map.
+	 * It aims at the middle of the players still playing and eases toward it, but never scrolls past the edges of
+	 * the map; on an axis where the whole map fits in the view, it stays on the middle of the map.
+	 * GetTarget holds all the placement math and needs no graphics device.
+	 *@see MapLayout
+	 *@see PlayerManager
+	*/
+	class FollowCamera final : public DX::OrthographicCamera
+	{
+	public:
+
+		FollowCamera(const std::shared_ptr<DX::DeviceResources>& deviceResources);
+
+		void SetPlayers(const PlayerManager& players);
+
+		virtual void Update(const DX::StepTimer& timer) override;
+
+		static DirectX::XMFLOAT2 GetTarget(const std::vector<DirectX::XMFLOAT2>& playerPositions, const DirectX::XMFLOAT4& mapBounds, const DirectX::XMFLOAT2& viewSize);
+
+	private:
+
+		static std::float_t GetTargetOnAxis(std::float_t followedMin, std::float_t followedMax, std::float_t mapMin, std::float_t mapMax, std::float_t viewSize);
+
+		const PlayerManager* mPlayers;
+		std::vector<DirectX::XMFLOAT2> mPlayerPositions; // per frame scratch
+		bool mIsPlaced;                                   // the first update jumps to the target
+
+		static const std::float_t kFollowSharpness;
+	};
+}
@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "FrameArena.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const size_t FrameArena::kDefaultCapacityBytes = 256 * 1024;
+
+	/************************************************************************/
+	FrameArena& FrameArena::GetInstance()
+	{
+		static FrameArena sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	FrameArena::FrameArena() :
+		mBlock(new uint8_t[kDefaultCapacityBytes]), mCapacity(kDefaultCapacityBytes), mOffset(0), mOverflowBytes(0), mHighWaterBytes(0)
+	{
+	}
+
+	/************************************************************************/
+	void* FrameArena::Allocate(size_t size, size_t alignment)
+	{
+		// the block comes from new[], which aligns it for any fundamental type
+		const size_t start = (mOffset + alignment - 1) & ~(alignment - 1);
+		if (start + size <= mCapacity)
+		{
+			mOffset = start + size;
+			return mBlock.get() + start;
+		}
+
+		mOverflowBlocks.push_back(unique_ptr<uint8_t[]>(new uint8_t[size + alignment]));
+		mOverflowBytes += size + alignment;
+
+		uintptr_t address = reinterpret_cast<uintptr_t>(mOverflowBlocks.back().get());
+		address = (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+		return reinterpret_cast<void*>(address);
+	}
+
+	/************************************************************************/
+	void FrameArena::Reset()
+	{
+		const size_t usedBytes = UsedBytes();
+		mHighWaterBytes = usedBytes > mHighWaterBytes ? usedBytes : mHighWaterBytes;
+
+		// a frame that overflowed will happen again, the block takes everything it needed at once
+		if (!mOverflowBlocks.empty())
+		{
+			mOverflowBlocks.clear();
+			mCapacity = mHighWaterBytes + mHighWaterBytes / 2;
+			mBlock.reset(new uint8_t[mCapacity]);
+		}
+
+		mOffset = 0;
+		mOverflowBytes = 0;
+	}
+
+	/************************************************************************/
+	size_t FrameArena::UsedBytes() const
+	{
+		return mOffset + mOverflowBytes;
+	}
+
+	/************************************************************************/
+	size_t FrameArena::CapacityBytes() const
+	{
+		return mCapacity;
+	}
+
+	/************************************************************************/
+	size_t FrameArena::HighWaterBytes() const
+	{
+		return mHighWaterBytes;
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Singleton handing out memory that only lives until the end of the frame, by bumping an offset in one block.
+	 * Allocating is an aligned add, freeing does nothing: GameMain resets the whole arena at the end of each update.
+	 * When a frame needs more than the block holds, the extra allocations come from the heap and the block grows to
+	 * the high water mark at the next reset, so after a few frames a steady game never reaches the heap.
+	 * It belongs to the game thread, the headless tools running simulations on other threads never use it.
+	 *@see ArenaAllocator
+	*/
+	class FrameArena final
+	{
+	public:
+
+		FrameArena(const FrameArena& rhs) = delete;
+		FrameArena(const FrameArena&& rhs) = delete;
+		FrameArena& operator=(const FrameArena& rhs) = delete;
+		FrameArena& operator=(const FrameArena&& rhs) = delete;
+
+		static FrameArena& GetInstance();
+
+		void* Allocate(size_t size, size_t alignment);
+		void Reset();
+
+		size_t UsedBytes() const;
+		size_t CapacityBytes() const;
+		size_t HighWaterBytes() const;
+
+		static const size_t kDefaultCapacityBytes;
+
+	private:
+
+		FrameArena();
+		~FrameArena() = default;
+
+		std::unique_ptr<uint8_t[]> mBlock;
+		size_t mCapacity;
+		size_t mOffset;
+		size_t mOverflowBytes;
+		size_t mHighWaterBytes;
+		std::vector<std::unique_ptr<uint8_t[]>> mOverflowBlocks; // what did not fit this frame
+	};
+
+	/** Allocator giving standard containers memory from the frame arena.
+	 * Containers using it must not outlive the frame they were filled in: FrameVector is meant for locals and
+	 * for values returned to a caller that consumes them within the update.
+	 *@see FrameArena
+	*/
+	template <typename T>
+	class ArenaAllocator
+	{
+	public:
+
+		typedef T value_type;
+
+		ArenaAllocator() = default;
+
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>&)
+		{
+		}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(FrameArena::GetInstance().Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T*, size_t)
+		{
+		}
+
+		template <typename U>
+		bool operator==(const ArenaAllocator<U>&) const
+		{
+			return true;
+		}
+
+		template <typename U>
+		bool operator!=(const ArenaAllocator<U>&) const
+		{
+			return false;
+		}
+	};
+
+	template <typename T>
+	using FrameVector = std::vector<T, ArenaAllocator<T>>;
+}
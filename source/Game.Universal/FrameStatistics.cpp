@@ -0,0 +1,144 @@
+#include "pch.h"
+#include "FrameStatistics.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const double_t FrameStatistics::kDefaultWindowSeconds = 5.0;
+	const uint32_t FrameStatistics::kDefaultMaxFrameCount = 1200;        // the whole window up to 240 frames per second
+	const double_t FrameStatistics::kHistogramBucketMilliseconds = 4.0;
+	const uint32_t FrameStatistics::kHistogramBucketCount = 12;          // up to 44 ms, then everything slower
+
+	/************************************************************************/
+	FrameStatistics::FrameStatistics(uint32_t metricCount, double_t windowSeconds, uint32_t maxFrameCount) :
+		mMetricCount(metricCount), mWindowMilliseconds(windowSeconds * 1000), mMilliseconds(maxFrameCount), 
+		mMetricValues(static_cast<size_t>(maxFrameCount) * metricCount), mNextFrame(0), mFrameCount(0), mTotalMilliseconds(0)
+	{
+		if (maxFrameCount == 0)
+		{
+			throw runtime_error("frame statistics need room for at least one frame");
+		}
+
+		mSortedMilliseconds.reserve(maxFrameCount);
+	}
+
+	/************************************************************************/
+	void FrameStatistics::AddFrame(double_t milliseconds, const uint64_t* metricValues)
+	{
+		const uint32_t capacity = static_cast<uint32_t>(mMilliseconds.size());
+		if (mFrameCount == capacity)
+		{
+			mTotalMilliseconds -= mMilliseconds[GetFrameIndex(mFrameCount - 1)];
+			--mFrameCount;
+		}
+
+		mMilliseconds[mNextFrame] = milliseconds;
+		copy(metricValues, metricValues + mMetricCount, mMetricValues.begin() + static_cast<size_t>(mNextFrame) * mMetricCount);
+		mNextFrame = (mNextFrame + 1) % capacity;
+		++mFrameCount;
+		mTotalMilliseconds += milliseconds;
+
+		// forget the frames that left the window, the newest one always stays
+		while (mFrameCount > 1 && mTotalMilliseconds - mMilliseconds[GetFrameIndex(mFrameCount - 1)] >= mWindowMilliseconds)
+		{
+			mTotalMilliseconds -= mMilliseconds[GetFrameIndex(mFrameCount - 1)];
+			--mFrameCount;
+		}
+	}
+
+	/************************************************************************/
+	void FrameStatistics::Clear()
+	{
+		mNextFrame = 0;
+		mFrameCount = 0;
+		mTotalMilliseconds = 0;
+	}
+
+	/************************************************************************/
+	void FrameStatistics::Summarize(FrameStatisticsSummary& summary) const
+	{
+		summary.FrameCount = mFrameCount;
+		summary.WindowSeconds = mTotalMilliseconds / 1000;
+		summary.Histogram.assign(kHistogramBucketCount, 0);
+		summary.Metrics.assign(mMetricCount, MetricSummary());
+
+		if (mFrameCount == 0)
+		{
+			summary.FramesPerSecond = 0;
+			summary.MeanMilliseconds = 0;
+			summary.P50Milliseconds = 0;
+			summary.P95Milliseconds = 0;
+			summary.P99Milliseconds = 0;
+			summary.MaxMilliseconds = 0;
+			return;
+		}
+
+		mSortedMilliseconds.clear();
+		for (uint32_t age = 0; age < mFrameCount; ++age)
+		{
+			const uint32_t frame = GetFrameIndex(age);
+			const double_t milliseconds = mMilliseconds[frame];
+			mSortedMilliseconds.push_back(milliseconds);
+
+			uint32_t bucket = static_cast<uint32_t>(milliseconds / kHistogramBucketMilliseconds);
+			if (bucket >= kHistogramBucketCount)
+			{
+				bucket = kHistogramBucketCount - 1;
+			}
+			++summary.Histogram[bucket];
+
+			for (uint32_t metric = 0; metric < mMetricCount; ++metric)
+			{
+				const uint64_t value = mMetricValues[static_cast<size_t>(frame) * mMetricCount + metric];
+				MetricSummary& metricSummary = summary.Metrics[metric];
+				if (age == 0)
+				{
+					metricSummary.Last = value;
+				}
+				metricSummary.Mean += value;
+				metricSummary.Max = value > metricSummary.Max ? value : metricSummary.Max;
+			}
+		}
+
+		for (auto& metricSummary : summary.Metrics)
+		{
+			metricSummary.Mean /= mFrameCount;
+		}
+
+		sort(mSortedMilliseconds.begin(), mSortedMilliseconds.end());
+		auto percentile = [this](uint32_t percent)
+		{
+			size_t rank = (mSortedMilliseconds.size() * percent + 99) / 100;
+			return mSortedMilliseconds[rank > 0 ? rank - 1 : 0];
+		};
+
+		summary.MeanMilliseconds = mTotalMilliseconds / mFrameCount;
+		summary.FramesPerSecond = mTotalMilliseconds > 0 ? mFrameCount * 1000 / mTotalMilliseconds : 0;
+		summary.P50Milliseconds = percentile(50);
+		summary.P95Milliseconds = percentile(95);
+		summary.P99Milliseconds = percentile(99);
+		summary.MaxMilliseconds = mSortedMilliseconds.back();
+	}
+
+	/************************************************************************/
+	uint32_t FrameStatistics::FrameCount() const
+	{
+		return mFrameCount;
+	}
+
+	/************************************************************************/
+	uint32_t FrameStatistics::MetricCount() const
+	{
+		return mMetricCount;
+	}
+
+	/************************************************************************/
+	uint32_t FrameStatistics::GetFrameIndex(uint32_t age) const
+	{
+		// age 0 is the newest frame
+		const uint32_t capacity = static_cast<uint32_t>(mMilliseconds.size());
+		return (mNextFrame + capacity - 1 - age) % capacity;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Structure summarizing one metric over the frames of a statistics window.
+	*/
+	struct MetricSummary
+	{
+		uint64_t Last;
+		std::double_t Mean;
+		uint64_t Max;
+	};
+
+	/** Structure summarizing the frames of a statistics window.
+	 * Percentiles use the nearest rank, the p99 of 100 frames is the second slowest one.
+	*/
+	struct FrameStatisticsSummary
+	{
+		uint32_t FrameCount;
+		std::double_t WindowSeconds;
+		std::double_t FramesPerSecond;
+		std::double_t MeanMilliseconds;
+		std::double_t P50Milliseconds;
+		std::double_t P95Milliseconds;
+		std::double_t P99Milliseconds;
+		std::double_t MaxMilliseconds;
+		std::vector<uint32_t> Histogram; // frames per kHistogramBucketMilliseconds, the last bucket holds all the slower ones
+		std::vector<MetricSummary> Metrics;
+	};
+
+	/** Class keeping the duration and the metrics of the frames of the last few seconds, and summarizing them.
+	 * It only does arithmetic on what it is given, never reads a clock nor a device, so it runs and can be checked
+	 * anywhere. Frames are kept in a ring sized once, adding a frame never allocates, and summaries reuse their vectors.
+	 *@see MetricsRegistry
+	*/
+	class FrameStatistics final
+	{
+	public:
+
+		explicit FrameStatistics(uint32_t metricCount, std::double_t windowSeconds = kDefaultWindowSeconds, uint32_t maxFrameCount = kDefaultMaxFrameCount);
+
+		void AddFrame(std::double_t milliseconds, const uint64_t* metricValues);
+		void Clear();
+		void Summarize(FrameStatisticsSummary& summary) const;
+
+		uint32_t FrameCount() const;
+		uint32_t MetricCount() const;
+
+		static const std::double_t kDefaultWindowSeconds;
+		static const uint32_t kDefaultMaxFrameCount;
+		static const std::double_t kHistogramBucketMilliseconds;
+		static const uint32_t kHistogramBucketCount;
+
+	private:
+
+		uint32_t GetFrameIndex(uint32_t age) const;
+
+		uint32_t mMetricCount;
+		std::double_t mWindowMilliseconds;
+
+		// ring of frames, mFrameCount of them ending right before mNextFrame
+		std::vector<std::double_t> mMilliseconds;
+		std::vector<uint64_t> mMetricValues; // mMetricCount values per frame
+		uint32_t mNextFrame;
+		uint32_t mFrameCount;
+		std::double_t mTotalMilliseconds;
+
+		mutable std::vector<std::double_t> mSortedMilliseconds;
+	};
+}
@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "FrameStatsRenderer.h"
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+using namespace DX;
+using namespace Microsoft::WRL;
+
+namespace DirectXGame
+{
+	const double_t FrameStatsRenderer::kRefreshSeconds = 0.25;
+	const float_t FrameStatsRenderer::kTextWidth = 520.0f;
+	const float_t FrameStatsRenderer::kTextHeight = 400.0f;
+	const float_t FrameStatsRenderer::kHistogramHeight = 60.0f;
+	const float_t FrameStatsRenderer::kHistogramBarWidth = 16.0f;
+	const double_t FrameStatsRenderer::kFrameBudgetMilliseconds = 1000.0 / 60;
+
+	/************************************************************************/
+	FrameStatsRenderer::FrameStatsRenderer(const shared_ptr<DX::DeviceResources>& deviceResources) :
+		DrawableGameComponent(deviceResources), mNextRefreshSeconds(0)
+	{
+		ZeroMemory(&mTextMetrics, sizeof(DWRITE_TEXT_METRICS));
+
+		ComPtr<IDWriteTextFormat> textFormat;
+		ThrowIfFailed(mDeviceResources->GetDWriteFactory()->CreateTextFormat(L"Consolas", nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL,
+			DWRITE_FONT_STRETCH_NORMAL, 16.0f, L"en-US", &textFormat));
+		ThrowIfFailed(textFormat.As(&mTextFormat));
+		ThrowIfFailed(mTextFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR));
+		ThrowIfFailed(mTextFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_TRAILING));
+		ThrowIfFailed(mDeviceResources->GetD2DFactory()->CreateDrawingStateBlock(&mStateBlock));
+
+		CreateDeviceDependentResources();
+		UpdateTextLayout();
+	}
+
+	/************************************************************************/
+	void FrameStatsRenderer::CreateDeviceDependentResources()
+	{
+		ThrowIfFailed(mDeviceResources->GetD2DDeviceContext()->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::White), &mWhiteBrush));
+		ThrowIfFailed(mDeviceResources->GetD2DDeviceContext()->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::OrangeRed), &mSpikeBrush));
+	}
+
+	/************************************************************************/
+	void FrameStatsRenderer::ReleaseDeviceDependentResources()
+	{
+		mWhiteBrush.Reset();
+		mSpikeBrush.Reset();
+	}
+
+	/************************************************************************/
+	void FrameStatsRenderer::Update(const StepTimer& timer)
+	{
+		if (timer.GetTotalSeconds() < mNextRefreshSeconds)
+		{
+			return;
+		}
+		mNextRefreshSeconds = timer.GetTotalSeconds() + kRefreshSeconds;
+
+		MetricsRegistry& registry = MetricsRegistry::GetInstance();
+		registry.Statistics().Summarize(mSummary);
+
+		wstringstream text;
+		text << fixed << setprecision(1);
+		text << static_cast<uint32_t>(mSummary.FramesPerSecond + 0.5) << L" FPS, " << mSummary.MeanMilliseconds << L" ms mean" << endl;
+		text << L"p50 " << mSummary.P50Milliseconds << L"  p95 " << mSummary.P95Milliseconds << L"  p99 " << mSummary.P99Milliseconds << L" ms" << endl;
+		text << L"max " << mSummary.MaxMilliseconds << L" ms over the last " << mSummary.WindowSeconds << L" s" << endl;
+		for (uint32_t metric = 0; metric < registry.MetricCount() && metric < mSummary.Metrics.size(); ++metric)
+		{
+			const string name = registry.GetName(metric);
+			const MetricSummary& metricSummary = mSummary.Metrics[metric];
+			text << wstring(name.begin(), name.end()) << L" " << metricSummary.Last << L"  mean " << metricSummary.Mean << L"  max " << metricSummary.Max << endl;
+		}
+		mText = text.str();
+
+		UpdateTextLayout();
+	}
+
+	/************************************************************************/
+	void FrameStatsRenderer::Render(const StepTimer& timer)
+	{
+		UNREFERENCED_PARAMETER(timer);
+
+		ID2D1DeviceContext* context = mDeviceResources->GetD2DDeviceContext();
+		Windows::Foundation::Size logicalSize = mDeviceResources->GetLogicalSize();
+
+		context->SaveDrawingState(mStateBlock.Get());
+		context->BeginDraw();
+
+		// the text in the bottom right corner, the histogram right above it
+		D2D1::Matrix3x2F screenTranslation = D2D1::Matrix3x2F::Translation(logicalSize.Width - mTextMetrics.layoutWidth, logicalSize.Height - mTextMetrics.height);
+		context->SetTransform(screenTranslation * mDeviceResources->GetOrientationTransform2D());
+		context->DrawTextLayout(D2D1::Point2F(0.f, 0.f), mTextLayout.Get(), mWhiteBrush.Get());
+
+		uint32_t tallestBucket = 1;
+		for (auto count : mSummary.Histogram)
+		{
+			tallestBucket = count > tallestBucket ? count : tallestBucket;
+		}
+
+		const uint32_t bucketCount = static_cast<uint32_t>(mSummary.Histogram.size());
+		const float_t histogramLeft = mTextMetrics.layoutWidth - static_cast<float_t>(bucketCount) * kHistogramBarWidth;
+		for (uint32_t bucket = 0; bucket < bucketCount; ++bucket)
+		{
+			// the buckets slower than the frame budget are the spikes
+			const float_t height = kHistogramHeight * static_cast<float_t>(mSummary.Histogram[bucket]) / static_cast<float_t>(tallestBucket);
+			const float_t left = histogramLeft + static_cast<float_t>(bucket) * kHistogramBarWidth;
+			const bool isSpike = bucket * FrameStatistics::kHistogramBucketMilliseconds >= kFrameBudgetMilliseconds;
+			context->FillRectangle(D2D1::RectF(left + 1, -height, left + kHistogramBarWidth - 1, 0.f), isSpike ? mSpikeBrush.Get() : mWhiteBrush.Get());
+		}
+
+		// a lost device is handled by the next Present
+		HRESULT hr = context->EndDraw();
+		if (hr != D2DERR_RECREATE_TARGET)
+		{
+			ThrowIfFailed(hr);
+		}
+
+		context->RestoreDrawingState(mStateBlock.Get());
+	}
+
+	/************************************************************************/
+	void FrameStatsRenderer::UpdateTextLayout()
+	{
+		ComPtr<IDWriteTextLayout> textLayout;
+		ThrowIfFailed(mDeviceResources->GetDWriteFactory()->CreateTextLayout(mText.c_str(), static_cast<uint32_t>(mText.length()), mTextFormat.Get(),
+			kTextWidth, kTextHeight, &textLayout));
+		ThrowIfFailed(textLayout.As(&mTextLayout));
+		ThrowIfFailed(mTextLayout->GetMetrics(&mTextMetrics));
+	}
+}
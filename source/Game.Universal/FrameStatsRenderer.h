@@ -0,0 +1,46 @@
+#pragma once
+
+#include "DrawableGameComponent.h"
+#include "MetricsRegistry.h"
+
+namespace DirectXGame
+{
+	/** Class drawing the frame statistics in the bottom right corner of the screen, with Direct2D and DirectWrite.
+	 * It shows the frame rate, the frame time percentiles and the worst frame of the statistics window, a histogram of
+	 * the frame times, and the last, mean and worst value of every metric published to the registry.
+	 * The summary is refreshed a few times per second only, the text layout is not rebuilt every frame.
+	 *@see MetricsRegistry
+	*/
+	class FrameStatsRenderer final : public DX::DrawableGameComponent
+	{
+	public:
+
+		FrameStatsRenderer(const std::shared_ptr<DX::DeviceResources>& deviceResources);
+
+		virtual void CreateDeviceDependentResources() override;
+		virtual void ReleaseDeviceDependentResources() override;
+		virtual void Update(const DX::StepTimer& timer) override;
+		virtual void Render(const DX::StepTimer& timer) override;
+
+	private:
+
+		void UpdateTextLayout();
+
+		FrameStatisticsSummary mSummary;
+		std::wstring mText;
+		std::double_t mNextRefreshSeconds;
+		DWRITE_TEXT_METRICS mTextMetrics;
+		Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> mWhiteBrush;
+		Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> mSpikeBrush;
+		Microsoft::WRL::ComPtr<ID2D1DrawingStateBlock1> mStateBlock;
+		Microsoft::WRL::ComPtr<IDWriteTextLayout3> mTextLayout;
+		Microsoft::WRL::ComPtr<IDWriteTextFormat2> mTextFormat;
+
+		static const std::double_t kRefreshSeconds;
+		static const std::float_t kTextWidth;
+		static const std::float_t kTextHeight;
+		static const std::float_t kHistogramHeight;
+		static const std::float_t kHistogramBarWidth;
+		static const std::double_t kFrameBudgetMilliseconds;
+	};
+}
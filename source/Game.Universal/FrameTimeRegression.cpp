@@ -0,0 +1,255 @@
+#include "pch.h"
+#include "FrameTimeRegression.h"
+#include "ReplayRecorder.h"
+#include "RandomInputScript.h"
+#include "Renderable.h"
+#include "SpriteSheetParser.h"
+#include "LevelGenerator.h"
+#include "AllocationCounter.h"
+#include <chrono>
+#include <sstream>
+
+using namespace std;
+using namespace DirectX;
+using namespace DX;
+
+namespace DirectXGame
+{
+	const uint32_t FrameTimeRegression::kAllocationsMetric = 0;
+	const uint32_t FrameTimeRegression::kSpritesMetric = 1;
+	const vector<string> FrameTimeRegression::kSpriteSheetJSONPaths = { "Assets/JSONS/Atlas/Props.json", "Assets/JSONS/Atlas/MC.json",
+		"Assets/JSONS/Atlas/Bomb.json", "Assets/JSONS/Atlas/BombAE.json", "Assets/JSONS/Atlas/Barom.json" };
+	const uint32_t FrameTimeRegression::kSessionTickCount = 3600; // a minute of game
+
+	/************************************************************************/
+	FrameTimeRegression& FrameTimeRegression::GetInstance()
+	{
+		static FrameTimeRegression sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	vector<FrameRegressionSession> FrameTimeRegression::RecordBuiltInSessions(const Map& basicMap) const
+	{
+		vector<FrameRegressionSession> sessions;
+
+		GameSimulationOptions options;
+		sessions.push_back(RecordSession(basicMap, "wandering", options, RandomInputScript::kDefaultBombChance));
+
+		options.Seed = 1;
+		options.PlayerCount = LevelGenerator::kMaxPlayerCount;
+		sessions.push_back(RecordSession(basicMap, "bomb at every move", options, 1));
+
+		options.Seed = 2;
+		options.EnemyCount = 24;
+		sessions.push_back(RecordSession(basicMap, "crowded level", options, 2));
+
+		return sessions;
+	}
+
+	/************************************************************************/
+	vector<FrameRegressionResult> FrameTimeRegression::Run(const Map& basicMap, const vector<FrameRegressionSession>& sessions, const FrameBudget& budget)
+	{
+		if (mSpriteSheets.empty())
+		{
+			LoadSpriteSheets();
+		}
+
+		// the game camera: an orthographic camera with the default view, at (0, 0, 1)
+		const XMMATRIX viewMatrix = XMMatrixLookToRH(XMVectorSet(0, 0, 1, 1), XMLoadFloat3(&Vector3Helper::Forward), XMLoadFloat3(&Vector3Helper::Up));
+		const XMMATRIX projectionMatrix = XMMatrixOrthographicRH(OrthographicCamera::DefaultViewWidth, OrthographicCamera::DefaultViewHeight,
+			Camera::DefaultNearPlaneDistance, Camera::DefaultFarPlaneDistance);
+		XMStoreFloat4x4(&mViewProjection, XMMatrixMultiply(viewMatrix, projectionMatrix));
+
+		vector<FrameRegressionResult> results;
+		GameSimulation simulation;
+
+		for (auto& session : sessions)
+		{
+			const Replay& replay = session.SessionReplay;
+
+			// large enough to keep every tick of the session
+			FrameStatistics statistics(2, static_cast<double_t>(replay.TickCount()), static_cast<uint32_t>(replay.TickCount()));
+			simulation.Initialize(basicMap, replay.Options());
+			Play(simulation, replay, statistics);
+
+			FrameRegressionResult result;
+			result.Name = session.Name;
+			statistics.Summarize(result.Ticks);
+
+			const FrameStatisticsSummary& ticks = result.Ticks;
+			const double_t allocationsPerTick = ticks.Metrics[kAllocationsMetric].Mean;
+			const pair<double_t, double_t> checks[] =
+			{
+				{ ticks.MeanMilliseconds, budget.MeanMilliseconds },
+				{ ticks.P99Milliseconds, budget.P99Milliseconds },
+				{ ticks.MaxMilliseconds, budget.MaxMilliseconds },
+				{ allocationsPerTick, budget.AllocationsPerTick }
+			};
+			const char* checkNames[] = { "mean tick ms", "p99 tick ms", "max tick ms", "allocations per tick" };
+
+			for (uint32_t i = 0; i < sizeof(checks) / sizeof(checks[0]); ++i)
+			{
+				if (checks[i].first > checks[i].second)
+				{
+					stringstream line;
+					line << checkNames[i] << ": " << checks[i].first << " > " << checks[i].second;
+					result.ExceededBudgets.push_back(line.str());
+				}
+			}
+
+			results.push_back(result);
+		}
+
+		return results;
+	}
+
+	/************************************************************************/
+	void FrameTimeRegression::LoadSpriteSheets()
+	{
+		for (auto& path : kSpriteSheetJSONPaths)
+		{
+			mSpriteSheets.push_back(SpriteSheetParser::GetInstance().ParseSpriteSheet(path));
+		}
+	}
+
+	/************************************************************************/
+	void FrameTimeRegression::Play(GameSimulation& simulation, const Replay& replay, FrameStatistics& statistics)
+	{
+		uint64_t metricValues[2];
+
+		for (uint32_t run = 0; run < replay.RunCount(); ++run)
+		{
+			const PlayerInput* inputs = replay.GetRunInputs(run);
+			for (uint32_t i = replay.GetRunLength(run); i > 0; --i)
+			{
+				const uint64_t allocationCount = AllocationCounter::Count();
+				auto start = chrono::high_resolution_clock::now();
+
+				simulation.Tick(inputs);
+				PrepareSprites(simulation);
+
+				chrono::duration<double_t, milli> elapsed = chrono::high_resolution_clock::now() - start;
+				metricValues[kAllocationsMetric] = AllocationCounter::Count() - allocationCount;
+				metricValues[kSpritesMetric] = mSprites.size();
+				statistics.AddFrame(elapsed.count(), metricValues);
+			}
+		}
+	}
+
+	/************************************************************************/
+	void FrameTimeRegression::PrepareSprites(const GameSimulation& simulation)
+	{
+		mSprites.clear();
+		mSortKeys.Clear();
+
+		// simulated positions are in tiles, the renderables place the tile (x, y) at origin + (x, y) * tileSize
+		const XMFLOAT2 origin = Renderable::GetPositionFromTile(XMUINT2(0, 0));
+		const XMFLOAT2 nextTile = Renderable::GetPositionFromTile(XMUINT2(1, 1));
+		const XMFLOAT2 tileSize(nextTile.x - origin.x, nextTile.y - origin.y);
+
+		// MapRenderable: background, perk, door and blocks
+		const Map& map = simulation.GetMap();
+		const SpriteSheet& props = mSpriteSheets[0];
+		for (uint32_t y = 0; y < map.MapHeight; ++y)
+		{
+			for (uint32_t x = 0; x < map.MapWidth; ++x)
+			{
+				const uint32_t spriteIndex = map.BackgroundLayer[x][y];
+				if (spriteIndex > 0 && spriteIndex != 5)
+				{
+					AddSprite(*props.Sprites[spriteIndex - 1], 0, Renderable::GetPositionFromTile(XMUINT2(x, y)));
+				}
+			}
+		}
+		if (!simulation.IsPerkConsumed())
+		{
+			AddSprite(*props.Sprites[map.PerkTile.SpriteIndex], 0, Renderable::GetPositionFromTile(map.PerkTile.Tile));
+		}
+		AddSprite(*props.Sprites[map.DoorTile.SpriteIndex], 0, Renderable::GetPositionFromTile(map.DoorTile.Tile));
+		for (uint32_t y = 0; y < map.MapHeight; ++y)
+		{
+			for (uint32_t x = 0; x < map.MapWidth; ++x)
+			{
+				const uint32_t spriteIndex = map.BlocksLayer[x][y];
+				if (spriteIndex > 0)
+				{
+					AddSprite(*props.Sprites[spriteIndex - 1], 0, Renderable::GetPositionFromTile(XMUINT2(x, y)));
+				}
+			}
+		}
+
+		// Player, Bomb and EnemyManager
+		for (auto& player : simulation.Players())
+		{
+			if (player.State != PlayerState::Dead && !player.HasEscaped)
+			{
+				const XMFLOAT2 position(origin.x + tileSize.x * player.Position.x / GameSimulation::kTileUnits,
+										origin.y + tileSize.y * player.Position.y / GameSimulation::kTileUnits);
+				AddSprite(*mSpriteSheets[1].Sprites.front(), 1, position);
+			}
+		}
+		for (auto& bomb : simulation.Bombs())
+		{
+			AddSprite(*mSpriteSheets[2].Sprites.front(), 2, Renderable::GetPositionFromTile(bomb.Tile));
+		}
+		for (auto& explosion : simulation.Explosions())
+		{
+			AddSprite(*mSpriteSheets[3].Sprites.front(), 3, Renderable::GetPositionFromTile(explosion.Tile));
+		}
+		const EnemySimulation& enemies = simulation.GetEnemies();
+		for (uint32_t i = 0; i < enemies.Count(); ++i)
+		{
+			const XMFLOAT2& coordinates = enemies.Coordinates()[i];
+			AddSprite(*mSpriteSheets[4].Sprites.front(), 4, XMFLOAT2(origin.x + tileSize.x * coordinates.x, origin.y + tileSize.y * coordinates.y));
+		}
+
+		mSortKeys.Sort();
+	}
+
+	/************************************************************************/
+	void FrameTimeRegression::AddSprite(const Sprite& sprite, uint32_t spriteSheet, const XMFLOAT2& position)
+	{
+		PreparedSprite prepared;
+
+		// sorting layer, then sprite sheet, then y position, as RenderQueue::Submit with the sprite sheet for the texture
+		mSortKeys.Add(RenderSortKeys::MakeKey(sprite.SortingLayer, spriteSheet, position.y));
+
+		// as Renderable::DrawSprite
+		Transform2D transform(position, 0, Renderable::SpriteScale);
+		XMStoreFloat4x4(&prepared.WorldViewProjection, XMMatrixTranspose(transform.WorldMatrix() * XMLoadFloat4x4(&mViewProjection)));
+		prepared.UVRect = sprite.UVRect;
+
+		mSprites.push_back(prepared);
+	}
+
+	/************************************************************************/
+	FrameRegressionSession FrameTimeRegression::RecordSession(const Map& basicMap, const string& name, const GameSimulationOptions& options, uint32_t bombChance)
+	{
+		GameSimulation simulation;
+		simulation.Initialize(basicMap, options);
+		ReplayRecorder recorder(simulation, options);
+
+		vector<RandomInputScript> scripts;
+		for (uint32_t player = 0; player < options.PlayerCount; ++player)
+		{
+			scripts.push_back(RandomInputScript(options.Seed * LevelGenerator::kMaxPlayerCount + player + 1, bombChance));
+		}
+
+		vector<PlayerInput> inputs(options.PlayerCount);
+		for (uint32_t tick = 0; tick < kSessionTickCount; ++tick)
+		{
+			for (uint32_t player = 0; player < options.PlayerCount; ++player)
+			{
+				inputs[player] = scripts[player].Next();
+			}
+			recorder.Tick(inputs.data());
+		}
+
+		FrameRegressionSession session;
+		session.Name = name;
+		session.SessionReplay = recorder.Finish();
+
+		return session;
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Replay.h"
+#include "FrameStatistics.h"
+#include "RenderSortKeys.h"
+#include <string>
+
+namespace DirectXGame
+{
+	/** Structure holding the limits every tick of a recorded session must stay under.
+	 * A tick is the simulation step plus the preparation of the sprites it renders, as the game does once per frame.
+	*/
+	struct FrameBudget
+	{
+		FrameBudget() :
+			MeanMilliseconds(0.5), P99Milliseconds(2), MaxMilliseconds(8), AllocationsPerTick(1)
+		{
+		}
+
+		std::double_t MeanMilliseconds;
+		std::double_t P99Milliseconds;
+		std::double_t MaxMilliseconds;
+		std::double_t AllocationsPerTick; // mean over the session, spikes are caught by the timings
+	};
+
+	/** Structure holding a recorded session to measure.
+	*/
+	struct FrameRegressionSession
+	{
+		std::string Name;
+		Replay SessionReplay;
+	};
+
+	/** Structure holding the measures of one session.
+	 * The metrics of the summary are kAllocationsMetric and kSpritesMetric.
+	*/
+	struct FrameRegressionResult
+	{
+		std::string Name;
+		FrameStatisticsSummary Ticks;
+		std::vector<std::string> ExceededBudgets; // one line per budget, empty when the session fits
+	};
+
+	/** Singleton that plays recorded sessions end to end and checks their ticks against a frame budget.
+	 * Every tick runs the headless simulation, then does the CPU side of rendering its state: the world view projection
+	 * and texture transform of every sprite the renderables would draw, in a list sorted by sorting layer and sprite sheet
+	 * the way a sprite batcher would order it. Each tick is timed and its heap allocations are counted.
+	 * The built in sessions stress what changes to Player, Bomb and MapRenderable tend to slow down: bots dropping bombs
+	 * at every move, which sets off chains of explosions, and a crowded level; recorded replays can be added to them.
+	 *@see ReplayRecorder
+	 *@see HeadlessTools
+	*/
+	class FrameTimeRegression final
+	{
+	public:
+
+		FrameTimeRegression(const FrameTimeRegression& rhs) = delete;
+		FrameTimeRegression(const FrameTimeRegression&& rhs) = delete;
+		FrameTimeRegression& operator=(const FrameTimeRegression& rhs) = delete;
+		FrameTimeRegression& operator=(const FrameTimeRegression&& rhs) = delete;
+
+		static FrameTimeRegression& GetInstance();
+
+		std::vector<FrameRegressionSession> RecordBuiltInSessions(const Map& basicMap) const;
+		std::vector<FrameRegressionResult> Run(const Map& basicMap, const std::vector<FrameRegressionSession>& sessions, const FrameBudget& budget);
+
+		static const uint32_t kAllocationsMetric;
+		static const uint32_t kSpritesMetric;
+
+	private:
+
+		/** Structure holding what the renderables upload for one sprite.
+		*/
+		struct PreparedSprite
+		{
+			DirectX::XMFLOAT4X4 WorldViewProjection;
+			DirectX::XMFLOAT4 UVRect;
+		};
+
+		FrameTimeRegression() = default;
+		~FrameTimeRegression() = default;
+
+		void LoadSpriteSheets();
+		void Play(GameSimulation& simulation, const Replay& replay, FrameStatistics& statistics);
+		void PrepareSprites(const GameSimulation& simulation);
+		void AddSprite(const Sprite& sprite, uint32_t spriteSheet, const DirectX::XMFLOAT2& position);
+
+		static FrameRegressionSession RecordSession(const Map& basicMap, const std::string& name, const GameSimulationOptions& options, uint32_t bombChance);
+
+		// Props, MC, Bomb, BombAE and Barom, in that order
+		std::vector<SpriteSheet> mSpriteSheets;
+		std::vector<PreparedSprite> mSprites;
+		RenderSortKeys mSortKeys; // as RenderQueue, the prepared sprites are drawn in its order
+		DirectX::XMFLOAT4X4 mViewProjection;
+
+		static const std::vector<std::string> kSpriteSheetJSONPaths;
+		static const uint32_t kSessionTickCount;
+	};
+}
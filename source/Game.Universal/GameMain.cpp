@@ -2,9 +2,22 @@
 #include "GameMain.h"
 #include "MapRenderable.h"
 #include "Player.h"
+#include "EnemyManager.h"
+#include "PlayerManager.h"
 #include "CollisionManager.h"
 #include "LevelManager.h"
 #include "Bomb.h"
+#include "Profiler.h"
+#include "MetricsRegistry.h"
+#include "FrameArena.h"
+#include "FrameStatsRenderer.h"
+#include "FollowCamera.h"
+#include "RenderStateCache.h"
+#include "ConstantRingBuffer.h"
+#include "SpritePipeline.h"
+#include "RenderQueue.h"
+#include <chrono>
+#include <typeinfo>
 
 using namespace DX;
 using namespace std;
@@ -17,6 +30,10 @@ using namespace Concurrency;
 
 namespace DirectXGame
 {
+	const uint32_t GameMain::kPlayerCount = 1; // local players, a second one takes the arrow keys from the first
+	const uint32_t GameMain::kEnemyCount = 6;
+	const string GameMain::kTraceFileName = "frames.trace.json";
+
 	// Loads and initializes application assets when the application is loaded.
 	GameMain::GameMain(const shared_ptr<DX::DeviceResources>& deviceResources) :
 		mDeviceResources(deviceResources)
@@ -26,7 +43,7 @@ namespace DirectXGame
 
 		LevelManager::GetInstance().SetGameMain(*this);
 
-		auto camera = make_shared<OrthographicCamera>(mDeviceResources);
+		auto camera = make_shared<FollowCamera>(mDeviceResources);
 		mComponents.push_back(camera);
 		camera->SetPosition(0, 0, 1);
 
@@ -42,20 +59,42 @@ namespace DirectXGame
 		mGamePad = make_shared<GamePadComponent>(mDeviceResources);
 		mComponents.push_back(mGamePad);
 
-		auto fpsTextRenderer = make_shared<FpsTextRenderer>(mDeviceResources);
-		mComponents.push_back(fpsTextRenderer);
+		auto frameStatsRenderer = make_shared<FrameStatsRenderer>(mDeviceResources);
+		mComponents.push_back(frameStatsRenderer);
 
-		auto map = make_shared<MapRenderable>(mDeviceResources, camera);
+		auto map = make_shared<MapRenderable>(mDeviceResources, camera, kPlayerCount);
 		mComponents.push_back(map);
 
-		auto player = make_shared<Player>(mDeviceResources, camera, mKeyboard, mGamePad, *map);
+		auto enemies = make_shared<EnemyManager>(mDeviceResources, camera, *map, kEnemyCount);
+		mComponents.push_back(enemies);
+
+		// every player has its own game pad, the first two also share the keyboard
+		auto players = make_shared<PlayerManager>(mDeviceResources, camera);
+		for (uint32_t i = 0; i < kPlayerCount; ++i)
+		{
+			auto gamePad = mGamePad;
+			if (i > 0)
+			{
+				gamePad = make_shared<GamePadComponent>(mDeviceResources, i);
+				mComponents.push_back(gamePad);
+			}
+
+			PlayerInputSource inputSource(mKeyboard, PlayerInputSource::GetKeyboardLayout(i, kPlayerCount), gamePad);
+			players->AddPlayer(make_shared<Player>(mDeviceResources, camera, i, *map), inputSource);
+		}
+
 		CollisionManager::GetInstance().SetMap(map);
+		CollisionManager::GetInstance().SetEnemies(enemies);
+		camera->SetPlayers(*players);
 
-		mComponents.push_back(player);
+		// the players stay the last component, see AddNewComponents
+		mComponents.push_back(players);
 
 		mTimer.SetFixedTimeStep(true);
 		mTimer.SetTargetElapsedSeconds(1.0 / 60);
 
+		Profiler::GetInstance().SetThreadName("Main");
+
 		IntializeResources();
 	}
 
@@ -76,14 +115,33 @@ namespace DirectXGame
 	// Updates the application state once per frame.
 	void GameMain::Update()
 	{
+		// a frame goes from one update to the next, rendering and presenting included
+		auto frameStart = chrono::high_resolution_clock::now();
+		if (mTimer.GetFrameCount() > 0)
+		{
+			MetricsRegistry::GetInstance().EndFrame(chrono::duration<double_t, milli>(frameStart - mLastFrameStart).count());
+		}
+		mLastFrameStart = frameStart;
+
+		ProfileScope scope("GameMain::Update");
+
 		// Update scene objects.
 		mTimer.Tick([&]()
 		{
+			{
+				ProfileScope levelScope("LevelManager::Update");
+				LevelManager::GetInstance().Update(mTimer);
+			}
+
 			for (auto& component : mComponents)
 			{
+				// the name of the type of the component, which the runtime keeps for the whole program
+				ProfileScope componentScope(typeid(*component).name());
 				component->Update(mTimer);
 			}
 
+			UpdateProfiler();
+
 			if (mKeyboard->WasKeyPressedThisFrame(Keys::Escape) ||
 				mMouse->WasButtonPressedThisFrame(MouseButtons::Middle) ||
 				mGamePad->WasButtonPressedThisFrame(GamePadButtons::Back))
@@ -94,6 +152,9 @@ namespace DirectXGame
 
 		RemoveComponents();
 		AddNewComponents();
+
+		// nothing allocated from the arena outlives the update
+		FrameArena::GetInstance().Reset();
 	}
 
 	// Renders the current frame according to the current application state.
@@ -106,8 +167,16 @@ namespace DirectXGame
 			return false;
 		}
 
+		ProfileScope scope("GameMain::Render");
+
 		auto context = mDeviceResources->GetD3DDeviceContext();
 
+		// Nothing bound by the last frame is trusted, the context may have been used outside of the renderables.
+		DeviceRenderStateCache& renderState = DeviceRenderStateCache::GetInstance();
+		renderState.SetContext(context);
+		renderState.ResetStats();
+		ConstantRingBuffer::GetInstance().BeginFrame();
+
 		// Reset the viewport to target the whole screen.
 		auto viewport = mDeviceResources->GetScreenViewport();
 		context->RSSetViewports(1, &viewport);
@@ -125,13 +194,45 @@ namespace DirectXGame
 			auto drawableComponent = dynamic_pointer_cast<DrawableGameComponent>(component);
 			if (drawableComponent != nullptr && drawableComponent->Visible())
 			{
+				ProfileScope componentScope(typeid(*drawableComponent).name());
 				drawableComponent->Render(mTimer);
 			}
 		}
 
+		// the sprites were only submitted by the components, they are drawn sorted by layer, texture and y
+		RenderQueue::GetInstance().Flush(context);
+
+		MetricsRegistry::GetInstance().Add(MetricsRegistry::kSkippedBinds, renderState.Stats().SkippedBindCount);
+
 		return true;
 	}
 
+	// F9 starts and stops recording the frames, F10 saves what was recorded as a Chrome trace in the local folder.
+	void GameMain::UpdateProfiler()
+	{
+		Profiler& profiler = Profiler::GetInstance();
+
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::F9))
+		{
+			if (!profiler.IsEnabled())
+			{
+				profiler.Clear();
+			}
+			profiler.SetEnabled(!profiler.IsEnabled());
+		}
+
+		if (mKeyboard->WasKeyPressedThisFrame(Keys::F10))
+		{
+			// the local folder path is plain ascii
+			string path;
+			for (const wchar_t* character = Windows::Storage::ApplicationData::Current->LocalFolder->Path->Data(); *character != L'\0'; ++character)
+			{
+				path.push_back(static_cast<char>(*character));
+			}
+			profiler.SaveChromeTrace(path + "\\" + kTraceFileName);
+		}
+	}
+
 	void GameMain::AddComponent(const shared_ptr<DX::GameComponent>& component)
 	{
 		mComponentsToAdd.push_back(component);
@@ -145,6 +246,12 @@ namespace DirectXGame
 	// Notifies renderers that device resources need to be released.
 	void GameMain::OnDeviceLost()
 	{
+		// a new object may get the address of a released one, the cache must not take it for bound
+		DeviceRenderStateCache::GetInstance().SetContext(nullptr);
+		RenderQueue::GetInstance().Clear();
+		ConstantRingBuffer::GetInstance().ReleaseDeviceDependentResources();
+		SpritePipeline::GetInstance().ReleaseDeviceDependentResources();
+
 		for (auto& component : mComponents)
 		{
 			component->ReleaseDeviceDependentResources();
@@ -159,6 +266,10 @@ namespace DirectXGame
 
 	void GameMain::IntializeResources()
 	{
+		// shared by the renderables, which take their references once it is loaded
+		SpritePipeline::GetInstance().CreateDeviceDependentResources(mDeviceResources->GetD3DDevice());
+		ConstantRingBuffer::GetInstance().CreateDeviceDependentResources(mDeviceResources->GetD3DDevice());
+
 		for (auto& component : mComponents)
 		{
 			component->CreateDeviceDependentResources();
@@ -174,7 +285,7 @@ namespace DirectXGame
 			return;
 		}
 
-		auto player = mComponents.back();
+		auto players = mComponents.back();
 		mComponents.pop_back();
 
 		for (auto& componentToAdd : mComponentsToAdd)
@@ -182,7 +293,7 @@ namespace DirectXGame
 			mComponents.push_back(componentToAdd);
 		}
 
-		mComponents.push_back(player);
+		mComponents.push_back(players);
 		mComponentsToAdd.clear();
 	}
 
@@ -4,6 +4,7 @@
 #include "DeviceResources.h"
 #include <vector>
 #include <memory>
+#include <chrono>
 
 namespace DX
 {
@@ -33,6 +34,7 @@ namespace DirectXGame
 
 	private:
 		void IntializeResources();
+		void UpdateProfiler();
 
 		void AddNewComponents();
 		void RemoveComponents();
@@ -40,11 +42,16 @@ namespace DirectXGame
 		std::shared_ptr<DX::DeviceResources> mDeviceResources;
 		std::vector<std::shared_ptr<DX::GameComponent>> mComponents;
 		DX::StepTimer mTimer;
+		std::chrono::high_resolution_clock::time_point mLastFrameStart;
 		std::shared_ptr<DX::KeyboardComponent> mKeyboard;
 		std::shared_ptr<DX::MouseComponent> mMouse;
 		std::shared_ptr<DX::GamePadComponent> mGamePad;
 
 		std::vector<std::shared_ptr<DX::GameComponent>> mComponentsToAdd;
 		std::vector<const DX::GameComponent*> mComponentsToDelete;
+
+		static const std::uint32_t kPlayerCount;
+		static const std::uint32_t kEnemyCount;
+		static const std::string kTraceFileName;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,692 @@
+#include "pch.h"
+#include "GameSimulation.h"
+#include "LevelGenerator.h"
+#include "StateHash.h"
+#include "Profiler.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	const int32_t GameSimulation::kTileUnits = 256;
+	const double_t GameSimulation::kTickSeconds = 1.0 / 60;
+
+	const XMINT2 GameSimulation::kBaseSpeed = { 6, 9 }; // units per tick, Player::kBaseSpeed rounded
+	const XMINT2 GameSimulation::kSpeedIncrement = { 2, 2 }; // units per tick per skate
+	const int32_t GameSimulation::kBlockExtent = 112; // half size of the player against blocks and bombs
+	const int32_t GameSimulation::kExplosionExtent = 76; // half size of the player against flames
+	const int32_t GameSimulation::kCornerTolerance = 96; // how far from a row or a column center a blocked player still slides into it
+	const uint32_t GameSimulation::kBombTicks = 180; // 3 s
+	const uint32_t GameSimulation::kExplosionTicks = 42; // 7 frames of 0.1 s
+	const uint32_t GameSimulation::kDyingTicks = 108; // 6 frames of 0.3 s
+	const uint32_t GameSimulation::kEnemyMinSpawnDistance = 4;
+	const float_t GameSimulation::kEnemyCollisionDistance = 0.6f;
+
+	/************************************************************************/
+	GameSimulation::GameSimulation() :
+		mTick(0), mIsPerkConsumed(false)
+	{
+	}
+
+	/************************************************************************/
+	void GameSimulation::Initialize(const Map& basicMap, const GameSimulationOptions& options)
+	{
+		default_random_engine generator(options.Seed);
+		mMap = LevelGenerator::GetInstance().GenerateLevel(basicMap, generator, options.PlayerCount);
+		mNavigationGrid.Initialize(mMap);
+
+		mEnemies = EnemySimulation(options.Seed);
+		mEnemies.SpawnRandom(mNavigationGrid, options.EnemyCount, mMap.PlayerSpawnTiles, kEnemyMinSpawnDistance);
+
+		mPlayers.clear();
+		for (uint32_t i = 0; i < options.PlayerCount; ++i)
+		{
+			const XMUINT2& spawnTile = mMap.PlayerSpawnTiles[i % mMap.PlayerSpawnTiles.size()];
+
+			SimulatedPlayer player = {};
+			player.Position = XMINT2(static_cast<int32_t>(spawnTile.x) * kTileUnits, static_cast<int32_t>(spawnTile.y) * kTileUnits);
+			player.State = PlayerState::Idle;
+			mPlayers.push_back(player);
+		}
+
+		mBombs.clear();
+		mExplosions.clear();
+		mTick = 0;
+		mIsPerkConsumed = false;
+	}
+
+	/************************************************************************/
+	void GameSimulation::Tick(const PlayerInput* inputs)
+	{
+		ProfileScope scope("GameSimulation::Tick");
+
+		for (uint32_t i = 0; i < mPlayers.size(); ++i)
+		{
+			mPlayers[i].PreviousInput = mPlayers[i].Input;
+			mPlayers[i].Input = inputs[i];
+		}
+
+		// always the same order, players by index, then bombs and explosions by creation, then enemies
+		for (uint32_t i = 0; i < mPlayers.size(); ++i)
+		{
+			UpdatePlayer(i);
+		}
+
+		UpdateBombs();
+		UpdateExplosions();
+		mEnemies.Update(kTickSeconds, mNavigationGrid);
+		UpdateHazards();
+
+		++mTick;
+	}
+
+	/************************************************************************/
+	uint32_t GameSimulation::CurrentTick() const
+	{
+		return mTick;
+	}
+
+	/************************************************************************/
+	uint64_t GameSimulation::GetStateHash() const
+	{
+		StateHash hash;
+		hash.Add(mTick);
+		hash.Add(mIsPerkConsumed);
+
+		for (auto& column : mMap.BlocksLayer)
+		{
+			hash.Add(column);
+		}
+
+		// field by field, the padding of the structures is not part of the state
+		for (auto& player : mPlayers)
+		{
+			hash.Add(player.Position);
+			hash.Add(player.PlayerPerks);
+			hash.Add(player.Input.Flags);
+			hash.Add(player.PreviousInput.Flags);
+			hash.Add(player.State);
+			hash.Add(player.DyingTicks);
+			hash.Add(player.BombCount);
+			hash.Add(player.HasEscaped);
+		}
+
+		for (auto& bomb : mBombs)
+		{
+			hash.Add(bomb.Tile);
+			hash.Add(bomb.Owner);
+			hash.Add(bomb.TicksLeft);
+			hash.Add(bomb.IsRemoteControlled);
+		}
+
+		for (auto& explosion : mExplosions)
+		{
+			hash.Add(explosion.Tile);
+			hash.Add(explosion.TicksLeft);
+		}
+
+		mEnemies.AddToHash(hash);
+
+		return hash.Value();
+	}
+
+	/************************************************************************/
+	bool GameSimulation::IsOver() const
+	{
+		for (auto& player : mPlayers)
+		{
+			if (player.State == PlayerState::Idle || player.State == PlayerState::Moving || player.State == PlayerState::Dying)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/************************************************************************/
+	void GameSimulation::Save(SnapshotWriter& writer) const
+	{
+		writer.Write(mTick);
+		writer.Write(mIsPerkConsumed);
+
+		// the whole map, a snapshot restores without the level it was taken from
+		writer.Write(mMap.PerkTile.Tile);
+		writer.Write(mMap.PerkTile.SpriteIndex);
+		writer.Write(mMap.DoorTile.Tile);
+		writer.Write(mMap.DoorTile.SpriteIndex);
+		writer.Write(mMap.PlayerSpawnTile);
+		writer.Write(mMap.PlayerSpawnTiles);
+		writer.Write(mMap.RestrictedTiles);
+		writer.Write(mMap.MapWidth);
+		writer.Write(mMap.MapHeight);
+		writer.Write(mMap.TileWidth);
+		writer.Write(mMap.TileHeight);
+		SaveLayer(writer, mMap.BackgroundLayer);
+		SaveLayer(writer, mMap.BlocksLayer);
+
+		// field by field, the padding of the structures is not part of the state
+		writer.Write(static_cast<uint32_t>(mPlayers.size()));
+		for (auto& player : mPlayers)
+		{
+			writer.Write(player.Position);
+			writer.Write(player.PlayerPerks);
+			writer.Write(player.Input.Flags);
+			writer.Write(player.PreviousInput.Flags);
+			writer.Write(player.State);
+			writer.Write(player.DyingTicks);
+			writer.Write(player.BombCount);
+			writer.Write(player.HasEscaped);
+		}
+
+		writer.Write(static_cast<uint32_t>(mBombs.size()));
+		for (auto& bomb : mBombs)
+		{
+			writer.Write(bomb.Tile);
+			writer.Write(bomb.Owner);
+			writer.Write(bomb.TicksLeft);
+			writer.Write(bomb.IsRemoteControlled);
+		}
+
+		writer.Write(static_cast<uint32_t>(mExplosions.size()));
+		for (auto& explosion : mExplosions)
+		{
+			writer.Write(explosion.Tile);
+			writer.Write(explosion.TicksLeft);
+		}
+
+		mEnemies.Save(writer);
+	}
+
+	/************************************************************************/
+	void GameSimulation::Restore(SnapshotReader& reader)
+	{
+		reader.Read(mTick);
+		reader.Read(mIsPerkConsumed);
+
+		reader.Read(mMap.PerkTile.Tile);
+		reader.Read(mMap.PerkTile.SpriteIndex);
+		reader.Read(mMap.DoorTile.Tile);
+		reader.Read(mMap.DoorTile.SpriteIndex);
+		reader.Read(mMap.PlayerSpawnTile);
+		reader.Read(mMap.PlayerSpawnTiles);
+		reader.Read(mMap.RestrictedTiles);
+		reader.Read(mMap.MapWidth);
+		reader.Read(mMap.MapHeight);
+		reader.Read(mMap.TileWidth);
+		reader.Read(mMap.TileHeight);
+		RestoreLayer(reader, mMap.BackgroundLayer);
+		RestoreLayer(reader, mMap.BlocksLayer);
+
+		if (mMap.BlocksLayer.size() != mMap.MapWidth || (mMap.MapWidth > 0 && mMap.BlocksLayer[0].size() != mMap.MapHeight))
+		{
+			throw runtime_error("snapshot map layers do not match the map size");
+		}
+		mMap.Chunks.Initialize(mMap);
+
+		uint32_t count;
+		reader.Read(count);
+		mPlayers.resize(count);
+		for (auto& player : mPlayers)
+		{
+			reader.Read(player.Position);
+			reader.Read(player.PlayerPerks);
+			reader.Read(player.Input.Flags);
+			reader.Read(player.PreviousInput.Flags);
+			reader.Read(player.State);
+			reader.Read(player.DyingTicks);
+			reader.Read(player.BombCount);
+			reader.Read(player.HasEscaped);
+		}
+
+		reader.Read(count);
+		mBombs.resize(count);
+		for (auto& bomb : mBombs)
+		{
+			reader.Read(bomb.Tile);
+			reader.Read(bomb.Owner);
+			reader.Read(bomb.TicksLeft);
+			reader.Read(bomb.IsRemoteControlled);
+		}
+
+		reader.Read(count);
+		mExplosions.resize(count);
+		for (auto& explosion : mExplosions)
+		{
+			reader.Read(explosion.Tile);
+			reader.Read(explosion.TicksLeft);
+		}
+
+		// the navigation grid is derived from the blocks, the bombs and the explosions
+		mNavigationGrid.Initialize(mMap);
+		for (auto& bomb : mBombs)
+		{
+			mNavigationGrid.AddBomb(bomb.Tile);
+		}
+		for (auto& explosion : mExplosions)
+		{
+			mNavigationGrid.AddExplosion(explosion.Tile);
+		}
+
+		mEnemies.Restore(reader, mNavigationGrid);
+	}
+
+	/************************************************************************/
+	const Map& GameSimulation::GetMap() const
+	{
+		return mMap;
+	}
+
+	/************************************************************************/
+	const NavigationGrid& GameSimulation::GetNavigationGrid() const
+	{
+		return mNavigationGrid;
+	}
+
+	/************************************************************************/
+	const EnemySimulation& GameSimulation::GetEnemies() const
+	{
+		return mEnemies;
+	}
+
+	/************************************************************************/
+	const vector<SimulatedPlayer>& GameSimulation::Players() const
+	{
+		return mPlayers;
+	}
+
+	/************************************************************************/
+	const vector<SimulatedBomb>& GameSimulation::Bombs() const
+	{
+		return mBombs;
+	}
+
+	/************************************************************************/
+	const vector<SimulatedExplosion>& GameSimulation::Explosions() const
+	{
+		return mExplosions;
+	}
+
+	/************************************************************************/
+	bool GameSimulation::IsPerkConsumed() const
+	{
+		return mIsPerkConsumed;
+	}
+
+	/************************************************************************/
+	void GameSimulation::UpdatePlayer(uint32_t index)
+	{
+		SimulatedPlayer& player = mPlayers[index];
+
+		switch (player.State)
+		{
+			case DirectXGame::PlayerState::Idle:
+			case DirectXGame::PlayerState::Moving:
+			{
+				if (player.Input.IsSet(PlayerInputFlags::PlaceBomb) && !player.PreviousInput.IsSet(PlayerInputFlags::PlaceBomb))
+				{
+					PlaceBomb(index);
+				}
+
+				if (player.Input.IsSet(PlayerInputFlags::Detonate) && !player.PreviousInput.IsSet(PlayerInputFlags::Detonate) && player.PlayerPerks.Remote)
+				{
+					for (uint32_t i = 0; i < mBombs.size();)
+					{
+						if (mBombs[i].Owner == index)
+						{
+							ExplodeBomb(i);
+						}
+						else
+						{
+							++i;
+						}
+					}
+				}
+
+				// opposite directions of an axis cancel each other
+				int32_t directionX = (player.Input.IsSet(PlayerInputFlags::Right) ? 1 : 0) - (player.Input.IsSet(PlayerInputFlags::Left) ? 1 : 0);
+				int32_t directionY = (player.Input.IsSet(PlayerInputFlags::Up) ? 1 : 0) - (player.Input.IsSet(PlayerInputFlags::Down) ? 1 : 0);
+				player.State = directionX != 0 || directionY != 0 ? PlayerState::Moving : PlayerState::Idle;
+
+				MovePlayer(player, directionX * (kBaseSpeed.x + player.PlayerPerks.Skate * kSpeedIncrement.x), 0);
+				MovePlayer(player, 0, directionY * (kBaseSpeed.y + player.PlayerPerks.Skate * kSpeedIncrement.y));
+
+				// the perk and the door are under soft blocks, they can only be picked once their block is destroyed
+				XMUINT2 tile = GetTile(player.Position);
+				if (mMap.BlocksLayer[tile.x][tile.y] == static_cast<uint8_t>(SpriteIndicesInMap::None))
+				{
+					if (!mIsPerkConsumed && tile.x == mMap.PerkTile.Tile.x && tile.y == mMap.PerkTile.Tile.y)
+					{
+						ApplyPerk(player);
+					}
+					else if (mIsPerkConsumed && tile.x == mMap.DoorTile.Tile.x && tile.y == mMap.DoorTile.Tile.y)
+					{
+						player.HasEscaped = true;
+						player.State = PlayerState::Dead;
+					}
+				}
+				break;
+			}
+
+			case DirectXGame::PlayerState::Dying:
+			{
+				if (++player.DyingTicks >= kDyingTicks)
+				{
+					player.State = PlayerState::Dead;
+				}
+				break;
+			}
+
+			case DirectXGame::PlayerState::Dead:
+			default:
+				break;
+		}
+	}
+
+	/************************************************************************/
+	void GameSimulation::MovePlayer(SimulatedPlayer& player, int32_t deltaX, int32_t deltaY)
+	{
+		if (deltaX == 0 && deltaY == 0)
+		{
+			return;
+		}
+
+		XMINT2 target(player.Position.x + deltaX, player.Position.y + deltaY);
+		if (!IsBlocked(player, target))
+		{
+			player.Position = target;
+			return;
+		}
+
+		// blocked, slide toward the center of the row or column if the player nearly cleared the corner
+		XMUINT2 tile = GetTile(player.Position);
+		int32_t offset = deltaX != 0 ? player.Position.y - static_cast<int32_t>(tile.y) * kTileUnits : player.Position.x - static_cast<int32_t>(tile.x) * kTileUnits;
+		int32_t distance = offset < 0 ? -offset : offset;
+		if (distance == 0 || distance > kCornerTolerance)
+		{
+			return;
+		}
+
+		XMINT2 aligned = deltaX != 0 ? XMINT2(target.x, player.Position.y - offset) : XMINT2(player.Position.x - offset, target.y);
+		if (IsBlocked(player, aligned))
+		{
+			return;
+		}
+
+		int32_t speed = deltaX != 0 ? (deltaX < 0 ? -deltaX : deltaX) : (deltaY < 0 ? -deltaY : deltaY);
+		int32_t step = (speed < distance ? speed : distance) * (offset < 0 ? -1 : 1);
+		if (deltaX != 0)
+		{
+			player.Position.y -= step;
+		}
+		else
+		{
+			player.Position.x -= step;
+		}
+	}
+
+	/************************************************************************/
+	void GameSimulation::PlaceBomb(uint32_t index)
+	{
+		SimulatedPlayer& player = mPlayers[index];
+		if (player.BombCount > player.PlayerPerks.BombUp)
+		{
+			return;
+		}
+
+		// one bomb per tile, whoever placed it
+		XMUINT2 tile = GetTile(player.Position);
+		if (!mNavigationGrid.IsInside(tile) || mNavigationGrid.HasFlag(mNavigationGrid.GetIndex(tile), NavigationCellFlags::Bomb))
+		{
+			return;
+		}
+
+		SimulatedBomb bomb;
+		bomb.Tile = tile;
+		bomb.Owner = index;
+		bomb.TicksLeft = kBombTicks;
+		bomb.IsRemoteControlled = player.PlayerPerks.Remote;
+		mBombs.push_back(bomb);
+
+		++player.BombCount;
+		mNavigationGrid.AddBomb(tile);
+	}
+
+	/************************************************************************/
+	void GameSimulation::ApplyPerk(SimulatedPlayer& player)
+	{
+		switch (static_cast<PerksIndicesInSpriteSheet>(mMap.PerkTile.SpriteIndex))
+		{
+			case DirectXGame::PerksIndicesInSpriteSheet::BombUp:
+			{
+				++player.PlayerPerks.BombUp;
+				break;
+			}
+
+			case DirectXGame::PerksIndicesInSpriteSheet::Fire:
+			{
+				++player.PlayerPerks.Fire;
+				break;
+			}
+
+			case DirectXGame::PerksIndicesInSpriteSheet::PassBomb:
+			{
+				player.PlayerPerks.PassBomb = true;
+				break;
+			}
+
+			case DirectXGame::PerksIndicesInSpriteSheet::PassSoftBlock:
+			{
+				player.PlayerPerks.PassSoftBlocks = true;
+				break;
+			}
+
+			case DirectXGame::PerksIndicesInSpriteSheet::Remote:
+			{
+				player.PlayerPerks.Remote = true;
+				break;
+			}
+
+			case DirectXGame::PerksIndicesInSpriteSheet::Skate:
+			{
+				++player.PlayerPerks.Skate;
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		mIsPerkConsumed = true;
+	}
+
+	/************************************************************************/
+	void GameSimulation::UpdateBombs()
+	{
+		// like Bomb, an explosion does not set the other bombs off
+		for (uint32_t i = 0; i < mBombs.size();)
+		{
+			if (!mBombs[i].IsRemoteControlled && --mBombs[i].TicksLeft == 0)
+			{
+				ExplodeBomb(i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	/************************************************************************/
+	void GameSimulation::ExplodeBomb(uint32_t bombIndex)
+	{
+		ProfileScope scope("GameSimulation::ExplodeBomb");
+
+		SimulatedBomb bomb = mBombs[bombIndex];
+		mBombs.erase(mBombs.begin() + bombIndex);
+		mNavigationGrid.RemoveBomb(bomb.Tile);
+
+		SimulatedPlayer& owner = mPlayers[bomb.Owner];
+		--owner.BombCount;
+
+		// the range is read when the bomb goes off, a fire perk picked meanwhile counts
+		BlastPropagation::GetInstance().Propagate(mMap, bomb.Tile, owner.PlayerPerks.Fire, mFlames, mDestroyedBlocks);
+
+		for (auto& flame : mFlames)
+		{
+			SimulatedExplosion explosion;
+			explosion.Tile = flame.Tile;
+			explosion.TicksLeft = kExplosionTicks;
+			mExplosions.push_back(explosion);
+			mNavigationGrid.AddExplosion(flame.Tile);
+		}
+
+		for (auto& block : mDestroyedBlocks)
+		{
+			mMap.BlocksLayer[block.x][block.y] = static_cast<uint8_t>(SpriteIndicesInMap::None);
+			mMap.Chunks.OnBlockChanged(mMap, block);
+			mNavigationGrid.RefreshTile(mMap, block);
+		}
+	}
+
+	/************************************************************************/
+	void GameSimulation::UpdateExplosions()
+	{
+		for (uint32_t i = 0; i < mExplosions.size();)
+		{
+			if (--mExplosions[i].TicksLeft == 0)
+			{
+				mNavigationGrid.RemoveExplosion(mExplosions[i].Tile);
+				mExplosions.erase(mExplosions.begin() + i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	/************************************************************************/
+	void GameSimulation::UpdateHazards()
+	{
+		for (auto& player : mPlayers)
+		{
+			if (player.State != PlayerState::Idle && player.State != PlayerState::Moving)
+			{
+				continue;
+			}
+
+			XMFLOAT2 coordinates(static_cast<float_t>(player.Position.x) / kTileUnits, static_cast<float_t>(player.Position.y) / kTileUnits);
+			if (TouchesExplosion(player.Position) || mEnemies.Overlaps(coordinates, kEnemyCollisionDistance))
+			{
+				player.State = PlayerState::Dying;
+				player.DyingTicks = 0;
+			}
+		}
+	}
+
+	/************************************************************************/
+	bool GameSimulation::IsBlocked(const SimulatedPlayer& player, const XMINT2& position) const
+	{
+		const int32_t halfTile = kTileUnits / 2;
+		if (position.x - kBlockExtent + halfTile < 0 || position.y - kBlockExtent + halfTile < 0)
+		{
+			return true;
+		}
+
+		const uint32_t firstX = static_cast<uint32_t>((position.x - kBlockExtent + halfTile) / kTileUnits);
+		const uint32_t lastX = static_cast<uint32_t>((position.x + kBlockExtent + halfTile - 1) / kTileUnits);
+		const uint32_t firstY = static_cast<uint32_t>((position.y - kBlockExtent + halfTile) / kTileUnits);
+		const uint32_t lastY = static_cast<uint32_t>((position.y + kBlockExtent + halfTile - 1) / kTileUnits);
+
+		for (uint32_t y = firstY; y <= lastY; ++y)
+		{
+			for (uint32_t x = firstX; x <= lastX; ++x)
+			{
+				XMUINT2 tile(x, y);
+				if (!mNavigationGrid.IsInside(tile))
+				{
+					return true;
+				}
+
+				uint32_t index = mNavigationGrid.GetIndex(tile);
+				if (mNavigationGrid.HasFlag(index, NavigationCellFlags::SolidBlock) ||
+					(mNavigationGrid.HasFlag(index, NavigationCellFlags::SoftBlock) && !player.PlayerPerks.PassSoftBlocks))
+				{
+					return true;
+				}
+
+				// a player can always walk off the bomb it is standing on
+				if (mNavigationGrid.HasFlag(index, NavigationCellFlags::Bomb) && !player.PlayerPerks.PassBomb && !IsBombUnder(player, tile))
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/************************************************************************/
+	bool GameSimulation::IsBombUnder(const SimulatedPlayer& player, const XMUINT2& tile) const
+	{
+		const int32_t tileCenterX = static_cast<int32_t>(tile.x) * kTileUnits;
+		const int32_t tileCenterY = static_cast<int32_t>(tile.y) * kTileUnits;
+		const int32_t reach = kBlockExtent + kTileUnits / 2;
+
+		return player.Position.x > tileCenterX - reach && player.Position.x < tileCenterX + reach &&
+			player.Position.y > tileCenterY - reach && player.Position.y < tileCenterY + reach;
+	}
+
+	/************************************************************************/
+	bool GameSimulation::TouchesExplosion(const XMINT2& position) const
+	{
+		const int32_t halfTile = kTileUnits / 2;
+		const uint32_t firstX = static_cast<uint32_t>((position.x - kExplosionExtent + halfTile) / kTileUnits);
+		const uint32_t lastX = static_cast<uint32_t>((position.x + kExplosionExtent + halfTile - 1) / kTileUnits);
+		const uint32_t firstY = static_cast<uint32_t>((position.y - kExplosionExtent + halfTile) / kTileUnits);
+		const uint32_t lastY = static_cast<uint32_t>((position.y + kExplosionExtent + halfTile - 1) / kTileUnits);
+
+		for (uint32_t y = firstY; y <= lastY; ++y)
+		{
+			for (uint32_t x = firstX; x <= lastX; ++x)
+			{
+				XMUINT2 tile(x, y);
+				if (mNavigationGrid.IsInside(tile) && mNavigationGrid.HasFlag(mNavigationGrid.GetIndex(tile), NavigationCellFlags::Explosion))
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/************************************************************************/
+	void GameSimulation::SaveLayer(SnapshotWriter& writer, const vector<vector<uint8_t>>& layer)
+	{
+		writer.Write(static_cast<uint32_t>(layer.size()));
+		for (auto& column : layer)
+		{
+			writer.Write(column);
+		}
+	}
+
+	/************************************************************************/
+	void GameSimulation::RestoreLayer(SnapshotReader& reader, vector<vector<uint8_t>>& layer)
+	{
+		uint32_t columnCount;
+		reader.Read(columnCount);
+		layer.resize(columnCount);
+		for (auto& column : layer)
+		{
+			reader.Read(column);
+		}
+	}
+
+	/************************************************************************/
+	XMUINT2 GameSimulation::GetTile(const XMINT2& position)
+	{
+		return XMUINT2(static_cast<uint32_t>((position.x + kTileUnits / 2) / kTileUnits), static_cast<uint32_t>((position.y + kTileUnits / 2) / kTileUnits));
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "EnemySimulation.h"
+#include "BlastPropagation.h"
+#include "PlayerInput.h"
+
+namespace DirectXGame
+{
+	/** Structure holding the options a simulated game is started with.
+	 * Two simulations started with the same options and the same basic map generate the same level.
+	*/
+	struct GameSimulationOptions
+	{
+		GameSimulationOptions() :
+			Seed(0), PlayerCount(2), EnemyCount(6)
+		{
+		}
+
+		uint32_t Seed;
+		uint32_t PlayerCount;
+		uint32_t EnemyCount;
+	};
+
+	/** Structure representing a player of a simulated game.
+	 * Positions are fixed point tile coordinates, kTileUnits per tile, a player standing on the center of the tile (x, y)
+	 * is at (x * kTileUnits, y * kTileUnits).
+	*/
+	struct SimulatedPlayer
+	{
+		DirectX::XMINT2 Position;
+		Perks PlayerPerks;
+		PlayerInput Input;
+		PlayerInput PreviousInput;
+		PlayerState State;
+		uint32_t DyingTicks;
+		uint32_t BombCount;
+		bool HasEscaped;
+	};
+
+	/** Structure representing a ticking bomb of a simulated game.
+	*/
+	struct SimulatedBomb
+	{
+		DirectX::XMUINT2 Tile;
+		uint32_t Owner;
+		uint32_t TicksLeft;
+		bool IsRemoteControlled;
+	};
+
+	/** Structure representing a tile covered by the flames of a simulated explosion.
+	*/
+	struct SimulatedExplosion
+	{
+		DirectX::XMUINT2 Tile;
+		uint32_t TicksLeft;
+	};
+
+	/** Class simulating a whole game without rendering it, one fixed tick at a time.
+	 * The state only changes through the inputs given to Tick: there is no timer, the players, bombs and explosions
+	 * count in integer ticks and positions, and the enemies own a seeded generator and are always updated with the same
+	 * time step in the same order. Two simulations built from the same options and played with the same inputs stay
+	 * bit identical, which GetStateHash lets peers check every tick.
+	 * The rules follow Player, Bomb and MapRenderable, the speeds and timings being rounded to whole units and ticks.
+	 *@see LockstepSession
+	*/
+	class GameSimulation final
+	{
+	public:
+
+		GameSimulation();
+
+		void Initialize(const Map& basicMap, const GameSimulationOptions& options);
+		void Tick(const PlayerInput* inputs);
+
+		uint32_t CurrentTick() const;
+		uint64_t GetStateHash() const;
+		bool IsOver() const;
+
+		void Save(SnapshotWriter& writer) const;
+		void Restore(SnapshotReader& reader);
+
+		const Map& GetMap() const;
+		const NavigationGrid& GetNavigationGrid() const;
+		const EnemySimulation& GetEnemies() const;
+		const std::vector<SimulatedPlayer>& Players() const;
+		const std::vector<SimulatedBomb>& Bombs() const;
+		const std::vector<SimulatedExplosion>& Explosions() const;
+		bool IsPerkConsumed() const;
+
+		static const int32_t kTileUnits;
+		static const std::double_t kTickSeconds;
+
+	private:
+
+		void UpdatePlayer(uint32_t index);
+		void MovePlayer(SimulatedPlayer& player, int32_t deltaX, int32_t deltaY);
+		void PlaceBomb(uint32_t index);
+		void ApplyPerk(SimulatedPlayer& player);
+		void UpdateBombs();
+		void ExplodeBomb(uint32_t bombIndex);
+		void UpdateExplosions();
+		void UpdateHazards();
+
+		bool IsBlocked(const SimulatedPlayer& player, const DirectX::XMINT2& position) const;
+		bool IsBombUnder(const SimulatedPlayer& player, const DirectX::XMUINT2& tile) const;
+		bool TouchesExplosion(const DirectX::XMINT2& position) const;
+
+		static DirectX::XMUINT2 GetTile(const DirectX::XMINT2& position);
+		static void SaveLayer(SnapshotWriter& writer, const std::vector<std::vector<uint8_t>>& layer);
+		static void RestoreLayer(SnapshotReader& reader, std::vector<std::vector<uint8_t>>& layer);
+
+		Map mMap;
+		NavigationGrid mNavigationGrid;
+		EnemySimulation mEnemies;
+		std::vector<SimulatedPlayer> mPlayers;
+		std::vector<SimulatedBomb> mBombs;
+		std::vector<SimulatedExplosion> mExplosions;
+		uint32_t mTick;
+		bool mIsPerkConsumed;
+
+		// explosion scratch
+		std::vector<BlastTile> mFlames;
+		std::vector<DirectX::XMUINT2> mDestroyedBlocks;
+
+		static const DirectX::XMINT2 kBaseSpeed;
+		static const DirectX::XMINT2 kSpeedIncrement;
+		static const int32_t kBlockExtent;
+		static const int32_t kExplosionExtent;
+		static const int32_t kCornerTolerance;
+		static const uint32_t kBombTicks;
+		static const uint32_t kExplosionTicks;
+		static const uint32_t kDyingTicks;
+		static const uint32_t kEnemyMinSpawnDistance;
+		static const std::float_t kEnemyCollisionDistance;
+	};
+}
@@ -0,0 +1,806 @@
+#include "pch.h"
+#include "HeadlessTools.h"
+#include "LevelCorpusGenerator.h"
+#include "PathfindingBenchmark.h"
+#include "EnemyBenchmark.h"
+#include "LockstepTest.h"
+#include "SnapshotBenchmark.h"
+#include "RollbackTest.h"
+#include "ReplayRecorder.h"
+#include "ReplayPlayer.h"
+#include "BatchSimulationRunner.h"
+#include "Profiler.h"
+#include "MicroBenchmarks.h"
+#include "FrameTimeRegression.h"
+#include "RandomInputScript.h"
+#include "LevelGenerator.h"
+#include "MapParser.h"
+#include "AtlasPacker.h"
+#include "TileGridValidator.h"
+#include "RenderStateCacheValidator.h"
+#include "UploadRingValidator.h"
+#include "RenderSortValidator.h"
+#include <sstream>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const string HeadlessTools::kGenerateCorpusCommand = "--generate-corpus";
+	const string HeadlessTools::kBenchmarkPathfindingCommand = "--benchmark-pathfinding";
+	const string HeadlessTools::kBenchmarkEnemiesCommand = "--benchmark-enemies";
+	const string HeadlessTools::kTestLockstepCommand = "--test-lockstep";
+	const string HeadlessTools::kBenchmarkSnapshotsCommand = "--benchmark-snapshots";
+	const string HeadlessTools::kTestRollbackCommand = "--test-rollback";
+	const string HeadlessTools::kRecordReplayCommand = "--record-replay";
+	const string HeadlessTools::kPlayReplayCommand = "--play-replay";
+	const string HeadlessTools::kRunBatchCommand = "--run-batch";
+	const string HeadlessTools::kTraceReplayCommand = "--trace-replay";
+	const string HeadlessTools::kMicroBenchmarksCommand = "--micro-benchmarks";
+	const string HeadlessTools::kCheckFrameBudgetCommand = "--check-frame-budget";
+	const string HeadlessTools::kPackAtlasCommand = "--pack-atlas";
+	const string HeadlessTools::kValidateTileGridCommand = "--validate-tile-grid";
+	const string HeadlessTools::kValidateRenderStateCacheCommand = "--validate-render-state-cache";
+	const string HeadlessTools::kValidateUploadRingCommand = "--validate-upload-ring";
+	const string HeadlessTools::kValidateRenderSortCommand = "--validate-render-sort";
+
+	/************************************************************************/
+	HeadlessTools& HeadlessTools::GetInstance()
+	{
+		static HeadlessTools sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	vector<string> HeadlessTools::ToArguments(Platform::Array<Platform::String^>^ arguments)
+	{
+		vector<string> result;
+		if (arguments == nullptr)
+		{
+			return result;
+		}
+
+		for (auto argument : arguments)
+		{
+			// tools arguments are plain ascii
+			string narrowArgument;
+			for (const wchar_t* character = argument->Data(); *character != L'\0'; ++character)
+			{
+				narrowArgument.push_back(static_cast<char>(*character));
+			}
+			result.push_back(narrowArgument);
+		}
+
+		return result;
+	}
+
+	/************************************************************************/
+	bool HeadlessTools::TryRun(const vector<string>& arguments, int32_t& exitCode)
+	{
+		// the first argument is the executable
+		if (arguments.size() < 2)
+		{
+			return false;
+		}
+
+		try
+		{
+			if (arguments[1] == kGenerateCorpusCommand)
+			{
+				exitCode = RunGenerateCorpus(arguments);
+				return true;
+			}
+			if (arguments[1] == kBenchmarkPathfindingCommand)
+			{
+				exitCode = RunPathfindingBenchmark(arguments);
+				return true;
+			}
+			if (arguments[1] == kBenchmarkEnemiesCommand)
+			{
+				exitCode = RunEnemyBenchmark(arguments);
+				return true;
+			}
+			if (arguments[1] == kTestLockstepCommand)
+			{
+				exitCode = RunLockstepTest(arguments);
+				return true;
+			}
+			if (arguments[1] == kBenchmarkSnapshotsCommand)
+			{
+				exitCode = RunSnapshotBenchmark(arguments);
+				return true;
+			}
+			if (arguments[1] == kTestRollbackCommand)
+			{
+				exitCode = RunRollbackTest(arguments);
+				return true;
+			}
+			if (arguments[1] == kRecordReplayCommand)
+			{
+				exitCode = RunRecordReplay(arguments);
+				return true;
+			}
+			if (arguments[1] == kPlayReplayCommand)
+			{
+				exitCode = RunPlayReplay(arguments);
+				return true;
+			}
+			if (arguments[1] == kRunBatchCommand)
+			{
+				exitCode = RunBatch(arguments);
+				return true;
+			}
+			if (arguments[1] == kTraceReplayCommand)
+			{
+				exitCode = RunTraceReplay(arguments);
+				return true;
+			}
+			if (arguments[1] == kMicroBenchmarksCommand)
+			{
+				exitCode = RunMicroBenchmarks(arguments);
+				return true;
+			}
+			if (arguments[1] == kCheckFrameBudgetCommand)
+			{
+				exitCode = RunFrameBudgetCheck(arguments);
+				return true;
+			}
+			if (arguments[1] == kPackAtlasCommand)
+			{
+				exitCode = RunPackAtlas(arguments);
+				return true;
+			}
+			if (arguments[1] == kValidateTileGridCommand)
+			{
+				exitCode = RunTileGridValidation(arguments);
+				return true;
+			}
+			if (arguments[1] == kValidateRenderStateCacheCommand)
+			{
+				exitCode = RunRenderStateCacheValidation(arguments);
+				return true;
+			}
+			if (arguments[1] == kValidateUploadRingCommand)
+			{
+				exitCode = RunUploadRingValidation(arguments);
+				return true;
+			}
+			if (arguments[1] == kValidateRenderSortCommand)
+			{
+				exitCode = RunRenderSortValidation(arguments);
+				return true;
+			}
+		}
+		catch (const exception& e)
+		{
+			Log(string("error: ") + e.what());
+			PrintUsage();
+			exitCode = 1;
+			return true;
+		}
+
+		return false;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunGenerateCorpus(const vector<string>& arguments)
+	{
+		if (arguments.size() < 5)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		LevelCorpusOptions options;
+		options.FirstSeed = stoul(arguments[2]);
+		options.LevelCount = stoul(arguments[3]);
+		options.OutputPath = arguments[4];
+		if (arguments.size() > 5)
+		{
+			options.ThreadCount = stoul(arguments[5]);
+		}
+
+		LevelCorpusReport report = LevelCorpusGenerator::GetInstance().Generate(options);
+
+		stringstream message;
+		message << "levels: " << report.LevelCount << ", fair: " << report.FairLevelCount << ", threads: " << report.ThreadCount << endl;
+		message << "elapsed: " << report.ElapsedSeconds << " s, " << report.LevelsPerSecond << " levels/s, " 
+			<< report.LevelsPerSecondPerCore << " levels/s/core" << endl;
+		for (size_t i = 0; i < report.LevelsPerSecondOfEachThread.size(); ++i)
+		{
+			message << "  thread " << i << ": " << report.LevelsPerSecondOfEachThread[i] << " levels/s" << endl;
+		}
+		message << "corpus: " << options.OutputPath << " (" << report.CorpusSizeInBytes << " bytes)";
+		Log(message.str());
+
+		return 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunPathfindingBenchmark(const vector<string>& arguments)
+	{
+		PathfindingBenchmarkOptions options;
+		if (arguments.size() > 2)
+		{
+			options.LevelCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			options.AgentCount = stoul(arguments[3]);
+		}
+		if (arguments.size() > 4)
+		{
+			options.TicksPerLevel = stoul(arguments[4]);
+		}
+
+		PathfindingBenchmarkReport report = PathfindingBenchmark::GetInstance().Run(options);
+
+		stringstream message;
+		message << "levels: " << options.LevelCount << ", agents: " << options.AgentCount << ", ticks: " << report.TickCount << endl;
+		message << "queries: " << report.QueryCount << ", flood fills: " << report.FloodFillCount << " (" << report.ReusedFloodFillCount 
+			<< " reused), paths: " << report.PathCount << endl;
+		message << "elapsed: " << report.ElapsedSeconds << " s, " << report.QueriesPerSecond << " queries/s, " 
+			<< report.MillisecondsPerTick << " ms/tick, worst tick: " << report.WorstTickMilliseconds << " ms";
+		Log(message.str());
+
+		return 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunEnemyBenchmark(const vector<string>& arguments)
+	{
+		EnemyBenchmarkOptions options;
+		if (arguments.size() > 2)
+		{
+			options.LevelCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			options.EnemyCount = stoul(arguments[3]);
+		}
+		if (arguments.size() > 4)
+		{
+			options.TicksPerLevel = stoul(arguments[4]);
+		}
+
+		EnemyBenchmarkReport report = EnemyBenchmark::GetInstance().Run(options);
+
+		stringstream message;
+		message << "levels: " << options.LevelCount << ", enemies: " << options.EnemyCount << ", ticks: " << report.TickCount << endl;
+		message << "enemy updates: " << report.EnemyUpdateCount << ", collision queries: " << report.CollisionQueryCount << endl;
+		message << "elapsed: " << report.ElapsedSeconds << " s, " << report.EnemyUpdatesPerSecond << " enemy updates/s, " 
+			<< report.MillisecondsPerTick << " ms/tick, worst tick: " << report.WorstTickMilliseconds << " ms";
+		Log(message.str());
+
+		return 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunLockstepTest(const vector<string>& arguments)
+	{
+		LockstepTestOptions options;
+		if (arguments.size() > 2)
+		{
+			options.RoundCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			options.TicksPerRound = stoul(arguments[3]);
+		}
+		if (arguments.size() > 4)
+		{
+			options.PlayerCount = stoul(arguments[4]);
+		}
+		if (arguments.size() > 5)
+		{
+			options.LossPercent = stoul(arguments[5]);
+		}
+
+		LockstepTestReport report = LockstepTest::GetInstance().Run(options);
+
+		stringstream message;
+		message << "rounds: " << options.RoundCount << ", players: " << options.PlayerCount << ", ticks: " << report.TickCount << endl;
+		message << "hashes compared: " << report.ComparedHashCount << ", messages: " << report.MessageCount << ", dropped: " << report.DroppedMessageCount << endl;
+		message << "elapsed: " << report.ElapsedSeconds << " s, " << report.TicksPerSecond << " ticks/s" << endl;
+		if (report.DesyncedRoundCount > 0)
+		{
+			message << "DESYNC in " << report.DesyncedRoundCount << " rounds, first in round " << report.FirstDesyncRound 
+				<< " at tick " << report.FirstDesyncTick;
+		}
+		else
+		{
+			message << "all peers in sync";
+		}
+		Log(message.str());
+
+		return report.DesyncedRoundCount > 0 ? 1 : 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunSnapshotBenchmark(const vector<string>& arguments)
+	{
+		SnapshotBenchmarkOptions options;
+		if (arguments.size() > 2)
+		{
+			options.LevelCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			options.TicksPerLevel = stoul(arguments[3]);
+		}
+
+		SnapshotBenchmarkReport report = SnapshotBenchmark::GetInstance().Run(options);
+
+		stringstream message;
+		message << "levels: " << options.LevelCount << ", snapshots: " << report.SnapshotCount << ", mismatches: " << report.MismatchCount << endl;
+		message << "bytes per snapshot: " << report.BytesPerSnapshot << ", bytes per delta: " << report.BytesPerDelta << endl;
+		message << "saves: " << report.SavesPerSecond << "/s, restores: " << report.RestoresPerSecond << "/s, delta encodes: " 
+			<< report.DeltaEncodesPerSecond << "/s, delta decodes: " << report.DeltaDecodesPerSecond << "/s";
+		Log(message.str());
+
+		return report.MismatchCount > 0 ? 1 : 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunRollbackTest(const vector<string>& arguments)
+	{
+		RollbackTestOptions options;
+		if (arguments.size() > 2)
+		{
+			options.RoundCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			options.LatencyTicks = stoul(arguments[3]);
+		}
+		if (arguments.size() > 4)
+		{
+			options.LossPercent = stoul(arguments[4]);
+		}
+
+		RollbackTestReport report = RollbackTest::GetInstance().Run(options);
+
+		stringstream message;
+		message << "rounds: " << options.RoundCount << ", latency: " << options.LatencyTicks << " ticks, loss: " << options.LossPercent << "%" << endl;
+		message << "frames: " << report.FrameCount << ", stalled: " << report.StalledFrameCount << ", messages: " << report.MessageCount 
+			<< " (" << report.DroppedMessageCount << " dropped)" << endl;
+		message << "rollbacks: " << report.RollbackCount << ", resimulated ticks: " << report.ResimulatedTickCount << ", depth: " 
+			<< report.MeanRollbackDepth << " mean, " << report.MaxRollbackDepth << " max" << endl;
+		message << "resimulation: " << report.MillisecondsPerRollback << " ms per rollback, worst frame: " << report.WorstResimulationMilliseconds << " ms" << endl;
+		message << "full " << options.MaxRollback << " ticks rollback: " << report.FullRollbackMilliseconds << " ms mean, " 
+			<< report.WorstFullRollbackMilliseconds << " ms worst, frame budget: " << RollbackTest::kFrameBudgetMilliseconds << " ms" << endl;
+		message << "hashes compared: " << report.ComparedHashCount << ", desynced rounds: " << report.DesyncedRoundCount 
+			<< ", rounds not matching the reference: " << report.MismatchedRoundCount;
+		Log(message.str());
+
+		return report.DesyncedRoundCount > 0 || report.MismatchedRoundCount > 0 ? 1 : 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunRecordReplay(const vector<string>& arguments)
+	{
+		if (arguments.size() < 3)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		const string outputPath = arguments[2];
+		GameSimulationOptions options;
+		uint32_t tickCount = 3600;
+		if (arguments.size() > 3)
+		{
+			options.Seed = stoul(arguments[3]);
+		}
+		if (arguments.size() > 4)
+		{
+			tickCount = stoul(arguments[4]);
+		}
+		if (arguments.size() > 5)
+		{
+			options.PlayerCount = stoul(arguments[5]);
+		}
+
+		// the players are scripted bots, the replay only sees their inputs
+		GameSimulation simulation;
+		simulation.Initialize(MapParser::GetInstance().ParseMapSpriteSheet(), options);
+		ReplayRecorder recorder(simulation, options);
+
+		vector<RandomInputScript> scripts;
+		for (uint32_t player = 0; player < options.PlayerCount; ++player)
+		{
+			scripts.push_back(RandomInputScript(options.Seed * LevelGenerator::kMaxPlayerCount + player + 1));
+		}
+
+		vector<PlayerInput> inputs(options.PlayerCount);
+		for (uint32_t tick = 0; tick < tickCount; ++tick)
+		{
+			for (uint32_t player = 0; player < options.PlayerCount; ++player)
+			{
+				inputs[player] = scripts[player].Next();
+			}
+			recorder.Tick(inputs.data());
+		}
+
+		const Replay& replay = recorder.Finish();
+		replay.SaveToFile(outputPath);
+
+		vector<uint8_t> bytes;
+		replay.Save(bytes);
+
+		stringstream message;
+		message << "ticks: " << replay.TickCount() << ", players: " << options.PlayerCount << ", seed: " << options.Seed << endl;
+		message << "runs: " << replay.RunCount() << ", checkpoints: " << replay.Checkpoints().size() << endl;
+		message << "replay: " << outputPath << " (" << bytes.size() << " bytes)";
+		Log(message.str());
+
+		return 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunPlayReplay(const vector<string>& arguments)
+	{
+		if (arguments.size() < 3)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		uint32_t repeatCount = 1;
+		if (arguments.size() > 3)
+		{
+			repeatCount = stoul(arguments[3]);
+		}
+
+		Replay replay;
+		replay.LoadFromFile(arguments[2]);
+
+		ReplayReport report = ReplayPlayer::GetInstance().Play(MapParser::GetInstance().ParseMapSpriteSheet(), replay, repeatCount);
+
+		stringstream message;
+		message << "replay: " << arguments[2] << ", ticks: " << replay.TickCount() << ", players: " << replay.Options().PlayerCount 
+			<< ", seed: " << replay.Options().Seed << ", played " << repeatCount << " times" << endl;
+		message << "elapsed: " << report.ElapsedSeconds << " s, " << report.TicksPerSecond << " ticks/s, " 
+			<< report.RealTimeFactor << "x real time" << endl;
+		message << "checkpoints: " << report.CheckpointCount << ", mismatched: " << report.MismatchCount;
+		if (report.MismatchCount > 0)
+		{
+			message << ", first at tick " << report.FirstMismatchTick;
+		}
+		Log(message.str());
+
+		return report.MismatchCount > 0 ? 1 : 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunBatch(const vector<string>& arguments)
+	{
+		BatchSimulationOptions options;
+		if (arguments.size() > 2)
+		{
+			options.MatchCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			options.ThreadCount = stoul(arguments[3]);
+		}
+		if (arguments.size() > 4)
+		{
+			options.MaxTicksPerMatch = stoul(arguments[4]);
+		}
+
+		Replay replay;
+		if (arguments.size() > 5)
+		{
+			replay.LoadFromFile(arguments[5]);
+			options.InputReplay = &replay;
+			options.FirstSeed = replay.Options().Seed;
+			options.PlayerCount = replay.Options().PlayerCount;
+			options.EnemyCount = replay.Options().EnemyCount;
+		}
+
+		BatchSimulationReport report = BatchSimulationRunner::GetInstance().Run(options);
+
+		stringstream message;
+		message << "matches: " << report.MatchCount << ", players: " << options.PlayerCount << ", inputs: " 
+			<< (options.InputReplay != nullptr ? arguments[5] : "bots") << endl;
+		message << "escaped: " << report.EscapedMatchCount << ", lost: " << report.LostMatchCount << ", timed out: " << report.TimedOutMatchCount 
+			<< ", enemies killed: " << report.KilledEnemyCount << endl;
+		for (uint32_t player = 0; player < options.PlayerCount; ++player)
+		{
+			message << "  player " << player << ": " << report.EscapesOfEachPlayer[player] << " escapes, " << report.DeathsOfEachPlayer[player] << " deaths" << endl;
+		}
+		message << "ticks: " << report.TickCount << ", " << report.MeanTicksPerMatch << " per match" << endl;
+		message << "elapsed: " << report.ElapsedSeconds << " s, threads: " << report.ThreadCount << ", " << report.TicksPerSecond << " ticks/s, " 
+			<< report.TicksPerSecondPerCore << " ticks/s/core, parallel efficiency: " << report.ParallelEfficiency << endl;
+		for (size_t i = 0; i < report.TicksPerSecondOfEachThread.size(); ++i)
+		{
+			message << "  thread " << i << ": " << report.TicksPerSecondOfEachThread[i] << " ticks/s" << endl;
+		}
+		message << "real time factor: " << report.TicksPerSecond * GameSimulation::kTickSeconds << "x";
+		Log(message.str());
+
+		return 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunTraceReplay(const vector<string>& arguments)
+	{
+		if (arguments.size() < 4)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		Profiler& profiler = Profiler::GetInstance();
+		profiler.SetThreadName("Main");
+
+		Replay replay;
+		replay.LoadFromFile(arguments[2]);
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+
+		profiler.Clear();
+		profiler.SetEnabled(true);
+		ReplayReport report = ReplayPlayer::GetInstance().Play(basicMap, replay);
+		profiler.SetEnabled(false);
+
+		profiler.SaveChromeTrace(arguments[3]);
+
+		stringstream message;
+		message << "replay: " << arguments[2] << ", ticks: " << report.TickCount << ", elapsed: " << report.ElapsedSeconds << " s" << endl;
+		message << "events: " << profiler.GetEvents().size() << " (last " << Profiler::kCapacity << " kept), trace: " << arguments[3];
+		Log(message.str());
+
+		return report.MismatchCount > 0 ? 1 : 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunMicroBenchmarks(const vector<string>& arguments)
+	{
+		MicroBenchmarkOptions options;
+		if (arguments.size() > 3)
+		{
+			options.Filter = arguments[3];
+		}
+
+		vector<MicroBenchmarkResult> results = MicroBenchmarks::GetInstance().Run(options);
+
+		stringstream message;
+		for (auto& result : results)
+		{
+			message << result.Name << ": " << result.MedianNanoseconds << " ns median, " << result.MinNanoseconds << " ns min, " 
+				<< result.MaxNanoseconds << " ns max (" << result.IterationsPerSample << " iterations x " << result.SampleCount << ")" << endl;
+		}
+
+		// without a path, the json goes to the output after the summary
+		if (arguments.size() > 2)
+		{
+			ofstream ofs(arguments[2], ios::trunc);
+			MicroBenchmarks::GetInstance().WriteJSON(ofs, options, results);
+			message << "results: " << arguments[2];
+		}
+		else
+		{
+			MicroBenchmarks::GetInstance().WriteJSON(message, options, results);
+		}
+		Log(message.str());
+
+		return 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunFrameBudgetCheck(const vector<string>& arguments)
+	{
+		FrameBudget budget;
+		if (arguments.size() > 2)
+		{
+			budget.P99Milliseconds = stod(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			budget.AllocationsPerTick = stod(arguments[3]);
+		}
+
+		// the built in sessions always run, the given replays are measured after them
+		FrameTimeRegression& regression = FrameTimeRegression::GetInstance();
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+		vector<FrameRegressionSession> sessions = regression.RecordBuiltInSessions(basicMap);
+		for (size_t i = 4; i < arguments.size(); ++i)
+		{
+			FrameRegressionSession session;
+			session.Name = arguments[i];
+			session.SessionReplay.LoadFromFile(arguments[i]);
+			sessions.push_back(session);
+		}
+
+		vector<FrameRegressionResult> results = regression.Run(basicMap, sessions, budget);
+
+		stringstream message;
+		uint32_t failedCount = 0;
+		for (auto& result : results)
+		{
+			const FrameStatisticsSummary& ticks = result.Ticks;
+			message << result.Name << ": " << ticks.FrameCount << " ticks, " << ticks.MeanMilliseconds << " ms mean, " << ticks.P50Milliseconds << " ms p50, "
+				<< ticks.P99Milliseconds << " ms p99, " << ticks.MaxMilliseconds << " ms max, "
+				<< ticks.Metrics[FrameTimeRegression::kAllocationsMetric].Mean << " allocations per tick ("
+				<< ticks.Metrics[FrameTimeRegression::kAllocationsMetric].Max << " max), "
+				<< ticks.Metrics[FrameTimeRegression::kSpritesMetric].Mean << " sprites per tick" << endl;
+			for (auto& exceededBudget : result.ExceededBudgets)
+			{
+				message << "  over budget, " << exceededBudget << endl;
+			}
+			failedCount += result.ExceededBudgets.empty() ? 0 : 1;
+		}
+		message << (failedCount == 0 ? "all sessions fit the frame budget" : to_string(failedCount) + " session(s) over the frame budget");
+		Log(message.str());
+
+		return failedCount > 0 ? 1 : 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunPackAtlas(const vector<string>& arguments)
+	{
+		if (arguments.size() < 4)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		AtlasPackerOptions options;
+		options.OutputJSONDirectory = arguments[2];
+		options.OutputImagePath = arguments[3];
+		if (arguments.size() > 4)
+		{
+			options.MaxWidth = stoul(arguments[4]);
+		}
+
+		AtlasPackerReport report = AtlasPacker::GetInstance().Pack(options);
+
+		stringstream message;
+		message << "packed " << report.SpriteCount << " sprites from " << report.SheetCount << " sprite sheets in a "
+			<< report.Width << "x" << report.Height << " atlas, " << report.Occupancy * 100 << "% covered";
+		Log(message.str());
+
+		return 0;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunTileGridValidation(const vector<string>& arguments)
+	{
+		uint32_t levelCount = 100;
+		uint32_t firstSeed = 0;
+		if (arguments.size() > 2)
+		{
+			levelCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			firstSeed = stoul(arguments[3]);
+		}
+
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+		TileGridValidationReport report = TileGridValidator::GetInstance().Validate(basicMap, levelCount, firstSeed);
+
+		const bool passed = report.MismatchCount == 0 && report.UploadedCellCount == report.ChangedCellCount && report.MissedTileCount == 0 && report.ExtraTileCount == 0 &&
+			report.OccupancyMismatchCount == 0;
+		stringstream message;
+		message << report.LevelCount << " levels, " << report.TileCount << " tiles, " << report.MismatchCount << " mismatched tiles, max error "
+			<< report.MaxError << ", " << report.UploadedCellCount << " cells uploaded for " << report.ChangedCellCount << " changed cells, "
+			<< report.OccupancyMismatchCount << " mismatched occupancy bits, " << report.CulledViewCount << " culled views, " << report.MissedTileCount << " missed tiles, " << report.ExtraTileCount << " extra tiles" << endl
+			<< (passed ? "the tile grid matches the sprite path" : "the tile grid does not match the sprite path");
+		Log(message.str());
+
+		return passed ? 0 : 1;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunRenderStateCacheValidation(const vector<string>& arguments)
+	{
+		uint32_t sequenceCount = 1000;
+		uint32_t seed = 0;
+		if (arguments.size() > 2)
+		{
+			sequenceCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			seed = stoul(arguments[3]);
+		}
+
+		RenderStateCacheValidationReport report = RenderStateCacheValidator::GetInstance().Validate(sequenceCount, seed);
+
+		const bool passed = report.MissedBindCount == 0 && report.RedundantBindCount == 0 && report.StatsMismatchCount == 0;
+		stringstream message;
+		message << report.SequenceCount << " sequences, " << report.RequestedBindCount << " binds requested, " << report.ForwardedBindCount << " forwarded, "
+			<< report.SkippedBindCount << " skipped, " << report.MissedBindCount << " missed, " << report.RedundantBindCount << " redundant, "
+			<< report.StatsMismatchCount << " sequences with wrong counts" << endl
+			<< (passed ? "the render state cache binds exactly what changed" : "the render state cache does not track the bound state");
+		Log(message.str());
+
+		return passed ? 0 : 1;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunUploadRingValidation(const vector<string>& arguments)
+	{
+		uint32_t frameCount = 10000;
+		uint32_t seed = 0;
+		if (arguments.size() > 2)
+		{
+			frameCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			seed = stoul(arguments[3]);
+		}
+
+		UploadRingValidationReport report = UploadRingValidator::GetInstance().Validate(frameCount, seed);
+
+		const bool passed = report.MisalignedCount == 0 && report.OutOfBoundsCount == 0 && report.OverlapCount == 0 && report.MissingDiscardCount == 0 &&
+			report.UnneededDiscardCount == 0 && report.WrongRejectionCount == 0;
+		stringstream message;
+		message << report.FrameCount << " frames, " << report.AllocationCount << " allocations, " << report.DiscardCount << " discards, "
+			<< report.MisalignedCount << " misaligned, " << report.OutOfBoundsCount << " out of bounds, " << report.OverlapCount << " overlapping, "
+			<< report.MissingDiscardCount << " missing discards, " << report.UnneededDiscardCount << " unneeded discards, " << report.WrongRejectionCount << " wrong rejections" << endl
+			<< (passed ? "the upload ring never overwrites what the GPU may still read" : "the upload ring breaks the discard and no overwrite rules");
+		Log(message.str());
+
+		return passed ? 0 : 1;
+	}
+
+	/************************************************************************/
+	int32_t HeadlessTools::RunRenderSortValidation(const vector<string>& arguments)
+	{
+		uint32_t frameCount = 100;
+		uint32_t seed = 0;
+		if (arguments.size() > 2)
+		{
+			frameCount = stoul(arguments[2]);
+		}
+		if (arguments.size() > 3)
+		{
+			seed = stoul(arguments[3]);
+		}
+
+		RenderSortValidationReport report = RenderSortValidator::GetInstance().Validate(frameCount, seed);
+
+		const bool passed = report.MisorderedCount == 0 && report.WrongKeyOrderCount == 0;
+		stringstream message;
+		message << report.FrameCount << " frames, " << report.KeyCount << " keys, " << report.PassCount << " radix passes, "
+			<< report.MisorderedCount << " misordered, " << report.WrongKeyOrderCount << " wrong key orders" << endl
+			<< (passed ? "the render queue draws by layer, texture and y" : "the render queue does not sort the sprites as their keys");
+		Log(message.str());
+
+		return passed ? 0 : 1;
+	}
+
+	/************************************************************************/
+	void HeadlessTools::Log(const string& message)
+	{
+		cout << message << endl;
+		OutputDebugStringA((message + "\n").c_str());
+	}
+
+	/************************************************************************/
+	void HeadlessTools::PrintUsage()
+	{
+		Log("usage:\n"
+			"  " + kGenerateCorpusCommand + " <first seed> <level count> <output path> [thread count]\n"
+			"  " + kBenchmarkPathfindingCommand + " [level count] [agent count] [ticks per level]\n"
+			"  " + kBenchmarkEnemiesCommand + " [level count] [enemy count] [ticks per level]\n"
+			"  " + kTestLockstepCommand + " [round count] [ticks per round] [player count] [loss percent]\n"
+			"  " + kBenchmarkSnapshotsCommand + " [level count] [ticks per level]\n"
+			"  " + kTestRollbackCommand + " [round count] [latency ticks] [loss percent]\n"
+			"  " + kRecordReplayCommand + " <output path> [seed] [tick count] [player count]\n"
+			"  " + kPlayReplayCommand + " <replay path> [repeat count]\n"
+			"  " + kRunBatchCommand + " [match count] [thread count] [max ticks per match] [replay path]\n"
+			"  " + kTraceReplayCommand + " <replay path> <trace path>\n"
+			"  " + kMicroBenchmarksCommand + " [json path] [name filter]\n"
+			"  " + kCheckFrameBudgetCommand + " [p99 budget ms] [allocations per tick budget] [replay path...]\n"
+			"  " + kPackAtlasCommand + " <json output directory> <atlas output path> [max width]\n"
+			"  " + kValidateTileGridCommand + " [level count] [first seed]\n"
+			"  " + kValidateRenderStateCacheCommand + " [sequence count] [seed]\n"
+			"  " + kValidateUploadRingCommand + " [frame count] [seed]\n"
+			"  " + kValidateRenderSortCommand + " [frame count] [seed]");
+	}
+}
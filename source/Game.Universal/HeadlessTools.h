@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Singleton that runs the headless tools of the game from the command line, instead of the game itself.
+	 * Tools never touch the window or the graphics device, so they can run on build and test machines.
+	 *
+	 * Usage:
+	 *  --generate-corpus <first seed> <level count> <output path> [thread count]
+	 *  --benchmark-pathfinding [level count] [agent count] [ticks per level]
+	 *  --benchmark-enemies [level count] [enemy count] [ticks per level]
+	 *  --test-lockstep [round count] [ticks per round] [player count] [loss percent]
+	 *  --benchmark-snapshots [level count] [ticks per level]
+	 *  --test-rollback [round count] [latency ticks] [loss percent]
+	 *  --record-replay <output path> [seed] [tick count] [player count]
+	 *  --play-replay <replay path> [repeat count]
+	 *  --run-batch [match count] [thread count] [max ticks per match] [replay path]
+	 *  --trace-replay <replay path> <trace path>
+	 *  --micro-benchmarks [json path] [name filter]
+	 *  --check-frame-budget [p99 budget ms] [allocations per tick budget] [replay path...]
+	 *  --pack-atlas <json output directory> <atlas output path> [max width]
+	 *  --validate-tile-grid [level count] [first seed]
+	 *  --validate-render-state-cache [sequence count] [seed]
+	 *  --validate-upload-ring [frame count] [seed]
+	 *  --validate-render-sort [frame count] [seed]
+	*/
+	class HeadlessTools final
+	{
+	public:
+
+		HeadlessTools(const HeadlessTools& rhs) = delete;
+		HeadlessTools(const HeadlessTools&& rhs) = delete;
+		HeadlessTools& operator=(const HeadlessTools& rhs) = delete;
+		HeadlessTools& operator=(const HeadlessTools&& rhs) = delete;
+
+		static HeadlessTools& GetInstance();
+
+		static std::vector<std::string> ToArguments(Platform::Array<Platform::String^>^ arguments);
+
+		bool TryRun(const std::vector<std::string>& arguments, int32_t& exitCode);
+
+	private:
+
+		HeadlessTools() = default;
+		~HeadlessTools() = default;
+
+		int32_t RunGenerateCorpus(const std::vector<std::string>& arguments);
+		int32_t RunPathfindingBenchmark(const std::vector<std::string>& arguments);
+		int32_t RunEnemyBenchmark(const std::vector<std::string>& arguments);
+		int32_t RunLockstepTest(const std::vector<std::string>& arguments);
+		int32_t RunSnapshotBenchmark(const std::vector<std::string>& arguments);
+		int32_t RunRollbackTest(const std::vector<std::string>& arguments);
+		int32_t RunRecordReplay(const std::vector<std::string>& arguments);
+		int32_t RunPlayReplay(const std::vector<std::string>& arguments);
+		int32_t RunBatch(const std::vector<std::string>& arguments);
+		int32_t RunTraceReplay(const std::vector<std::string>& arguments);
+		int32_t RunMicroBenchmarks(const std::vector<std::string>& arguments);
+		int32_t RunFrameBudgetCheck(const std::vector<std::string>& arguments);
+		int32_t RunPackAtlas(const std::vector<std::string>& arguments);
+		int32_t RunTileGridValidation(const std::vector<std::string>& arguments);
+		int32_t RunRenderStateCacheValidation(const std::vector<std::string>& arguments);
+		int32_t RunUploadRingValidation(const std::vector<std::string>& arguments);
+		int32_t RunRenderSortValidation(const std::vector<std::string>& arguments);
+
+		void Log(const std::string& message);
+		void PrintUsage();
+
+		static const std::string kGenerateCorpusCommand;
+		static const std::string kBenchmarkPathfindingCommand;
+		static const std::string kBenchmarkEnemiesCommand;
+		static const std::string kTestLockstepCommand;
+		static const std::string kBenchmarkSnapshotsCommand;
+		static const std::string kTestRollbackCommand;
+		static const std::string kRecordReplayCommand;
+		static const std::string kPlayReplayCommand;
+		static const std::string kRunBatchCommand;
+		static const std::string kTraceReplayCommand;
+		static const std::string kMicroBenchmarksCommand;
+		static const std::string kCheckFrameBudgetCommand;
+		static const std::string kPackAtlasCommand;
+		static const std::string kValidateTileGridCommand;
+		static const std::string kValidateRenderStateCacheCommand;
+		static const std::string kValidateUploadRingCommand;
+		static const std::string kValidateRenderSortCommand;
+	};
+}
@@ -0,0 +1,198 @@
+#include "pch.h"
+#include "LevelCorpusGenerator.h"
+#include "LevelGenerator.h"
+#include "MapParser.h"
+#include <thread>
+#include <chrono>
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	const char LevelCorpusGenerator::kCorpusMagic[4] = { 'B', 'M', 'L', 'C' };
+
+	/************************************************************************/
+	LevelCorpusGenerator& LevelCorpusGenerator::GetInstance()
+	{
+		static LevelCorpusGenerator sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	LevelCorpusReport LevelCorpusGenerator::Generate(const LevelCorpusOptions& options)
+	{
+		const Map basicMap = options.MapJSONPath.empty() ? MapParser::GetInstance().ParseMapSpriteSheet() : 
+			MapParser::GetInstance().ParseMapSpriteSheet(options.MapJSONPath);
+
+		// the corpus stores the map size and the tiles of the door and the perk on one byte each
+		if (basicMap.MapWidth > UINT8_MAX || basicMap.MapHeight > UINT8_MAX)
+		{
+			throw runtime_error("a map " + to_string(basicMap.MapWidth) + " by " + to_string(basicMap.MapHeight) + " tiles does not fit a level corpus, which takes up to " +
+				to_string(UINT8_MAX) + " tiles per side");
+		}
+
+		uint32_t threadCount = options.ThreadCount > 0 ? options.ThreadCount : max(thread::hardware_concurrency(), 1U);
+		threadCount = max(min(threadCount, options.LevelCount), 1U);
+
+		vector<LevelCorpusRecord> records(options.LevelCount);
+		vector<double_t> threadSeconds(threadCount, 0);
+		vector<uint32_t> threadLevelCounts(threadCount, 0);
+		vector<thread> workers;
+
+		auto start = chrono::high_resolution_clock::now();
+
+		// each worker gets a contiguous slice of the seed range and writes its own slots only
+		for (uint32_t t = 0; t < threadCount; ++t)
+		{
+			uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(options.LevelCount) * t / threadCount);
+			uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(options.LevelCount) * (t + 1) / threadCount);
+			threadLevelCounts[t] = end - begin;
+
+			workers.emplace_back([this, &basicMap, &records, &threadSeconds, &options, t, begin, end]()
+			{
+				NavigationGrid grid;
+				Pathfinder pathfinder;
+
+				auto workerStart = chrono::high_resolution_clock::now();
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					records[i] = GenerateRecord(basicMap, options.FirstSeed + i, grid, pathfinder);
+				}
+				threadSeconds[t] = chrono::duration<double_t>(chrono::high_resolution_clock::now() - workerStart).count();
+			});
+		}
+
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+
+		LevelCorpusReport report;
+		report.ElapsedSeconds = chrono::duration<double_t>(chrono::high_resolution_clock::now() - start).count();
+		report.LevelCount = options.LevelCount;
+		report.ThreadCount = threadCount;
+		report.FairLevelCount = 0;
+
+		for (auto& record : records)
+		{
+			if (record.Flags & static_cast<uint8_t>(LevelCorpusFlags::Fair))
+			{
+				++report.FairLevelCount;
+			}
+		}
+
+		report.LevelsPerSecond = report.ElapsedSeconds > 0 ? report.LevelCount / report.ElapsedSeconds : 0;
+		report.LevelsPerSecondPerCore = report.LevelsPerSecond / threadCount;
+		for (uint32_t t = 0; t < threadCount; ++t)
+		{
+			report.LevelsPerSecondOfEachThread.push_back(threadSeconds[t] > 0 ? threadLevelCounts[t] / threadSeconds[t] : 0);
+		}
+
+		report.CorpusSizeInBytes = options.OutputPath.empty() ? 0 : WriteCorpus(options.OutputPath, basicMap, options.FirstSeed, records);
+
+		return report;
+	}
+
+	/************************************************************************/
+	LevelCorpusRecord LevelCorpusGenerator::GenerateRecord(const Map& basicMap, uint32_t seed, NavigationGrid& grid, Pathfinder& pathfinder) const
+	{
+		default_random_engine generator(seed);
+		Map map = LevelGenerator::GetInstance().GenerateLevel(basicMap, generator);
+		LevelValidationResult validation = LevelValidator::GetInstance().Validate(map, grid, pathfinder);
+
+		LevelCorpusRecord record;
+		record.Seed = seed;
+		record.Flags = 0;
+		if (validation.DoorReachable)
+		{
+			record.Flags |= static_cast<uint8_t>(LevelCorpusFlags::DoorReachable);
+		}
+		if (validation.PerkReachable)
+		{
+			record.Flags |= static_cast<uint8_t>(LevelCorpusFlags::PerkReachable);
+		}
+		if (validation.HasSafeOpeningBomb)
+		{
+			record.Flags |= static_cast<uint8_t>(LevelCorpusFlags::SafeOpeningBomb);
+		}
+		if (validation.IsFair)
+		{
+			record.Flags |= static_cast<uint8_t>(LevelCorpusFlags::Fair);
+		}
+		record.DoorX = static_cast<uint8_t>(map.DoorTile.Tile.x);
+		record.DoorY = static_cast<uint8_t>(map.DoorTile.Tile.y);
+		record.PerkX = static_cast<uint8_t>(map.PerkTile.Tile.x);
+		record.PerkY = static_cast<uint8_t>(map.PerkTile.Tile.y);
+		record.PerkSpriteIndex = map.PerkTile.SpriteIndex;
+		record.SoftBlocksToDoor = static_cast<uint8_t>(min(validation.SoftBlocksToDoor, 0xFFU));
+		record.SoftBlocksToPerk = static_cast<uint8_t>(min(validation.SoftBlocksToPerk, 0xFFU));
+
+		record.SoftBlocks.assign((map.MapWidth * map.MapHeight + 7) / 8, 0);
+		for (uint32_t y = 0; y < map.MapHeight; ++y)
+		{
+			for (uint32_t x = 0; x < map.MapWidth; ++x)
+			{
+				if (map.BlocksLayer[x][y] == static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock))
+				{
+					uint32_t bit = y * map.MapWidth + x;
+					record.SoftBlocks[bit / 8] |= static_cast<uint8_t>(1 << (bit % 8));
+				}
+			}
+		}
+
+		return record;
+	}
+
+	/************************************************************************/
+	uint64_t LevelCorpusGenerator::WriteCorpus(const string& outputPath, const Map& basicMap, uint32_t firstSeed, const vector<LevelCorpusRecord>& records) const
+	{
+		vector<uint8_t> buffer;
+
+		auto writeU8 = [&buffer](uint8_t value) { buffer.push_back(value); };
+		auto writeU16 = [&buffer](uint16_t value)
+		{
+			buffer.push_back(static_cast<uint8_t>(value));
+			buffer.push_back(static_cast<uint8_t>(value >> 8));
+		};
+		auto writeU32 = [&buffer](uint32_t value)
+		{
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+			}
+		};
+
+		buffer.insert(buffer.end(), begin(kCorpusMagic), end(kCorpusMagic));
+		writeU16(kCorpusVersion);
+		writeU8(static_cast<uint8_t>(basicMap.MapWidth));
+		writeU8(static_cast<uint8_t>(basicMap.MapHeight));
+		writeU32(static_cast<uint32_t>(records.size()));
+		writeU32(firstSeed);
+
+		for (auto& record : records)
+		{
+			writeU32(record.Seed);
+			writeU8(record.Flags);
+			writeU8(record.DoorX);
+			writeU8(record.DoorY);
+			writeU8(record.PerkX);
+			writeU8(record.PerkY);
+			writeU8(record.PerkSpriteIndex);
+			writeU8(record.SoftBlocksToDoor);
+			writeU8(record.SoftBlocksToPerk);
+			buffer.insert(buffer.end(), record.SoftBlocks.begin(), record.SoftBlocks.end());
+		}
+
+		// closing flushes the last bytes, which can fail as well
+		ofstream ofs(outputPath, ios::binary | ios::trunc);
+		ofs.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		ofs.close();
+		if (!ofs)
+		{
+			throw runtime_error("could not write the corpus " + outputPath);
+		}
+
+		return buffer.size();
+	}
+}
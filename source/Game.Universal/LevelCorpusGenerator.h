@@ -0,0 +1,100 @@
+#pragma once
+
+#include "RenderingDataStructures.h"
+#include "LevelValidator.h"
+
+namespace DirectXGame
+{
+	/** Structure holding the options of a level corpus generation run.
+	*/
+	struct LevelCorpusOptions
+	{
+		LevelCorpusOptions() :
+			FirstSeed(0), LevelCount(1000), ThreadCount(0)
+		{
+		}
+
+		uint32_t FirstSeed;
+		uint32_t LevelCount;
+		uint32_t ThreadCount; // 0 means one thread per core
+		std::string MapJSONPath;
+		std::string OutputPath;
+	};
+
+	/** Structure holding the numbers of a level corpus generation run.
+	*/
+	struct LevelCorpusReport
+	{
+		uint32_t LevelCount;
+		uint32_t FairLevelCount;
+		uint32_t ThreadCount;
+		std::double_t ElapsedSeconds;
+		std::double_t LevelsPerSecond;
+		std::double_t LevelsPerSecondPerCore;
+		std::vector<std::double_t> LevelsPerSecondOfEachThread;
+		std::uint64_t CorpusSizeInBytes;
+	};
+
+	/** Structure representing a single level of the corpus, as written on disk.
+	 * The solid blocks are the same for all levels of a corpus, so only the soft blocks are stored, one bit per tile.
+	*/
+	struct LevelCorpusRecord
+	{
+		uint32_t Seed;
+		uint8_t Flags;
+		uint8_t DoorX;
+		uint8_t DoorY;
+		uint8_t PerkX;
+		uint8_t PerkY;
+		uint8_t PerkSpriteIndex;
+		uint8_t SoftBlocksToDoor;
+		uint8_t SoftBlocksToPerk;
+		std::vector<uint8_t> SoftBlocks;
+	};
+
+	/** Enumeration representing the flags of a level corpus record.
+	*@see LevelCorpusRecord
+	*/
+	enum class LevelCorpusFlags : uint8_t
+	{
+		DoorReachable = 1 << 0,
+		PerkReachable = 1 << 1,
+		SafeOpeningBomb = 1 << 2,
+		Fair = 1 << 3
+	};
+
+	/** Singleton that generates and validates levels in bulk, from a range of seeds, and writes them in a compact binary corpus.
+	 * Each seed always produces the same level, so any level of the corpus can be regenerated from its seed.
+	 * Generate throws for maps over 255 tiles per side, which the corpus cannot hold, and when the corpus cannot be written.
+	 *
+	 * Corpus layout (little endian):
+	 *  header: "BMLC", uint16 version, uint8 map width, uint8 map height, uint32 level count, uint32 first seed
+	 *  records: uint32 seed, uint8 flags, uint8 door x, door y, perk x, perk y, perk sprite index,
+	 *           uint8 soft blocks to door, soft blocks to perk, then ceil(width * height / 8) bytes of soft blocks bits
+	*/
+	class LevelCorpusGenerator final
+	{
+	public:
+
+		LevelCorpusGenerator(const LevelCorpusGenerator& rhs) = delete;
+		LevelCorpusGenerator(const LevelCorpusGenerator&& rhs) = delete;
+		LevelCorpusGenerator& operator=(const LevelCorpusGenerator& rhs) = delete;
+		LevelCorpusGenerator& operator=(const LevelCorpusGenerator&& rhs) = delete;
+
+		static LevelCorpusGenerator& GetInstance();
+
+		LevelCorpusReport Generate(const LevelCorpusOptions& options);
+
+		static const uint16_t kCorpusVersion = 1;
+
+	private:
+
+		LevelCorpusGenerator() = default;
+		~LevelCorpusGenerator() = default;
+
+		LevelCorpusRecord GenerateRecord(const Map& basicMap, uint32_t seed, NavigationGrid& grid, Pathfinder& pathfinder) const;
+		std::uint64_t WriteCorpus(const std::string& outputPath, const Map& basicMap, uint32_t firstSeed, const std::vector<LevelCorpusRecord>& records) const;
+
+		static const char kCorpusMagic[4];
+	};
+}
@@ -18,25 +18,92 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	Map LevelGenerator::GenerateLevel()
+	Map LevelGenerator::GenerateLevel(uint32_t playerCount)
 	{
-		auto map = MapParser::GetInstance().ParseMapSpriteSheet();
-		GenerateSoftBlocks(map);
-		GeneratePerk(map);
-		GenerateDoor(map);
+		return GenerateLevel(MapParser::GetInstance().ParseMapSpriteSheet(), MathHelper::GetInstance().GetGenerator(), playerCount);
+	}
+
+	/************************************************************************/
+	Map LevelGenerator::GenerateLevel(const Map& basicMap, default_random_engine& generator, uint32_t playerCount)
+	{
+		Map map = basicMap;
+		AddPlayerSpawns(map, playerCount);
+		GenerateSoftBlocks(map, generator);
+		GeneratePerk(map, generator);
+		GenerateDoor(map, generator);
+		map.Chunks.Initialize(map);
+
+		return map;
+	}
+
+	/************************************************************************/
+	Map LevelGenerator::ExpandMap(const Map& basicMap, uint32_t width, uint32_t height)
+	{
+		// the two middle rows and columns repeat, a pillar and a free tile, so the sizes keep the parity of the basic map
+		width = width > basicMap.MapWidth ? width + (width - basicMap.MapWidth) % 2 : basicMap.MapWidth;
+		height = height > basicMap.MapHeight ? height + (height - basicMap.MapHeight) % 2 : basicMap.MapHeight;
+
+		Map map = basicMap;
+		map.MapWidth = width;
+		map.MapHeight = height;
+		map.BackgroundLayer.assign(width, vector<uint8_t>(height));
+		map.BlocksLayer.assign(width, vector<uint8_t>(height));
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			const uint32_t basicX = ExpandCoordinate(x, basicMap.MapWidth, width);
+			for (uint32_t y = 0; y < height; ++y)
+			{
+				const uint32_t basicY = ExpandCoordinate(y, basicMap.MapHeight, height);
+				map.BackgroundLayer[x][y] = basicMap.BackgroundLayer[basicX][basicY];
+				map.BlocksLayer[x][y] = basicMap.BlocksLayer[basicX][basicY];
+			}
+		}
+
+		// the tiles past the middle move with the walls
+		const XMUINT2 shift(width - basicMap.MapWidth, height - basicMap.MapHeight);
+		const XMUINT2 middle((basicMap.MapWidth / 2) & ~1U, (basicMap.MapHeight / 2) & ~1U);
+		for (auto& tile : map.RestrictedTiles)
+		{
+			tile = XMUINT2(tile.x < middle.x ? tile.x : tile.x + shift.x, tile.y < middle.y ? tile.y : tile.y + shift.y);
+		}
+		map.PlayerSpawnTile = map.RestrictedTiles[0];
+		map.PlayerSpawnTiles.assign(1, map.PlayerSpawnTile);
+		map.Chunks.Initialize(map);
 
 		return map;
 	}
 
 	/************************************************************************/
-	void LevelGenerator::GenerateSoftBlocks(Map& map)
+	void LevelGenerator::AddPlayerSpawns(Map& map, uint32_t playerCount)
 	{
-		// starts from bottom left
-		uint32_t softBlocksNum = MathHelper::GetInstance().GetRangedRandom(kMaxNumberOfSoftBlocks, kMinNumberOfSoftBlocks);
+		// the other players start in the other corners, with the same free tiles around them as the first player
+		// players after the fourth share the corners
+		const size_t restrictedTilesCount = map.RestrictedTiles.size();
+		const uint32_t spawnCount = playerCount < kMaxPlayerCount ? playerCount : kMaxPlayerCount;
+		for (uint32_t player = 1; player < spawnCount; ++player)
+		{
+			bool mirrorX = player != 3;
+			bool mirrorY = player != 2;
+
+			map.PlayerSpawnTiles.push_back(MirrorTile(map, map.PlayerSpawnTile, mirrorX, mirrorY));
+			for (size_t i = 0; i < restrictedTilesCount; ++i)
+			{
+				map.RestrictedTiles.push_back(MirrorTile(map, map.RestrictedTiles[i], mirrorX, mirrorY));
+			}
+		}
+	}
+
+	/************************************************************************/
+	void LevelGenerator::GenerateSoftBlocks(Map& map, default_random_engine& generator)
+	{
+		// starts from bottom left, as many blocks per tile as on the basic map whatever the size of the map
+		const uint32_t insideArea = (map.MapWidth - 2) * map.PlayerSpawnTile.y;
+		uint32_t softBlocksNum = MathHelper::GetRangedRandom(generator, kMaxNumberOfSoftBlocks * insideArea / kBasicMapInsideArea,
+															 kMinNumberOfSoftBlocks * insideArea / kBasicMapInsideArea);
 
 		while (softBlocksNum > 0)
 		{
-			XMUINT2 randomTile = GetRandomTile(map);
+			XMUINT2 randomTile = GetRandomTile(map, generator);
 			uint32_t index = map.BlocksLayer[randomTile.x][randomTile.y];
 
 			if (!index)
@@ -63,32 +130,32 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	void LevelGenerator::GeneratePerk(Map& map)
+	void LevelGenerator::GeneratePerk(Map& map, default_random_engine& generator)
 	{
 		bool itemAdded = false;
 
 		while (!itemAdded)
 		{
-			XMUINT2 randomTile = GetRandomTile(map);
+			XMUINT2 randomTile = GetRandomTile(map, generator);
 			uint32_t index = map.BlocksLayer[randomTile.x][randomTile.y];
 
 			if (index == static_cast<uint32_t>(SpriteIndicesInMap::SoftBlock))
 			{
 				itemAdded = true;
 				map.PerkTile.Tile = randomTile;
-				map.PerkTile.SpriteIndex = GetRandomPerk();
+				map.PerkTile.SpriteIndex = GetRandomPerk(generator);
 			}
 		}
 	}
 
 	/************************************************************************/
-	void LevelGenerator::GenerateDoor(Map& map)
+	void LevelGenerator::GenerateDoor(Map& map, default_random_engine& generator)
 	{
 		bool itemAdded = false;
 
 		while (!itemAdded)
 		{
-			XMUINT2 randomTile = GetRandomTile(map);
+			XMUINT2 randomTile = GetRandomTile(map, generator);
 			if (IsSameTile(randomTile, map.PerkTile.Tile))
 			{
 				continue;
@@ -106,22 +173,27 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	DirectX::XMUINT2 LevelGenerator::GetRandomTile(const Map & map)
+	DirectX::XMUINT2 LevelGenerator::GetRandomTile(const Map & map, default_random_engine& generator)
 	{
-		MathHelper& mathHelper = MathHelper::GetInstance();
-
 		XMUINT2 randomTile;
 
-		randomTile.x = mathHelper.GetRangedRandom(map.MapWidth - 1, map.PlayerSpawnTile.x);
-		randomTile.y = mathHelper.GetRangedRandom(map.PlayerSpawnTile.y + 1, 1U);
+		randomTile.x = MathHelper::GetRangedRandom(generator, map.MapWidth - 1, map.PlayerSpawnTile.x);
+		randomTile.y = MathHelper::GetRangedRandom(generator, map.PlayerSpawnTile.y + 1, 1U);
 
 		return randomTile;
 	}
 
 	/************************************************************************/
-	uint8_t LevelGenerator::GetRandomPerk()
+	XMUINT2 LevelGenerator::MirrorTile(const Map& map, const XMUINT2& tile, bool mirrorX, bool mirrorY)
 	{
-		RandomPerk perk = static_cast<RandomPerk>(MathHelper::GetInstance().GetRangedRandom(static_cast<uint32_t>(RandomPerk::PassSoftBlocks)));
+		// the outer walls are on the columns 0 and MapWidth - 1, and on the rows 0 and PlayerSpawnTile.y + 1
+		return XMUINT2(mirrorX ? map.MapWidth - 1 - tile.x : tile.x, mirrorY ? map.PlayerSpawnTile.y + 1 - tile.y : tile.y);
+	}
+
+	/************************************************************************/
+	uint8_t LevelGenerator::GetRandomPerk(default_random_engine& generator)
+	{
+		RandomPerk perk = static_cast<RandomPerk>(MathHelper::GetRangedRandom(generator, static_cast<uint32_t>(RandomPerk::PassSoftBlocks)));
 
 		switch (perk)
 		{
@@ -148,6 +220,22 @@ namespace DirectXGame
 		}
 	}
 
+	/************************************************************************/
+	uint32_t LevelGenerator::ExpandCoordinate(uint32_t coordinate, uint32_t basicSize, uint32_t size)
+	{
+		const uint32_t middle = (basicSize / 2) & ~1U;
+		const uint32_t extra = size - basicSize;
+		if (coordinate < middle)
+		{
+			return coordinate;
+		}
+		if (coordinate >= middle + extra)
+		{
+			return coordinate - extra;
+		}
+		return middle + (coordinate - middle) % 2;
+	}
+
 	/************************************************************************/
 	bool LevelGenerator::IsSameTile(const DirectX::XMUINT2& first, const DirectX::XMUINT2& second)
 	{
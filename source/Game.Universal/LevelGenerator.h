@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RenderingDataStructures.h"
+#include <random>
 
 namespace DirectXGame
 {
@@ -16,6 +17,8 @@ namespace DirectXGame
 	};
 
 	/** Singleton that handles generating a level randomly.
+	 * The generator itself is stateless, so levels can be generated from several threads at once
+	 * as long as each thread passes its own random engine.
 	*/
 	class LevelGenerator final
 	{
@@ -28,22 +31,30 @@ namespace DirectXGame
 
 		static LevelGenerator& GetInstance();
 
-		Map GenerateLevel();
+		Map GenerateLevel(uint32_t playerCount = 1);
+		Map GenerateLevel(const Map& basicMap, std::default_random_engine& generator, uint32_t playerCount = 1);
+		Map ExpandMap(const Map& basicMap, uint32_t width, uint32_t height);
+
+		static const uint32_t kMaxPlayerCount = 4;
 
 	private:
 
 		LevelGenerator() = default;
 		~LevelGenerator() = default;
 
-		void GenerateSoftBlocks(Map& map);
-		void GeneratePerk(Map& map);
-		void GenerateDoor(Map& map);
+		void AddPlayerSpawns(Map& map, uint32_t playerCount);
+		void GenerateSoftBlocks(Map& map, std::default_random_engine& generator);
+		void GeneratePerk(Map& map, std::default_random_engine& generator);
+		void GenerateDoor(Map& map, std::default_random_engine& generator);
 
-		DirectX::XMUINT2 GetRandomTile(const Map& map);
-		uint8_t GetRandomPerk();
+		DirectX::XMUINT2 GetRandomTile(const Map& map, std::default_random_engine& generator);
+		DirectX::XMUINT2 MirrorTile(const Map& map, const DirectX::XMUINT2& tile, bool mirrorX, bool mirrorY);
+		uint8_t GetRandomPerk(std::default_random_engine& generator);
 		bool IsSameTile(const DirectX::XMUINT2& first, const DirectX::XMUINT2& second);
+		static uint32_t ExpandCoordinate(uint32_t coordinate, uint32_t basicSize, uint32_t size);
 
 		static const uint32_t kMinNumberOfSoftBlocks = 80;
 		static const uint32_t kMaxNumberOfSoftBlocks = 120;
+		static const uint32_t kBasicMapInsideArea = 23 * 13; // the tiles inside the walls of BasicMap.json
 	};
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "LevelManager.h"
 #include "GameMain.h"
 #include "Bomb.h"
+#include "StepTimer.h"
+#include "StateHash.h"
 
 using namespace std;
 using namespace DirectX;
@@ -22,27 +24,106 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	vector<XMUINT2> LevelManager::GetBombsTiles() const
+	void LevelManager::SetMap(const Map& map)
 	{
-		vector<XMUINT2> vect;
+		mMap = &map;
+		mMapLayout = MapLayout(map);
+		mNavigationGrid.Initialize(map);
+		mDangerMap.Initialize(map);
+	}
+
+	/************************************************************************/
+	void LevelManager::Update(const DX::StepTimer& timer)
+	{
+		mDangerMap.SetTime(timer.GetTotalSeconds());
+	}
+
+	/************************************************************************/
+	void LevelManager::OnBlockDestroyed(const Map& map, const XMUINT2& tile)
+	{
+		mNavigationGrid.RefreshTile(map, tile);
+		mDangerMap.RefreshBlasts(map);
+	}
+
+	/************************************************************************/
+	void LevelManager::OnBombExploded(const Bomb& bomb)
+	{
+		mDangerMap.RemoveBomb(&bomb);
+	}
+
+	/************************************************************************/
+	void LevelManager::OnBombRangeChanged(const Bomb& bomb)
+	{
+		mDangerMap.UpdateBombRange(&bomb, *mMap, bomb.GetRange());
+	}
+
+	/************************************************************************/
+	const MapLayout& LevelManager::GetMapLayout() const
+	{
+		return mMapLayout;
+	}
+
+	/************************************************************************/
+	const NavigationGrid& LevelManager::GetNavigationGrid() const
+	{
+		return mNavigationGrid;
+	}
+
+	/************************************************************************/
+	const DangerMap& LevelManager::GetDangerMap() const
+	{
+		return mDangerMap;
+	}
+
+	/************************************************************************/
+	uint64_t LevelManager::GetStateHash() const
+	{
+		StateHash hash;
+		for (uint32_t i = 0; i < mNavigationGrid.CellCount(); ++i)
+		{
+			hash.Add(mNavigationGrid.GetCell(i));
+		}
+
+		// the bombs are kept in the order they were placed
+		for (auto& bomb : mBombs)
+		{
+			hash.Add(bomb->GetStateHash());
+		}
+		hash.Add(mBombsAE);
+		return hash.Value();
+	}
+
+	/************************************************************************/
+	FrameVector<XMUINT2> LevelManager::GetBombsTiles() const
+	{
+		FrameVector<XMUINT2> vect;
+		vect.reserve(mBombs.size());
 		for (auto& bomb : mBombs)
 		{
 			vect.push_back(Bomb::GetTileFromPosition(bomb->Position()));
 		}
 
-		return move(vect);
+		return vect;
+	}
+
+	/************************************************************************/
+	FrameVector<XMUINT2> LevelManager::GetBombsAETiles() const
+	{
+		return FrameVector<XMUINT2>(mBombsAE.begin(), mBombsAE.end());
 	}
 
 	/************************************************************************/
-	vector<XMUINT2> LevelManager::GetBombsAETiles() const
+	ObjectPool<Bomb>& LevelManager::GetBombPool()
 	{
-		return mBombsAE;
+		return mBombPool;
 	}
 
 	/************************************************************************/
 	void LevelManager::AddBomb(const shared_ptr<Bomb>& bomb)
 	{
 		mBombs.push_back(bomb);
+		mNavigationGrid.AddBomb(Bomb::GetTileFromPosition(bomb->Position()));
+		mDangerMap.AddBomb(bomb.get(), *mMap, Bomb::GetTileFromPosition(bomb->Position()), bomb->GetRange(), mDangerMap.Time() + bomb->GetTimeLeft());
 		mGameMain->AddComponent(bomb);
 	}
 
@@ -53,6 +134,8 @@ namespace DirectXGame
 		{
 			if ((*it).get() == &bomb)
 			{
+				mNavigationGrid.RemoveBomb(Bomb::GetTileFromPosition(bomb.Position()));
+				mDangerMap.RemoveBomb(&bomb);
 				mBombs.erase(it);
 				mGameMain->RemoveComponent(bomb);
 
@@ -66,6 +149,8 @@ namespace DirectXGame
 	void LevelManager::AddBombAE(const XMUINT2& bombAE)
 	{
 		mBombsAE.push_back(bombAE);
+		mNavigationGrid.AddExplosion(bombAE);
+		mDangerMap.AddExplosion(bombAE);
 	}
 
 	/************************************************************************/
@@ -76,6 +161,8 @@ namespace DirectXGame
 			if ((*it).x == bombAE.x && (*it).y == bombAE.y)
 			{
 				mBombsAE.erase(it);
+				mNavigationGrid.RemoveExplosion(bombAE);
+				mDangerMap.RemoveExplosion(bombAE);
 				return true;
 			}
 		}
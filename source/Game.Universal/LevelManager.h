@@ -1,5 +1,17 @@
 #pragma once
 
+#include "NavigationGrid.h"
+#include "DangerMap.h"
+#include "FrameArena.h"
+#include "ObjectPool.h"
+#include "TrackingAllocator.h"
+#include "MapLayout.h"
+
+namespace DX
+{
+	class StepTimer;
+}
+
 namespace DirectXGame
 {
 	class GameMain;
@@ -19,10 +31,21 @@ namespace DirectXGame
 		static LevelManager& GetInstance();
 
 		void SetGameMain(GameMain& gameMain);
+		void SetMap(const Map& map);
+		void Update(const DX::StepTimer& timer);
+		void OnBlockDestroyed(const Map& map, const DirectX::XMUINT2& tile);
+		void OnBombExploded(const Bomb& bomb);
+		void OnBombRangeChanged(const Bomb& bomb);
+
+		const MapLayout& GetMapLayout() const;
+		const NavigationGrid& GetNavigationGrid() const;
+		const DangerMap& GetDangerMap() const;
+		uint64_t GetStateHash() const;
 
-		std::vector<DirectX::XMUINT2> GetBombsTiles() const;
-		std::vector<DirectX::XMUINT2> GetBombsAETiles() const;
+		FrameVector<DirectX::XMUINT2> GetBombsTiles() const;
+		FrameVector<DirectX::XMUINT2> GetBombsAETiles() const;
 
+		ObjectPool<Bomb>& GetBombPool();
 		void AddBomb(const std::shared_ptr<Bomb>& bomb);
 		bool RemoveBomb(const Bomb& bomb);
 
@@ -35,8 +58,13 @@ namespace DirectXGame
 		~LevelManager() = default;
 
 		GameMain* mGameMain;
-		std::vector<std::shared_ptr<Bomb>> mBombs;
-		std::vector<DirectX::XMUINT2> mBombsAE;
+		const Map* mMap;
+		MapLayout mMapLayout; // of the reference tile size until a map is set
+		ObjectPool<Bomb> mBombPool; // before the bombs, which go back to it when destroyed
+		TrackedVector<std::shared_ptr<Bomb>, AllocationSubsystem::Level> mBombs;
+		TrackedVector<DirectX::XMUINT2, AllocationSubsystem::Level> mBombsAE;
+		NavigationGrid mNavigationGrid;
+		DangerMap mDangerMap;
 	};
 
 }
\ No newline at end of file
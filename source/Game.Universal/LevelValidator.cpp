@@ -0,0 +1,83 @@
+#include "pch.h"
+#include "LevelValidator.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	// walking on an empty tile is free, breaking a soft block costs 1
+	const NavigationRules LevelValidator::kSoftBlocksCostRules(true, true, false, 0, 1);
+
+	/************************************************************************/
+	LevelValidator& LevelValidator::GetInstance()
+	{
+		static LevelValidator sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	LevelValidationResult LevelValidator::Validate(const Map& map) const
+	{
+		NavigationGrid grid;
+		Pathfinder pathfinder;
+
+		return Validate(map, grid, pathfinder);
+	}
+
+	/************************************************************************/
+	LevelValidationResult LevelValidator::Validate(const Map& map, NavigationGrid& grid, Pathfinder& pathfinder) const
+	{
+		LevelValidationResult result;
+
+		grid.Initialize(map);
+		pathfinder.FloodFill(grid, map.PlayerSpawnTile, kSoftBlocksCostRules);
+
+		const uint32_t doorCost = pathfinder.GetCost(grid, map.DoorTile.Tile);
+		const uint32_t perkCost = pathfinder.GetCost(grid, map.PerkTile.Tile);
+
+		result.DoorReachable = doorCost != Pathfinder::kUnreachable;
+		result.PerkReachable = perkCost != Pathfinder::kUnreachable;
+		result.SoftBlocksToDoor = doorCost;
+		result.SoftBlocksToPerk = perkCost;
+
+		vector<XMUINT2> openTiles;
+		for (uint32_t index = 0; index < grid.CellCount(); ++index)
+		{
+			XMUINT2 tile = grid.GetTile(index);
+			if (pathfinder.GetCost(grid, tile) == 0)
+			{
+				openTiles.push_back(tile);
+			}
+		}
+
+		result.OpenTilesFromSpawn = static_cast<uint32_t>(openTiles.size());
+		result.HasSafeOpeningBomb = HasSafeOpeningBomb(openTiles);
+		result.IsFair = result.DoorReachable && result.PerkReachable && result.HasSafeOpeningBomb &&
+			doorCost <= kMaxSoftBlocksToDoor && perkCost <= kMaxSoftBlocksToPerk &&
+			result.OpenTilesFromSpawn >= kMinOpenTilesFromSpawn;
+
+		return result;
+	}
+
+	/************************************************************************/
+	bool LevelValidator::HasSafeOpeningBomb(const vector<XMUINT2>& openTiles) const
+	{
+		// the player starts without perks, so the first bomb covers its tile and one tile in each direction.
+		// the level is only playable if the player can drop it somewhere and walk to a tile outside of that cross.
+		for (auto& bombTile : openTiles)
+		{
+			for (auto& tile : openTiles)
+			{
+				bool inBlastOnX = tile.y == bombTile.y && (tile.x + 1 >= bombTile.x && tile.x <= bombTile.x + 1);
+				bool inBlastOnY = tile.x == bombTile.x && (tile.y + 1 >= bombTile.y && tile.y <= bombTile.y + 1);
+				if (!inBlastOnX && !inBlastOnY)
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "RenderingDataStructures.h"
+#include "NavigationGrid.h"
+#include "Pathfinder.h"
+
+namespace DirectXGame
+{
+	/** Structure holding the result of validating a generated level.
+	*/
+	struct LevelValidationResult
+	{
+		LevelValidationResult() :
+			DoorReachable(false), PerkReachable(false), HasSafeOpeningBomb(false), IsFair(false),
+			SoftBlocksToDoor(0), SoftBlocksToPerk(0), OpenTilesFromSpawn(0)
+		{
+		}
+
+		bool DoorReachable;
+		bool PerkReachable;
+		bool HasSafeOpeningBomb;
+		bool IsFair;
+
+		uint32_t SoftBlocksToDoor;   // soft blocks the player has to blow up to get to the door
+		uint32_t SoftBlocksToPerk;   // soft blocks the player has to blow up to get to the perk
+		uint32_t OpenTilesFromSpawn; // tiles reachable from the spawn without blowing anything up
+	};
+
+	/** Singleton that checks if a generated level is playable and fair.
+	 * Soft blocks count as passable since they can be destroyed, solid blocks never are.
+	 * The validator does not keep any state, so it can be used from several threads at once,
+	 * each thread passing its own navigation grid and path finder to avoid reallocating them for every level.
+	*/
+	class LevelValidator final
+	{
+	public:
+
+		LevelValidator(const LevelValidator& rhs) = delete;
+		LevelValidator(const LevelValidator&& rhs) = delete;
+		LevelValidator& operator=(const LevelValidator& rhs) = delete;
+		LevelValidator& operator=(const LevelValidator&& rhs) = delete;
+
+		static LevelValidator& GetInstance();
+
+		LevelValidationResult Validate(const Map& map) const;
+		LevelValidationResult Validate(const Map& map, NavigationGrid& grid, Pathfinder& pathfinder) const;
+
+	private:
+
+		LevelValidator() = default;
+		~LevelValidator() = default;
+
+		bool HasSafeOpeningBomb(const std::vector<DirectX::XMUINT2>& openTiles) const;
+
+		static const NavigationRules kSoftBlocksCostRules;
+		static const uint32_t kMaxSoftBlocksToDoor = 12;
+		static const uint32_t kMaxSoftBlocksToPerk = 12;
+		static const uint32_t kMinOpenTilesFromSpawn = 3;
+	};
+}
@@ -0,0 +1,244 @@
+#include "pch.h"
+#include "LockstepSession.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	LockstepSession::LockstepSession(GameSimulation& simulation, LoopbackTransport& transport, uint32_t localPlayer, uint32_t inputDelay) :
+		mSimulation(simulation), mTransport(transport), mLocalPlayer(localPlayer),
+		mPlayerCount(static_cast<uint32_t>(simulation.Players().size())),
+		mInputDelay(inputDelay < kMaxInputDelay ? inputDelay : kMaxInputDelay),
+		mNextLocalInputTick(0), mDesyncTick(UINT32_MAX), mComparedHashCount(0)
+	{
+		if (mPlayerCount == 0 || mPlayerCount > PeerMessage::kMaxPeerCount || mLocalPlayer >= mPlayerCount)
+		{
+			throw runtime_error("a lockstep session needs between 1 and " + to_string(PeerMessage::kMaxPeerCount) + " players, the local one included");
+		}
+
+		const HashRecord emptyRecord = { UINT32_MAX, 0 };
+		mFrames.resize(kWindowSize, { UINT32_MAX, 0, vector<PlayerInput>() });
+		mLocalHashes.assign(kWindowSize, emptyRecord);
+		mRemoteHashes.assign(kWindowSize * mPlayerCount, emptyRecord);
+
+		// nobody has input for the first ticks, every peer plays them idle
+		mNextLocalInputTick = mSimulation.CurrentTick() + mInputDelay;
+		for (uint32_t tick = mSimulation.CurrentTick(); tick < mNextLocalInputTick; ++tick)
+		{
+			GetFrame(tick).ReceivedMask = UINT32_MAX;
+		}
+
+		for (uint32_t player = 0; player < PeerMessage::kMaxPeerCount; ++player)
+		{
+			mNextMissingTicks[player] = mNextLocalInputTick;
+			mRemoteNextMissingTicks[player] = mNextLocalInputTick;
+			mRemoteHashTicks[player] = UINT32_MAX;
+		}
+	}
+
+	/************************************************************************/
+	bool LockstepSession::NeedsLocalInput() const
+	{
+		return mNextLocalInputTick <= mSimulation.CurrentTick() + mInputDelay;
+	}
+
+	/************************************************************************/
+	void LockstepSession::AddLocalInput(const PlayerInput& input)
+	{
+		InputFrame& frame = GetFrame(mNextLocalInputTick);
+		frame.Inputs[mLocalPlayer] = input;
+		frame.ReceivedMask |= 1u << mLocalPlayer;
+		mNextMissingTicks[mLocalPlayer] = ++mNextLocalInputTick;
+
+		SendInputs();
+	}
+
+	/************************************************************************/
+	bool LockstepSession::TryAdvance()
+	{
+		ReceiveMessages();
+
+		const uint32_t tick = mSimulation.CurrentTick();
+		const uint32_t allPlayersMask = (1u << mPlayerCount) - 1;
+
+		InputFrame& frame = GetFrame(tick);
+		if ((frame.ReceivedMask & allPlayersMask) != allPlayersMask)
+		{
+			// what this session waits for may have been lost, and so may what the others wait for from it
+			SendInputs();
+			return false;
+		}
+
+		mSimulation.Tick(frame.Inputs.data());
+
+		HashRecord& localHash = mLocalHashes[tick % kWindowSize];
+		localHash.Tick = tick;
+		localHash.Hash = mSimulation.GetStateHash();
+		CompareHashes(tick);
+
+		return true;
+	}
+
+	/************************************************************************/
+	void LockstepSession::Poll()
+	{
+		// a session done playing still acknowledges the inputs of the others and repeats its own
+		ReceiveMessages();
+		SendInputs();
+	}
+
+	/************************************************************************/
+	uint32_t LockstepSession::CurrentTick() const
+	{
+		return mSimulation.CurrentTick();
+	}
+
+	/************************************************************************/
+	bool LockstepSession::HasDesynced() const
+	{
+		return mDesyncTick != UINT32_MAX;
+	}
+
+	/************************************************************************/
+	uint32_t LockstepSession::DesyncTick() const
+	{
+		return mDesyncTick;
+	}
+
+	/************************************************************************/
+	uint64_t LockstepSession::ComparedHashCount() const
+	{
+		return mComparedHashCount;
+	}
+
+	/************************************************************************/
+	LockstepSession::InputFrame& LockstepSession::GetFrame(uint32_t tick)
+	{
+		// peers send inputs up to twice the input delay ahead of the current tick, kMaxInputDelay keeps them in the window
+		// and ReceiveMessages drops any beyond it, so a slot is always played before its tick comes around again
+		InputFrame& frame = mFrames[tick % kWindowSize];
+		if (frame.Tick != tick)
+		{
+			frame.Tick = tick;
+			frame.ReceivedMask = 0;
+			frame.Inputs.assign(mPlayerCount, PlayerInput());
+		}
+		return frame;
+	}
+
+	/************************************************************************/
+	void LockstepSession::ReceiveMessages()
+	{
+		PeerMessage message;
+		while (mTransport.Receive(mLocalPlayer, message))
+		{
+			if (message.PlayerIndex >= mPlayerCount || message.PlayerIndex == mLocalPlayer)
+			{
+				continue;
+			}
+
+			// inputs are received in order, repeated ones, ones after a gap and ones past the window are ignored, the
+			// sender repeats them until they are acknowledged
+			const uint32_t player = message.PlayerIndex;
+			const uint32_t windowEnd = mSimulation.CurrentTick() + kWindowSize;
+			for (uint32_t i = 0; i < message.InputCount && i < PeerMessage::kMaxInputCount; ++i)
+			{
+				if (message.Tick + i == mNextMissingTicks[player] && message.Tick + i < windowEnd)
+				{
+					InputFrame& frame = GetFrame(message.Tick + i);
+					frame.Inputs[player] = message.Inputs[i];
+					frame.ReceivedMask |= 1u << player;
+					++mNextMissingTicks[player];
+				}
+			}
+
+			// what that player already has of the local inputs, they are not sent again
+			if (message.NextMissingTicks[mLocalPlayer] > mRemoteNextMissingTicks[player])
+			{
+				mRemoteNextMissingTicks[player] = message.NextMissingTicks[mLocalPlayer];
+			}
+
+			// repeated messages carry hashes already compared
+			if (message.HashTick != UINT32_MAX && (mRemoteHashTicks[player] == UINT32_MAX || message.HashTick > mRemoteHashTicks[player]))
+			{
+				mRemoteHashTicks[player] = message.HashTick;
+				HashRecord& remoteHash = mRemoteHashes[player * kWindowSize + message.HashTick % kWindowSize];
+				remoteHash.Tick = message.HashTick;
+				remoteHash.Hash = message.StateHash;
+				CompareHashes(message.HashTick);
+			}
+		}
+	}
+
+	/************************************************************************/
+	void LockstepSession::SendInputs()
+	{
+		PeerMessage message = {};
+		message.PlayerIndex = mLocalPlayer;
+
+		// every local input one of the other players is still missing, oldest first
+		uint32_t firstTick = mNextLocalInputTick;
+		for (uint32_t player = 0; player < mPlayerCount; ++player)
+		{
+			if (player != mLocalPlayer && mRemoteNextMissingTicks[player] < firstTick)
+			{
+				firstTick = mRemoteNextMissingTicks[player];
+			}
+		}
+
+		message.Tick = firstTick;
+		message.InputCount = mNextLocalInputTick - firstTick;
+		if (message.InputCount > PeerMessage::kMaxInputCount)
+		{
+			message.InputCount = PeerMessage::kMaxInputCount;
+		}
+		for (uint32_t i = 0; i < message.InputCount; ++i)
+		{
+			message.Inputs[i] = mFrames[(firstTick + i) % kWindowSize].Inputs[mLocalPlayer];
+		}
+
+		for (uint32_t player = 0; player < mPlayerCount; ++player)
+		{
+			message.NextMissingTicks[player] = mNextMissingTicks[player];
+		}
+
+		message.HashTick = UINT32_MAX;
+		if (mSimulation.CurrentTick() > 0)
+		{
+			const HashRecord& lastHash = mLocalHashes[(mSimulation.CurrentTick() - 1) % kWindowSize];
+			message.HashTick = lastHash.Tick;
+			message.StateHash = lastHash.Hash;
+		}
+
+		mTransport.Send(mLocalPlayer, message);
+	}
+
+	/************************************************************************/
+	void LockstepSession::CompareHashes(uint32_t tick)
+	{
+		const HashRecord& localHash = mLocalHashes[tick % kWindowSize];
+		if (localHash.Tick != tick)
+		{
+			// not simulated yet, compared when it is
+			return;
+		}
+
+		for (uint32_t player = 0; player < mPlayerCount; ++player)
+		{
+			HashRecord& remoteHash = mRemoteHashes[player * kWindowSize + tick % kWindowSize];
+			if (player == mLocalPlayer || remoteHash.Tick != tick)
+			{
+				continue;
+			}
+
+			if (remoteHash.Hash != localHash.Hash && tick < mDesyncTick)
+			{
+				mDesyncTick = tick;
+			}
+
+			remoteHash.Tick = UINT32_MAX;
+			++mComparedHashCount;
+		}
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "GameSimulation.h"
+#include "LoopbackTransport.h"
+
+namespace DirectXGame
+{
+	/** Class keeping the simulation of one peer in lockstep with the simulations of the others.
+	 * The local input is sent inputDelay ticks ahead of the tick it is played at, up to kMaxInputDelay, and a tick is only simulated once
+	 * the inputs of every player are known, so all peers simulate the same ticks with the same inputs.
+	 * Every message also carries the state hash of the last tick its sender simulated, a hash that differs from the
+	 * local one means the peers desynced.
+	 * Messages repeat every local input the other peers have not acknowledged, and a stalled session sends again while
+	 * it waits, so lost messages are recovered by later ones.
+	 *@see GameSimulation
+	*/
+	class LockstepSession final
+	{
+	public:
+
+		LockstepSession(GameSimulation& simulation, LoopbackTransport& transport, uint32_t localPlayer, uint32_t inputDelay = kDefaultInputDelay);
+
+		bool NeedsLocalInput() const;
+		void AddLocalInput(const PlayerInput& input);
+		bool TryAdvance();
+		void Poll();
+
+		uint32_t CurrentTick() const;
+		bool HasDesynced() const;
+		uint32_t DesyncTick() const;
+		uint64_t ComparedHashCount() const;
+
+		static const uint32_t kDefaultInputDelay = 2;
+
+	private:
+
+		/** Structure holding the inputs of every player for one tick.
+		*/
+		struct InputFrame
+		{
+			uint32_t Tick;
+			uint32_t ReceivedMask;
+			std::vector<PlayerInput> Inputs;
+		};
+
+		/** Structure holding the state hash of one tick.
+		*/
+		struct HashRecord
+		{
+			uint32_t Tick;
+			uint64_t Hash;
+		};
+
+		InputFrame& GetFrame(uint32_t tick);
+		void ReceiveMessages();
+		void SendInputs();
+		void CompareHashes(uint32_t tick);
+
+		GameSimulation& mSimulation;
+		LoopbackTransport& mTransport;
+		uint32_t mLocalPlayer;
+		uint32_t mPlayerCount;
+		uint32_t mInputDelay;
+		uint32_t mNextLocalInputTick;
+		uint32_t mDesyncTick;
+		uint64_t mComparedHashCount;
+
+		// per player: first tick whose input is not received, first tick of the local inputs that player has not
+		// received, and newest state hash tick received from that player
+		uint32_t mNextMissingTicks[PeerMessage::kMaxPeerCount];
+		uint32_t mRemoteNextMissingTicks[PeerMessage::kMaxPeerCount];
+		uint32_t mRemoteHashTicks[PeerMessage::kMaxPeerCount];
+
+		// rings indexed by tick % kWindowSize, the remote hashes have one ring per player
+		std::vector<InputFrame> mFrames;
+		std::vector<HashRecord> mLocalHashes;
+		std::vector<HashRecord> mRemoteHashes;
+
+		static const uint32_t kWindowSize = 128;
+		static const uint32_t kMaxInputDelay = (kWindowSize - 2) / 2; // inputs up to 2 * delay + 1 ticks ahead stay in the window
+	};
+}
@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "LockstepTest.h"
+#include "RandomInputScript.h"
+#include "LevelGenerator.h"
+#include "MapParser.h"
+#include <chrono>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t LockstepTest::kMaxStepsPerTick = 100; // past that the sessions are considered stuck
+
+	/************************************************************************/
+	LockstepTest& LockstepTest::GetInstance()
+	{
+		static LockstepTest sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	LockstepTestReport LockstepTest::Run(const LockstepTestOptions& options)
+	{
+		LockstepTestReport report = {};
+		report.FirstDesyncRound = UINT32_MAX;
+		report.FirstDesyncTick = UINT32_MAX;
+
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+		auto start = chrono::high_resolution_clock::now();
+
+		for (uint32_t round = 0; round < options.RoundCount; ++round)
+		{
+			uint32_t desyncTick = RunRound(basicMap, options, options.FirstSeed + round, report);
+			if (desyncTick != UINT32_MAX)
+			{
+				++report.DesyncedRoundCount;
+				if (report.FirstDesyncRound == UINT32_MAX)
+				{
+					report.FirstDesyncRound = round;
+					report.FirstDesyncTick = desyncTick;
+				}
+			}
+		}
+
+		chrono::duration<double_t> elapsed = chrono::high_resolution_clock::now() - start;
+		report.ElapsedSeconds = elapsed.count();
+		report.TicksPerSecond = report.ElapsedSeconds > 0 ? report.TickCount / report.ElapsedSeconds : 0;
+
+		return report;
+	}
+
+	/************************************************************************/
+	uint32_t LockstepTest::RunRound(const Map& basicMap, const LockstepTestOptions& options, uint32_t seed, LockstepTestReport& report)
+	{
+		GameSimulationOptions simulationOptions;
+		simulationOptions.Seed = seed;
+		simulationOptions.PlayerCount = options.PlayerCount;
+		simulationOptions.EnemyCount = options.EnemyCount;
+
+		// one peer per player, each with its own copy of the game
+		LoopbackTransport transport(options.PlayerCount, options.LatencyTicks, options.LossPercent, seed + 1);
+		vector<unique_ptr<GameSimulation>> simulations;
+		vector<unique_ptr<LockstepSession>> sessions;
+		vector<RandomInputScript> scripts;
+		for (uint32_t player = 0; player < options.PlayerCount; ++player)
+		{
+			simulations.push_back(make_unique<GameSimulation>());
+			simulations.back()->Initialize(basicMap, simulationOptions);
+			sessions.push_back(make_unique<LockstepSession>(*simulations.back(), transport, player, options.InputDelay));
+			scripts.push_back(RandomInputScript(seed * LevelGenerator::kMaxPlayerCount + player + 1));
+		}
+
+		// a session waiting for a lost input sends again every step, until the input gets through
+		const uint64_t maxStepCount = static_cast<uint64_t>(options.TicksPerRound + 1) * kMaxStepsPerTick;
+		uint64_t stepCount = 0;
+		bool isPlaying = true;
+		while (isPlaying)
+		{
+			if (++stepCount > maxStepCount)
+			{
+				throw runtime_error("lockstep sessions stalled, inputs are not getting through");
+			}
+
+			transport.Advance();
+			isPlaying = false;
+
+			for (uint32_t player = 0; player < options.PlayerCount; ++player)
+			{
+				LockstepSession& session = *sessions[player];
+				if (session.CurrentTick() >= options.TicksPerRound)
+				{
+					session.Poll();
+					continue;
+				}
+
+				if (session.NeedsLocalInput())
+				{
+					session.AddLocalInput(scripts[player].Next());
+				}
+
+				if (session.TryAdvance())
+				{
+					++report.TickCount;
+				}
+				isPlaying = isPlaying || session.CurrentTick() < options.TicksPerRound;
+			}
+		}
+
+		uint32_t desyncTick = UINT32_MAX;
+		for (auto& session : sessions)
+		{
+			report.ComparedHashCount += session->ComparedHashCount();
+			desyncTick = session->DesyncTick() < desyncTick ? session->DesyncTick() : desyncTick;
+		}
+
+		// the last tick is never sent, compare it directly
+		const uint64_t finalHash = simulations.front()->GetStateHash();
+		for (auto& simulation : simulations)
+		{
+			if (simulation->GetStateHash() != finalHash && desyncTick == UINT32_MAX)
+			{
+				desyncTick = simulation->CurrentTick() - 1;
+			}
+		}
+
+		report.MessageCount += transport.SentCount();
+		report.DroppedMessageCount += transport.DroppedCount();
+		return desyncTick;
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "LockstepSession.h"
+
+namespace DirectXGame
+{
+	/** Structure holding the options of a lockstep test run.
+	*/
+	struct LockstepTestOptions
+	{
+		LockstepTestOptions() :
+			FirstSeed(0), RoundCount(20), TicksPerRound(3600), PlayerCount(2), EnemyCount(6), LatencyTicks(1), LossPercent(5),
+			InputDelay(LockstepSession::kDefaultInputDelay)
+		{
+		}
+
+		uint32_t FirstSeed;
+		uint32_t RoundCount;
+		uint32_t TicksPerRound;
+		uint32_t PlayerCount;
+		uint32_t EnemyCount;
+		uint32_t LatencyTicks;
+		uint32_t LossPercent;
+		uint32_t InputDelay;
+	};
+
+	/** Structure holding the results of a lockstep test run.
+	*/
+	struct LockstepTestReport
+	{
+		uint64_t TickCount;
+		uint64_t ComparedHashCount;
+		uint64_t MessageCount;
+		uint64_t DroppedMessageCount;
+		uint32_t DesyncedRoundCount;
+		uint32_t FirstDesyncRound;
+		uint32_t FirstDesyncTick;
+		std::double_t ElapsedSeconds;
+		std::double_t TicksPerSecond;
+	};
+
+	/** Singleton that checks the simulation stays deterministic over long sessions.
+	 * Every round, one simulation per player is started from the same seed, each driven by its own lockstep session
+	 * over a loopback transport that delays and drops messages, and fed by a scripted bot for its local player. The sessions compare their state hashes
+	 * every tick, and the final hashes of all the simulations are compared once the round is played.
+	 *@see LockstepSession
+	*/
+	class LockstepTest final
+	{
+	public:
+
+		LockstepTest(const LockstepTest& rhs) = delete;
+		LockstepTest(const LockstepTest&& rhs) = delete;
+		LockstepTest& operator=(const LockstepTest& rhs) = delete;
+		LockstepTest& operator=(const LockstepTest&& rhs) = delete;
+
+		static LockstepTest& GetInstance();
+
+		LockstepTestReport Run(const LockstepTestOptions& options);
+
+	private:
+
+		LockstepTest() = default;
+		~LockstepTest() = default;
+
+		uint32_t RunRound(const Map& basicMap, const LockstepTestOptions& options, uint32_t seed, LockstepTestReport& report);
+
+		static const uint32_t kMaxStepsPerTick;
+	};
+}
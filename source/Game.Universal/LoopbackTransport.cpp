@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "LoopbackTransport.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	LoopbackTransport::LoopbackTransport(uint32_t peerCount, uint32_t latencyTicks, uint32_t lossPercent, uint32_t seed) :
+		mQueues(peerCount), mCurrentTick(0), mLatencyTicks(latencyTicks), mLossPercent(lossPercent),
+		mRandomState(seed != 0 ? seed : 1), mSentCount(0), mDroppedCount(0)
+	{
+	}
+
+	/************************************************************************/
+	void LoopbackTransport::Advance()
+	{
+		++mCurrentTick;
+	}
+
+	/************************************************************************/
+	void LoopbackTransport::Send(uint32_t sender, const PeerMessage& message)
+	{
+		for (uint32_t peer = 0; peer < mQueues.size(); ++peer)
+		{
+			if (peer == sender)
+			{
+				continue;
+			}
+
+			++mSentCount;
+			if (IsDropped())
+			{
+				++mDroppedCount;
+				continue;
+			}
+
+			PendingMessage pendingMessage;
+			pendingMessage.DeliveryTick = mCurrentTick + mLatencyTicks;
+			pendingMessage.Message = message;
+			mQueues[peer].push_back(pendingMessage);
+		}
+	}
+
+	/************************************************************************/
+	bool LoopbackTransport::Receive(uint32_t receiver, PeerMessage& message)
+	{
+		auto& queue = mQueues[receiver];
+		if (queue.empty() || queue.front().DeliveryTick > mCurrentTick)
+		{
+			return false;
+		}
+
+		message = queue.front().Message;
+		queue.pop_front();
+		return true;
+	}
+
+	/************************************************************************/
+	uint64_t LoopbackTransport::SentCount() const
+	{
+		return mSentCount;
+	}
+
+	/************************************************************************/
+	uint64_t LoopbackTransport::DroppedCount() const
+	{
+		return mDroppedCount;
+	}
+
+	/************************************************************************/
+	bool LoopbackTransport::IsDropped()
+	{
+		if (mLossPercent == 0)
+		{
+			return false;
+		}
+
+		mRandomState ^= mRandomState << 13;
+		mRandomState ^= mRandomState >> 17;
+		mRandomState ^= mRandomState << 5;
+
+		return mRandomState % 100 < mLossPercent;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "PlayerInput.h"
+#include <deque>
+
+namespace DirectXGame
+{
+	/** Structure representing the message a peer sends every tick.
+	 * It carries inputs of its local player for consecutive ticks starting at Tick, the first tick of every player
+	 * it has not received yet, and the state hash of a tick it simulated so the others can check they are still in sync.
+	*/
+	struct PeerMessage
+	{
+		static const uint32_t kMaxInputCount = 16;
+		static const uint32_t kMaxPeerCount = 4;
+
+		uint32_t Tick;
+		uint32_t PlayerIndex;
+		uint32_t InputCount;
+		PlayerInput Inputs[kMaxInputCount];
+		uint32_t NextMissingTicks[kMaxPeerCount];
+		uint32_t HashTick; // UINT32_MAX when the sender has no hash to share yet
+		uint64_t StateHash;
+	};
+
+	/** Class connecting peers running in the same process, every message sent by a peer is queued for all the others.
+	 * It stands in for the network when testing the sessions: messages are held for a number of ticks of latency,
+	 * and a share of them can be dropped, picked by a seeded generator so a test always loses the same messages.
+	 * Messages that are delivered keep their order.
+	 *@see LockstepSession
+	 *@see RollbackSession
+	*/
+	class LoopbackTransport final
+	{
+	public:
+
+		explicit LoopbackTransport(uint32_t peerCount, uint32_t latencyTicks = 0, uint32_t lossPercent = 0, uint32_t seed = 1);
+
+		void Advance();
+		void Send(uint32_t sender, const PeerMessage& message);
+		bool Receive(uint32_t receiver, PeerMessage& message);
+
+		uint64_t SentCount() const;
+		uint64_t DroppedCount() const;
+
+	private:
+
+		/** Structure representing a message on its way.
+		*/
+		struct PendingMessage
+		{
+			uint64_t DeliveryTick;
+			PeerMessage Message;
+		};
+
+		bool IsDropped();
+
+		std::vector<std::deque<PendingMessage>> mQueues;
+		uint64_t mCurrentTick;
+		uint32_t mLatencyTicks;
+		uint32_t mLossPercent;
+		uint32_t mRandomState;
+		uint64_t mSentCount;
+		uint64_t mDroppedCount;
+	};
+}
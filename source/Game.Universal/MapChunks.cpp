@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "MapChunks.h"
+#include "RenderingDataStructures.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	atomic<uint64_t> MapChunks::sLastGeneration(0);
+
+	/************************************************************************/
+	MapChunks::MapChunks() :
+		mChunkCounts(0, 0), mMapSize(0, 0), mGeneration(0)
+	{
+	}
+
+	/************************************************************************/
+	void MapChunks::Initialize(const Map& map)
+	{
+		mGeneration = ++sLastGeneration;
+		mMapSize = XMUINT2(map.MapWidth, map.MapHeight);
+		mChunkCounts = XMUINT2((map.MapWidth + kChunkSize - 1) / kChunkSize, (map.MapHeight + kChunkSize - 1) / kChunkSize);
+		mChunks.assign(mChunkCounts.x * mChunkCounts.y, Chunk());
+
+		for (uint32_t x = 0; x < map.MapWidth; ++x)
+		{
+			for (uint32_t y = 0; y < map.MapHeight; ++y)
+			{
+				if (IsBlock(map.BlocksLayer[x][y]))
+				{
+					Chunk& chunk = mChunks[GetChunkIndex(XMUINT2(x, y))];
+					const uint32_t bit = (y % kChunkSize) * kChunkSize + x % kChunkSize;
+					chunk.Occupancy[bit / 64] |= 1ULL << (bit % 64);
+					++chunk.BlockCount;
+				}
+			}
+		}
+	}
+
+	/************************************************************************/
+	void MapChunks::OnBlockChanged(const Map& map, const XMUINT2& tile)
+	{
+		Chunk& chunk = mChunks[GetChunkIndex(tile)];
+		const uint32_t bit = (tile.y % kChunkSize) * kChunkSize + tile.x % kChunkSize;
+		const uint64_t mask = 1ULL << (bit % 64);
+		const bool wasBlocked = (chunk.Occupancy[bit / 64] & mask) != 0;
+		const bool isBlocked = IsBlock(map.BlocksLayer[tile.x][tile.y]);
+
+		if (isBlocked && !wasBlocked)
+		{
+			chunk.Occupancy[bit / 64] |= mask;
+			++chunk.BlockCount;
+		}
+		else if (!isBlocked && wasBlocked)
+		{
+			chunk.Occupancy[bit / 64] &= ~mask;
+			--chunk.BlockCount;
+		}
+
+		// other layers and other kinds of blocks are drawn too, the chunk changed either way
+		++chunk.Version;
+	}
+
+	/************************************************************************/
+	bool MapChunks::IsBlocked(const XMUINT2& tile) const
+	{
+		// nothing goes past the edges of the map
+		if (tile.x >= mMapSize.x || tile.y >= mMapSize.y)
+		{
+			return true;
+		}
+
+		const Chunk& chunk = mChunks[GetChunkIndex(tile)];
+		const uint32_t bit = (tile.y % kChunkSize) * kChunkSize + tile.x % kChunkSize;
+		return (chunk.Occupancy[bit / 64] & (1ULL << (bit % 64))) != 0;
+	}
+
+	/************************************************************************/
+	bool MapChunks::IsChunkEmpty(uint32_t chunk) const
+	{
+		return mChunks[chunk].BlockCount == 0;
+	}
+
+	/************************************************************************/
+	uint64_t MapChunks::Generation() const
+	{
+		return mGeneration;
+	}
+
+	/************************************************************************/
+	uint32_t MapChunks::ChunkVersion(uint32_t chunk) const
+	{
+		return mChunks[chunk].Version;
+	}
+
+	/************************************************************************/
+	const XMUINT2& MapChunks::ChunkCounts() const
+	{
+		return mChunkCounts;
+	}
+
+	/************************************************************************/
+	uint32_t MapChunks::ChunkCount() const
+	{
+		return static_cast<uint32_t>(mChunks.size());
+	}
+
+	/************************************************************************/
+	uint32_t MapChunks::GetChunkIndex(const XMUINT2& tile) const
+	{
+		return (tile.y / kChunkSize) * mChunkCounts.x + tile.x / kChunkSize;
+	}
+
+	/************************************************************************/
+	bool MapChunks::IsBlock(uint8_t block)
+	{
+		return block == static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock) || block == static_cast<uint8_t>(SpriteIndicesInMap::SolidBlock);
+	}
+}
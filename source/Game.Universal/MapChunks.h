@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+namespace DirectXGame
+{
+	struct Map;
+
+	/** Class splitting the blocks layer of a map in chunks of kChunkSize x kChunkSize tiles.
+	 * Every chunk keeps an occupancy mask, one bit per tile holding a soft or a solid block, which collision and blast
+	 * propagation read instead of the layer, and a version that goes up whenever one of its tiles changes: the dirty
+	 * flag of each user of the map is the version it last saw, so every user only goes over the chunks changed since,
+	 * and a chunk that never changes costs one comparison per frame.
+	 * The layers of the map stay the reference. Initialize rebuilds the chunks from them after any bulk change, under
+	 * a new generation no user has seen, and OnBlockChanged must follow every single change.
+	 *@see Map
+	 *@see TileGrid
+	*/
+	class MapChunks final
+	{
+	public:
+
+		MapChunks();
+
+		void Initialize(const Map& map);
+		void OnBlockChanged(const Map& map, const DirectX::XMUINT2& tile);
+
+		bool IsBlocked(const DirectX::XMUINT2& tile) const;
+		bool IsChunkEmpty(uint32_t chunk) const;
+		uint64_t Generation() const;
+		uint32_t ChunkVersion(uint32_t chunk) const;
+
+		const DirectX::XMUINT2& ChunkCounts() const;
+		uint32_t ChunkCount() const;
+		uint32_t GetChunkIndex(const DirectX::XMUINT2& tile) const;
+
+		static const uint32_t kChunkSize = 16;
+
+	private:
+
+		struct Chunk
+		{
+			uint64_t Occupancy[kChunkSize * kChunkSize / 64]; // a row of tiles after the other
+			uint32_t BlockCount;
+			uint32_t Version;
+		};
+
+		static bool IsBlock(uint8_t block);
+
+		std::vector<Chunk> mChunks;     // row after row
+		DirectX::XMUINT2 mChunkCounts;  // chunks per row, rows of chunks
+		DirectX::XMUINT2 mMapSize;
+		uint64_t mGeneration;           // 0 until initialized
+
+		static std::atomic<uint64_t> sLastGeneration; // maps are generated from several threads
+	};
+}
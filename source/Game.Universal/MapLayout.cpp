@@ -0,0 +1,94 @@
+#include "pch.h"
+#include "MapLayout.h"
+#include "Renderable.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	const XMFLOAT2 MapLayout::kOrigin = XMFLOAT2(-48.f, -32.5f);
+	const XMUINT2 MapLayout::kReferenceTileSize = XMUINT2(52, 52); // pixels, the tiles of BasicMap.json
+	const float_t MapLayout::kTileSpacing = 1.985f; // a little less than the sprite size, neighboring tiles overlap by a hair
+
+	/************************************************************************/
+	MapLayout::MapLayout() :
+		mTileStep(kTileSpacing * Renderable::SpriteScale.x, kTileSpacing * Renderable::SpriteScale.y),
+		mTileExtent(Renderable::SpriteScale), mMapSize(0, 0)
+	{
+	}
+
+	/************************************************************************/
+	MapLayout::MapLayout(const Map& map) :
+		MapLayout()
+	{
+		// a ratio of exactly 1 for the reference size, so the basic map is where it always was
+		const XMFLOAT2 ratio(static_cast<float_t>(map.TileWidth) / kReferenceTileSize.x, static_cast<float_t>(map.TileHeight) / kReferenceTileSize.y);
+		mTileStep = XMFLOAT2(mTileStep.x * ratio.x, mTileStep.y * ratio.y);
+		mTileExtent = XMFLOAT2(mTileExtent.x * ratio.x, mTileExtent.y * ratio.y);
+		mMapSize = XMUINT2(map.MapWidth, map.MapHeight);
+	}
+
+	/************************************************************************/
+	const XMFLOAT2& MapLayout::TileStep() const
+	{
+		return mTileStep;
+	}
+
+	/************************************************************************/
+	const XMFLOAT2& MapLayout::TileExtent() const
+	{
+		return mTileExtent;
+	}
+
+	/************************************************************************/
+	const XMUINT2& MapLayout::MapSize() const
+	{
+		return mMapSize;
+	}
+
+	/************************************************************************/
+	XMFLOAT2 MapLayout::GetPositionFromTile(const XMUINT2& tile) const
+	{
+		return XMFLOAT2(kOrigin.x + tile.x * mTileStep.x, kOrigin.y + tile.y * mTileStep.y);
+	}
+
+	/************************************************************************/
+	XMUINT2 MapLayout::GetTileFromPosition(const XMFLOAT2& position) const
+	{
+		XMFLOAT2 center = GetCenterPositionOfSprite(position);
+		return XMUINT2(static_cast<uint32_t>((center.x - kOrigin.x) / mTileStep.x), static_cast<uint32_t>((center.y - kOrigin.y) / mTileStep.y));
+	}
+
+	/************************************************************************/
+	XMFLOAT2 MapLayout::GetTileCoordinatesFromPosition(const XMFLOAT2& position) const
+	{
+		return XMFLOAT2((position.x - kOrigin.x) / mTileStep.x, (position.y - kOrigin.y) / mTileStep.y);
+	}
+
+	/************************************************************************/
+	XMFLOAT2 MapLayout::GetPositionFromTileCoordinates(const XMFLOAT2& coordinates) const
+	{
+		return XMFLOAT2(kOrigin.x + coordinates.x * mTileStep.x, kOrigin.y + coordinates.y * mTileStep.y);
+	}
+
+	/************************************************************************/
+	XMFLOAT2 MapLayout::GetCenterPositionOfSprite(const XMFLOAT2& position) const
+	{
+		return XMFLOAT2(position.x + mTileStep.x / 2, position.y + mTileStep.y / 2);
+	}
+
+	/************************************************************************/
+	XMFLOAT2 MapLayout::GetSpriteExtents() const
+	{
+		return XMFLOAT2(mTileStep.x / 2, mTileStep.y / 2);
+	}
+
+	/************************************************************************/
+	XMFLOAT4 MapLayout::Bounds() const
+	{
+		// from the outer edge of the first tile sprites to the outer edge of the last ones
+		const XMFLOAT2 lastTile = GetPositionFromTile(XMUINT2(mMapSize.x > 0 ? mMapSize.x - 1 : 0, mMapSize.y > 0 ? mMapSize.y - 1 : 0));
+		return XMFLOAT4(kOrigin.x - mTileExtent.x, kOrigin.y - mTileExtent.y, lastTile.x + mTileExtent.x, lastTile.y + mTileExtent.y);
+	}
+}
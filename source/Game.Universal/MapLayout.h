@@ -0,0 +1,44 @@
+#pragma once
+
+#include "RenderingDataStructures.h"
+
+namespace DirectXGame
+{
+	/** Class placing the tiles of a map in the world.
+	 * The world does not depend on the screen, the camera decides what part of it is seen. Tile (0, 0) of every map
+	 * is at kOrigin and the tiles are as far apart as the TileWidth and TileHeight of the map JSON make them: a tile
+	 * of kReferenceTileSize pixels, the size the sprites are drawn for, is kTileSpacing sprite scales wide.
+	 * A position is where the sprite of a tile is drawn, it goes back to the nearest tile.
+	 *@see LevelManager
+	 *@see FollowCamera
+	*/
+	class MapLayout final
+	{
+	public:
+
+		MapLayout();
+		explicit MapLayout(const Map& map);
+
+		const DirectX::XMFLOAT2& TileStep() const;
+		const DirectX::XMFLOAT2& TileExtent() const;
+		const DirectX::XMUINT2& MapSize() const;
+
+		DirectX::XMFLOAT2 GetPositionFromTile(const DirectX::XMUINT2& tile) const;
+		DirectX::XMUINT2 GetTileFromPosition(const DirectX::XMFLOAT2& position) const;
+		DirectX::XMFLOAT2 GetTileCoordinatesFromPosition(const DirectX::XMFLOAT2& position) const;
+		DirectX::XMFLOAT2 GetPositionFromTileCoordinates(const DirectX::XMFLOAT2& coordinates) const;
+		DirectX::XMFLOAT2 GetCenterPositionOfSprite(const DirectX::XMFLOAT2& position) const;
+		DirectX::XMFLOAT2 GetSpriteExtents() const;
+		DirectX::XMFLOAT4 Bounds() const;
+
+		static const DirectX::XMFLOAT2 kOrigin;
+		static const DirectX::XMUINT2 kReferenceTileSize;
+		static const std::float_t kTileSpacing;
+
+	private:
+
+		DirectX::XMFLOAT2 mTileStep;   // distance between the positions of neighboring tiles
+		DirectX::XMFLOAT2 mTileExtent; // half size of the sprite of a tile
+		DirectX::XMUINT2 mMapSize;     // in tiles
+	};
+}
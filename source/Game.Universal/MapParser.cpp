@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "MapParser.h"
+#include "Profiler.h"
 #include <istreamwrapper.h>
 
 using namespace std;
@@ -18,9 +19,11 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	Map MapParser::ParseMapSpriteSheet()
+	Map MapParser::ParseMapSpriteSheet(const string& filePath)
 	{
-		ifstream ifs(kMapJSONPath);
+		ProfileScope scope("MapParser::ParseMapSpriteSheet");
+
+		ifstream ifs(filePath);
 		IStreamWrapper ist(ifs);
 
 		Document jsonDoc;
@@ -37,6 +40,7 @@ namespace DirectXGame
 		assert(layers.IsArray());
 
 		PopulateLayers(basicMap, layers);
+		basicMap.Chunks.Initialize(basicMap);
 
 		assert(jsonDoc.HasMember("restrictedTiles"));
 
@@ -45,6 +49,7 @@ namespace DirectXGame
 
 		PopulateRestrictedTiles(basicMap, restrictedTiles);
 		basicMap.PlayerSpawnTile = basicMap.RestrictedTiles[0];
+		basicMap.PlayerSpawnTiles.push_back(basicMap.PlayerSpawnTile);
 
 		return basicMap;
 	}
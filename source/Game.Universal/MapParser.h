@@ -18,7 +18,7 @@ namespace DirectXGame
 
 		static MapParser& GetInstance();
 
-		Map ParseMapSpriteSheet();
+		Map ParseMapSpriteSheet(const std::string& filePath = kMapJSONPath);
 
 	private:
 
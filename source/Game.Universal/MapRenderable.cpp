@@ -4,6 +4,11 @@
 #include "LevelGenerator.h"
 #include "SpriteSheetParser.h"
 #include "CollisionManager.h"
+#include "LevelManager.h"
+#include "StateHash.h"
+#include "MetricsRegistry.h"
+#include "ViewCulling.h"
+#include "RenderStateCache.h"
 
 using namespace std;
 using namespace DirectX;
@@ -11,19 +16,69 @@ using namespace DX;
 
 namespace DirectXGame
 {
-	const string MapRenderable::kJSONFilePath = "Assets/JSONS/Props.json";
-	const wstring MapRenderable::kTextureMapPath = L"Assets/SpriteSheets/PropsSpriteSheet.png";
+	const string MapRenderable::kJSONFilePath = "Assets/JSONS/Atlas/Props.json";
+	const wstring MapRenderable::kTextureMapPath = L"Assets/SpriteSheets/Atlas.png";
 	const string MapRenderable::kSoftBlockFadingAnimationName = "SoftBlockFading";
 	const double_t MapRenderable::kSoftBlockFadingAnimationLength = 0.1;
 
 	/************************************************************************/
 	MapRenderable::MapRenderable(const shared_ptr<DX::DeviceResources>& deviceResources, const shared_ptr<Camera>& camera,
-								 const string& jsonPath, const wstring & textureMapPath, XMFLOAT2 position) :
-		Renderable(deviceResources, camera, jsonPath, textureMapPath, position), mIsPerkConsumed(false)
+								 uint32_t playerCount, const string& jsonPath, const wstring & textureMapPath, XMFLOAT2 position) :
+		Renderable(deviceResources, camera, jsonPath, textureMapPath, position), mIsPerkConsumed(false), mUploadedCellCount(0), mTileGridLoadingComplete(false)
 	{
+		// the level is generated once, the sprites are initialized again every time the device is created
+		mMap = LevelGenerator::GetInstance().GenerateLevel(playerCount);
+		LevelManager::GetInstance().SetMap(mMap);
+
 		InitializeSprites();
 	}
 
+	/************************************************************************/
+	void MapRenderable::CreateDeviceDependentResources()
+	{
+		Renderable::CreateDeviceDependentResources();
+
+		// the tile buffers need the sprite sheet, they are created on the first upload
+		auto loadVSTask = ReadDataAsync(L"TileGridVS.cso");
+		loadVSTask.then([this](const std::vector<byte>& fileData)
+		{
+			ThrowIfFailed(
+				mDeviceResources->GetD3DDevice()->CreateVertexShader(
+					&fileData[0],
+					fileData.size(),
+					nullptr,
+					mTileGridVertexShader.ReleaseAndGetAddressOf()
+				)
+			);
+
+			CD3D11_BUFFER_DESC constantBufferDesc(sizeof(VSCBufferTileGrid), D3D11_BIND_CONSTANT_BUFFER);
+			ThrowIfFailed(
+				mDeviceResources->GetD3DDevice()->CreateBuffer(
+					&constantBufferDesc,
+					nullptr,
+					mVSCBufferTileGrid.ReleaseAndGetAddressOf()
+				)
+			);
+
+			mTileGridLoadingComplete = true;
+		});
+	}
+
+	/************************************************************************/
+	void MapRenderable::ReleaseDeviceDependentResources()
+	{
+		Renderable::ReleaseDeviceDependentResources();
+
+		mTileGridLoadingComplete = false;
+		mTileGridVertexShader.Reset();
+		mVSCBufferTileGrid.Reset();
+		mTileSprites.Reset();
+		mTileSpritesView.Reset();
+		mSpriteRects.Reset();
+		mSpriteRectsView.Reset();
+		mUploadedCellCount = 0;
+	}
+
 	/************************************************************************/
 	void MapRenderable::Update(const StepTimer& timer)
 	{
@@ -36,13 +91,13 @@ namespace DirectXGame
 	void MapRenderable::Render(const StepTimer& timer)
 	{
 		// Loading is asynchronous. Only draw geometry after it's loaded.
-		if (!mLoadingComplete)
+		if (!mLoadingComplete || !mTileGridLoadingComplete)
 		{
 			return;
 		}
 
+		RenderTileGrid();
 		Renderable::Render(timer);
-		RenderBasicMap();
 		RenderFadingSoftBlocks();
 	}
 
@@ -56,6 +111,8 @@ namespace DirectXGame
 	void MapRenderable::AddFadingBlock(const DirectX::XMUINT2& tile)
 	{
 		mMap.BlocksLayer[tile.x][tile.y] = static_cast<uint8_t>(SpriteIndicesInMap::None);
+		mMap.Chunks.OnBlockChanged(mMap, tile);
+		LevelManager::GetInstance().OnBlockDestroyed(mMap, tile);
 
 		FadingSoftBlock fadingSoftBlock(mRenderableSpriteSheet.Animations[kSoftBlockFadingAnimationName], GetPositionFromTile(tile));
 		mFadingBlocks.push_back(fadingSoftBlock);
@@ -73,63 +130,122 @@ namespace DirectXGame
 		return mIsPerkConsumed;
 	}
 
+	/************************************************************************/
+	uint64_t MapRenderable::GetStateHash() const
+	{
+		StateHash hash;
+		for (auto& column : mMap.BlocksLayer)
+		{
+			hash.Add(column);
+		}
+		hash.Add(mIsPerkConsumed);
+		for (auto& fadingBlock : mFadingBlocks)
+		{
+			hash.Add(fadingBlock.Position);
+			hash.Add(fadingBlock.AnimTimer);
+		}
+		return hash.Value();
+	}
+
 	/************************************************************************/
 	void MapRenderable::InitializeSprites()
 	{
 		mRenderableSpriteSheet = SpriteSheetParser::GetInstance().ParseSpriteSheet(mSpriteSheetJSONPath);
 		mRenderableSpriteSheet.Animations[kSoftBlockFadingAnimationName]->AnimationLength = kSoftBlockFadingAnimationLength;
-		mMap = LevelGenerator::GetInstance().GenerateLevel();
 	}
 
 	/************************************************************************/
-	void MapRenderable::RenderBasicMap()
+	void MapRenderable::RenderTileGrid()
 	{
-		for (uint32_t y = 0; y < mMap.MapHeight; ++y)
-		{
-			for (uint32_t x = 0; x < mMap.MapWidth; ++x)
-			{
-				XMUINT2 currentTile(x, y);
+		UploadTileGrid();
 
-				// render bg tile
-				uint32_t currentSpriteIndex = mMap.BackgroundLayer[x][y];
-				if (currentSpriteIndex > 0 && currentSpriteIndex != 5) // todo fix the gray background problem
-				{
-					RenderTile(currentTile, --currentSpriteIndex);
-				}
-			}
+		MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+		mTileGrid.SetVisibleTiles(ViewCulling::GetInstance().GetVisibleTiles(mCamera->VisibleRectangle(), mTileGrid.Constants()));
+		metrics.Add(MetricsRegistry::kCulledSprites, mTileGrid.CellCount() - mTileGrid.InstanceCount());
+		if (mTileGrid.InstanceCount() == 0)
+		{
+			return;
 		}
 
-		if (!mIsPerkConsumed)
+		ID3D11DeviceContext* direct3DDeviceContext = mDeviceResources->GetD3DDeviceContext();
+		DeviceRenderStateCache& renderState = DeviceRenderStateCache::GetInstance();
+		renderState.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		renderState.SetInputLayout(nullptr);
+
+		renderState.SetVertexShader(mTileGridVertexShader.Get());
+		renderState.SetPixelShader(mPixelShader.Get());
+
+		XMStoreFloat4x4(&mVSCBufferTileGridData.ViewProjection, XMMatrixTranspose(mCamera->ViewProjectionMatrix()));
+		mVSCBufferTileGridData.Grid = mTileGrid.Constants();
+		direct3DDeviceContext->UpdateSubresource(mVSCBufferTileGrid.Get(), 0, nullptr, &mVSCBufferTileGridData, 0, 0);
+		renderState.SetVSConstantBuffer(0, mVSCBufferTileGrid.Get());
+
+		renderState.SetVSShaderResource(0, mTileSpritesView.Get());
+		renderState.SetVSShaderResource(1, mSpriteRectsView.Get());
+		renderState.SetPSShaderResource(0, mSpriteSheet.Get());
+		renderState.SetPSSampler(0, mTextureSampler.Get());
+		renderState.SetBlendState(mAlphaBlending.Get());
+
+		// one instance per visible tile of every layer, the layers are in drawing order
+		direct3DDeviceContext->DrawInstanced(TileGrid::kVerticesPerTile, mTileGrid.InstanceCount(), 0, 0);
+
+		metrics.Add(MetricsRegistry::kConstantBufferUpdates);
+		metrics.Add(MetricsRegistry::kDrawCalls);
+	}
+
+	/************************************************************************/
+	void MapRenderable::UploadTileGrid()
+	{
+		ID3D11Device* direct3DDevice = mDeviceResources->GetD3DDevice();
+		ID3D11DeviceContext* direct3DDeviceContext = mDeviceResources->GetD3DDeviceContext();
+
+		if (mSpriteRects == nullptr)
 		{
-			RenderTile(mMap.PerkTile.Tile, mMap.PerkTile.SpriteIndex);
+			const vector<XMFLOAT4> spriteRects = TileGrid::GetSpriteRects(mRenderableSpriteSheet);
+
+			D3D11_BUFFER_DESC spriteRectsDesc = { 0 };
+			spriteRectsDesc.ByteWidth = static_cast<UINT>(sizeof(XMFLOAT4) * spriteRects.size());
+			spriteRectsDesc.Usage = D3D11_USAGE_IMMUTABLE;
+			spriteRectsDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+			D3D11_SUBRESOURCE_DATA spriteRectsData = { 0 };
+			spriteRectsData.pSysMem = spriteRects.data();
+			ThrowIfFailed(direct3DDevice->CreateBuffer(&spriteRectsDesc, &spriteRectsData, mSpriteRects.ReleaseAndGetAddressOf()));
+
+			CD3D11_SHADER_RESOURCE_VIEW_DESC spriteRectsViewDesc(mSpriteRects.Get(), DXGI_FORMAT_R32G32B32A32_FLOAT, 0, static_cast<UINT>(spriteRects.size()));
+			ThrowIfFailed(direct3DDevice->CreateShaderResourceView(mSpriteRects.Get(), &spriteRectsViewDesc, mSpriteRectsView.ReleaseAndGetAddressOf()));
 		}
 
-		RenderTile(mMap.DoorTile.Tile, mMap.DoorTile.SpriteIndex);
+		mTileGrid.Update(mMap, mIsPerkConsumed);
 
-		for (uint32_t y = 0; y < mMap.MapHeight; ++y)
+		if (mUploadedCellCount != mTileGrid.CellCount())
 		{
-			for (uint32_t x = 0; x < mMap.MapWidth; ++x)
-			{
-				XMUINT2 currentTile(x, y);
+			// first upload, or a map of another size: the buffer is created with every cell
+			D3D11_BUFFER_DESC tileSpritesDesc = { 0 };
+			tileSpritesDesc.ByteWidth = mTileGrid.CellCount();
+			tileSpritesDesc.Usage = D3D11_USAGE_DEFAULT;
+			tileSpritesDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 
-				// render blocks
-				uint32_t currentSpriteIndex = mMap.BlocksLayer[x][y];
-				if (currentSpriteIndex > 0)
-				{
-					RenderTile(currentTile, --currentSpriteIndex);
-				}
+			D3D11_SUBRESOURCE_DATA tileSpritesData = { 0 };
+			tileSpritesData.pSysMem = mTileGrid.Cells().data();
+			ThrowIfFailed(direct3DDevice->CreateBuffer(&tileSpritesDesc, &tileSpritesData, mTileSprites.ReleaseAndGetAddressOf()));
+
+			CD3D11_SHADER_RESOURCE_VIEW_DESC tileSpritesViewDesc(mTileSprites.Get(), DXGI_FORMAT_R8_UINT, 0, mTileGrid.CellCount());
+			ThrowIfFailed(direct3DDevice->CreateShaderResourceView(mTileSprites.Get(), &tileSpritesViewDesc, mTileSpritesView.ReleaseAndGetAddressOf()));
+
+			mUploadedCellCount = mTileGrid.CellCount();
+		}
+		else
+		{
+			// a byte per destroyed block or consumed perk
+			for (uint32_t cell : mTileGrid.ChangedCells())
+			{
+				const D3D11_BOX cellBox = { cell, 0, 0, cell + 1, 1, 1 };
+				direct3DDeviceContext->UpdateSubresource(mTileSprites.Get(), 0, &cellBox, &mTileGrid.Cells()[cell], 0, 0);
 			}
 		}
-	}
-
-	/************************************************************************/
-	void MapRenderable::RenderTile(const XMUINT2& tile, const uint32_t spriteIndex)
-	{
-		auto sprite = mRenderableSpriteSheet.Sprites[spriteIndex];
-		XMFLOAT2 tilePosition = GetPositionFromTile(tile);
-		Transform2D transform(tilePosition, 0, SpriteScale);
 
-		DrawSprite(*sprite, transform);
+		mTileGrid.ClearChangedCells();
 	}
 
 	/************************************************************************/
@@ -137,7 +253,7 @@ namespace DirectXGame
 	{
 		for (auto& block : mFadingBlocks)
 		{
-			auto sprite = block.Anim.Sprites[block.Anim.CurrentSpriteIndex];
+			const auto& sprite = block.Anim.Sprites[block.Anim.CurrentSpriteIndex];
 			Transform2D transform(block.Position , 0, SpriteScale);
 
 			DrawSprite(*sprite, transform);
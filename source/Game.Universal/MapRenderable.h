@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Renderable.h"
+#include "TileGrid.h"
 
 namespace DirectXGame
 {
@@ -24,15 +25,21 @@ namespace DirectXGame
 	};
 
 	/** Class handling a renderable map.
+	 * The background, the perk, the door and the blocks are one instanced draw of the tile grid, whose quads are
+	 * generated by TileGridVS; only the tiles that changed since the last frame are uploaded. The fading soft blocks
+	 * are drawn as sprites on top.
+	 *@see TileGrid
 	*/
 	class MapRenderable final : public Renderable
 	{
 	public:
 
 		MapRenderable(const std::shared_ptr<DX::DeviceResources>& deviceResources, const std::shared_ptr<DX::Camera>& camera,
-					  const std::string& jsonPath = kJSONFilePath, const std::wstring& textureMapPath = kTextureMapPath, 
-					  DirectX::XMFLOAT2 position = kMapStartPosition);
+					  uint32_t playerCount = 1, const std::string& jsonPath = kJSONFilePath, const std::wstring& textureMapPath = kTextureMapPath, 
+					  DirectX::XMFLOAT2 position = MapLayout::kOrigin);
 
+		virtual void CreateDeviceDependentResources() override;
+		virtual void ReleaseDeviceDependentResources() override;
 		virtual void Update(const DX::StepTimer& timer) override;
 		virtual void Render(const DX::StepTimer& timer) override;
 
@@ -40,6 +47,7 @@ namespace DirectXGame
 		void AddFadingBlock(const DirectX::XMUINT2& tile);
 		void PerkConsumed();
 		bool IsPerkConsumed() const;
+		uint64_t GetStateHash() const;
 
 	protected:
 
@@ -47,8 +55,14 @@ namespace DirectXGame
 
 	private:
 
-		void RenderBasicMap();
-		void RenderTile(const DirectX::XMUINT2& tile, const std::uint32_t spriteIndex);
+		struct VSCBufferTileGrid
+		{
+			DirectX::XMFLOAT4X4 ViewProjection;
+			TileGridConstants Grid;
+		};
+
+		void RenderTileGrid();
+		void UploadTileGrid();
 		void RenderFadingSoftBlocks();
 
 		void UpdateAnimations(const DX::StepTimer& timer);
@@ -56,6 +70,17 @@ namespace DirectXGame
 		Map mMap;
 		bool mIsPerkConsumed;
 
+		TileGrid mTileGrid;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> mTileGridVertexShader;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mVSCBufferTileGrid;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mTileSprites;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mTileSpritesView;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mSpriteRects;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mSpriteRectsView;
+		VSCBufferTileGrid mVSCBufferTileGridData;
+		uint32_t mUploadedCellCount;
+		bool mTileGridLoadingComplete;
+
 		std::vector<FadingSoftBlock> mFadingBlocks;
 
 		static const std::string kJSONFilePath;
@@ -14,10 +14,22 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	uint32_t MathHelper::GetRangedRandom(const uint32_t max, const uint32_t min)
+	uint32_t MathHelper::GetRangedRandom(default_random_engine& generator, const uint32_t max, const uint32_t min)
 	{
 		uniform_int_distribution<uint32_t> dist(min, max);
-		return dist(mRandomGenerator);
+		return dist(generator);
+	}
+
+	/************************************************************************/
+	default_random_engine& MathHelper::GetGenerator()
+	{
+		return mRandomGenerator;
+	}
+
+	/************************************************************************/
+	uint32_t MathHelper::GetRangedRandom(const uint32_t max, const uint32_t min)
+	{
+		return GetRangedRandom(mRandomGenerator, max, min);
 	}
 
 	/************************************************************************/
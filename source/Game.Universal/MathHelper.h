@@ -17,6 +17,10 @@ namespace DirectXGame
 
 		static MathHelper& GetInstance();
 
+		static uint32_t GetRangedRandom(std::default_random_engine& generator, const uint32_t max, const uint32_t min = 0);
+
+		std::default_random_engine& GetGenerator();
+
 		uint32_t GetRangedRandom(const uint32_t max, const uint32_t min = 0);
 		uint16_t GetRangedRandom(const uint16_t max, const uint16_t min = 0);
 		uint8_t GetRangedRandom(const uint8_t max, const uint8_t min = 0);
@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "MetricsRegistry.h"
+#include "AllocationCounter.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	// registered in this order by the constructor
+	const uint32_t MetricsRegistry::kDrawCalls = 0;
+	const uint32_t MetricsRegistry::kConstantBufferUpdates = 1;
+	const uint32_t MetricsRegistry::kAllocations = 2;
+	const uint32_t MetricsRegistry::kCulledSprites = 3;
+	const uint32_t MetricsRegistry::kSkippedBinds = 4;
+
+	/************************************************************************/
+	MetricsRegistry& MetricsRegistry::GetInstance()
+	{
+		static MetricsRegistry sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	MetricsRegistry::MetricsRegistry() :
+		mMetricCount(0), mLastAllocationCount(AllocationCounter::Count()), mStatistics(kMaxMetricCount)
+	{
+		for (uint32_t metric = 0; metric < kMaxMetricCount; ++metric)
+		{
+			mCounters[metric] = 0;
+			mFrameValues[metric] = 0;
+		}
+
+		Register("draw calls");
+		Register("cbuffer updates");
+		Register("allocations");
+		Register("culled sprites");
+		Register("skipped binds");
+	}
+
+	/************************************************************************/
+	uint32_t MetricsRegistry::Register(const string& name)
+	{
+		lock_guard<mutex> lock(mNamesMutex);
+
+		for (uint32_t metric = 0; metric < mNames.size(); ++metric)
+		{
+			if (mNames[metric] == name)
+			{
+				return metric;
+			}
+		}
+
+		if (mNames.size() >= kMaxMetricCount)
+		{
+			throw runtime_error("too many metrics, " + name + " does not fit");
+		}
+
+		mNames.push_back(name);
+		mMetricCount = static_cast<uint32_t>(mNames.size());
+		return mMetricCount - 1;
+	}
+
+	/************************************************************************/
+	void MetricsRegistry::Add(uint32_t metric, uint64_t value)
+	{
+		mCounters[metric].fetch_add(value, memory_order_relaxed);
+	}
+
+	/************************************************************************/
+	void MetricsRegistry::EndFrame(double_t frameMilliseconds)
+	{
+		const uint32_t metricCount = mMetricCount;
+		for (uint32_t metric = 0; metric < metricCount; ++metric)
+		{
+			mFrameValues[metric] = mCounters[metric].exchange(0, memory_order_relaxed);
+		}
+
+		const uint64_t allocationCount = AllocationCounter::Count();
+		mFrameValues[kAllocations] += allocationCount - mLastAllocationCount;
+		mLastAllocationCount = allocationCount;
+
+		mStatistics.AddFrame(frameMilliseconds, mFrameValues);
+	}
+
+	/************************************************************************/
+	uint32_t MetricsRegistry::MetricCount() const
+	{
+		return mMetricCount;
+	}
+
+	/************************************************************************/
+	string MetricsRegistry::GetName(uint32_t metric) const
+	{
+		lock_guard<mutex> lock(mNamesMutex);
+		return mNames[metric];
+	}
+
+	/************************************************************************/
+	const FrameStatistics& MetricsRegistry::Statistics() const
+	{
+		return mStatistics;
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "FrameStatistics.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+
+namespace DirectXGame
+{
+	/** Singleton collecting the counters subsystems publish every frame, and the statistics of the last frames.
+	 * A subsystem registers its metric once by name and then adds to it from any thread, for the cost of a relaxed
+	 * atomic increment. At the end of each frame, the counters go into the frame statistics with the frame time
+	 * and restart from zero. Draw calls, constant buffer updates and heap allocations are always registered.
+	 *@see FrameStatistics
+	*/
+	class MetricsRegistry final
+	{
+	public:
+
+		MetricsRegistry(const MetricsRegistry& rhs) = delete;
+		MetricsRegistry(const MetricsRegistry&& rhs) = delete;
+		MetricsRegistry& operator=(const MetricsRegistry& rhs) = delete;
+		MetricsRegistry& operator=(const MetricsRegistry&& rhs) = delete;
+
+		static MetricsRegistry& GetInstance();
+
+		uint32_t Register(const std::string& name);
+		void Add(uint32_t metric, uint64_t value = 1);
+		void EndFrame(std::double_t frameMilliseconds);
+
+		uint32_t MetricCount() const;
+		std::string GetName(uint32_t metric) const;
+		const FrameStatistics& Statistics() const;
+
+		static const uint32_t kMaxMetricCount = 16;
+		static const uint32_t kDrawCalls;
+		static const uint32_t kConstantBufferUpdates;
+		static const uint32_t kAllocations;
+		static const uint32_t kCulledSprites;
+		static const uint32_t kSkippedBinds;
+
+	private:
+
+		MetricsRegistry();
+		~MetricsRegistry() = default;
+
+		mutable std::mutex mNamesMutex;
+		std::vector<std::string> mNames;
+		std::atomic<uint32_t> mMetricCount;
+		std::atomic<uint64_t> mCounters[kMaxMetricCount];
+
+		uint64_t mFrameValues[kMaxMetricCount];
+		uint64_t mLastAllocationCount;
+		FrameStatistics mStatistics;
+	};
+}
@@ -0,0 +1,417 @@
+#include "pch.h"
+#include "MicroBenchmarks.h"
+#include "CollisionManager.h"
+#include "Renderable.h"
+#include "BlastPropagation.h"
+#include "NavigationGrid.h"
+#include "LevelGenerator.h"
+#include "MapParser.h"
+#include "SpriteSheetParser.h"
+#include "ViewCulling.h"
+#include "ConstantRingBuffer.h"
+#include "RenderSortKeys.h"
+#include <algorithm>
+#include <chrono>
+#include <ostreamwrapper.h>
+#include <prettywriter.h>
+
+using namespace std;
+using namespace DirectX;
+using namespace rapidjson;
+
+namespace DirectXGame
+{
+	const uint32_t MicroBenchmarks::kFormatVersion = 1;
+	const string MicroBenchmarks::kSpriteSheetJSONPath = "Assets/JSONS/Atlas/MC.json"; // the players, the largest sprite sheet
+	const uint32_t MicroBenchmarks::kQueryCount = 64;
+	const uint32_t MicroBenchmarks::kBombCount = 6;
+	const uint32_t MicroBenchmarks::kExplosionCount = 12;
+	const uint32_t MicroBenchmarks::kLargeMapSize = 128; // tiles per side of the scrolling maps the large map benchmarks run on
+	const uint32_t MicroBenchmarks::kSpritesPerFrame = 10000;
+	const uint32_t MicroBenchmarks::kSpriteConstantsSize = 80; // the world view projection and the UV rectangle of a sprite
+	const uint32_t MicroBenchmarks::kSortedSpriteCount = 50000; // sprites RenderQueue sorts in a busy frame
+	const uint64_t MicroBenchmarks::kMaxIterationsPerSample = 1ULL << 32;
+
+	/************************************************************************/
+	MicroBenchmarks& MicroBenchmarks::GetInstance()
+	{
+		static MicroBenchmarks sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	vector<MicroBenchmarkResult> MicroBenchmarks::Run(const MicroBenchmarkOptions& options)
+	{
+		// a level in the middle of a game: a few bombs ticking and a few blasts burning
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+		default_random_engine generator(options.Seed);
+		const Map map = LevelGenerator::GetInstance().GenerateLevel(basicMap, generator, LevelGenerator::kMaxPlayerCount);
+
+		NavigationGrid grid;
+		grid.Initialize(map);
+		vector<XMUINT2> openTiles;
+		for (uint32_t index = 0; index < grid.CellCount(); ++index)
+		{
+			if (grid.GetCell(index) == static_cast<uint8_t>(NavigationCellFlags::None))
+			{
+				openTiles.push_back(grid.GetTile(index));
+			}
+		}
+		shuffle(openTiles.begin(), openTiles.end(), generator);
+		for (uint32_t i = 0; i < kBombCount && i < openTiles.size(); ++i)
+		{
+			grid.AddBomb(openTiles[i]);
+		}
+		for (uint32_t i = kBombCount; i < kBombCount + kExplosionCount && i < openTiles.size(); ++i)
+		{
+			grid.AddExplosion(openTiles[i]);
+		}
+
+		// players spread over the open tiles, a little off center and moving in every direction
+		static const XMFLOAT2 kVelocities[] = { XMFLOAT2(0.1f, 0), XMFLOAT2(-0.1f, 0), XMFLOAT2(0, 0.1f), XMFLOAT2(0, -0.1f), XMFLOAT2(0, 0) };
+		vector<PlayerCollisionQuery> templateQueries;
+		vector<XMFLOAT2> positions;
+		for (uint32_t i = 0; i < kQueryCount; ++i)
+		{
+			XMFLOAT2 position = Renderable::GetPositionFromTile(openTiles[i % openTiles.size()]);
+			position.x += 0.25f * static_cast<float_t>(i % 3);
+			position.y += 0.25f * static_cast<float_t>(i % 5);
+			positions.push_back(position);
+			templateQueries.push_back(PlayerCollisionQuery(position, kVelocities[i % (sizeof(kVelocities) / sizeof(kVelocities[0]))]));
+		}
+
+		vector<MicroBenchmarkResult> results;
+
+		vector<PlayerCollisionQuery> queries;
+		Add(results, "CollisionManager::PlayersCollisionCheck", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				queries = templateQueries;
+				CollisionManager::GetInstance().PlayersCollisionCheck(map, grid, nullptr, queries);
+				for (auto& query : queries)
+				{
+					checksum += static_cast<uint64_t>(query.Type) + query.Restrictions.CanMoveOnX + 2 * query.Restrictions.CanMoveOnY;
+				}
+			}
+			return checksum;
+		}, options);
+
+		Add(results, "Renderable::GetTileFromPosition", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				for (auto& position : positions)
+				{
+					XMUINT2 tile = Renderable::GetTileFromPosition(position);
+					checksum += tile.x + tile.y;
+				}
+			}
+			return checksum;
+		}, options);
+
+		Add(results, "Renderable::GetPositionFromTile", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				for (uint32_t index = 0; index < grid.CellCount(); ++index)
+				{
+					XMFLOAT2 position = Renderable::GetPositionFromTile(grid.GetTile(index));
+					checksum += static_cast<uint64_t>(position.x * 8 + position.y * 8 + 4096);
+				}
+			}
+			return checksum;
+		}, options);
+
+		// what Bomb::Explode computes, for bombs of every range all over the level
+		vector<BlastTile> flames;
+		vector<XMUINT2> destroyedBlocks;
+		Add(results, "BlastPropagation::Propagate", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				for (uint32_t bomb = 0; bomb < kQueryCount; ++bomb)
+				{
+					flames.clear();
+					destroyedBlocks.clear();
+					BlastPropagation::GetInstance().Propagate(map, openTiles[bomb % openTiles.size()], 1 + bomb % 5, flames, destroyedBlocks);
+					checksum += flames.size() + 16 * destroyedBlocks.size();
+				}
+			}
+			return checksum;
+		}, options);
+
+		Add(results, "LevelGenerator::GenerateLevel", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				default_random_engine levelGenerator(static_cast<uint32_t>(options.Seed + i));
+				Map level = LevelGenerator::GetInstance().GenerateLevel(basicMap, levelGenerator);
+				checksum += level.DoorTile.Tile.x + level.DoorTile.Tile.y * 32 + level.PerkTile.Tile.x * 1024;
+			}
+			return checksum;
+		}, options);
+
+		// the stress scenarios play on maps far larger than the screen
+		const Map largeMap = LevelGenerator::GetInstance().ExpandMap(basicMap, kLargeMapSize, kLargeMapSize);
+		Add(results, "LevelGenerator::GenerateLevel large map", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				default_random_engine levelGenerator(static_cast<uint32_t>(options.Seed + i));
+				Map level = LevelGenerator::GetInstance().GenerateLevel(largeMap, levelGenerator, LevelGenerator::kMaxPlayerCount);
+				checksum += level.DoorTile.Tile.x + level.DoorTile.Tile.y * 256 + level.PerkTile.Tile.x * 65536;
+			}
+			return checksum;
+		}, options);
+
+		// a frame of the tile grid on a large level where nothing changed, only the chunk versions are compared
+		default_random_engine largeLevelGenerator(options.Seed);
+		const Map largeLevel = LevelGenerator::GetInstance().GenerateLevel(largeMap, largeLevelGenerator, LevelGenerator::kMaxPlayerCount);
+		TileGrid largeTileGrid;
+		largeTileGrid.Update(largeLevel, false);
+		Add(results, "TileGrid::Update large map", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				largeTileGrid.ClearChangedCells();
+				largeTileGrid.Update(largeLevel, false);
+				checksum += largeTileGrid.ChangedCells().size() + 1;
+			}
+			return checksum;
+		}, options);
+
+		Add(results, "SpriteSheetParser::ParseSpriteSheet", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				SpriteSheet spriteSheet = SpriteSheetParser::GetInstance().ParseSpriteSheet(kSpriteSheetJSONPath);
+				checksum += spriteSheet.Sprites.size() + spriteSheet.Animations.size();
+			}
+			return checksum;
+		}, options);
+
+		Add(results, "MapParser::ParseMapSpriteSheet", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				Map parsedMap = MapParser::GetInstance().ParseMapSpriteSheet();
+				checksum += parsedMap.MapWidth * parsedMap.MapHeight + parsedMap.PlayerSpawnTiles.size();
+			}
+			return checksum;
+		}, options);
+
+		// a scrolling map far larger than the view, with the default camera looking at places all over it
+		TileGridConstants largeGrid = TileGrid().Constants();
+		largeGrid.GridSize = XMUINT2(kLargeMapSize, kLargeMapSize);
+		const XMFLOAT2 largeMapSize(largeGrid.TileStep.x * kLargeMapSize, largeGrid.TileStep.y * kLargeMapSize);
+		uniform_real_distribution<float_t> cameraDistribution(0.0f, 1.0f);
+		const XMFLOAT2 halfView(DX::OrthographicCamera::DefaultViewWidth / 2, DX::OrthographicCamera::DefaultViewHeight / 2);
+		vector<XMFLOAT4> visibleRectangles;
+		for (uint32_t i = 0; i < kQueryCount; ++i)
+		{
+			const XMFLOAT2 center(largeGrid.Origin.x + cameraDistribution(generator) * largeMapSize.x, largeGrid.Origin.y + cameraDistribution(generator) * largeMapSize.y);
+			visibleRectangles.push_back(XMFLOAT4(center.x - halfView.x, center.y - halfView.y, center.x + halfView.x, center.y + halfView.y));
+		}
+
+		Add(results, "ViewCulling::GetVisibleTiles", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				for (auto& visibleRectangle : visibleRectangles)
+				{
+					TileRange visibleTiles = ViewCulling::GetInstance().GetVisibleTiles(visibleRectangle, largeGrid);
+					checksum += visibleTiles.First.x + visibleTiles.First.y + visibleTiles.Size.x * visibleTiles.Size.y;
+				}
+			}
+			return checksum;
+		}, options);
+
+		// what culling every tile one by one would cost, as the sprites are
+		Add(results, "ViewCulling::IsVisible", [&](uint64_t iterations)
+		{
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				const XMFLOAT4& visibleRectangle = visibleRectangles[i % visibleRectangles.size()];
+				for (uint32_t y = 0; y < kLargeMapSize; ++y)
+				{
+					for (uint32_t x = 0; x < kLargeMapSize; ++x)
+					{
+						const XMFLOAT2 center(largeGrid.Origin.x + static_cast<float_t>(x) * largeGrid.TileStep.x, largeGrid.Origin.y + static_cast<float_t>(y) * largeGrid.TileStep.y);
+						checksum += ViewCulling::GetInstance().IsVisible(visibleRectangle, center, largeGrid.TileExtent) ? 1 : 0;
+					}
+				}
+			}
+			return checksum;
+		}, options);
+
+		// the constants of every sprite of a frame, as DrawSprite takes them from ConstantRingBuffer
+		Add(results, "UploadRing::Allocate", [&](uint64_t iterations)
+		{
+			UploadRing ring(ConstantRingBuffer::kCapacityBytes, ConstantRingBuffer::kRangeAlignment);
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				if (i % kSpritesPerFrame == 0)
+				{
+					ring.BeginFrame();
+				}
+
+				UploadRingAllocation allocation;
+				ring.Allocate(kSpriteConstantsSize, allocation);
+				checksum += allocation.Offset;
+			}
+			return checksum;
+		}, options);
+
+		// the keys of a frame as RenderQueue makes them, a few layers and textures and sprites sharing rows
+		uniform_int_distribution<uint32_t> layerDistribution(0, 3);
+		uniform_int_distribution<uint32_t> textureDistribution(0, 3);
+		uniform_int_distribution<uint32_t> rowDistribution(0, kLargeMapSize - 1);
+		vector<uint64_t> frameKeys;
+		for (uint32_t i = 0; i < kSortedSpriteCount; ++i)
+		{
+			const float_t row = static_cast<float_t>(rowDistribution(generator)) * largeGrid.TileStep.y;
+			frameKeys.push_back(RenderSortKeys::MakeKey(static_cast<float_t>(layerDistribution(generator)) * 3.0f, textureDistribution(generator), row));
+		}
+
+		Add(results, "RenderSortKeys::Sort", [&](uint64_t iterations)
+		{
+			RenderSortKeys sortKeys;
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				sortKeys.Clear();
+				for (uint64_t key : frameKeys)
+				{
+					sortKeys.Add(key);
+				}
+				sortKeys.Sort();
+				checksum += sortKeys.Order().front() + sortKeys.Order().back();
+			}
+			return checksum;
+		}, options);
+
+		// the same keys through the standard library, what the radix sort has to beat
+		Add(results, "std::stable_sort (render sort keys)", [&](uint64_t iterations)
+		{
+			vector<pair<uint64_t, uint32_t>> sortKeys(frameKeys.size());
+			uint64_t checksum = 0;
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				for (uint32_t key = 0; key < frameKeys.size(); ++key)
+				{
+					sortKeys[key] = make_pair(frameKeys[key], key);
+				}
+				stable_sort(sortKeys.begin(), sortKeys.end(), [](const pair<uint64_t, uint32_t>& lhs, const pair<uint64_t, uint32_t>& rhs)
+				{
+					return lhs.first < rhs.first;
+				});
+				checksum += sortKeys.front().second + sortKeys.back().second;
+			}
+			return checksum;
+		}, options);
+
+		return results;
+	}
+
+	/************************************************************************/
+	void MicroBenchmarks::WriteJSON(ostream& stream, const MicroBenchmarkOptions& options, const vector<MicroBenchmarkResult>& results) const
+	{
+		OStreamWrapper wrapper(stream);
+		PrettyWriter<OStreamWrapper> writer(wrapper);
+
+		writer.StartObject();
+		writer.Key("version");
+		writer.Uint(kFormatVersion);
+		writer.Key("seed");
+		writer.Uint(options.Seed);
+		writer.Key("benchmarks");
+		writer.StartArray();
+		for (auto& result : results)
+		{
+			writer.StartObject();
+			writer.Key("name");
+			writer.String(result.Name.c_str());
+			writer.Key("iterations");
+			writer.Uint64(result.IterationsPerSample);
+			writer.Key("samples");
+			writer.Uint(result.SampleCount);
+			writer.Key("median_ns");
+			writer.Double(result.MedianNanoseconds);
+			writer.Key("min_ns");
+			writer.Double(result.MinNanoseconds);
+			writer.Key("mean_ns");
+			writer.Double(result.MeanNanoseconds);
+			writer.Key("max_ns");
+			writer.Double(result.MaxNanoseconds);
+			writer.Key("checksum");
+			writer.Uint64(result.Checksum);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.EndObject();
+
+		stream << endl;
+	}
+
+	/************************************************************************/
+	void MicroBenchmarks::Add(vector<MicroBenchmarkResult>& results, const string& name, const Workload& workload, const MicroBenchmarkOptions& options) const
+	{
+		if (!options.Filter.empty() && name.find(options.Filter) == string::npos)
+		{
+			return;
+		}
+
+		auto time = [&workload](uint64_t iterations, uint64_t& checksum)
+		{
+			auto start = chrono::high_resolution_clock::now();
+			checksum = workload(iterations);
+			return chrono::duration<double_t, nano>(chrono::high_resolution_clock::now() - start).count();
+		};
+
+		MicroBenchmarkResult result = {};
+		result.Name = name;
+		result.SampleCount = options.SampleCount > 0 ? options.SampleCount : 1;
+
+		// the checksum of a single iteration does not depend on how fast the machine is
+		time(1, result.Checksum);
+
+		// the first runs also warm the caches and the allocator
+		uint64_t checksum;
+		const double_t minSampleNanoseconds = options.MinSampleMilliseconds * 1e6;
+		result.IterationsPerSample = 1;
+		while (time(result.IterationsPerSample, checksum) < minSampleNanoseconds && result.IterationsPerSample < kMaxIterationsPerSample)
+		{
+			result.IterationsPerSample *= 2;
+		}
+
+		vector<double_t> samples;
+		for (uint32_t sample = 0; sample < result.SampleCount; ++sample)
+		{
+			samples.push_back(time(result.IterationsPerSample, checksum) / static_cast<double_t>(result.IterationsPerSample));
+		}
+
+		sort(samples.begin(), samples.end());
+		result.MedianNanoseconds = samples[samples.size() / 2];
+		result.MinNanoseconds = samples.front();
+		result.MaxNanoseconds = samples.back();
+		for (auto sample : samples)
+		{
+			result.MeanNanoseconds += sample / static_cast<double_t>(samples.size());
+		}
+
+		results.push_back(result);
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Structure holding the options of a micro benchmark run.
+	*/
+	struct MicroBenchmarkOptions
+	{
+		MicroBenchmarkOptions() :
+			Seed(0), SampleCount(15), MinSampleMilliseconds(10)
+		{
+		}
+
+		uint32_t Seed;
+		uint32_t SampleCount;
+		uint32_t MinSampleMilliseconds;
+		std::string Filter; // only the benchmarks whose name contains it, all of them when empty
+	};
+
+	/** Structure holding the timings of one micro benchmark.
+	 * The checksum is computed from what the measured code returned, it only changes when its behavior does.
+	*/
+	struct MicroBenchmarkResult
+	{
+		std::string Name;
+		uint64_t IterationsPerSample;
+		uint32_t SampleCount;
+		std::double_t MedianNanoseconds;
+		std::double_t MinNanoseconds;
+		std::double_t MeanNanoseconds;
+		std::double_t MaxNanoseconds;
+		uint64_t Checksum;
+	};
+
+	/** Singleton that times the gameplay hot paths one by one, on fixed seeds and level states.
+	 * Each benchmark first doubles its iteration count until a sample lasts MinSampleMilliseconds, then takes
+	 * SampleCount samples; the median time per iteration is the number to track, the spread tells how noisy it is.
+	 * Results are written as JSON, one object per benchmark, so runs can be stored and compared over time:
+	 *  { "version": 1, "seed": 0, "benchmarks": [ { "name": "...", "iterations": 0, "samples": 0,
+	 *    "median_ns": 0.0, "min_ns": 0.0, "mean_ns": 0.0, "max_ns": 0.0, "checksum": 0 } ] }
+	 *@see HeadlessTools
+	*/
+	class MicroBenchmarks final
+	{
+	public:
+
+		MicroBenchmarks(const MicroBenchmarks& rhs) = delete;
+		MicroBenchmarks(const MicroBenchmarks&& rhs) = delete;
+		MicroBenchmarks& operator=(const MicroBenchmarks& rhs) = delete;
+		MicroBenchmarks& operator=(const MicroBenchmarks&& rhs) = delete;
+
+		static MicroBenchmarks& GetInstance();
+
+		std::vector<MicroBenchmarkResult> Run(const MicroBenchmarkOptions& options);
+		void WriteJSON(std::ostream& stream, const MicroBenchmarkOptions& options, const std::vector<MicroBenchmarkResult>& results) const;
+
+		static const uint32_t kFormatVersion;
+
+	private:
+
+		// runs the measured code the given number of times and returns a checksum of what it computed
+		typedef std::function<uint64_t(uint64_t iterations)> Workload;
+
+		MicroBenchmarks() = default;
+		~MicroBenchmarks() = default;
+
+		void Add(std::vector<MicroBenchmarkResult>& results, const std::string& name, const Workload& workload, const MicroBenchmarkOptions& options) const;
+
+		static const std::string kSpriteSheetJSONPath;
+		static const uint32_t kQueryCount;
+		static const uint32_t kBombCount;
+		static const uint32_t kExplosionCount;
+		static const uint32_t kLargeMapSize;
+		static const uint32_t kSpritesPerFrame;
+		static const uint32_t kSpriteConstantsSize;
+		static const uint32_t kSortedSpriteCount;
+		static const uint64_t kMaxIterationsPerSample;
+	};
+}
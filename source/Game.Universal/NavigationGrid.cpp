@@ -0,0 +1,170 @@
+#include "pch.h"
+#include "NavigationGrid.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	NavigationGrid::NavigationGrid() :
+		mWidth(0), mHeight(0), mRevision(0), mChangeLog(kChangeLogSize)
+	{
+	}
+
+	/************************************************************************/
+	void NavigationGrid::Initialize(const Map& map)
+	{
+		bool sizeChanged = mWidth != map.MapWidth || mHeight != map.MapHeight;
+		mWidth = map.MapWidth;
+		mHeight = map.MapHeight;
+		mCells.assign(mWidth * mHeight, static_cast<uint8_t>(NavigationCellFlags::None));
+		mBombCounts.assign(mWidth * mHeight, 0);
+		mExplosionCounts.assign(mWidth * mHeight, 0);
+
+		if (sizeChanged)
+		{
+			mTiles.resize(mWidth * mHeight);
+			for (uint32_t index = 0; index < mWidth * mHeight; ++index)
+			{
+				mTiles[index] = XMUINT2(index % mWidth, index / mWidth);
+			}
+		}
+
+		// the map blocks are stored by column, so walk them in that order
+		const uint8_t solidBlock = static_cast<uint8_t>(SpriteIndicesInMap::SolidBlock);
+		const uint8_t softBlock = static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock);
+		for (uint32_t x = 0; x < mWidth; ++x)
+		{
+			const vector<uint8_t>& column = map.BlocksLayer[x];
+			for (uint32_t y = 0; y < mHeight; ++y)
+			{
+				if (column[y] == solidBlock)
+				{
+					mCells[y * mWidth + x] = static_cast<uint8_t>(NavigationCellFlags::SolidBlock);
+				}
+				else if (column[y] == softBlock)
+				{
+					mCells[y * mWidth + x] = static_cast<uint8_t>(NavigationCellFlags::SoftBlock);
+				}
+			}
+		}
+
+		// everything changed, no change log can describe that
+		mRevision += kChangeLogSize + 1;
+	}
+
+	/************************************************************************/
+	void NavigationGrid::RefreshTile(const Map& map, const XMUINT2& tile)
+	{
+		if (!IsInside(tile))
+		{
+			return;
+		}
+
+		uint32_t index = GetIndex(tile);
+		UpdateFlag(index, NavigationCellFlags::SolidBlock, map.BlocksLayer[tile.x][tile.y] == static_cast<uint8_t>(SpriteIndicesInMap::SolidBlock));
+		UpdateFlag(index, NavigationCellFlags::SoftBlock, map.BlocksLayer[tile.x][tile.y] == static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock));
+		RecordChange(tile);
+	}
+
+	/************************************************************************/
+	void NavigationGrid::AddBomb(const XMUINT2& tile)
+	{
+		if (!IsInside(tile))
+		{
+			return;
+		}
+
+		uint32_t index = GetIndex(tile);
+		++mBombCounts[index];
+		UpdateFlag(index, NavigationCellFlags::Bomb, true);
+		RecordChange(tile);
+	}
+
+	/************************************************************************/
+	void NavigationGrid::RemoveBomb(const XMUINT2& tile)
+	{
+		if (!IsInside(tile))
+		{
+			return;
+		}
+
+		uint32_t index = GetIndex(tile);
+		if (mBombCounts[index] > 0)
+		{
+			--mBombCounts[index];
+		}
+		UpdateFlag(index, NavigationCellFlags::Bomb, mBombCounts[index] > 0);
+		RecordChange(tile);
+	}
+
+	/************************************************************************/
+	void NavigationGrid::AddExplosion(const XMUINT2& tile)
+	{
+		if (!IsInside(tile))
+		{
+			return;
+		}
+
+		uint32_t index = GetIndex(tile);
+		++mExplosionCounts[index];
+		UpdateFlag(index, NavigationCellFlags::Explosion, true);
+		RecordChange(tile);
+	}
+
+	/************************************************************************/
+	void NavigationGrid::RemoveExplosion(const XMUINT2& tile)
+	{
+		if (!IsInside(tile))
+		{
+			return;
+		}
+
+		uint32_t index = GetIndex(tile);
+		if (mExplosionCounts[index] > 0)
+		{
+			--mExplosionCounts[index];
+		}
+		UpdateFlag(index, NavigationCellFlags::Explosion, mExplosionCounts[index] > 0);
+		RecordChange(tile);
+	}
+
+	/************************************************************************/
+	bool NavigationGrid::GetChangesSince(uint32_t revision, vector<XMUINT2>& changes) const
+	{
+		changes.clear();
+		if (mRevision - revision > kChangeLogSize)
+		{
+			// the log was overwritten, the caller has to assume everything changed
+			return false;
+		}
+
+		for (uint32_t r = revision + 1; r <= mRevision; ++r)
+		{
+			changes.push_back(mChangeLog[r % kChangeLogSize]);
+		}
+
+		return true;
+	}
+
+	/************************************************************************/
+	void NavigationGrid::UpdateFlag(uint32_t index, NavigationCellFlags flag, bool set)
+	{
+		if (set)
+		{
+			mCells[index] = static_cast<uint8_t>(mCells[index] | static_cast<uint8_t>(flag));
+		}
+		else
+		{
+			mCells[index] = static_cast<uint8_t>(mCells[index] & ~static_cast<uint8_t>(flag));
+		}
+	}
+
+	/************************************************************************/
+	void NavigationGrid::RecordChange(const XMUINT2& tile)
+	{
+		++mRevision;
+		mChangeLog[mRevision % kChangeLogSize] = tile;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "RenderingDataStructures.h"
+
+namespace DirectXGame
+{
+	/** Enumeration representing what occupies a cell of the navigation grid.
+	*@see NavigationGrid
+	*/
+	enum class NavigationCellFlags : uint8_t
+	{
+		None = 0,
+		SolidBlock = 1 << 0,
+		SoftBlock = 1 << 1,
+		Bomb = 1 << 2,
+		Explosion = 1 << 3
+	};
+
+	/** Class representing a flat, cache friendly copy of the map blocks and of the bombs and explosions occupancy.
+	 * It is kept up to date incrementally, and every change is recorded so that path and reachability results can be
+	 * invalidated only when a change touches them.
+	 *@see Pathfinder
+	*/
+	class NavigationGrid final
+	{
+	public:
+
+		NavigationGrid();
+
+		void Initialize(const Map& map);
+		void RefreshTile(const Map& map, const DirectX::XMUINT2& tile);
+
+		void AddBomb(const DirectX::XMUINT2& tile);
+		void RemoveBomb(const DirectX::XMUINT2& tile);
+		void AddExplosion(const DirectX::XMUINT2& tile);
+		void RemoveExplosion(const DirectX::XMUINT2& tile);
+
+		uint32_t Width() const { return mWidth; }
+		uint32_t Height() const { return mHeight; }
+		uint32_t CellCount() const { return mWidth * mHeight; }
+		uint32_t Revision() const { return mRevision; }
+
+		bool IsInside(const DirectX::XMUINT2& tile) const { return tile.x < mWidth && tile.y < mHeight; }
+		uint32_t GetIndex(const DirectX::XMUINT2& tile) const { return tile.y * mWidth + tile.x; }
+		const DirectX::XMUINT2& GetTile(uint32_t index) const { return mTiles[index]; }
+
+		uint8_t GetCell(uint32_t index) const { return mCells[index]; }
+		bool HasFlag(uint32_t index, NavigationCellFlags flag) const { return (mCells[index] & static_cast<uint8_t>(flag)) != 0; }
+		bool GetChangesSince(uint32_t revision, std::vector<DirectX::XMUINT2>& changes) const;
+
+	private:
+
+		void UpdateFlag(uint32_t index, NavigationCellFlags flag, bool set);
+		void RecordChange(const DirectX::XMUINT2& tile);
+
+		uint32_t mWidth;
+		uint32_t mHeight;
+		uint32_t mRevision;
+		std::vector<uint8_t> mCells;
+		std::vector<uint8_t> mBombCounts;
+		std::vector<uint8_t> mExplosionCounts;
+		std::vector<DirectX::XMUINT2> mTiles; // tile of every index, saves a division in the search loops
+
+		// ring buffer of the last changed tiles, the change of revision r is stored at r % kChangeLogSize
+		std::vector<DirectX::XMUINT2> mChangeLog;
+
+		static const uint32_t kChangeLogSize = 64;
+	};
+}
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "ObjectPool.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const size_t PoolStorage::kSlotAlignment = 16; // the SIMD types of DirectXMath
+
+	/************************************************************************/
+	PoolStorage::PoolStorage(uint32_t slotsPerChunk) :
+		mFreeSlots(nullptr), mSlotSize(0), mSlotsPerChunk(slotsPerChunk > 0 ? slotsPerChunk : 1), mLiveCount(0)
+	{
+	}
+
+	/************************************************************************/
+	void* PoolStorage::Allocate(size_t size)
+	{
+		if (mSlotSize == 0)
+		{
+			const size_t minSize = size > sizeof(FreeSlot) ? size : sizeof(FreeSlot);
+			mSlotSize = (minSize + kSlotAlignment - 1) & ~(kSlotAlignment - 1);
+		}
+
+		if (size > mSlotSize)
+		{
+			return ::operator new(size);
+		}
+
+		if (mFreeSlots == nullptr)
+		{
+			AddChunk();
+		}
+
+		FreeSlot* slot = mFreeSlots;
+		mFreeSlots = slot->Next;
+		++mLiveCount;
+
+		return slot;
+	}
+
+	/************************************************************************/
+	void PoolStorage::Deallocate(void* slot, size_t size)
+	{
+		if (size > mSlotSize)
+		{
+			::operator delete(slot);
+			return;
+		}
+
+		FreeSlot* freeSlot = static_cast<FreeSlot*>(slot);
+		freeSlot->Next = mFreeSlots;
+		mFreeSlots = freeSlot;
+		--mLiveCount;
+	}
+
+	/************************************************************************/
+	uint32_t PoolStorage::LiveCount() const
+	{
+		return mLiveCount;
+	}
+
+	/************************************************************************/
+	uint32_t PoolStorage::SlotCount() const
+	{
+		return static_cast<uint32_t>(mChunks.size()) * mSlotsPerChunk;
+	}
+
+	/************************************************************************/
+	void PoolStorage::AddChunk()
+	{
+		// new[] only aligns for the fundamental types, the chunk is over allocated to align its first slot
+		mChunks.push_back(unique_ptr<uint8_t[]>(new uint8_t[mSlotSize * mSlotsPerChunk + kSlotAlignment]));
+		uintptr_t address = reinterpret_cast<uintptr_t>(mChunks.back().get());
+		uint8_t* first = reinterpret_cast<uint8_t*>((address + kSlotAlignment - 1) & ~static_cast<uintptr_t>(kSlotAlignment - 1));
+
+		// slots are chained in address order, the first one is handed out first
+		for (uint32_t i = mSlotsPerChunk; i > 0; --i)
+		{
+			FreeSlot* slot = reinterpret_cast<FreeSlot*>(first + (i - 1) * mSlotSize);
+			slot->Next = mFreeSlots;
+			mFreeSlots = slot;
+		}
+	}
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Class keeping fixed size slots in chunks, and recycling freed slots through an intrusive free list.
+	 * The slot size is fixed by the first allocation, every later one must ask for the same size; a request for
+	 * another size goes to the heap, so a pool shared by mistake still works, only without its benefit.
+	 *@see ObjectPool
+	*/
+	class PoolStorage final
+	{
+	public:
+
+		explicit PoolStorage(uint32_t slotsPerChunk);
+		PoolStorage(const PoolStorage& rhs) = delete;
+		PoolStorage& operator=(const PoolStorage& rhs) = delete;
+		~PoolStorage() = default;
+
+		void* Allocate(size_t size);
+		void Deallocate(void* slot, size_t size);
+
+		uint32_t LiveCount() const;
+		uint32_t SlotCount() const;
+
+	private:
+
+		void AddChunk();
+
+		struct FreeSlot
+		{
+			FreeSlot* Next;
+		};
+
+		std::vector<std::unique_ptr<uint8_t[]>> mChunks;
+		FreeSlot* mFreeSlots;
+		size_t mSlotSize;
+		uint32_t mSlotsPerChunk;
+		uint32_t mLiveCount;
+
+		static const size_t kSlotAlignment;
+	};
+
+	/** Allocator giving standard containers and allocate_shared the slots of a pool storage.
+	 * Rebinding keeps the same storage, which is how the control block of a shared pointer and the object it owns
+	 * end up in one slot.
+	 *@see PoolStorage
+	*/
+	template <typename T>
+	class PoolAllocator
+	{
+	public:
+
+		typedef T value_type;
+
+		explicit PoolAllocator(PoolStorage& storage) :
+			mStorage(&storage)
+		{
+		}
+
+		template <typename U>
+		PoolAllocator(const PoolAllocator<U>& rhs) :
+			mStorage(rhs.Storage())
+		{
+		}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(mStorage->Allocate(count * sizeof(T)));
+		}
+
+		void deallocate(T* pointer, size_t count)
+		{
+			mStorage->Deallocate(pointer, count * sizeof(T));
+		}
+
+		PoolStorage* Storage() const
+		{
+			return mStorage;
+		}
+
+		template <typename U>
+		bool operator==(const PoolAllocator<U>& rhs) const
+		{
+			return mStorage == rhs.Storage();
+		}
+
+		template <typename U>
+		bool operator!=(const PoolAllocator<U>& rhs) const
+		{
+			return mStorage != rhs.Storage();
+		}
+
+	private:
+
+		PoolStorage* mStorage;
+	};
+
+	/** Class creating the long lived entities of one type from a pool, instead of one heap allocation each.
+	 * Objects are handed out as shared pointers whose control block shares the slot of the object, so placing and
+	 * exploding bombs all game long keeps reusing the same few slots. The pool must outlive every object it created.
+	 *@see PoolStorage
+	*/
+	template <typename T>
+	class ObjectPool final
+	{
+	public:
+
+		explicit ObjectPool(uint32_t slotsPerChunk = 16) :
+			mStorage(slotsPerChunk)
+		{
+		}
+
+		template <typename... Arguments>
+		std::shared_ptr<T> MakeShared(Arguments&&... arguments)
+		{
+			return std::allocate_shared<T>(PoolAllocator<T>(mStorage), std::forward<Arguments>(arguments)...);
+		}
+
+		uint32_t LiveCount() const
+		{
+			return mStorage.LiveCount();
+		}
+
+		uint32_t SlotCount() const
+		{
+			return mStorage.SlotCount();
+		}
+
+	private:
+
+		PoolStorage mStorage;
+	};
+}
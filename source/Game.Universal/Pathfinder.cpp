@@ -0,0 +1,381 @@
+#include "pch.h"
+#include "Pathfinder.h"
+#include <algorithm>
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	const uint32_t Pathfinder::kUnreachable = UINT32_MAX;
+
+	/************************************************************************/
+	Pathfinder::Pathfinder() :
+		mFloodStamp(0), mFloodRevision(0), mFloodStart(0, 0), mHasFloodFill(false), mSearchStamp(0)
+	{
+	}
+
+	/************************************************************************/
+	uint32_t Pathfinder::FloodFill(const NavigationGrid& grid, const XMUINT2& start, const NavigationRules& rules)
+	{
+		mHasFloodFill = false;
+		if (!grid.IsInside(start))
+		{
+			return 0;
+		}
+
+		PrepareBuffers(grid);
+		uint32_t stamp = NextStamp(mFloodStamps, mFloodStamp);
+		uint32_t reachedCount = 1;
+		uint32_t neighbours[4];
+
+		uint32_t startIndex = grid.GetIndex(start);
+		mFloodStamps[startIndex] = stamp;
+		mFloodCosts[startIndex] = 0;
+
+		bool uniformCost = !rules.PassSoftBlocks || rules.SoftBlockCost == 0;
+		if (uniformCost)
+		{
+			// breadth first search, the queue is a flat array since every cell is pushed once at most
+			uint32_t head = 0;
+			uint32_t tail = 0;
+			mFloodQueue[tail++] = startIndex;
+
+			while (head < tail)
+			{
+				uint32_t index = mFloodQueue[head++];
+				uint32_t neighbourCount = GetNeighbours(grid, index, neighbours);
+
+				for (uint32_t i = 0; i < neighbourCount; ++i)
+				{
+					uint32_t neighbour = neighbours[i];
+					if (mFloodStamps[neighbour] == stamp || !IsWalkable(grid, neighbour, rules))
+					{
+						continue;
+					}
+
+					mFloodStamps[neighbour] = stamp;
+					mFloodCosts[neighbour] = mFloodCosts[index] + rules.StepCost;
+					mFloodQueue[tail++] = neighbour;
+					++reachedCount;
+				}
+			}
+		}
+		else if (rules.StepCost == 0 && rules.SoftBlockCost == 1)
+		{
+			// 0-1 breadth first search, free cells go to the front of the queue and soft blocks to the back.
+			// a cell is pushed once per neighbour at most, so the queue is a ring over four times the cell count
+			const uint32_t capacity = static_cast<uint32_t>(mFloodQueue.size());
+			uint32_t head = 0;
+			uint32_t count = 1;
+			mFloodQueue[head] = startIndex;
+
+			while (count > 0)
+			{
+				uint32_t index = mFloodQueue[head];
+				head = head + 1 < capacity ? head + 1 : 0;
+				--count;
+
+				uint32_t neighbourCount = GetNeighbours(grid, index, neighbours);
+				for (uint32_t i = 0; i < neighbourCount; ++i)
+				{
+					uint32_t neighbour = neighbours[i];
+					if (!IsWalkable(grid, neighbour, rules))
+					{
+						continue;
+					}
+
+					uint32_t enterCost = GetEnterCost(grid, neighbour, rules);
+					uint32_t cost = mFloodCosts[index] + enterCost;
+					bool visited = mFloodStamps[neighbour] == stamp;
+					if (!visited || cost < mFloodCosts[neighbour])
+					{
+						if (!visited)
+						{
+							++reachedCount;
+						}
+
+						mFloodStamps[neighbour] = stamp;
+						mFloodCosts[neighbour] = cost;
+						if (enterCost == 0)
+						{
+							head = head > 0 ? head - 1 : capacity - 1;
+							mFloodQueue[head] = neighbour;
+						}
+						else
+						{
+							uint32_t tail = head + count;
+							mFloodQueue[tail < capacity ? tail : tail - capacity] = neighbour;
+						}
+						++count;
+					}
+				}
+			}
+		}
+		else
+		{
+			// dijkstra, the soft blocks make the costs non uniform
+			mOpenList.clear();
+			mOpenList.push_back({ 0, 0, startIndex });
+
+			while (!mOpenList.empty())
+			{
+				pop_heap(mOpenList.begin(), mOpenList.end());
+				OpenNode node = mOpenList.back();
+				mOpenList.pop_back();
+
+				if (node.Cost > mFloodCosts[node.Index])
+				{
+					continue;
+				}
+
+				uint32_t neighbourCount = GetNeighbours(grid, node.Index, neighbours);
+				for (uint32_t i = 0; i < neighbourCount; ++i)
+				{
+					uint32_t neighbour = neighbours[i];
+					if (!IsWalkable(grid, neighbour, rules))
+					{
+						continue;
+					}
+
+					uint32_t cost = node.Cost + GetEnterCost(grid, neighbour, rules);
+					bool visited = mFloodStamps[neighbour] == stamp;
+					if (!visited || cost < mFloodCosts[neighbour])
+					{
+						if (!visited)
+						{
+							++reachedCount;
+						}
+
+						mFloodStamps[neighbour] = stamp;
+						mFloodCosts[neighbour] = cost;
+						mOpenList.push_back({ cost, cost, neighbour });
+						push_heap(mOpenList.begin(), mOpenList.end());
+					}
+				}
+			}
+		}
+
+		mFloodRevision = grid.Revision();
+		mFloodStart = start;
+		mFloodRules = rules;
+		mHasFloodFill = true;
+
+		return reachedCount;
+	}
+
+	/************************************************************************/
+	bool Pathfinder::IsFloodFillValid(const NavigationGrid& grid, const XMUINT2& start, const NavigationRules& rules)
+	{
+		if (!mHasFloodFill || mFloodStart.x != start.x || mFloodStart.y != start.y || mFloodRules != rules || 
+			mFloodStamps.size() != grid.CellCount())
+		{
+			return false;
+		}
+
+		if (mFloodRevision == grid.Revision())
+		{
+			return true;
+		}
+
+		if (!grid.GetChangesSince(mFloodRevision, mChanges))
+		{
+			return false;
+		}
+
+		// a change only matters if it is inside the reached area, or next to it
+		uint32_t neighbours[4];
+		for (auto& tile : mChanges)
+		{
+			uint32_t index = grid.GetIndex(tile);
+			if (mFloodStamps[index] == mFloodStamp)
+			{
+				return false;
+			}
+
+			uint32_t neighbourCount = GetNeighbours(grid, index, neighbours);
+			for (uint32_t i = 0; i < neighbourCount; ++i)
+			{
+				if (mFloodStamps[neighbours[i]] == mFloodStamp)
+				{
+					return false;
+				}
+			}
+		}
+
+		mFloodRevision = grid.Revision();
+		return true;
+	}
+
+	/************************************************************************/
+	bool Pathfinder::FindPath(const NavigationGrid& grid, const XMUINT2& start, const XMUINT2& goal, const NavigationRules& rules, vector<XMUINT2>& path)
+	{
+		path.clear();
+		if (!grid.IsInside(start) || !grid.IsInside(goal))
+		{
+			return false;
+		}
+
+		PrepareBuffers(grid);
+		uint32_t stamp = NextStamp(mSearchStamps, mSearchStamp);
+		uint32_t neighbours[4];
+
+		uint32_t startIndex = grid.GetIndex(start);
+		uint32_t goalIndex = grid.GetIndex(goal);
+
+		// manhattan distance is admissible since every step costs at least StepCost
+		auto heuristic = [&grid, &goal, &rules](uint32_t index)
+		{
+			XMUINT2 tile = grid.GetTile(index);
+			uint32_t dx = tile.x > goal.x ? tile.x - goal.x : goal.x - tile.x;
+			uint32_t dy = tile.y > goal.y ? tile.y - goal.y : goal.y - tile.y;
+			return (dx + dy) * rules.StepCost;
+		};
+
+		mSearchStamps[startIndex] = stamp;
+		mSearchCosts[startIndex] = 0;
+		mSearchParents[startIndex] = startIndex;
+
+		mOpenList.clear();
+		mOpenList.push_back({ heuristic(startIndex), 0, startIndex });
+
+		while (!mOpenList.empty())
+		{
+			pop_heap(mOpenList.begin(), mOpenList.end());
+			OpenNode node = mOpenList.back();
+			mOpenList.pop_back();
+
+			if (node.Cost > mSearchCosts[node.Index])
+			{
+				continue;
+			}
+
+			if (node.Index == goalIndex)
+			{
+				for (uint32_t index = goalIndex; index != startIndex; index = mSearchParents[index])
+				{
+					path.push_back(grid.GetTile(index));
+				}
+				path.push_back(start);
+				reverse(path.begin(), path.end());
+
+				return true;
+			}
+
+			uint32_t neighbourCount = GetNeighbours(grid, node.Index, neighbours);
+			for (uint32_t i = 0; i < neighbourCount; ++i)
+			{
+				uint32_t neighbour = neighbours[i];
+				if (!IsWalkable(grid, neighbour, rules))
+				{
+					continue;
+				}
+
+				uint32_t cost = node.Cost + GetEnterCost(grid, neighbour, rules);
+				if (mSearchStamps[neighbour] != stamp || cost < mSearchCosts[neighbour])
+				{
+					mSearchStamps[neighbour] = stamp;
+					mSearchCosts[neighbour] = cost;
+					mSearchParents[neighbour] = node.Index;
+					mOpenList.push_back({ cost + heuristic(neighbour), cost, neighbour });
+					push_heap(mOpenList.begin(), mOpenList.end());
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/************************************************************************/
+	void Pathfinder::PrepareBuffers(const NavigationGrid& grid)
+	{
+		uint32_t cellCount = grid.CellCount();
+		if (mFloodStamps.size() == cellCount)
+		{
+			return;
+		}
+
+		mFloodStamps.assign(cellCount, 0);
+		mFloodCosts.assign(cellCount, 0);
+		mFloodQueue.assign(cellCount * 4, 0);
+		mSearchStamps.assign(cellCount, 0);
+		mSearchCosts.assign(cellCount, 0);
+		mSearchParents.assign(cellCount, 0);
+		mOpenList.reserve(cellCount * 4);
+		mFloodStamp = 0;
+		mSearchStamp = 0;
+		mHasFloodFill = false;
+	}
+
+	/************************************************************************/
+	uint32_t Pathfinder::NextStamp(vector<uint32_t>& stamps, uint32_t& stamp)
+	{
+		++stamp;
+		if (stamp == 0)
+		{
+			fill(stamps.begin(), stamps.end(), 0);
+			stamp = 1;
+		}
+
+		return stamp;
+	}
+
+	/************************************************************************/
+	bool Pathfinder::IsWalkable(const NavigationGrid& grid, uint32_t index, const NavigationRules& rules) const
+	{
+		uint8_t cell = grid.GetCell(index);
+
+		if (cell & static_cast<uint8_t>(NavigationCellFlags::SolidBlock))
+		{
+			return false;
+		}
+		if (!rules.PassSoftBlocks && (cell & static_cast<uint8_t>(NavigationCellFlags::SoftBlock)))
+		{
+			return false;
+		}
+		if (!rules.PassBombs && (cell & static_cast<uint8_t>(NavigationCellFlags::Bomb)))
+		{
+			return false;
+		}
+		if (rules.AvoidExplosions && (cell & static_cast<uint8_t>(NavigationCellFlags::Explosion)))
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	/************************************************************************/
+	uint32_t Pathfinder::GetEnterCost(const NavigationGrid& grid, uint32_t index, const NavigationRules& rules) const
+	{
+		return rules.StepCost + (grid.HasFlag(index, NavigationCellFlags::SoftBlock) ? rules.SoftBlockCost : 0);
+	}
+
+	/************************************************************************/
+	uint32_t Pathfinder::GetNeighbours(const NavigationGrid& grid, uint32_t index, uint32_t neighbours[4]) const
+	{
+		uint32_t count = 0;
+		const XMUINT2& tile = grid.GetTile(index);
+		uint32_t x = tile.x;
+		uint32_t y = tile.y;
+
+		if (x > 0)
+		{
+			neighbours[count++] = index - 1;
+		}
+		if (x + 1 < grid.Width())
+		{
+			neighbours[count++] = index + 1;
+		}
+		if (y > 0)
+		{
+			neighbours[count++] = index - grid.Width();
+		}
+		if (y + 1 < grid.Height())
+		{
+			neighbours[count++] = index + grid.Width();
+		}
+
+		return count;
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "NavigationGrid.h"
+
+namespace DirectXGame
+{
+	/** Structure describing which cells an agent can walk through, and what they cost.
+	*/
+	struct NavigationRules
+	{
+		NavigationRules(const bool passSoftBlocks = false, const bool passBombs = false, const bool avoidExplosions = true,
+						const uint32_t stepCost = 1, const uint32_t softBlockCost = 0) :
+			PassSoftBlocks(passSoftBlocks), PassBombs(passBombs), AvoidExplosions(avoidExplosions),
+			StepCost(stepCost), SoftBlockCost(softBlockCost)
+		{
+		}
+
+		bool operator==(const NavigationRules& rhs) const
+		{
+			return PassSoftBlocks == rhs.PassSoftBlocks && PassBombs == rhs.PassBombs && AvoidExplosions == rhs.AvoidExplosions &&
+				StepCost == rhs.StepCost && SoftBlockCost == rhs.SoftBlockCost;
+		}
+
+		bool operator!=(const NavigationRules& rhs) const { return !operator==(rhs); }
+
+		bool PassSoftBlocks;
+		bool PassBombs;
+		bool AvoidExplosions;
+
+		uint32_t StepCost;      // cost of entering any cell
+		uint32_t SoftBlockCost; // extra cost of entering a soft block, when they can be passed
+	};
+
+	/** Class answering reachability and path queries over a navigation grid.
+	 * All the scratch memory is owned by the path finder and reused between queries, so a query does not allocate
+	 * once the buffers have grown to the grid size. Buffers are reset lazily with generation stamps.
+	 * The result of the last flood fill is kept, and is only invalidated when a grid change touches the reached area.
+	 *@see NavigationGrid
+	*/
+	class Pathfinder final
+	{
+	public:
+
+		Pathfinder();
+
+		uint32_t FloodFill(const NavigationGrid& grid, const DirectX::XMUINT2& start, const NavigationRules& rules);
+		bool IsReachable(const NavigationGrid& grid, const DirectX::XMUINT2& tile) const
+		{
+			return mHasFloodFill && grid.IsInside(tile) && mFloodStamps[grid.GetIndex(tile)] == mFloodStamp;
+		}
+
+		uint32_t GetCost(const NavigationGrid& grid, const DirectX::XMUINT2& tile) const
+		{
+			return IsReachable(grid, tile) ? mFloodCosts[grid.GetIndex(tile)] : kUnreachable;
+		}
+
+		bool IsFloodFillValid(const NavigationGrid& grid, const DirectX::XMUINT2& start, const NavigationRules& rules);
+
+		bool FindPath(const NavigationGrid& grid, const DirectX::XMUINT2& start, const DirectX::XMUINT2& goal,
+					  const NavigationRules& rules, std::vector<DirectX::XMUINT2>& path);
+
+		static const uint32_t kUnreachable;
+
+	private:
+
+		struct OpenNode
+		{
+			uint32_t Priority;
+			uint32_t Cost;
+			uint32_t Index;
+
+			bool operator<(const OpenNode& rhs) const { return Priority > rhs.Priority; } // min heap
+		};
+
+		void PrepareBuffers(const NavigationGrid& grid);
+		uint32_t NextStamp(std::vector<uint32_t>& stamps, uint32_t& stamp);
+		bool IsWalkable(const NavigationGrid& grid, uint32_t index, const NavigationRules& rules) const;
+		uint32_t GetEnterCost(const NavigationGrid& grid, uint32_t index, const NavigationRules& rules) const;
+		uint32_t GetNeighbours(const NavigationGrid& grid, uint32_t index, uint32_t neighbours[4]) const;
+
+		// flood fill results
+		std::vector<uint32_t> mFloodStamps;
+		std::vector<uint32_t> mFloodCosts;
+		std::vector<uint32_t> mFloodQueue;
+		uint32_t mFloodStamp;
+		uint32_t mFloodRevision;
+		DirectX::XMUINT2 mFloodStart;
+		NavigationRules mFloodRules;
+		bool mHasFloodFill;
+
+		// path search scratch
+		std::vector<uint32_t> mSearchStamps;
+		std::vector<uint32_t> mSearchCosts;
+		std::vector<uint32_t> mSearchParents;
+		std::vector<OpenNode> mOpenList;
+		std::vector<DirectX::XMUINT2> mChanges;
+		uint32_t mSearchStamp;
+	};
+}
@@ -0,0 +1,206 @@
+#include "pch.h"
+#include "PathfindingBenchmark.h"
+#include "LevelGenerator.h"
+#include "MapParser.h"
+#include "MathHelper.h"
+#include <chrono>
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	// enemies walk around soft blocks, bombs and explosions
+	const NavigationRules PathfindingBenchmark::kAgentRules(false, false, true);
+
+	// at 60 ticks per second, a bomb explodes after 3 seconds and its blast lasts half a second
+	const uint32_t PathfindingBenchmark::kMaxBombs = 8;
+	const uint32_t PathfindingBenchmark::kTicksBetweenBombs = 20;
+	const uint32_t PathfindingBenchmark::kBombTicks = 180;
+	const uint32_t PathfindingBenchmark::kExplosionTicks = 30;
+	const uint32_t PathfindingBenchmark::kTicksPerStep = 8;
+
+	/************************************************************************/
+	PathfindingBenchmark& PathfindingBenchmark::GetInstance()
+	{
+		static PathfindingBenchmark sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	PathfindingBenchmarkReport PathfindingBenchmark::Run(const PathfindingBenchmarkOptions& options)
+	{
+		PathfindingBenchmarkReport report = {};
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+
+		NavigationGrid grid;
+		vector<Agent> agents(options.AgentCount);
+		vector<BenchmarkBomb> bombs;
+		vector<XMUINT2> openTiles;
+		chrono::duration<double_t> elapsed(0);
+
+		for (uint32_t level = 0; level < options.LevelCount; ++level)
+		{
+			default_random_engine generator(options.FirstSeed + level);
+			Map map = LevelGenerator::GetInstance().GenerateLevel(basicMap, generator);
+			grid.Initialize(map);
+			bombs.clear();
+
+			openTiles.clear();
+			for (uint32_t index = 0; index < grid.CellCount(); ++index)
+			{
+				if (grid.GetCell(index) == static_cast<uint8_t>(NavigationCellFlags::None))
+				{
+					openTiles.push_back(grid.GetTile(index));
+				}
+			}
+
+			for (auto& agent : agents)
+			{
+				agent.Tile = PickTile(openTiles, generator);
+				agent.Goal = agent.Tile;
+				agent.Path.clear();
+				agent.PathIndex = 0;
+			}
+
+			for (uint32_t tick = 0; tick < options.TicksPerLevel; ++tick)
+			{
+				auto tickStart = chrono::high_resolution_clock::now();
+
+				UpdateBombs(grid, bombs, openTiles, tick, generator);
+
+				for (auto& agent : agents)
+				{
+					Pathfinder& pathfinder = agent.AgentPathfinder;
+
+					++report.QueryCount;
+					bool isFloodFillValid = pathfinder.IsFloodFillValid(grid, agent.Tile, kAgentRules);
+					if (isFloodFillValid)
+					{
+						++report.ReusedFloodFillCount;
+					}
+					else
+					{
+						pathfinder.FloodFill(grid, agent.Tile, kAgentRules);
+						++report.FloodFillCount;
+					}
+
+					// plan again when the goal is reached, or when the grid changed around the agent
+					bool pathEnded = agent.PathIndex + 1 >= agent.Path.size();
+					if (!isFloodFillValid || pathEnded)
+					{
+						if (pathEnded || !pathfinder.IsReachable(grid, agent.Goal))
+						{
+							agent.Goal = PickTile(openTiles, generator);
+							++report.QueryCount;
+							if (!pathfinder.IsReachable(grid, agent.Goal))
+							{
+								agent.Goal = agent.Tile;
+							}
+						}
+
+						agent.Path.clear();
+						agent.PathIndex = 0;
+						if (agent.Goal.x != agent.Tile.x || agent.Goal.y != agent.Tile.y)
+						{
+							++report.QueryCount;
+							++report.PathCount;
+							pathfinder.FindPath(grid, agent.Tile, agent.Goal, kAgentRules, agent.Path);
+						}
+					}
+
+					if (tick % kTicksPerStep == 0 && agent.PathIndex + 1 < agent.Path.size())
+					{
+						agent.Tile = agent.Path[++agent.PathIndex];
+					}
+				}
+
+				chrono::duration<double_t> tickDuration = chrono::high_resolution_clock::now() - tickStart;
+				elapsed += tickDuration;
+				report.WorstTickMilliseconds = max(report.WorstTickMilliseconds, tickDuration.count() * 1000);
+				++report.TickCount;
+			}
+		}
+
+		report.ElapsedSeconds = elapsed.count();
+		report.QueriesPerSecond = report.ElapsedSeconds > 0 ? report.QueryCount / report.ElapsedSeconds : 0;
+		report.MillisecondsPerTick = report.TickCount > 0 ? report.ElapsedSeconds * 1000 / report.TickCount : 0;
+
+		return report;
+	}
+
+	/************************************************************************/
+	void PathfindingBenchmark::UpdateBombs(NavigationGrid& grid, vector<BenchmarkBomb>& bombs, const vector<XMUINT2>& openTiles,
+										   uint32_t tick, default_random_engine& generator) const
+	{
+		vector<XMUINT2> blastTiles;
+
+		for (auto it = bombs.begin(); it != bombs.end();)
+		{
+			if (--it->TicksLeft > 0)
+			{
+				++it;
+				continue;
+			}
+
+			GetBlastTiles(grid, it->Tile, blastTiles);
+			if (!it->Exploded)
+			{
+				grid.RemoveBomb(it->Tile);
+				for (auto& tile : blastTiles)
+				{
+					grid.AddExplosion(tile);
+				}
+
+				it->Exploded = true;
+				it->TicksLeft = kExplosionTicks;
+				++it;
+			}
+			else
+			{
+				for (auto& tile : blastTiles)
+				{
+					grid.RemoveExplosion(tile);
+				}
+
+				it = bombs.erase(it);
+			}
+		}
+
+		if (tick % kTicksBetweenBombs == 0 && bombs.size() < kMaxBombs)
+		{
+			BenchmarkBomb bomb;
+			bomb.Tile = PickTile(openTiles, generator);
+			bomb.TicksLeft = kBombTicks;
+			bomb.Exploded = false;
+
+			grid.AddBomb(bomb.Tile);
+			bombs.push_back(bomb);
+		}
+	}
+
+	/************************************************************************/
+	void PathfindingBenchmark::GetBlastTiles(const NavigationGrid& grid, const XMUINT2& center, vector<XMUINT2>& tiles) const
+	{
+		static const int32_t kOffsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+		// the blocks never change during the benchmark, so a blast always covers the same tiles
+		tiles.clear();
+		tiles.push_back(center);
+		for (auto& offset : kOffsets)
+		{
+			XMUINT2 tile(center.x + offset[0], center.y + offset[1]);
+			if (grid.IsInside(tile) && !grid.HasFlag(grid.GetIndex(tile), NavigationCellFlags::SolidBlock) &&
+				!grid.HasFlag(grid.GetIndex(tile), NavigationCellFlags::SoftBlock))
+			{
+				tiles.push_back(tile);
+			}
+		}
+	}
+
+	/************************************************************************/
+	XMUINT2 PathfindingBenchmark::PickTile(const vector<XMUINT2>& tiles, default_random_engine& generator) const
+	{
+		return tiles[MathHelper::GetRangedRandom(generator, static_cast<uint32_t>(tiles.size() - 1))];
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "NavigationGrid.h"
+#include "Pathfinder.h"
+#include <random>
+
+namespace DirectXGame
+{
+	/** Structure holding the options of a path finding benchmark run.
+	*/
+	struct PathfindingBenchmarkOptions
+	{
+		PathfindingBenchmarkOptions() :
+			FirstSeed(0), LevelCount(100), AgentCount(32), TicksPerLevel(600)
+		{
+		}
+
+		uint32_t FirstSeed;
+		uint32_t LevelCount;
+		uint32_t AgentCount;
+		uint32_t TicksPerLevel;
+	};
+
+	/** Structure holding the numbers of a path finding benchmark run.
+	*/
+	struct PathfindingBenchmarkReport
+	{
+		uint64_t TickCount;
+		uint64_t QueryCount;
+		uint64_t FloodFillCount;
+		uint64_t ReusedFloodFillCount;
+		uint64_t PathCount;
+		std::double_t ElapsedSeconds;
+		std::double_t QueriesPerSecond;
+		std::double_t MillisecondsPerTick;
+		std::double_t WorstTickMilliseconds;
+	};
+
+	/** Singleton that measures the navigation code under a game like load.
+	 * Every generated level is played for a number of ticks: each tick a few bombs are dropped or exploded on the grid,
+	 * then every agent checks what it can reach from its tile, and walks one step along a path toward its goal.
+	 * Agents only flood fill again when a grid change touched their reachable area.
+	 *@see Pathfinder
+	*/
+	class PathfindingBenchmark final
+	{
+	public:
+
+		PathfindingBenchmark(const PathfindingBenchmark& rhs) = delete;
+		PathfindingBenchmark(const PathfindingBenchmark&& rhs) = delete;
+		PathfindingBenchmark& operator=(const PathfindingBenchmark& rhs) = delete;
+		PathfindingBenchmark& operator=(const PathfindingBenchmark&& rhs) = delete;
+
+		static PathfindingBenchmark& GetInstance();
+
+		PathfindingBenchmarkReport Run(const PathfindingBenchmarkOptions& options);
+
+	private:
+
+		/** Structure representing a simulated enemy walking around the level.
+		*/
+		struct Agent
+		{
+			DirectX::XMUINT2 Tile;
+			DirectX::XMUINT2 Goal;
+			std::vector<DirectX::XMUINT2> Path;
+			uint32_t PathIndex;
+			Pathfinder AgentPathfinder;
+		};
+
+		/** Structure representing a simulated bomb, ticking then exploding.
+		*/
+		struct BenchmarkBomb
+		{
+			DirectX::XMUINT2 Tile;
+			uint32_t TicksLeft;
+			bool Exploded;
+		};
+
+		PathfindingBenchmark() = default;
+		~PathfindingBenchmark() = default;
+
+		void UpdateBombs(NavigationGrid& grid, std::vector<BenchmarkBomb>& bombs, const std::vector<DirectX::XMUINT2>& openTiles,
+						 uint32_t tick, std::default_random_engine& generator) const;
+		void GetBlastTiles(const NavigationGrid& grid, const DirectX::XMUINT2& center, std::vector<DirectX::XMUINT2>& tiles) const;
+		DirectX::XMUINT2 PickTile(const std::vector<DirectX::XMUINT2>& tiles, std::default_random_engine& generator) const;
+
+		static const NavigationRules kAgentRules;
+		static const uint32_t kMaxBombs;
+		static const uint32_t kTicksBetweenBombs;
+		static const uint32_t kBombTicks;
+		static const uint32_t kExplosionTicks;
+		static const uint32_t kTicksPerStep;
+	};
+}
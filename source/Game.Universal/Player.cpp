@@ -4,11 +4,10 @@
 #include "LevelGenerator.h"
 #include "SpriteSheetParser.h"
 #include "CollisionManager.h"
-#include "KeyboardComponent.h"
-#include "GamePadComponent.h"
 #include "Bomb.h"
 #include "LevelManager.h"
 #include "MapRenderable.h"
+#include "StateHash.h"
 
 using namespace std;
 using namespace DirectX;
@@ -25,8 +24,8 @@ namespace DirectXGame
 	const float_t Player::kButtonCooldownTime = 0.2f;
 
 	// rendering
-	const string Player::kJSONFilePath = "Assets/JSONS/MC.json";
-	const wstring Player::kTextureMapPath = L"Assets/SpriteSheets/MCSpriteSheet.png";
+	const string Player::kJSONFilePath = "Assets/JSONS/Atlas/MC.json";
+	const wstring Player::kTextureMapPath = L"Assets/SpriteSheets/Atlas.png";
 
 	// animation
 	const double_t Player::kDeathAnimationLength = 0.3;
@@ -44,12 +43,10 @@ namespace DirectXGame
 
 
 	/************************************************************************/
-	Player::Player(const shared_ptr<DX::DeviceResources>& deviceResources, const shared_ptr<Camera>& camera,
-				   const shared_ptr<KeyboardComponent>& keyboard, const shared_ptr<GamePadComponent>& gamePad,
+	Player::Player(const shared_ptr<DX::DeviceResources>& deviceResources, const shared_ptr<Camera>& camera, uint32_t playerIndex,
 				   MapRenderable& map, const string& jsonPath, const wstring& textureMapPath) :
 		Renderable(deviceResources, camera, jsonPath, textureMapPath),
-		mKeyBoard(keyboard),
-		mGamePad(gamePad),
+		mIndex(playerIndex),
 		mMap(map),
 		mCurrentPlayerState(PlayerState::Idle),
 		mCurrentAnimation(nullptr),
@@ -59,7 +56,8 @@ namespace DirectXGame
 		mCurrentMovementState(),
 		mPreviousMovementState()
 	{
-		mPosition = GetPositionFromTile(mMap.GetMap().PlayerSpawnTile);
+		const auto& spawnTiles = mMap.GetMap().PlayerSpawnTiles;
+		mPosition = GetPositionFromTile(spawnTiles.empty() ? mMap.GetMap().PlayerSpawnTile : spawnTiles[mIndex % spawnTiles.size()]);
 		// for debug
 		//++mPerks.BombUp;
 		//++mPerks.Fire;
@@ -69,28 +67,10 @@ namespace DirectXGame
 	/************************************************************************/
 	void Player::Update(const DX::StepTimer& timer)
 	{
-		switch (mCurrentPlayerState)
+		// playing players are moved by PlayerManager, with the collisions of all the players checked at once
+		if (mCurrentPlayerState == PlayerState::Dying)
 		{
-			case DirectXGame::PlayerState::Idle:
-			case DirectXGame::PlayerState::Moving:
-			{
-				ProcessInput();
-				UpdateVelocity();
-				UpdateAnimation(timer);
-				VelocityRestrictions velocityRestrictions = CheckCollisions(timer);
-				UpdatePosition(timer, velocityRestrictions);
-				break;
-			}
-
-			case DirectXGame::PlayerState::Dying:
-			{
-				UpdateAnimation(timer);
-				break;
-			}
-
-			case DirectXGame::PlayerState::Dead:
-			default:
-				break;
+			UpdateAnimation(timer);
 		}
 	}
 
@@ -104,12 +84,69 @@ namespace DirectXGame
 		}
 
 		Renderable::Render(timer);
-		auto sprite = mCurrentAnimation->Sprites[mCurrentAnimation->CurrentSpriteIndex];
+		const auto& sprite = mCurrentAnimation->Sprites[mCurrentAnimation->CurrentSpriteIndex];
 		Transform2D transform(mPosition, 0, SpriteScale);
 
 		DrawSprite(*sprite, transform);
 	}
 
+	/************************************************************************/
+	void Player::SetInput(const PlayerInput& input)
+	{
+		mPreviousInput = mInput;
+		mInput = input;
+	}
+
+	/************************************************************************/
+	bool Player::IsPlaying() const
+	{
+		return mCurrentPlayerState == PlayerState::Idle || mCurrentPlayerState == PlayerState::Moving;
+	}
+
+	/************************************************************************/
+	XMFLOAT2 Player::PrepareMovement(const StepTimer& timer)
+	{
+		ProcessInput();
+		UpdateVelocity();
+		UpdateAnimation(timer);
+
+		return XMFLOAT2(static_cast<float_t>(mVelocity.x * timer.GetElapsedSeconds()), static_cast<float_t>(mVelocity.y * timer.GetElapsedSeconds()));
+	}
+
+	/************************************************************************/
+	void Player::ApplyMovement(const StepTimer& timer, PlayerCollisionType collisionType, const VelocityRestrictions& velocityRestrictions)
+	{
+		HandleCollision(collisionType);
+		UpdatePosition(timer, velocityRestrictions);
+	}
+
+	/************************************************************************/
+	uint32_t Player::Index() const
+	{
+		return mIndex;
+	}
+
+	/************************************************************************/
+	PlayerState Player::GetState() const
+	{
+		return mCurrentPlayerState;
+	}
+
+	/************************************************************************/
+	uint64_t Player::GetStateHash() const
+	{
+		StateHash hash;
+		hash.Add(mPosition);
+		hash.Add(mVelocity);
+		hash.Add(mPerks);
+		hash.Add(mInput.Flags);
+		hash.Add(mPreviousInput.Flags);
+		hash.Add(mCurrentPlayerState);
+		hash.Add(mAnimationTimer);
+		hash.Add(static_cast<uint32_t>(mBombs.size()));
+		return hash.Value();
+	}
+
 	/************************************************************************/
 	const Perks& Player::GetPerks() const
 	{
@@ -154,28 +191,25 @@ namespace DirectXGame
 	/************************************************************************/
 	void Player::ProcessInput()
 	{
-		if (!((mKeyBoard->IsKeyDown(Keys::A) || mKeyBoard->IsKeyDown(Keys::Left) || mGamePad->IsButtonDown(GamePadButtons::DPadLeft))
-			  && (mKeyBoard->IsKeyDown(Keys::D) || mKeyBoard->IsKeyDown(Keys::Right) || mGamePad->IsButtonDown(GamePadButtons::DPadRight))))
+		// when both directions of an axis are held, keep going the way the player was going
+		if (!(mInput.IsSet(PlayerInputFlags::Left) && mInput.IsSet(PlayerInputFlags::Right)))
 		{
-			mCurrentMovementState.GoingLeft = mKeyBoard->IsKeyDown(Keys::A) || mKeyBoard->IsKeyDown(Keys::Left) || mGamePad->IsButtonDown(GamePadButtons::DPadLeft);
-			mCurrentMovementState.GoingRight = mKeyBoard->IsKeyDown(Keys::D) || mKeyBoard->IsKeyDown(Keys::Right) || mGamePad->IsButtonDown(GamePadButtons::DPadRight);
+			mCurrentMovementState.GoingLeft = mInput.IsSet(PlayerInputFlags::Left);
+			mCurrentMovementState.GoingRight = mInput.IsSet(PlayerInputFlags::Right);
 		}
 
-		if (!((mKeyBoard->IsKeyDown(Keys::W) || mKeyBoard->IsKeyDown(Keys::Up) || mGamePad->IsButtonDown(GamePadButtons::DPadUp))
-			  && (mKeyBoard->IsKeyDown(Keys::S) || mKeyBoard->IsKeyDown(Keys::Down) || mGamePad->IsButtonDown(GamePadButtons::DPadDown))))
+		if (!(mInput.IsSet(PlayerInputFlags::Up) && mInput.IsSet(PlayerInputFlags::Down)))
 		{
-			mCurrentMovementState.GoingUp = mKeyBoard->IsKeyDown(Keys::W) || mKeyBoard->IsKeyDown(Keys::Up) || mGamePad->IsButtonDown(GamePadButtons::DPadUp);
-			mCurrentMovementState.GoingDown = mKeyBoard->IsKeyDown(Keys::S) || mKeyBoard->IsKeyDown(Keys::Down) || mGamePad->IsButtonDown(GamePadButtons::DPadDown);
+			mCurrentMovementState.GoingUp = mInput.IsSet(PlayerInputFlags::Up);
+			mCurrentMovementState.GoingDown = mInput.IsSet(PlayerInputFlags::Down);
 		}
 
-		if (mKeyBoard->IsKeyDown(Keys::Z) && !mKeyBoard->IsKeyHeldDown(Keys::Z)
-			|| mGamePad->IsButtonDown(GamePadButtons::A) && !mGamePad->IsButtonHeldDown(GamePadButtons::A))
+		if (mInput.IsSet(PlayerInputFlags::PlaceBomb) && !mPreviousInput.IsSet(PlayerInputFlags::PlaceBomb))
 		{
 			PlaceBomb();
 		}
 
-		if (mKeyBoard->IsKeyDown(Keys::X) && !mKeyBoard->IsKeyHeldDown(Keys::X)
-			|| mGamePad->IsButtonDown(GamePadButtons::B) && !mGamePad->IsButtonHeldDown(GamePadButtons::B))
+		if (mInput.IsSet(PlayerInputFlags::Detonate) && !mPreviousInput.IsSet(PlayerInputFlags::Detonate))
 		{
 			ExplodeBombs();
 		}
@@ -236,13 +270,9 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	VelocityRestrictions Player::CheckCollisions(const DX::StepTimer& timer)
+	void Player::HandleCollision(PlayerCollisionType collisionType)
 	{
-		VelocityRestrictions restrictions;
-		XMFLOAT2 frameVelocity(static_cast<float_t>(mVelocity.x * timer.GetElapsedSeconds()), static_cast<float_t>(mVelocity.y * timer.GetElapsedSeconds()));
-		PlayerCollisionType collsionType = CollisionManager::GetInstance().PlayerCollisionCheck(mPosition, frameVelocity, restrictions);
-
-		switch (collsionType)
+		switch (collisionType)
 		{
 			case DirectXGame::PlayerCollisionType::None:
 			{
@@ -255,16 +285,13 @@ namespace DirectXGame
 			}
 
 			case DirectXGame::PlayerCollisionType::BombAE:
+			case DirectXGame::PlayerCollisionType::Enemy:
 			{
 				mAnimationTimer = 0;
 				mCurrentAnimation = mRenderableSpriteSheet.Animations[kDeathAnimationName];
 				mCurrentPlayerState = PlayerState::Dying;
 				break;
 			}
-			case DirectXGame::PlayerCollisionType::Enemy:
-			{
-				break;
-			}
 			case DirectXGame::PlayerCollisionType::Perk:
 			{
 				ApplyPerk();
@@ -281,7 +308,6 @@ namespace DirectXGame
 			default:
 				break;
 		}
-		return restrictions;
 	}
 
 	/************************************************************************/
@@ -415,6 +441,10 @@ namespace DirectXGame
 			case DirectXGame::PerksIndicesInSpriteSheet::Fire:
 			{
 				++mPerks.Fire;
+				for (auto& bomb : mBombs)
+				{
+					LevelManager::GetInstance().OnBombRangeChanged(*bomb);
+				}
 				break;
 			}
 
@@ -454,18 +484,15 @@ namespace DirectXGame
 	{
 		if (mBombs.size() <= mPerks.BombUp)
 		{
-			for (auto bomb : mBombs)
+			// one bomb per tile, whoever placed it
+			const NavigationGrid& grid = LevelManager::GetInstance().GetNavigationGrid();
+			XMUINT2 playerTile = GetTileFromPosition(mPosition);
+			if (!grid.IsInside(playerTile) || grid.HasFlag(grid.GetIndex(playerTile), NavigationCellFlags::Bomb))
 			{
-				XMUINT2 bombTile = GetTileFromPosition(bomb->Position());
-				XMUINT2 playerTile = GetTileFromPosition(mPosition);
-
-				if (bombTile.x == playerTile.x && bombTile.y == playerTile.y)
-				{
-					return;
-				}
+				return;
 			}
 
-			auto bomb = make_shared<Bomb>(mDeviceResources, mCamera, *this);
+			auto bomb = LevelManager::GetInstance().GetBombPool().MakeShared(mDeviceResources, mCamera, *this);
 			mBombs.push_back(bomb);
 			LevelManager::GetInstance().AddBomb(bomb);
 		}
@@ -476,9 +503,11 @@ namespace DirectXGame
 	{
 		if (mPerks.Remote)
 		{
-			vector<shared_ptr<Bomb>> vect = mBombs;
-			for (auto& bomb : vect)
+			// exploding a bomb removes it from mBombs, the reference keeps it alive until it is done. They go off in the
+			// order they were placed, as GameSimulation detonates them, since the order decides the chain reactions
+			while (!mBombs.empty())
 			{
+				shared_ptr<Bomb> bomb = mBombs.front();
 				bomb->Explode();
 			}
 		}
@@ -2,25 +2,11 @@
 
 #include "Renderable.h"
 #include "CollisionManager.h"
-
-namespace DX
-{
-	class KeyboardComponent;
-	class GamePadComponent;
-}
+#include "PlayerInput.h"
+#include "TrackingAllocator.h"
 
 namespace DirectXGame
 {
-	/** Enumeration representing the different states the player can have in the game.
-	*/
-	enum class PlayerState
-	{
-		Idle,
-		Moving,
-		Dying,
-		Dead
-	};
-
 	/** Structure describing the player's movement state.
 	*/
 	struct PlayerMovementState
@@ -50,46 +36,31 @@ namespace DirectXGame
 		bool GoingRight;
 	};
 
-	/** Structure representing the player's perks.
-	*/
-	struct Perks
-	{
-		Perks(const uint8_t bombUp = 0, const uint8_t fire = 0, const uint8_t skate = 0, const bool remote = false,
-			  const bool passBomb = false, const bool passSoftBlocks = false) :
-			BombUp(bombUp),
-			Fire(fire),
-			Skate(skate),
-			Remote(remote),
-			PassBomb(passBomb),
-			PassSoftBlocks(passSoftBlocks)
-		{
-		}
-
-		uint8_t BombUp;
-		uint8_t Fire;
-		uint8_t Skate;
-
-		bool Remote;
-		bool PassBomb;
-		bool PassSoftBlocks;
-	};
-
 	class Bomb;
 	class MapRenderable;
 
 	/** Class representing an animated renderable player.
+	 * A player does not read any device, it plays the PlayerInput it is given every frame.
+	 *@see PlayerManager
 	*/
 	class Player final : public Renderable
 	{
 	public:
 
-		Player(const std::shared_ptr<DX::DeviceResources>& deviceResources, const std::shared_ptr<DX::Camera>& camera, const std::shared_ptr<DX::KeyboardComponent>& keyboard, 
-			   const std::shared_ptr<DX::GamePadComponent>& gamePad, MapRenderable& map, const std::string& jsonPath = kJSONFilePath, 
-			   const std::wstring& textureMapPath = kTextureMapPath);
+		Player(const std::shared_ptr<DX::DeviceResources>& deviceResources, const std::shared_ptr<DX::Camera>& camera, uint32_t playerIndex,
+			   MapRenderable& map, const std::string& jsonPath = kJSONFilePath, const std::wstring& textureMapPath = kTextureMapPath);
 		
 		virtual void Update(const DX::StepTimer& timer) override;
 		virtual void Render(const DX::StepTimer& timer) override;
 
+		void SetInput(const PlayerInput& input);
+		bool IsPlaying() const;
+		DirectX::XMFLOAT2 PrepareMovement(const DX::StepTimer& timer);
+		void ApplyMovement(const DX::StepTimer& timer, PlayerCollisionType collisionType, const VelocityRestrictions& velocityRestrictions);
+
+		uint32_t Index() const;
+		PlayerState GetState() const;
+		uint64_t GetStateHash() const;
 		const Perks& GetPerks() const;
 		bool RemoveBomb(const Bomb& bomb);
 		Map& GetMap();
@@ -104,7 +75,7 @@ namespace DirectXGame
 		void ProcessInput();
 		void UpdateVelocity();
 		void UpdateAnimation(const DX::StepTimer& timer);
-		VelocityRestrictions CheckCollisions(const DX::StepTimer& timer);
+		void HandleCollision(PlayerCollisionType collisionType);
 		void UpdatePosition(const DX::StepTimer& timer, const VelocityRestrictions& velocityRestrictions);
 		void HandleIdleStateAnimationUpdate(const DX::StepTimer& timer);
 		void HandleMovingStateAnimationUpdate(const DX::StepTimer& timer);
@@ -115,11 +86,12 @@ namespace DirectXGame
 		void PlaceBomb();
 		void ExplodeBombs();
 
+		uint32_t mIndex;
 		Perks mPerks;
-		std::shared_ptr<DX::KeyboardComponent> mKeyBoard;
-		std::shared_ptr<DX::GamePadComponent> mGamePad;
+		PlayerInput mInput;
+		PlayerInput mPreviousInput;
 		MapRenderable& mMap;
-		std::vector<std::shared_ptr<Bomb>> mBombs;
+		TrackedVector<std::shared_ptr<Bomb>, AllocationSubsystem::Players> mBombs;
 		PlayerState mCurrentPlayerState;
 
 		// movement
@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "PlayerInput.h"
+#include "KeyboardComponent.h"
+#include "GamePadComponent.h"
+
+using namespace std;
+using namespace DX;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	PlayerInputSource::PlayerInputSource(const shared_ptr<KeyboardComponent>& keyboard, KeyboardLayout layout, const shared_ptr<GamePadComponent>& gamePad) :
+		mKeyboard(keyboard), mGamePad(gamePad), mLayout(layout)
+	{
+	}
+
+	/************************************************************************/
+	PlayerInput PlayerInputSource::Read() const
+	{
+		PlayerInput input;
+		ReadKeyboard(input);
+		ReadGamePad(input);
+
+		return input;
+	}
+
+	/************************************************************************/
+	KeyboardLayout PlayerInputSource::GetKeyboardLayout(uint32_t playerIndex, uint32_t playerCount)
+	{
+		// two players share the keyboard, the others only have their game pad
+		if (playerCount == 1)
+		{
+			return KeyboardLayout::WASDAndArrows;
+		}
+
+		switch (playerIndex)
+		{
+			case 0:
+				return KeyboardLayout::WASD;
+			case 1:
+				return KeyboardLayout::Arrows;
+			default:
+				return KeyboardLayout::None;
+		}
+	}
+
+	/************************************************************************/
+	void PlayerInputSource::ReadKeyboard(PlayerInput& input) const
+	{
+		static const pair<Keys, PlayerInputFlags> kWASDBindings[] =
+		{
+			{ Keys::W, PlayerInputFlags::Up }, { Keys::S, PlayerInputFlags::Down }, { Keys::A, PlayerInputFlags::Left }, { Keys::D, PlayerInputFlags::Right },
+			{ Keys::Z, PlayerInputFlags::PlaceBomb }, { Keys::X, PlayerInputFlags::Detonate }
+		};
+		static const pair<Keys, PlayerInputFlags> kArrowsBindings[] =
+		{
+			{ Keys::Up, PlayerInputFlags::Up }, { Keys::Down, PlayerInputFlags::Down }, { Keys::Left, PlayerInputFlags::Left }, { Keys::Right, PlayerInputFlags::Right },
+			{ Keys::RightControl, PlayerInputFlags::PlaceBomb }, { Keys::RightShift, PlayerInputFlags::Detonate }
+		};
+
+		if (mKeyboard == nullptr)
+		{
+			return;
+		}
+
+		if (mLayout == KeyboardLayout::WASD || mLayout == KeyboardLayout::WASDAndArrows)
+		{
+			for (auto& binding : kWASDBindings)
+			{
+				if (mKeyboard->IsKeyDown(binding.first))
+				{
+					input.Set(binding.second);
+				}
+			}
+		}
+
+		if (mLayout == KeyboardLayout::Arrows || mLayout == KeyboardLayout::WASDAndArrows)
+		{
+			for (auto& binding : kArrowsBindings)
+			{
+				// a single player keeps Z and X for the bombs
+				bool isBombKey = binding.second == PlayerInputFlags::PlaceBomb || binding.second == PlayerInputFlags::Detonate;
+				if (mKeyboard->IsKeyDown(binding.first) && !(isBombKey && mLayout == KeyboardLayout::WASDAndArrows))
+				{
+					input.Set(binding.second);
+				}
+			}
+		}
+	}
+
+	/************************************************************************/
+	void PlayerInputSource::ReadGamePad(PlayerInput& input) const
+	{
+		static const pair<GamePadButtons, PlayerInputFlags> kBindings[] =
+		{
+			{ GamePadButtons::DPadUp, PlayerInputFlags::Up }, { GamePadButtons::DPadDown, PlayerInputFlags::Down },
+			{ GamePadButtons::DPadLeft, PlayerInputFlags::Left }, { GamePadButtons::DPadRight, PlayerInputFlags::Right },
+			{ GamePadButtons::A, PlayerInputFlags::PlaceBomb }, { GamePadButtons::B, PlayerInputFlags::Detonate }
+		};
+
+		if (mGamePad == nullptr)
+		{
+			return;
+		}
+
+		for (auto& binding : kBindings)
+		{
+			if (mGamePad->IsButtonDown(binding.first))
+			{
+				input.Set(binding.second);
+			}
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+
+namespace DX
+{
+	class KeyboardComponent;
+	class GamePadComponent;
+}
+
+namespace DirectXGame
+{
+	/** Enumeration representing the buttons a player can hold during a frame.
+	*@see PlayerInput
+	*/
+	enum class PlayerInputFlags : uint8_t
+	{
+		None = 0,
+		Up = 1 << 0,
+		Down = 1 << 1,
+		Left = 1 << 2,
+		Right = 1 << 3,
+		PlaceBomb = 1 << 4,
+		Detonate = 1 << 5
+	};
+
+	/** Structure representing what a player holds during one frame, whatever the device it comes from.
+	 * Only the held state is stored, presses are found by comparing with the input of the previous frame.
+	*/
+	struct PlayerInput
+	{
+		PlayerInput(const uint8_t flags = 0) :
+			Flags(flags)
+		{
+		}
+
+		bool operator==(const PlayerInput& rhs) const { return Flags == rhs.Flags; }
+		bool operator!=(const PlayerInput& rhs) const { return !operator==(rhs); }
+
+		bool IsSet(PlayerInputFlags flag) const { return (Flags & static_cast<uint8_t>(flag)) != 0; }
+		void Set(PlayerInputFlags flag) { Flags = static_cast<uint8_t>(Flags | static_cast<uint8_t>(flag)); }
+
+		uint8_t Flags;
+	};
+
+	/** Enumeration representing the keys of the keyboard a player uses.
+	*@see PlayerInputSource
+	*/
+	enum class KeyboardLayout
+	{
+		None,
+		WASD,           // W A S D, Z to place a bomb, X to detonate
+		Arrows,         // arrows, right control to place a bomb, right shift to detonate
+		WASDAndArrows   // both sets of directions, Z and X, when a single player has the keyboard
+	};
+
+	/** Class reading the input of one local player from the shared keyboard and from the player's own game pad.
+	*@see PlayerInput
+	*/
+	class PlayerInputSource final
+	{
+	public:
+
+		PlayerInputSource(const std::shared_ptr<DX::KeyboardComponent>& keyboard, KeyboardLayout layout, const std::shared_ptr<DX::GamePadComponent>& gamePad);
+
+		PlayerInput Read() const;
+
+		static KeyboardLayout GetKeyboardLayout(uint32_t playerIndex, uint32_t playerCount);
+
+	private:
+
+		void ReadKeyboard(PlayerInput& input) const;
+		void ReadGamePad(PlayerInput& input) const;
+
+		std::shared_ptr<DX::KeyboardComponent> mKeyboard;
+		std::shared_ptr<DX::GamePadComponent> mGamePad;
+		KeyboardLayout mLayout;
+	};
+}
@@ -0,0 +1,111 @@
+#include "pch.h"
+#include "PlayerManager.h"
+#include "Player.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace DX;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	PlayerManager::PlayerManager(const shared_ptr<DX::DeviceResources>& deviceResources, const shared_ptr<Camera>& camera) :
+		DrawableGameComponent(deviceResources, camera)
+	{
+	}
+
+	/************************************************************************/
+	void PlayerManager::AddPlayer(const shared_ptr<Player>& player, const PlayerInputSource& inputSource)
+	{
+		mPlayers.push_back(player);
+		mInputSources.push_back(inputSource);
+	}
+
+	/************************************************************************/
+	void PlayerManager::CreateDeviceDependentResources()
+	{
+		for (auto& player : mPlayers)
+		{
+			player->CreateDeviceDependentResources();
+		}
+	}
+
+	/************************************************************************/
+	void PlayerManager::CreateWindowSizeDependentResources()
+	{
+		for (auto& player : mPlayers)
+		{
+			player->CreateWindowSizeDependentResources();
+		}
+	}
+
+	/************************************************************************/
+	void PlayerManager::ReleaseDeviceDependentResources()
+	{
+		for (auto& player : mPlayers)
+		{
+			player->ReleaseDeviceDependentResources();
+		}
+	}
+
+	/************************************************************************/
+	void PlayerManager::Update(const StepTimer& timer)
+	{
+		mMovingPlayers.clear();
+		mCollisionQueries.clear();
+
+		for (size_t i = 0; i < mPlayers.size(); ++i)
+		{
+			Player& player = *mPlayers[i];
+			player.SetInput(mInputSources[i].Read());
+
+			if (player.IsPlaying())
+			{
+				XMFLOAT2 frameVelocity = player.PrepareMovement(timer);
+				mMovingPlayers.push_back(&player);
+				mCollisionQueries.push_back(PlayerCollisionQuery(player.Position(), frameVelocity));
+			}
+			else
+			{
+				// dying players only play their animation
+				player.Update(timer);
+			}
+		}
+
+		if (mMovingPlayers.empty())
+		{
+			return;
+		}
+
+		CollisionManager::GetInstance().PlayersCollisionCheck(mCollisionQueries);
+
+		for (size_t i = 0; i < mMovingPlayers.size(); ++i)
+		{
+			mMovingPlayers[i]->ApplyMovement(timer, mCollisionQueries[i].Type, mCollisionQueries[i].Restrictions);
+		}
+	}
+
+	/************************************************************************/
+	void PlayerManager::Render(const StepTimer& timer)
+	{
+		for (auto& player : mPlayers)
+		{
+			if (player->Visible())
+			{
+				player->Render(timer);
+			}
+		}
+	}
+
+	/************************************************************************/
+	uint32_t PlayerManager::PlayerCount() const
+	{
+		return static_cast<uint32_t>(mPlayers.size());
+	}
+
+	/************************************************************************/
+	const vector<shared_ptr<Player>>& PlayerManager::Players() const
+	{
+		return mPlayers;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "DrawableGameComponent.h"
+#include "PlayerInput.h"
+#include "CollisionManager.h"
+#include <vector>
+
+namespace DirectXGame
+{
+	class Player;
+
+	/** Class updating and rendering all the local players of the game as one component.
+	 * Every frame the input of each player is read from its own source, then all the players move in the same passes:
+	 * they prepare their movement, their collisions are checked in one batch, then they move.
+	 * The work done per frame is linear in the number of players.
+	 *@see Player
+	*/
+	class PlayerManager final : public DX::DrawableGameComponent
+	{
+	public:
+
+		PlayerManager(const std::shared_ptr<DX::DeviceResources>& deviceResources, const std::shared_ptr<DX::Camera>& camera);
+
+		void AddPlayer(const std::shared_ptr<Player>& player, const PlayerInputSource& inputSource);
+
+		virtual void CreateDeviceDependentResources() override;
+		virtual void CreateWindowSizeDependentResources() override;
+		virtual void ReleaseDeviceDependentResources() override;
+		virtual void Update(const DX::StepTimer& timer) override;
+		virtual void Render(const DX::StepTimer& timer) override;
+
+		uint32_t PlayerCount() const;
+		const std::vector<std::shared_ptr<Player>>& Players() const;
+
+	private:
+
+		std::vector<std::shared_ptr<Player>> mPlayers;
+		std::vector<PlayerInputSource> mInputSources;
+
+		// per frame scratch, one entry per playing player
+		std::vector<Player*> mMovingPlayers;
+		std::vector<PlayerCollisionQuery> mCollisionQueries;
+	};
+}
@@ -0,0 +1,158 @@
+#include "pch.h"
+#include "Profiler.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t Profiler::kCapacity = 1 << 16; // 18 seconds of 60 scopes per frame at 60 frames per second
+
+	/************************************************************************/
+	Profiler& Profiler::GetInstance()
+	{
+		static Profiler sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	Profiler::Profiler() :
+		mIsEnabled(false), mNextEvent(0), mEvents(kCapacity), mOrigin(chrono::high_resolution_clock::now()), mThreadCount(0)
+	{
+	}
+
+	/************************************************************************/
+	void Profiler::SetEnabled(bool enabled)
+	{
+		mIsEnabled.store(enabled, memory_order_release);
+	}
+
+	/************************************************************************/
+	bool Profiler::IsEnabled() const
+	{
+		return mIsEnabled.load(memory_order_acquire);
+	}
+
+	/************************************************************************/
+	void Profiler::Clear()
+	{
+		mNextEvent = 0;
+	}
+
+	/************************************************************************/
+	void Profiler::SetThreadName(const string& name)
+	{
+		const uint32_t threadIndex = GetThreadIndex();
+
+		lock_guard<mutex> lock(mThreadMutex);
+		for (auto& threadName : mThreadNames)
+		{
+			if (threadName.first == threadIndex)
+			{
+				threadName.second = name;
+				return;
+			}
+		}
+		mThreadNames.emplace_back(threadIndex, name);
+	}
+
+	/************************************************************************/
+	int64_t Profiler::Now() const
+	{
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::high_resolution_clock::now() - mOrigin).count();
+	}
+
+	/************************************************************************/
+	void Profiler::Record(const char* name, int64_t startNanoseconds, int64_t endNanoseconds)
+	{
+		ProfileEvent& event = mEvents[mNextEvent.fetch_add(1, memory_order_relaxed) % kCapacity];
+		event.Name = name;
+		event.ThreadIndex = GetThreadIndex();
+		event.StartNanoseconds = startNanoseconds;
+		event.DurationNanoseconds = endNanoseconds - startNanoseconds;
+	}
+
+	/************************************************************************/
+	vector<ProfileEvent> Profiler::GetEvents() const
+	{
+		// oldest first
+		const uint64_t end = mNextEvent.load();
+		const uint64_t begin = end > kCapacity ? end - kCapacity : 0;
+
+		vector<ProfileEvent> events;
+		events.reserve(static_cast<size_t>(end - begin));
+		for (uint64_t i = begin; i < end; ++i)
+		{
+			events.push_back(mEvents[i % kCapacity]);
+		}
+		return events;
+	}
+
+	/************************************************************************/
+	void Profiler::ExportChromeTrace(ostream& stream) const
+	{
+		auto writeString = [&stream](const string& value)
+		{
+			stream << '"';
+			for (char character : value)
+			{
+				if (character == '"' || character == '\\')
+				{
+					stream << '\\';
+				}
+				stream << character;
+			}
+			stream << '"';
+		};
+
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool isFirst = true;
+
+		{
+			lock_guard<mutex> lock(mThreadMutex);
+			for (auto& threadName : mThreadNames)
+			{
+				stream << (isFirst ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadName.first << ",\"args\":{\"name\":";
+				writeString(threadName.second);
+				stream << "}}";
+				isFirst = false;
+			}
+		}
+
+		// complete events, in microseconds
+		stream.setf(ios::fixed);
+		stream.precision(3);
+		for (auto& event : GetEvents())
+		{
+			stream << (isFirst ? "" : ",") << "\n{\"name\":";
+			writeString(event.Name);
+			stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.ThreadIndex << ",\"ts\":" << event.StartNanoseconds / 1000.0 
+				<< ",\"dur\":" << event.DurationNanoseconds / 1000.0 << "}";
+			isFirst = false;
+		}
+
+		stream << "\n]}\n";
+	}
+
+	/************************************************************************/
+	void Profiler::SaveChromeTrace(const string& path) const
+	{
+		ofstream ofs(path, ios::trunc);
+		ExportChromeTrace(ofs);
+		if (!ofs)
+		{
+			throw runtime_error("could not write the trace " + path);
+		}
+	}
+
+	/************************************************************************/
+	uint32_t Profiler::GetThreadIndex()
+	{
+		// small indices read better in a trace than system thread ids
+		thread_local uint32_t sThreadIndex = UINT32_MAX;
+		if (sThreadIndex == UINT32_MAX)
+		{
+			sThreadIndex = mThreadCount++;
+		}
+		return sThreadIndex;
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Structure representing a timed scope, as kept by the profiler.
+	 * Times are in nanoseconds since the profiler was created.
+	*/
+	struct ProfileEvent
+	{
+		const char* Name;
+		uint32_t ThreadIndex;
+		int64_t StartNanoseconds;
+		int64_t DurationNanoseconds;
+	};
+
+	/** Singleton that keeps the last timed scopes of every thread in a ring buffer, and exports them as a Chrome trace.
+	 * Recording is off by default: a scope then only reads one flag, so scopes can stay in the hot paths of shipped builds.
+	 * When on, a scope costs two clock reads and one atomic increment to claim its slot, no lock is ever taken.
+	 * The ring keeps the most recent events and overwrites the oldest ones. Its memory is allocated once with the
+	 * profiler and never resized, so enabling recording while other threads record is safe.
+	 * Traces load in chrome://tracing or ui.perfetto.dev, one row per thread. Export from the thread driving the frames,
+	 * between two of them: scopes still open on other threads at that time are not in the trace.
+	 *@see ProfileScope
+	*/
+	class Profiler final
+	{
+	public:
+
+		Profiler(const Profiler& rhs) = delete;
+		Profiler(const Profiler&& rhs) = delete;
+		Profiler& operator=(const Profiler& rhs) = delete;
+		Profiler& operator=(const Profiler&& rhs) = delete;
+
+		static Profiler& GetInstance();
+
+		void SetEnabled(bool enabled);
+		bool IsEnabled() const;
+		void Clear();
+		void SetThreadName(const std::string& name);
+
+		int64_t Now() const;
+		void Record(const char* name, int64_t startNanoseconds, int64_t endNanoseconds);
+
+		std::vector<ProfileEvent> GetEvents() const;
+		void ExportChromeTrace(std::ostream& stream) const;
+		void SaveChromeTrace(const std::string& path) const;
+
+		static const uint32_t kCapacity;
+
+	private:
+
+		Profiler();
+		~Profiler() = default;
+
+		uint32_t GetThreadIndex();
+
+		std::atomic<bool> mIsEnabled;
+		std::atomic<uint64_t> mNextEvent;
+		std::vector<ProfileEvent> mEvents;
+		std::chrono::high_resolution_clock::time_point mOrigin;
+
+		// thread names are only touched once per thread and on export
+		mutable std::mutex mThreadMutex;
+		std::atomic<uint32_t> mThreadCount;
+		std::vector<std::pair<uint32_t, std::string>> mThreadNames;
+	};
+
+	/** Class timing the scope it is declared in, from its construction to its destruction.
+	 * The name must outlive the trace export, string literals are the intended use.
+	 * Scopes nest, a trace viewer stacks the inner ones under the outer ones of the same thread.
+	 *@see Profiler
+	*/
+	class ProfileScope final
+	{
+	public:
+
+		explicit ProfileScope(const char* name)
+		{
+			Profiler& profiler = Profiler::GetInstance();
+			mName = profiler.IsEnabled() ? name : nullptr;
+			mStartNanoseconds = mName != nullptr ? profiler.Now() : 0;
+		}
+
+		~ProfileScope()
+		{
+			if (mName != nullptr)
+			{
+				Profiler& profiler = Profiler::GetInstance();
+				profiler.Record(mName, mStartNanoseconds, profiler.Now());
+			}
+		}
+
+		ProfileScope(const ProfileScope& rhs) = delete;
+		ProfileScope& operator=(const ProfileScope& rhs) = delete;
+
+	private:
+
+		const char* mName;
+		int64_t mStartNanoseconds;
+	};
+}
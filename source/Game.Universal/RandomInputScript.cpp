@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "RandomInputScript.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t RandomInputScript::kMinHoldTicks = 8;
+	const uint32_t RandomInputScript::kMaxHoldTicks = 40;
+	const uint32_t RandomInputScript::kDefaultBombChance = 6;
+	const uint32_t RandomInputScript::kDetonateChance = 10;
+
+	/************************************************************************/
+	RandomInputScript::RandomInputScript(uint32_t seed, uint32_t bombChance) :
+		mRandomState(seed != 0 ? seed : 1), mBombChance(bombChance != 0 ? bombChance : 1), mTicksLeft(0), mIsFirstTick(false), mPlacesBomb(false), mDetonates(false)
+	{
+	}
+
+	/************************************************************************/
+	PlayerInput RandomInputScript::Next()
+	{
+		static const PlayerInputFlags directions[] = { PlayerInputFlags::None, PlayerInputFlags::Up, PlayerInputFlags::Down, PlayerInputFlags::Left, PlayerInputFlags::Right };
+
+		if (mTicksLeft == 0)
+		{
+			mHeldInput = PlayerInput();
+			mHeldInput.Set(directions[GetRandom(static_cast<uint32_t>(sizeof(directions) / sizeof(directions[0])))]);
+			mTicksLeft = kMinHoldTicks + GetRandom(kMaxHoldTicks - kMinHoldTicks + 1);
+			mPlacesBomb = GetRandom(mBombChance) == 0;
+			mDetonates = GetRandom(kDetonateChance) == 0;
+			mIsFirstTick = true;
+		}
+
+		// buttons are only held for the first tick of a move, so every move can press them again
+		PlayerInput input = mHeldInput;
+		if (mIsFirstTick && mPlacesBomb)
+		{
+			input.Set(PlayerInputFlags::PlaceBomb);
+		}
+		if (mIsFirstTick && mDetonates)
+		{
+			input.Set(PlayerInputFlags::Detonate);
+		}
+
+		mIsFirstTick = false;
+		--mTicksLeft;
+
+		return input;
+	}
+
+	/************************************************************************/
+	uint32_t RandomInputScript::GetRandom(uint32_t count)
+	{
+		mRandomState ^= mRandomState << 13;
+		mRandomState ^= mRandomState >> 17;
+		mRandomState ^= mRandomState << 5;
+
+		return mRandomState % count;
+	}
+}
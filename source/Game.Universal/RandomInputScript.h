@@ -0,0 +1,39 @@
+#pragma once
+
+#include "PlayerInput.h"
+
+namespace DirectXGame
+{
+	/** Class generating the inputs of a bot player that wanders and drops bombs at random.
+	 * One move out of bombChance starts with a bomb, a chance of 1 drops one at every move.
+	 * The inputs only depend on the seed and on how many were generated, never on the game, so the same script
+	 * can be generated again on another machine instead of being sent.
+	 *@see LockstepTest
+	*/
+	class RandomInputScript final
+	{
+	public:
+
+		explicit RandomInputScript(uint32_t seed = 0, uint32_t bombChance = kDefaultBombChance);
+
+		PlayerInput Next();
+
+		static const uint32_t kDefaultBombChance;
+
+	private:
+
+		uint32_t GetRandom(uint32_t count);
+
+		uint32_t mRandomState;
+		uint32_t mBombChance;
+		PlayerInput mHeldInput;
+		uint32_t mTicksLeft;
+		bool mIsFirstTick;
+		bool mPlacesBomb;
+		bool mDetonates;
+
+		static const uint32_t kMinHoldTicks;
+		static const uint32_t kMaxHoldTicks;
+		static const uint32_t kDetonateChance;
+	};
+}
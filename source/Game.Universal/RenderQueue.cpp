@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "RenderQueue.h"
+#include "RenderStateCache.h"
+#include "MetricsRegistry.h"
+#include "Profiler.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	RenderQueue& RenderQueue::GetInstance()
+	{
+		static RenderQueue sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	void RenderQueue::Submit(float_t sortingLayer, ID3D11ShaderResourceView* texture, float_t y, const VSCBufferPerObject& constants)
+	{
+		mSortKeys.Add(RenderSortKeys::MakeKey(sortingLayer, GetTextureId(texture), y));
+		mItems.push_back({ constants, texture });
+	}
+
+	/************************************************************************/
+	void RenderQueue::Flush(ID3D11DeviceContext1* context)
+	{
+		ProfileScope scope("RenderQueue::Flush");
+
+		if (mItems.empty())
+		{
+			return;
+		}
+
+		mSortKeys.Sort();
+
+		// every sprite is drawn on the same objects, only the texture and the constants change
+		SpritePipeline& pipeline = SpritePipeline::GetInstance();
+		DeviceRenderStateCache& renderState = DeviceRenderStateCache::GetInstance();
+		renderState.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		renderState.SetInputLayout(pipeline.InputLayout());
+		renderState.SetVertexBuffer(pipeline.VertexBuffer(), sizeof(VertexPositionTexture), 0);
+		renderState.SetIndexBuffer(pipeline.IndexBuffer(), DXGI_FORMAT_R32_UINT, 0);
+		renderState.SetVertexShader(pipeline.VertexShader());
+		renderState.SetPixelShader(pipeline.PixelShader());
+		renderState.SetPSSampler(0, pipeline.TextureSampler());
+		renderState.SetBlendState(pipeline.AlphaBlending());
+
+		// the constants go to the next ranges of the frame's ring buffer, written in one map for as many sprites as the
+		// ring holds before it starts over, a draw only reads its range once the buffer is unmapped
+		ConstantRingBuffer& constantRing = ConstantRingBuffer::GetInstance();
+		MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+		const vector<uint32_t>& order = mSortKeys.Order();
+		const uint32_t count = static_cast<uint32_t>(order.size());
+		uint32_t next = 0;
+		while (next < count)
+		{
+			const uint32_t mappedCount = constantRing.Map(context, sizeof(VSCBufferPerObject), count - next);
+			if (mappedCount == 0)
+			{
+				break;
+			}
+
+			mConstantRanges.resize(mappedCount);
+			for (uint32_t i = 0; i < mappedCount; ++i)
+			{
+				constantRing.Write(&mItems[order[next + i]].Constants, mConstantRanges[i]);
+			}
+			constantRing.Unmap(context);
+
+			for (uint32_t i = 0; i < mappedCount; ++i)
+			{
+				const ConstantBufferRange& range = mConstantRanges[i];
+				renderState.SetPSShaderResource(0, mItems[order[next + i]].Texture);
+				renderState.SetVSConstantBuffer(0, range.Buffer, range.FirstConstant, range.ConstantCount);
+				context->DrawIndexed(pipeline.IndexCount(), 0, 0);
+			}
+			next += mappedCount;
+		}
+
+		// devices without offsets update the pipeline's buffer for every sprite
+		for (; next < count; ++next)
+		{
+			const RenderQueueItem& item = mItems[order[next]];
+			renderState.SetPSShaderResource(0, item.Texture);
+			context->UpdateSubresource(pipeline.ConstantBuffer(), 0, nullptr, &item.Constants, 0, 0);
+			renderState.SetVSConstantBuffer(0, pipeline.ConstantBuffer());
+			metrics.Add(MetricsRegistry::kConstantBufferUpdates);
+			context->DrawIndexed(pipeline.IndexCount(), 0, 0);
+		}
+
+		metrics.Add(MetricsRegistry::kDrawCalls, mItems.size());
+		Clear();
+	}
+
+	/************************************************************************/
+	void RenderQueue::Clear()
+	{
+		mItems.clear();
+		mTextures.clear();
+		mSortKeys.Clear();
+	}
+
+	/************************************************************************/
+	uint32_t RenderQueue::Count() const
+	{
+		return static_cast<uint32_t>(mItems.size());
+	}
+
+	/************************************************************************/
+	uint32_t RenderQueue::GetTextureId(ID3D11ShaderResourceView* texture)
+	{
+		// a frame has a handful of textures, since the atlas only one
+		for (uint32_t id = 0; id < mTextures.size(); ++id)
+		{
+			if (mTextures[id] == texture)
+			{
+				return id;
+			}
+		}
+
+		mTextures.push_back(texture);
+		return static_cast<uint32_t>(mTextures.size() - 1);
+	}
+}
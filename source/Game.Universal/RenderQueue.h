@@ -0,0 +1,56 @@
+#pragma once
+
+#include "RenderSortKeys.h"
+#include "SpritePipeline.h"
+#include "ConstantRingBuffer.h"
+
+namespace DirectXGame
+{
+	/** Structure holding what is needed to draw one sprite once the queue is sorted.
+	*/
+	struct RenderQueueItem
+	{
+		VSCBufferPerObject Constants;
+		ID3D11ShaderResourceView* Texture; // the renderable submitting it keeps it alive for the frame
+	};
+
+	/** Singleton collecting the sprites of a frame, so they are drawn in an explicit order instead of as submitted.
+	 * Renderables submit their sprites from Render with the sorting layer of the sprite, their texture and their
+	 * y position, which RenderSortKeys turns into a sort key. GameMain flushes the queue once every component has
+	 * rendered: the keys are radix sorted and the sprites drawn in that order, on the objects of SpritePipeline, so
+	 * the sprites sharing a layer and a texture follow each other and only their constants change between draws.
+	 * The constants of the sprites are written to ConstantRingBuffer in one map, and drawn once it is unmapped.
+	 * Textures get their ids in the order they are first submitted in a frame.
+	 *@see Renderable
+	 *@see RenderSortKeys
+	*/
+	class RenderQueue final
+	{
+	public:
+
+		RenderQueue(const RenderQueue& rhs) = delete;
+		RenderQueue(const RenderQueue&& rhs) = delete;
+		RenderQueue& operator=(const RenderQueue& rhs) = delete;
+		RenderQueue& operator=(const RenderQueue&& rhs) = delete;
+
+		static RenderQueue& GetInstance();
+
+		void Submit(std::float_t sortingLayer, ID3D11ShaderResourceView* texture, std::float_t y, const VSCBufferPerObject& constants);
+		void Flush(ID3D11DeviceContext1* context);
+		void Clear();
+
+		uint32_t Count() const;
+
+	private:
+
+		RenderQueue() = default;
+		~RenderQueue() = default;
+
+		uint32_t GetTextureId(ID3D11ShaderResourceView* texture);
+
+		std::vector<RenderQueueItem> mItems;
+		std::vector<ID3D11ShaderResourceView*> mTextures; // of this frame, by id
+		RenderSortKeys mSortKeys;
+		std::vector<ConstantBufferRange> mConstantRanges; // of the mapped sprites, reused every flush
+	};
+}
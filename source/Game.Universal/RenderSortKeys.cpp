@@ -0,0 +1,134 @@
+#include "pch.h"
+#include "RenderSortKeys.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t RenderSortKeys::kLayerShift = 56;   // 8 bits
+	const uint32_t RenderSortKeys::kTextureShift = 40; // 16 bits
+	const uint32_t RenderSortKeys::kDepthShift = 8;    // 32 bits, the low 8 are left at 0
+	const uint32_t RenderSortKeys::kMaxTextureId = 0xFFFF;
+	const float_t RenderSortKeys::kMinSortingLayer = -20.0f;
+	const float_t RenderSortKeys::kLayerStepsPerUnit = 2.0f; // the sprite sheets use halves of layers
+	const uint32_t RenderSortKeys::kDigitBits = 8;
+	const uint32_t RenderSortKeys::kDigitCount = 8;
+	const uint32_t RenderSortKeys::kBucketCount = 256;
+
+	/************************************************************************/
+	RenderSortKeys::RenderSortKeys() :
+		mHistograms(kDigitCount * kBucketCount), mLastPassCount(0)
+	{
+	}
+
+	/************************************************************************/
+	void RenderSortKeys::Clear()
+	{
+		mKeys.clear();
+		mOrder.clear();
+	}
+
+	/************************************************************************/
+	void RenderSortKeys::Add(uint64_t key)
+	{
+		mOrder.push_back(static_cast<uint32_t>(mKeys.size()));
+		mKeys.push_back(key);
+	}
+
+	/************************************************************************/
+	void RenderSortKeys::Sort()
+	{
+		const uint32_t count = Count();
+		mLastPassCount = 0;
+		if (count < 2)
+		{
+			return;
+		}
+
+		fill(mHistograms.begin(), mHistograms.end(), 0);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint64_t key = mKeys[i];
+			for (uint32_t digit = 0; digit < kDigitCount; ++digit)
+			{
+				++mHistograms[digit * kBucketCount + ((key >> (digit * kDigitBits)) & (kBucketCount - 1))];
+			}
+		}
+
+		mScratchKeys.resize(count);
+		mScratchOrder.resize(count);
+
+		for (uint32_t digit = 0; digit < kDigitCount; ++digit)
+		{
+			uint32_t* histogram = &mHistograms[digit * kBucketCount];
+			const uint32_t shift = digit * kDigitBits;
+
+			// every key has the same digit, the pass would not move anything
+			if (histogram[(mKeys[0] >> shift) & (kBucketCount - 1)] == count)
+			{
+				continue;
+			}
+
+			// the counts become the first position of each bucket
+			uint32_t offset = 0;
+			for (uint32_t bucket = 0; bucket < kBucketCount; ++bucket)
+			{
+				const uint32_t bucketCount = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketCount;
+			}
+
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				const uint64_t key = mKeys[i];
+				const uint32_t position = histogram[(key >> shift) & (kBucketCount - 1)]++;
+				mScratchKeys[position] = key;
+				mScratchOrder[position] = mOrder[i];
+			}
+
+			mKeys.swap(mScratchKeys);
+			mOrder.swap(mScratchOrder);
+			++mLastPassCount;
+		}
+	}
+
+	/************************************************************************/
+	const vector<uint64_t>& RenderSortKeys::Keys() const
+	{
+		return mKeys;
+	}
+
+	/************************************************************************/
+	const vector<uint32_t>& RenderSortKeys::Order() const
+	{
+		return mOrder;
+	}
+
+	/************************************************************************/
+	uint32_t RenderSortKeys::Count() const
+	{
+		return static_cast<uint32_t>(mKeys.size());
+	}
+
+	/************************************************************************/
+	uint32_t RenderSortKeys::LastPassCount() const
+	{
+		return mLastPassCount;
+	}
+
+	/************************************************************************/
+	uint64_t RenderSortKeys::MakeKey(float_t sortingLayer, uint32_t textureId, float_t y)
+	{
+		const float_t layerStep = (sortingLayer - kMinSortingLayer) * kLayerStepsPerUnit;
+		const uint64_t layer = layerStep <= 0.0f ? 0 : (layerStep >= 255.0f ? 255 : static_cast<uint64_t>(layerStep));
+		const uint64_t texture = textureId < kMaxTextureId ? textureId : kMaxTextureId;
+
+		// the bits of a float ordered as an unsigned integer, then reversed so that higher y comes first
+		uint32_t bits;
+		memcpy(&bits, &y, sizeof(bits));
+		const uint32_t ordered = (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+		const uint32_t depth = ~ordered;
+
+		return (layer << kLayerShift) | (texture << kTextureShift) | (static_cast<uint64_t>(depth) << kDepthShift);
+	}
+}
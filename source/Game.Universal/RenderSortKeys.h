@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Class sorting the draws of a frame by 64 bit keys, with a least significant digit radix sort.
+	 * A key holds, from the most significant bits, the sorting layer of the sprite, the id of its texture and its
+	 * y position, higher up the screen first so sprites lower down overlap the ones behind them; draws sharing a
+	 * layer and a texture end up next to each other, as one batch. Sort orders the indices of the keys in the order
+	 * they were added, the sort is stable so equal keys keep that order. The keys of a frame mostly share their
+	 * texture and low bits, the passes over a digit all keys share are skipped.
+	 * Nothing here needs a graphics device.
+	 *@see RenderQueue
+	 *@see RenderSortValidator
+	*/
+	class RenderSortKeys final
+	{
+	public:
+
+		RenderSortKeys();
+
+		void Clear();
+		void Add(uint64_t key);
+		void Sort();
+
+		const std::vector<uint64_t>& Keys() const;
+		const std::vector<uint32_t>& Order() const;
+		uint32_t Count() const;
+		uint32_t LastPassCount() const;
+
+		static uint64_t MakeKey(std::float_t sortingLayer, uint32_t textureId, std::float_t y);
+
+		static const uint32_t kLayerShift;
+		static const uint32_t kTextureShift;
+		static const uint32_t kDepthShift;
+		static const uint32_t kMaxTextureId;
+
+	private:
+
+		static const std::float_t kMinSortingLayer;
+		static const std::float_t kLayerStepsPerUnit;
+		static const uint32_t kDigitBits;
+		static const uint32_t kDigitCount;
+		static const uint32_t kBucketCount;
+
+		std::vector<uint64_t> mKeys;  // sorted by Sort, with the order
+		std::vector<uint32_t> mOrder; // index of each key in the order it was added
+		std::vector<uint64_t> mScratchKeys;
+		std::vector<uint32_t> mScratchOrder;
+		std::vector<uint32_t> mHistograms; // one per digit, counted in a single pass over the keys
+		uint32_t mLastPassCount;
+	};
+}
@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "RenderSortValidator.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t RenderSortValidator::kMaxKeysPerFrame = 50000;
+	const uint32_t RenderSortValidator::kLayerCount = 81; // -20 to 20 in steps of 0.5, as the sprite sheets
+	const uint32_t RenderSortValidator::kTextureCount = 8;
+	const float_t RenderSortValidator::kMaxY = 2000.0f;
+	const uint32_t RenderSortValidator::kPairsPerFrame = 1000;
+
+	/************************************************************************/
+	RenderSortValidator& RenderSortValidator::GetInstance()
+	{
+		static RenderSortValidator sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	RenderSortValidationReport RenderSortValidator::Validate(uint32_t frameCount, uint32_t seed)
+	{
+		RenderSortValidationReport report = { frameCount, 0, 0, 0, 0 };
+
+		default_random_engine generator(seed);
+		uniform_int_distribution<uint32_t> keyCountDistribution(0, kMaxKeysPerFrame);
+		uniform_int_distribution<uint32_t> layerDistribution(0, kLayerCount - 1);
+		uniform_int_distribution<uint32_t> textureDistribution(0, kTextureCount - 1);
+		uniform_real_distribution<float_t> yDistribution(-kMaxY, kMaxY);
+		uniform_int_distribution<uint32_t> percentDistribution(0, 99);
+
+		RenderSortKeys sortKeys;
+		vector<pair<uint64_t, uint32_t>> expected;
+
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			sortKeys.Clear();
+			expected.clear();
+
+			// a frame uses a few layers and textures, and sprites on the same row share their y
+			const uint32_t keyCount = keyCountDistribution(generator);
+			const uint32_t frameLayers[] = { layerDistribution(generator), layerDistribution(generator), layerDistribution(generator) };
+			float_t y = 0.0f;
+			for (uint32_t i = 0; i < keyCount; ++i)
+			{
+				if (percentDistribution(generator) < 50)
+				{
+					y = yDistribution(generator);
+				}
+				const float_t layer = static_cast<float_t>(frameLayers[i % ARRAYSIZE(frameLayers)]) * 0.5f - 20.0f;
+				const uint64_t key = RenderSortKeys::MakeKey(layer, textureDistribution(generator), y);
+				sortKeys.Add(key);
+				expected.push_back(make_pair(key, i));
+			}
+
+			sortKeys.Sort();
+			stable_sort(expected.begin(), expected.end(), [](const pair<uint64_t, uint32_t>& lhs, const pair<uint64_t, uint32_t>& rhs)
+			{
+				return lhs.first < rhs.first;
+			});
+
+			report.KeyCount += keyCount;
+			report.PassCount += sortKeys.LastPassCount();
+			for (uint32_t i = 0; i < keyCount; ++i)
+			{
+				if (sortKeys.Keys()[i] != expected[i].first || sortKeys.Order()[i] != expected[i].second)
+				{
+					++report.MisorderedCount;
+				}
+			}
+
+			for (uint32_t pairIndex = 0; pairIndex < kPairsPerFrame; ++pairIndex)
+			{
+				const float_t lhsLayer = static_cast<float_t>(layerDistribution(generator)) * 0.5f - 20.0f;
+				const float_t rhsLayer = percentDistribution(generator) < 50 ? lhsLayer : static_cast<float_t>(layerDistribution(generator)) * 0.5f - 20.0f;
+				const uint32_t lhsTexture = textureDistribution(generator);
+				const uint32_t rhsTexture = percentDistribution(generator) < 50 ? lhsTexture : textureDistribution(generator);
+				const float_t lhsY = yDistribution(generator);
+				const float_t rhsY = percentDistribution(generator) < 10 ? lhsY : yDistribution(generator);
+
+				// the sprite drawn first is on the lower layer, then has the lower texture, then is higher up
+				bool lhsFirst;
+				if (lhsLayer != rhsLayer)
+				{
+					lhsFirst = lhsLayer < rhsLayer;
+				}
+				else if (lhsTexture != rhsTexture)
+				{
+					lhsFirst = lhsTexture < rhsTexture;
+				}
+				else
+				{
+					lhsFirst = lhsY > rhsY;
+				}
+
+				const uint64_t lhsKey = RenderSortKeys::MakeKey(lhsLayer, lhsTexture, lhsY);
+				const uint64_t rhsKey = RenderSortKeys::MakeKey(rhsLayer, rhsTexture, rhsY);
+				const bool isTie = lhsLayer == rhsLayer && lhsTexture == rhsTexture && lhsY == rhsY;
+				if (isTie ? lhsKey != rhsKey : (lhsKey < rhsKey) != lhsFirst)
+				{
+					++report.WrongKeyOrderCount;
+				}
+			}
+		}
+
+		return report;
+	}
+}
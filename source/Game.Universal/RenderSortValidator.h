@@ -0,0 +1,50 @@
+#pragma once
+
+#include "RenderSortKeys.h"
+#include <random>
+
+namespace DirectXGame
+{
+	/** Structure holding the outcome of a render sort validation run.
+	*/
+	struct RenderSortValidationReport
+	{
+		uint32_t FrameCount;
+		uint64_t KeyCount;
+		uint64_t PassCount;           // radix passes run, the others were skipped
+		uint64_t MisorderedCount;     // positions where the order differs from a stable sort of the keys
+		uint64_t WrongKeyOrderCount;  // pairs of sprites whose keys do not order them by layer, texture, then higher y
+	};
+
+	/** Singleton checking RenderSortKeys on its own, without a graphics device.
+	 * Random frames add keys made from a few layers and textures and random y positions, as the renderables do, and
+	 * the radix sort is compared with std::stable_sort over the same keys. Random pairs of sprites check that MakeKey
+	 * orders them first by layer, then by texture, then higher y first.
+	 *@see RenderSortKeys
+	 *@see HeadlessTools
+	*/
+	class RenderSortValidator final
+	{
+	public:
+
+		RenderSortValidator(const RenderSortValidator& rhs) = delete;
+		RenderSortValidator(const RenderSortValidator&& rhs) = delete;
+		RenderSortValidator& operator=(const RenderSortValidator& rhs) = delete;
+		RenderSortValidator& operator=(const RenderSortValidator&& rhs) = delete;
+
+		static RenderSortValidator& GetInstance();
+
+		RenderSortValidationReport Validate(uint32_t frameCount, uint32_t seed);
+
+	private:
+
+		RenderSortValidator() = default;
+		~RenderSortValidator() = default;
+
+		static const uint32_t kMaxKeysPerFrame;
+		static const uint32_t kLayerCount;
+		static const uint32_t kTextureCount;
+		static const std::float_t kMaxY;
+		static const uint32_t kPairsPerFrame;
+	};
+}
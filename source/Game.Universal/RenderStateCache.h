@@ -0,0 +1,271 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DirectXGame
+{
+	/** Structure counting the binds a render state cache was asked for, and the ones it did not pass on.
+	*/
+	struct RenderStateCacheStats
+	{
+		uint64_t RequestedBindCount;
+		uint64_t SkippedBindCount; // already bound, the context never saw them
+	};
+
+	/** Class standing between the renderers and a device context, remembering what is bound to the pipeline.
+	 * A bind of what is already bound never reaches the context and is counted as skipped, so renderables sharing
+	 * their shaders, buffers and states only pay for what differs from the one drawn before them. The context is a
+	 * template argument so the tracking can be checked against a mock recording the binds it receives; the game uses
+	 * the instance of DeviceRenderStateCache. Nothing is known after Invalidate, which must be called whenever the
+	 * context may have been bound without the cache, and when the device goes, since a new object may get the
+	 * address of a released one. Only the slots below kSlotCount are tracked, the others always reach the context.
+	 *@see RenderStateCacheValidator
+	*/
+	template <typename TContext>
+	class RenderStateCache final
+	{
+	public:
+
+		static const uint32_t kSlotCount = 2;
+
+		explicit RenderStateCache(TContext* context = nullptr) :
+			mContext(context)
+		{
+			Invalidate();
+			ResetStats();
+		}
+
+		RenderStateCache(const RenderStateCache& rhs) = delete;
+		RenderStateCache& operator=(const RenderStateCache& rhs) = delete;
+		~RenderStateCache() = default;
+
+		static RenderStateCache& GetInstance()
+		{
+			static RenderStateCache sInstance;
+			return sInstance;
+		}
+
+		void SetContext(TContext* context)
+		{
+			mContext = context;
+			Invalidate();
+		}
+
+		void Invalidate()
+		{
+			mTopology.IsKnown = false;
+			mInputLayout.IsKnown = false;
+			mVertexBuffer.IsKnown = false;
+			mIndexBuffer.IsKnown = false;
+			mVertexShader.IsKnown = false;
+			mPixelShader.IsKnown = false;
+			mBlendState.IsKnown = false;
+			for (uint32_t slot = 0; slot < kSlotCount; ++slot)
+			{
+				mVSConstantBuffers[slot].IsKnown = false;
+				mVSShaderResources[slot].IsKnown = false;
+				mPSShaderResources[slot].IsKnown = false;
+				mPSSamplers[slot].IsKnown = false;
+			}
+		}
+
+		void SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+		{
+			if (Change(mTopology, topology))
+			{
+				mContext->IASetPrimitiveTopology(topology);
+			}
+		}
+
+		void SetInputLayout(ID3D11InputLayout* inputLayout)
+		{
+			if (Change(mInputLayout, inputLayout))
+			{
+				mContext->IASetInputLayout(inputLayout);
+			}
+		}
+
+		void SetVertexBuffer(ID3D11Buffer* vertexBuffer, UINT stride, UINT offset)
+		{
+			const VertexBufferBinding binding = { vertexBuffer, stride, offset };
+			if (Change(mVertexBuffer, binding))
+			{
+				mContext->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+			}
+		}
+
+		void SetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset)
+		{
+			const IndexBufferBinding binding = { indexBuffer, format, offset };
+			if (Change(mIndexBuffer, binding))
+			{
+				mContext->IASetIndexBuffer(indexBuffer, format, offset);
+			}
+		}
+
+		void SetVertexShader(ID3D11VertexShader* vertexShader)
+		{
+			if (Change(mVertexShader, vertexShader))
+			{
+				mContext->VSSetShader(vertexShader, nullptr, 0);
+			}
+		}
+
+		void SetPixelShader(ID3D11PixelShader* pixelShader)
+		{
+			if (Change(mPixelShader, pixelShader))
+			{
+				mContext->PSSetShader(pixelShader, nullptr, 0);
+			}
+		}
+
+		// a constant count of 0 binds the whole buffer, otherwise the range of constants from the first one
+		void SetVSConstantBuffer(uint32_t slot, ID3D11Buffer* constantBuffer, UINT firstConstant = 0, UINT constantCount = 0)
+		{
+			const ConstantBufferBinding binding = { constantBuffer, firstConstant, constantCount };
+			if (!ChangeSlot(mVSConstantBuffers, slot, binding))
+			{
+				return;
+			}
+
+			if (constantCount == 0)
+			{
+				mContext->VSSetConstantBuffers(slot, 1, &constantBuffer);
+			}
+			else
+			{
+				mContext->VSSetConstantBuffers1(slot, 1, &constantBuffer, &firstConstant, &constantCount);
+			}
+		}
+
+		void SetVSShaderResource(uint32_t slot, ID3D11ShaderResourceView* shaderResource)
+		{
+			if (ChangeSlot(mVSShaderResources, slot, shaderResource))
+			{
+				mContext->VSSetShaderResources(slot, 1, &shaderResource);
+			}
+		}
+
+		void SetPSShaderResource(uint32_t slot, ID3D11ShaderResourceView* shaderResource)
+		{
+			if (ChangeSlot(mPSShaderResources, slot, shaderResource))
+			{
+				mContext->PSSetShaderResources(slot, 1, &shaderResource);
+			}
+		}
+
+		void SetPSSampler(uint32_t slot, ID3D11SamplerState* sampler)
+		{
+			if (ChangeSlot(mPSSamplers, slot, sampler))
+			{
+				mContext->PSSetSamplers(slot, 1, &sampler);
+			}
+		}
+
+		void SetBlendState(ID3D11BlendState* blendState)
+		{
+			if (Change(mBlendState, blendState))
+			{
+				mContext->OMSetBlendState(blendState, nullptr, 0xFFFFFFFF);
+			}
+		}
+
+		const RenderStateCacheStats& Stats() const
+		{
+			return mStats;
+		}
+
+		void ResetStats()
+		{
+			mStats.RequestedBindCount = 0;
+			mStats.SkippedBindCount = 0;
+		}
+
+	private:
+
+		template <typename T>
+		struct TrackedState
+		{
+			T Value;
+			bool IsKnown;
+		};
+
+		struct VertexBufferBinding
+		{
+			ID3D11Buffer* Buffer;
+			UINT Stride;
+			UINT Offset;
+
+			bool operator==(const VertexBufferBinding& rhs) const
+			{
+				return Buffer == rhs.Buffer && Stride == rhs.Stride && Offset == rhs.Offset;
+			}
+		};
+
+		struct IndexBufferBinding
+		{
+			ID3D11Buffer* Buffer;
+			DXGI_FORMAT Format;
+			UINT Offset;
+
+			bool operator==(const IndexBufferBinding& rhs) const
+			{
+				return Buffer == rhs.Buffer && Format == rhs.Format && Offset == rhs.Offset;
+			}
+		};
+
+		struct ConstantBufferBinding
+		{
+			ID3D11Buffer* Buffer;
+			UINT FirstConstant;
+			UINT ConstantCount;
+
+			bool operator==(const ConstantBufferBinding& rhs) const
+			{
+				return Buffer == rhs.Buffer && FirstConstant == rhs.FirstConstant && ConstantCount == rhs.ConstantCount;
+			}
+		};
+
+		template <typename T>
+		bool Change(TrackedState<T>& state, const T& value)
+		{
+			++mStats.RequestedBindCount;
+			if (state.IsKnown && state.Value == value)
+			{
+				++mStats.SkippedBindCount;
+				return false;
+			}
+
+			state.Value = value;
+			state.IsKnown = true;
+			return true;
+		}
+
+		template <typename T>
+		bool ChangeSlot(TrackedState<T> (&states)[kSlotCount], uint32_t slot, const T& value)
+		{
+			if (slot >= kSlotCount)
+			{
+				++mStats.RequestedBindCount;
+				return true;
+			}
+			return Change(states[slot], value);
+		}
+
+		TContext* mContext;
+		TrackedState<D3D11_PRIMITIVE_TOPOLOGY> mTopology;
+		TrackedState<ID3D11InputLayout*> mInputLayout;
+		TrackedState<VertexBufferBinding> mVertexBuffer; // slot 0, the only one the renderers use
+		TrackedState<IndexBufferBinding> mIndexBuffer;
+		TrackedState<ID3D11VertexShader*> mVertexShader;
+		TrackedState<ID3D11PixelShader*> mPixelShader;
+		TrackedState<ConstantBufferBinding> mVSConstantBuffers[kSlotCount];
+		TrackedState<ID3D11ShaderResourceView*> mVSShaderResources[kSlotCount];
+		TrackedState<ID3D11ShaderResourceView*> mPSShaderResources[kSlotCount];
+		TrackedState<ID3D11SamplerState*> mPSSamplers[kSlotCount];
+		TrackedState<ID3D11BlendState*> mBlendState;
+		RenderStateCacheStats mStats;
+	};
+
+	typedef RenderStateCache<ID3D11DeviceContext1> DeviceRenderStateCache;
+}
@@ -0,0 +1,326 @@
+#include "pch.h"
+#include "RenderStateCacheValidator.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t RenderStateCacheValidator::kBindsPerSequence = 4096;
+	const uint32_t RenderStateCacheValidator::kObjectsPerState = 3; // plus nullptr, so repeats are common
+	const uint32_t RenderStateCacheValidator::kInvalidatePercent = 2;
+
+	/** Class standing for a device context, recording what each bind puts in the pipeline instead of binding it.
+	*/
+	class RenderStateCacheValidator::RecordingContext final
+	{
+	public:
+
+		RecordingContext() :
+			mBindCount(0)
+		{
+			for (auto& slots : mBound)
+			{
+				for (auto& binding : slots)
+				{
+					binding = Binding{ { 0, 0, 0 } };
+				}
+			}
+		}
+
+		void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+		{
+			Record(BindKind::Topology, 0, Binding{ { static_cast<uintptr_t>(topology), 0, 0 } });
+		}
+
+		void IASetInputLayout(ID3D11InputLayout* inputLayout)
+		{
+			Record(BindKind::InputLayout, 0, Binding{ { reinterpret_cast<uintptr_t>(inputLayout), 0, 0 } });
+		}
+
+		void IASetVertexBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets)
+		{
+			for (UINT index = 0; index < count; ++index)
+			{
+				Record(BindKind::VertexBuffer, startSlot + index, Binding{ { reinterpret_cast<uintptr_t>(vertexBuffers[index]), strides[index], offsets[index] } });
+			}
+		}
+
+		void IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset)
+		{
+			Record(BindKind::IndexBuffer, 0, Binding{ { reinterpret_cast<uintptr_t>(indexBuffer), static_cast<uintptr_t>(format), offset } });
+		}
+
+		void VSSetShader(ID3D11VertexShader* vertexShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount)
+		{
+			UNREFERENCED_PARAMETER(classInstances);
+			UNREFERENCED_PARAMETER(classInstanceCount);
+			Record(BindKind::VertexShader, 0, Binding{ { reinterpret_cast<uintptr_t>(vertexShader), 0, 0 } });
+		}
+
+		void PSSetShader(ID3D11PixelShader* pixelShader, ID3D11ClassInstance* const* classInstances, UINT classInstanceCount)
+		{
+			UNREFERENCED_PARAMETER(classInstances);
+			UNREFERENCED_PARAMETER(classInstanceCount);
+			Record(BindKind::PixelShader, 0, Binding{ { reinterpret_cast<uintptr_t>(pixelShader), 0, 0 } });
+		}
+
+		void VSSetConstantBuffers(UINT startSlot, UINT count, ID3D11Buffer* const* constantBuffers)
+		{
+			RecordSlots(BindKind::VSConstantBuffer, startSlot, count, constantBuffers);
+		}
+
+		void VSSetConstantBuffers1(UINT startSlot, UINT count, ID3D11Buffer* const* constantBuffers, const UINT* firstConstants, const UINT* constantCounts)
+		{
+			for (UINT index = 0; index < count; ++index)
+			{
+				Record(BindKind::VSConstantBuffer, startSlot + index, Binding{ { reinterpret_cast<uintptr_t>(constantBuffers[index]), firstConstants[index], constantCounts[index] } });
+			}
+		}
+
+		void VSSetShaderResources(UINT startSlot, UINT count, ID3D11ShaderResourceView* const* shaderResources)
+		{
+			RecordSlots(BindKind::VSShaderResource, startSlot, count, shaderResources);
+		}
+
+		void PSSetShaderResources(UINT startSlot, UINT count, ID3D11ShaderResourceView* const* shaderResources)
+		{
+			RecordSlots(BindKind::PSShaderResource, startSlot, count, shaderResources);
+		}
+
+		void PSSetSamplers(UINT startSlot, UINT count, ID3D11SamplerState* const* samplers)
+		{
+			RecordSlots(BindKind::PSSampler, startSlot, count, samplers);
+		}
+
+		void OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask)
+		{
+			UNREFERENCED_PARAMETER(blendFactor);
+			UNREFERENCED_PARAMETER(sampleMask);
+			Record(BindKind::BlendState, 0, Binding{ { reinterpret_cast<uintptr_t>(blendState), 0, 0 } });
+		}
+
+		const Binding& Bound(BindKind kind, uint32_t slot) const
+		{
+			return mBound[static_cast<uint32_t>(kind)][slot];
+		}
+
+		uint64_t BindCount() const
+		{
+			return mBindCount;
+		}
+
+	private:
+
+		template <typename T>
+		void RecordSlots(BindKind kind, UINT startSlot, UINT count, T* const* objects)
+		{
+			for (UINT index = 0; index < count; ++index)
+			{
+				Record(kind, startSlot + index, Binding{ { reinterpret_cast<uintptr_t>(objects[index]), 0, 0 } });
+			}
+		}
+
+		void Record(BindKind kind, uint32_t slot, const Binding& binding)
+		{
+			mBound[static_cast<uint32_t>(kind)][slot] = binding;
+			++mBindCount;
+		}
+
+		Binding mBound[static_cast<uint32_t>(BindKind::Count)][kSlotCount];
+		uint64_t mBindCount;
+	};
+
+	/************************************************************************/
+	RenderStateCacheValidator& RenderStateCacheValidator::GetInstance()
+	{
+		static RenderStateCacheValidator sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	RenderStateCacheValidationReport RenderStateCacheValidator::Validate(uint32_t sequenceCount, uint32_t seed)
+	{
+		RenderStateCacheValidationReport report = { sequenceCount, 0, 0, 0, 0, 0, 0 };
+
+		default_random_engine generator(seed);
+		uniform_int_distribution<uint32_t> percentDistribution(0, 99);
+		uniform_int_distribution<uint32_t> kindDistribution(0, static_cast<uint32_t>(BindKind::Count) - 1);
+		uniform_int_distribution<uint32_t> slotDistribution(0, kSlotCount - 1);
+
+		for (uint32_t sequence = 0; sequence < sequenceCount; ++sequence)
+		{
+			RecordingContext context;
+			RenderStateCache<RecordingContext> cache(&context);
+
+			// what the cache has bound since the last Invalidate, so a perfect cache would know it
+			bool isKnown[static_cast<uint32_t>(BindKind::Count)][kSlotCount] = {};
+			uint64_t forwardedBindCount = 0;
+			uint64_t requestedBindCount = 0;
+
+			for (uint32_t bind = 0; bind < kBindsPerSequence; ++bind)
+			{
+				if (percentDistribution(generator) < kInvalidatePercent)
+				{
+					cache.Invalidate();
+					for (auto& slots : isKnown)
+					{
+						for (auto& slotIsKnown : slots)
+						{
+							slotIsKnown = false;
+						}
+					}
+					continue;
+				}
+
+				const BindKind kind = static_cast<BindKind>(kindDistribution(generator));
+				const uint32_t slot = IsSlotted(kind) ? slotDistribution(generator) : 0;
+				const Binding binding = GetRandomBinding(generator, kind);
+				bool& slotIsKnown = isKnown[static_cast<uint32_t>(kind)][slot];
+				const bool isNeeded = !slotIsKnown || context.Bound(kind, slot) != binding;
+
+				const uint64_t bindCount = context.BindCount();
+				Request(cache, kind, slot, binding);
+				++requestedBindCount;
+
+				const bool isForwarded = context.BindCount() != bindCount;
+				if (isForwarded)
+				{
+					++forwardedBindCount;
+				}
+				if (context.Bound(kind, slot) != binding || (isNeeded && !isForwarded))
+				{
+					++report.MissedBindCount;
+				}
+				if (isForwarded && !isNeeded)
+				{
+					++report.RedundantBindCount;
+				}
+
+				slotIsKnown = slot < DeviceRenderStateCache::kSlotCount;
+			}
+
+			const RenderStateCacheStats& stats = cache.Stats();
+			if (stats.RequestedBindCount != requestedBindCount || stats.SkippedBindCount != requestedBindCount - forwardedBindCount)
+			{
+				++report.StatsMismatchCount;
+			}
+
+			report.RequestedBindCount += requestedBindCount;
+			report.ForwardedBindCount += forwardedBindCount;
+			report.SkippedBindCount += stats.SkippedBindCount;
+		}
+
+		return report;
+	}
+
+	/************************************************************************/
+	bool RenderStateCacheValidator::Binding::operator==(const Binding& rhs) const
+	{
+		return Values[0] == rhs.Values[0] && Values[1] == rhs.Values[1] && Values[2] == rhs.Values[2];
+	}
+
+	/************************************************************************/
+	bool RenderStateCacheValidator::Binding::operator!=(const Binding& rhs) const
+	{
+		return !operator==(rhs);
+	}
+
+	/************************************************************************/
+	void RenderStateCacheValidator::Request(RenderStateCache<RecordingContext>& cache, BindKind kind, uint32_t slot, const Binding& binding)
+	{
+		switch (kind)
+		{
+			case BindKind::Topology:
+				cache.SetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(binding.Values[0]));
+				break;
+
+			case BindKind::InputLayout:
+				cache.SetInputLayout(reinterpret_cast<ID3D11InputLayout*>(binding.Values[0]));
+				break;
+
+			case BindKind::VertexBuffer:
+				cache.SetVertexBuffer(reinterpret_cast<ID3D11Buffer*>(binding.Values[0]), static_cast<UINT>(binding.Values[1]), static_cast<UINT>(binding.Values[2]));
+				break;
+
+			case BindKind::IndexBuffer:
+				cache.SetIndexBuffer(reinterpret_cast<ID3D11Buffer*>(binding.Values[0]), static_cast<DXGI_FORMAT>(binding.Values[1]), static_cast<UINT>(binding.Values[2]));
+				break;
+
+			case BindKind::VertexShader:
+				cache.SetVertexShader(reinterpret_cast<ID3D11VertexShader*>(binding.Values[0]));
+				break;
+
+			case BindKind::PixelShader:
+				cache.SetPixelShader(reinterpret_cast<ID3D11PixelShader*>(binding.Values[0]));
+				break;
+
+			case BindKind::VSConstantBuffer:
+				cache.SetVSConstantBuffer(slot, reinterpret_cast<ID3D11Buffer*>(binding.Values[0]), static_cast<UINT>(binding.Values[1]), static_cast<UINT>(binding.Values[2]));
+				break;
+
+			case BindKind::VSShaderResource:
+				cache.SetVSShaderResource(slot, reinterpret_cast<ID3D11ShaderResourceView*>(binding.Values[0]));
+				break;
+
+			case BindKind::PSShaderResource:
+				cache.SetPSShaderResource(slot, reinterpret_cast<ID3D11ShaderResourceView*>(binding.Values[0]));
+				break;
+
+			case BindKind::PSSampler:
+				cache.SetPSSampler(slot, reinterpret_cast<ID3D11SamplerState*>(binding.Values[0]));
+				break;
+
+			case BindKind::BlendState:
+				cache.SetBlendState(reinterpret_cast<ID3D11BlendState*>(binding.Values[0]));
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	/************************************************************************/
+	RenderStateCacheValidator::Binding RenderStateCacheValidator::GetRandomBinding(default_random_engine& generator, BindKind kind)
+	{
+		// fake objects at aligned addresses, never dereferenced
+		uniform_int_distribution<uint32_t> objectDistribution(0, kObjectsPerState);
+		uniform_int_distribution<uint32_t> variantDistribution(0, 1);
+		Binding binding = { { static_cast<uintptr_t>(objectDistribution(generator)) * 16, 0, 0 } };
+
+		switch (kind)
+		{
+			case BindKind::Topology:
+				binding.Values[0] = binding.Values[0] == 0 ? D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST : D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+				break;
+
+			case BindKind::VertexBuffer:
+				binding.Values[1] = variantDistribution(generator) == 0 ? 16 : 20;
+				binding.Values[2] = variantDistribution(generator) == 0 ? 0 : 64;
+				break;
+
+			case BindKind::IndexBuffer:
+				binding.Values[1] = variantDistribution(generator) == 0 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+				break;
+
+			case BindKind::VSConstantBuffer:
+				// the whole buffer, or a range of the constant ring buffer
+				if (variantDistribution(generator) != 0)
+				{
+					binding.Values[1] = variantDistribution(generator) == 0 ? 0 : 16;
+					binding.Values[2] = 16;
+				}
+				break;
+
+			default:
+				break;
+		}
+
+		return binding;
+	}
+
+	/************************************************************************/
+	bool RenderStateCacheValidator::IsSlotted(BindKind kind)
+	{
+		return kind == BindKind::VSConstantBuffer || kind == BindKind::VSShaderResource || kind == BindKind::PSShaderResource || kind == BindKind::PSSampler;
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "RenderStateCache.h"
+#include <random>
+
+namespace DirectXGame
+{
+	/** Structure holding the outcome of a render state cache validation run.
+	*/
+	struct RenderStateCacheValidationReport
+	{
+		uint32_t SequenceCount;
+		uint64_t RequestedBindCount;
+		uint64_t ForwardedBindCount; // binds the mock context received
+		uint64_t SkippedBindCount;   // as counted by the cache
+		uint64_t MissedBindCount;    // requests after which the mock context did not have what was asked for
+		uint64_t RedundantBindCount; // binds the mock context received although it already had them
+		uint64_t StatsMismatchCount; // sequences whose cache counts disagree with what the mock context received
+	};
+
+	/** Singleton checking the tracking of RenderStateCache against a mock context, without a graphics device.
+	 * Each sequence draws random binds from a few fake objects per state, so most of them repeat what is bound,
+	 * with an occasional Invalidate in between. The mock context records what it has bound; after every request it
+	 * must have what was asked for, and it must only have received the binds that changed something or followed an
+	 * Invalidate, which is what a perfect cache would pass on.
+	 *@see RenderStateCache
+	 *@see HeadlessTools
+	*/
+	class RenderStateCacheValidator final
+	{
+	public:
+
+		RenderStateCacheValidator(const RenderStateCacheValidator& rhs) = delete;
+		RenderStateCacheValidator(const RenderStateCacheValidator&& rhs) = delete;
+		RenderStateCacheValidator& operator=(const RenderStateCacheValidator& rhs) = delete;
+		RenderStateCacheValidator& operator=(const RenderStateCacheValidator&& rhs) = delete;
+
+		static RenderStateCacheValidator& GetInstance();
+
+		RenderStateCacheValidationReport Validate(uint32_t sequenceCount, uint32_t seed);
+
+	private:
+
+		RenderStateCacheValidator() = default;
+		~RenderStateCacheValidator() = default;
+
+		enum class BindKind : uint32_t
+		{
+			Topology,
+			InputLayout,
+			VertexBuffer,
+			IndexBuffer,
+			VertexShader,
+			PixelShader,
+			VSConstantBuffer,
+			VSShaderResource,
+			PSShaderResource,
+			PSSampler,
+			BlendState,
+			Count
+		};
+
+		/** Structure representing what one bind puts in one slot of the pipeline.
+		*/
+		struct Binding
+		{
+			uintptr_t Values[3]; // the object, then the stride, format or first constant and the offset or constant count
+
+			bool operator==(const Binding& rhs) const;
+			bool operator!=(const Binding& rhs) const;
+		};
+
+		class RecordingContext;
+
+		static void Request(RenderStateCache<RecordingContext>& cache, BindKind kind, uint32_t slot, const Binding& binding);
+		static Binding GetRandomBinding(std::default_random_engine& generator, BindKind kind);
+		static bool IsSlotted(BindKind kind);
+
+		static const uint32_t kSlotCount = DeviceRenderStateCache::kSlotCount + 1; // the last one untracked
+		static const uint32_t kBindsPerSequence;
+		static const uint32_t kObjectsPerState;
+		static const uint32_t kInvalidatePercent;
+	};
+}
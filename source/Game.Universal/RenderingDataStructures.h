@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 #include <DirectXMath.h>
+#include "MapChunks.h"
 
 namespace DirectXGame
 {
@@ -15,11 +16,14 @@ namespace DirectXGame
 #pragma region Structures
 
 	/** Structure representing the data of a sprite in a sprite sheet.
+	 * X and Y are the top left pixel of the sprite in the texture. UVRect is its rectangle in texture coordinates,
+	 * computed once when the sheet is loaded and uploaded as is by the renderables, so the sprite can sit anywhere
+	 * in a sheet or in the atlas.
 	*/
 	struct Sprite
 	{
-		Sprite(const uint32_t width = 52, const uint32_t height = 52, const uint32_t x = 0, const uint32_t y = 0, const DirectX::XMFLOAT2& uvScalingFactor = DirectX::XMFLOAT2(), const float_t sortingLayer = 0) :
-			Width(width), Height(height), X(x), Y(y), UVScalingFactor(uvScalingFactor), SortingLayer(sortingLayer)
+		Sprite(const uint32_t width = 52, const uint32_t height = 52, const uint32_t x = 0, const uint32_t y = 0, const DirectX::XMFLOAT4& uvRect = DirectX::XMFLOAT4(0, 0, 1, 1), const float_t sortingLayer = 0) :
+			Width(width), Height(height), X(x), Y(y), UVRect(uvRect), SortingLayer(sortingLayer)
 		{
 		}
 
@@ -27,7 +31,7 @@ namespace DirectXGame
 		uint32_t Height;
 		uint32_t X;
 		uint32_t Y;
-		DirectX::XMFLOAT2 UVScalingFactor;
+		DirectX::XMFLOAT4 UVRect; // top left corner in x and y, size in z and w
 		float_t SortingLayer;
 	};
 
@@ -47,7 +51,7 @@ namespace DirectXGame
 	{
 		std::vector<std::shared_ptr<Sprite>> Sprites;
 		std::map<std::string, std::shared_ptr<Animation>> Animations;
-		float_t TextureXUnit;
+		float_t TextureXUnit; // size of a texel in texture coordinates
 		float_t TextureYUnit;
 	};
 
@@ -67,6 +71,7 @@ namespace DirectXGame
 		TileWithSpriteIndex DoorTile;
 
 		DirectX::XMUINT2 PlayerSpawnTile;
+		std::vector<DirectX::XMUINT2> PlayerSpawnTiles; // one per player, the first one is PlayerSpawnTile
 		std::vector<DirectX::XMUINT2> RestrictedTiles;
 
 		uint32_t MapWidth;
@@ -77,6 +82,31 @@ namespace DirectXGame
 
 		std::vector<std::vector<uint8_t>> BackgroundLayer;
 		std::vector<std::vector<uint8_t>> BlocksLayer;
+		MapChunks Chunks; // follows BlocksLayer, see MapChunks
+	};
+
+	/** Structure representing the player's perks.
+	*/
+	struct Perks
+	{
+		Perks(const uint8_t bombUp = 0, const uint8_t fire = 0, const uint8_t skate = 0, const bool remote = false,
+			  const bool passBomb = false, const bool passSoftBlocks = false) :
+			BombUp(bombUp),
+			Fire(fire),
+			Skate(skate),
+			Remote(remote),
+			PassBomb(passBomb),
+			PassSoftBlocks(passSoftBlocks)
+		{
+		}
+
+		uint8_t BombUp;
+		uint8_t Fire;
+		uint8_t Skate;
+
+		bool Remote;
+		bool PassBomb;
+		bool PassSoftBlocks;
 	};
 
 #pragma endregion
@@ -84,6 +114,16 @@ namespace DirectXGame
 
 #pragma region Enums
 
+	/** Enumeration representing the different states the player can have in the game.
+	*/
+	enum class PlayerState : uint8_t
+	{
+		Idle,
+		Moving,
+		Dying,
+		Dead
+	};
+
 	/** Enumeration representing the sprites indices in a spritesheet object.
 	 *@see SpriteSheet
 	*/
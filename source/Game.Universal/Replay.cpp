@@ -0,0 +1,182 @@
+#include "pch.h"
+#include "Replay.h"
+#include <iterator>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t Replay::kMagic = 0x594C5052; // "RPLY"
+	const uint16_t Replay::kVersion = 1;
+
+	/************************************************************************/
+	Replay::Replay() :
+		mTickCount(0)
+	{
+	}
+
+	/************************************************************************/
+	Replay::Replay(const GameSimulationOptions& options) :
+		mOptions(options), mTickCount(0)
+	{
+	}
+
+	/************************************************************************/
+	void Replay::AddInputs(const PlayerInput* inputs)
+	{
+		const uint32_t playerCount = mOptions.PlayerCount;
+
+		// extend the last run while nobody changes its input
+		if (!mRunLengths.empty() && equal(inputs, inputs + playerCount, mRunInputs.end() - playerCount))
+		{
+			++mRunLengths.back();
+		}
+		else
+		{
+			mRunLengths.push_back(1);
+			mRunInputs.insert(mRunInputs.end(), inputs, inputs + playerCount);
+		}
+
+		++mTickCount;
+	}
+
+	/************************************************************************/
+	void Replay::AddCheckpoint(uint32_t tick, uint64_t stateHash)
+	{
+		ReplayCheckpoint checkpoint;
+		checkpoint.Tick = tick;
+		checkpoint.StateHash = stateHash;
+		mCheckpoints.push_back(checkpoint);
+	}
+
+	/************************************************************************/
+	const GameSimulationOptions& Replay::Options() const
+	{
+		return mOptions;
+	}
+
+	/************************************************************************/
+	uint32_t Replay::TickCount() const
+	{
+		return mTickCount;
+	}
+
+	/************************************************************************/
+	uint32_t Replay::RunCount() const
+	{
+		return static_cast<uint32_t>(mRunLengths.size());
+	}
+
+	/************************************************************************/
+	uint32_t Replay::GetRunLength(uint32_t run) const
+	{
+		return mRunLengths[run];
+	}
+
+	/************************************************************************/
+	const PlayerInput* Replay::GetRunInputs(uint32_t run) const
+	{
+		return mRunInputs.data() + run * mOptions.PlayerCount;
+	}
+
+	/************************************************************************/
+	const vector<ReplayCheckpoint>& Replay::Checkpoints() const
+	{
+		return mCheckpoints;
+	}
+
+	/************************************************************************/
+	void Replay::Save(vector<uint8_t>& bytes) const
+	{
+		bytes.clear();
+
+		SnapshotWriter writer(bytes);
+		writer.Write(kMagic);
+		writer.Write(kVersion);
+		writer.Write(mOptions.Seed);
+		writer.Write(mOptions.PlayerCount);
+		writer.Write(mOptions.EnemyCount);
+		writer.Write(mTickCount);
+		writer.Write(mRunLengths);
+		writer.Write(mRunInputs);
+
+		writer.Write(static_cast<uint32_t>(mCheckpoints.size()));
+		for (auto& checkpoint : mCheckpoints)
+		{
+			writer.Write(checkpoint.Tick);
+			writer.Write(checkpoint.StateHash);
+		}
+	}
+
+	/************************************************************************/
+	void Replay::Load(const vector<uint8_t>& bytes)
+	{
+		SnapshotReader reader(bytes.data(), bytes.size());
+
+		uint32_t magic;
+		uint16_t version;
+		reader.Read(magic);
+		reader.Read(version);
+		if (magic != kMagic)
+		{
+			throw runtime_error("not a replay");
+		}
+		if (version != kVersion)
+		{
+			throw runtime_error("unsupported replay version " + to_string(version));
+		}
+
+		reader.Read(mOptions.Seed);
+		reader.Read(mOptions.PlayerCount);
+		reader.Read(mOptions.EnemyCount);
+		reader.Read(mTickCount);
+		reader.Read(mRunLengths);
+		reader.Read(mRunInputs);
+
+		uint32_t checkpointCount;
+		reader.Read(checkpointCount);
+		mCheckpoints.resize(checkpointCount);
+		for (auto& checkpoint : mCheckpoints)
+		{
+			reader.Read(checkpoint.Tick);
+			reader.Read(checkpoint.StateHash);
+		}
+
+		uint64_t runTicks = 0;
+		for (auto length : mRunLengths)
+		{
+			runTicks += length;
+		}
+		if (mRunInputs.size() != static_cast<uint64_t>(mRunLengths.size()) * mOptions.PlayerCount || runTicks != mTickCount)
+		{
+			throw runtime_error("replay runs do not match its tick count");
+		}
+	}
+
+	/************************************************************************/
+	void Replay::SaveToFile(const string& path) const
+	{
+		vector<uint8_t> bytes;
+		Save(bytes);
+
+		ofstream ofs(path, ios::binary | ios::trunc);
+		ofs.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+		if (!ofs)
+		{
+			throw runtime_error("could not write the replay " + path);
+		}
+	}
+
+	/************************************************************************/
+	void Replay::LoadFromFile(const string& path)
+	{
+		ifstream ifs(path, ios::binary);
+		if (!ifs)
+		{
+			throw runtime_error("could not open the replay " + path);
+		}
+
+		vector<uint8_t> bytes((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+		Load(bytes);
+	}
+}
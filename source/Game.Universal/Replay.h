@@ -0,0 +1,57 @@
+#pragma once
+
+#include "GameSimulation.h"
+
+namespace DirectXGame
+{
+	/** Structure representing the state hash a replay expects at a tick.
+	*/
+	struct ReplayCheckpoint
+	{
+		uint32_t Tick;
+		uint64_t StateHash;
+	};
+
+	/** Class holding a recorded game: the options it started with, the inputs of every player for every tick, and
+	 * state hashes taken along the way.
+	 * Inputs are stored run length encoded, a run being a number of ticks during which no player changed its input.
+	 * Players hold their buttons for many ticks, so a minute of game usually takes a few hundred bytes.
+	 * Since the simulation is deterministic, playing the inputs again must hit every checkpoint, which makes
+	 * replays both regression tests and benchmark workloads.
+	 *@see ReplayRecorder
+	 *@see ReplayPlayer
+	*/
+	class Replay final
+	{
+	public:
+
+		Replay();
+		explicit Replay(const GameSimulationOptions& options);
+
+		void AddInputs(const PlayerInput* inputs);
+		void AddCheckpoint(uint32_t tick, uint64_t stateHash);
+
+		const GameSimulationOptions& Options() const;
+		uint32_t TickCount() const;
+		uint32_t RunCount() const;
+		uint32_t GetRunLength(uint32_t run) const;
+		const PlayerInput* GetRunInputs(uint32_t run) const;
+		const std::vector<ReplayCheckpoint>& Checkpoints() const;
+
+		void Save(std::vector<uint8_t>& bytes) const;
+		void Load(const std::vector<uint8_t>& bytes);
+		void SaveToFile(const std::string& path) const;
+		void LoadFromFile(const std::string& path);
+
+		static const uint32_t kMagic;
+		static const uint16_t kVersion;
+
+	private:
+
+		GameSimulationOptions mOptions;
+		uint32_t mTickCount;
+		std::vector<uint32_t> mRunLengths;
+		std::vector<PlayerInput> mRunInputs; // PlayerCount inputs per run
+		std::vector<ReplayCheckpoint> mCheckpoints;
+	};
+}
@@ -0,0 +1,74 @@
+#include "pch.h"
+#include "ReplayPlayer.h"
+#include <chrono>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	ReplayPlayer& ReplayPlayer::GetInstance()
+	{
+		static ReplayPlayer sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	ReplayReport ReplayPlayer::Play(const Map& basicMap, const Replay& replay, uint32_t repeatCount)
+	{
+		ReplayReport report = {};
+		report.FirstMismatchTick = UINT32_MAX;
+
+		GameSimulation simulation;
+		auto start = chrono::high_resolution_clock::now();
+
+		for (uint32_t i = 0; i < repeatCount; ++i)
+		{
+			simulation.Initialize(basicMap, replay.Options());
+			Play(simulation, replay, report);
+		}
+
+		chrono::duration<double_t> elapsed = chrono::high_resolution_clock::now() - start;
+		report.ElapsedSeconds = elapsed.count();
+		report.TicksPerSecond = report.ElapsedSeconds > 0 ? report.TickCount / report.ElapsedSeconds : 0;
+		report.RealTimeFactor = report.TicksPerSecond * GameSimulation::kTickSeconds;
+
+		return report;
+	}
+
+	/************************************************************************/
+	void ReplayPlayer::Play(GameSimulation& simulation, const Replay& replay, ReplayReport& report)
+	{
+		if (simulation.CurrentTick() != 0 || simulation.Players().size() != replay.Options().PlayerCount)
+		{
+			throw runtime_error("a replay must be played from the first tick of a simulation started with its options");
+		}
+
+		auto& checkpoints = replay.Checkpoints();
+		size_t nextCheckpoint = 0;
+
+		for (uint32_t run = 0; run < replay.RunCount(); ++run)
+		{
+			const PlayerInput* inputs = replay.GetRunInputs(run);
+			for (uint32_t i = replay.GetRunLength(run); i > 0; --i)
+			{
+				simulation.Tick(inputs);
+				++report.TickCount;
+
+				if (nextCheckpoint < checkpoints.size() && checkpoints[nextCheckpoint].Tick == simulation.CurrentTick())
+				{
+					++report.CheckpointCount;
+					if (checkpoints[nextCheckpoint].StateHash != simulation.GetStateHash())
+					{
+						++report.MismatchCount;
+						if (simulation.CurrentTick() < report.FirstMismatchTick)
+						{
+							report.FirstMismatchTick = simulation.CurrentTick();
+						}
+					}
+					++nextCheckpoint;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Replay.h"
+
+namespace DirectXGame
+{
+	/** Structure holding the results of playing a replay.
+	*/
+	struct ReplayReport
+	{
+		uint64_t TickCount;
+		uint32_t CheckpointCount;
+		uint32_t MismatchCount;
+		uint32_t FirstMismatchTick;
+		std::double_t ElapsedSeconds;
+		std::double_t TicksPerSecond;
+		std::double_t RealTimeFactor; // how many times faster than the game runs
+	};
+
+	/** Singleton that plays replays back on a headless simulation, as fast as it can.
+	 * The recorded runs are expanded tick by tick and the state hash is compared at every checkpoint, so a replay
+	 * recorded before a change tells whether the change altered the game, and how long the same game now takes to simulate.
+	 *@see Replay
+	*/
+	class ReplayPlayer final
+	{
+	public:
+
+		ReplayPlayer(const ReplayPlayer& rhs) = delete;
+		ReplayPlayer(const ReplayPlayer&& rhs) = delete;
+		ReplayPlayer& operator=(const ReplayPlayer& rhs) = delete;
+		ReplayPlayer& operator=(const ReplayPlayer&& rhs) = delete;
+
+		static ReplayPlayer& GetInstance();
+
+		ReplayReport Play(const Map& basicMap, const Replay& replay, uint32_t repeatCount = 1);
+		void Play(GameSimulation& simulation, const Replay& replay, ReplayReport& report);
+
+	private:
+
+		ReplayPlayer() = default;
+		~ReplayPlayer() = default;
+	};
+}
@@ -0,0 +1,57 @@
+#include "pch.h"
+#include "ReplayRecorder.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t ReplayRecorder::kCheckpointInterval = 600; // every 10 seconds of game
+
+	/************************************************************************/
+	ReplayRecorder::ReplayRecorder(GameSimulation& simulation, const GameSimulationOptions& options) :
+		mSimulation(simulation), mReplay(options), mIsFinished(false)
+	{
+		if (mSimulation.CurrentTick() != 0 || mSimulation.Players().size() != options.PlayerCount)
+		{
+			throw runtime_error("a replay must be recorded from the first tick of a simulation started with its options");
+		}
+	}
+
+	/************************************************************************/
+	void ReplayRecorder::Tick(const PlayerInput* inputs)
+	{
+		if (mIsFinished)
+		{
+			throw runtime_error("the replay is already finished");
+		}
+
+		mReplay.AddInputs(inputs);
+		mSimulation.Tick(inputs);
+
+		if (mSimulation.CurrentTick() % kCheckpointInterval == 0)
+		{
+			mReplay.AddCheckpoint(mSimulation.CurrentTick(), mSimulation.GetStateHash());
+		}
+	}
+
+	/************************************************************************/
+	Replay& ReplayRecorder::Finish()
+	{
+		if (!mIsFinished)
+		{
+			// the final state is always checked, unless the last tick was already a checkpoint
+			if (mSimulation.CurrentTick() % kCheckpointInterval != 0)
+			{
+				mReplay.AddCheckpoint(mSimulation.CurrentTick(), mSimulation.GetStateHash());
+			}
+			mIsFinished = true;
+		}
+		return mReplay;
+	}
+
+	/************************************************************************/
+	const Replay& ReplayRecorder::GetReplay() const
+	{
+		return mReplay;
+	}
+}
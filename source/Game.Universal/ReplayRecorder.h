@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Replay.h"
+
+namespace DirectXGame
+{
+	/** Class recording the inputs a simulation is played with, tick after tick, into a replay.
+	 * The inputs go through the recorder on their way to the simulation, so what is recorded is exactly what was played,
+	 * whatever produced it: local devices, a network session or a script. A checkpoint is taken every
+	 * kCheckpointInterval ticks and when the recording is finished.
+	 *@see Replay
+	*/
+	class ReplayRecorder final
+	{
+	public:
+
+		ReplayRecorder(GameSimulation& simulation, const GameSimulationOptions& options);
+
+		void Tick(const PlayerInput* inputs);
+		Replay& Finish();
+
+		const Replay& GetReplay() const;
+
+		static const uint32_t kCheckpointInterval;
+
+	private:
+
+		GameSimulation& mSimulation;
+		Replay mReplay;
+		bool mIsFinished;
+	};
+}
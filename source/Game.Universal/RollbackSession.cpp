@@ -0,0 +1,319 @@
+#include "pch.h"
+#include "RollbackSession.h"
+#include <chrono>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	RollbackSession::RollbackSession(GameSimulation& simulation, LoopbackTransport& transport, uint32_t localPlayer, uint32_t inputDelay, uint32_t maxRollback) :
+		mSimulation(simulation), mTransport(transport), mLocalPlayer(localPlayer),
+		mPlayerCount(static_cast<uint32_t>(simulation.Players().size())), mInputDelay(inputDelay), mMaxRollback(maxRollback),
+		mRollbackTick(UINT32_MAX), mDesyncTick(UINT32_MAX), mMetrics(), mFrames(kWindowSize)
+	{
+		if (mPlayerCount == 0 || mPlayerCount > PeerMessage::kMaxPeerCount || mLocalPlayer >= mPlayerCount)
+		{
+			throw runtime_error("a rollback session needs between 1 and " + to_string(PeerMessage::kMaxPeerCount) + " players, the local one included");
+		}
+
+		// the unacknowledged local inputs and the unconfirmed snapshots must stay in the ring
+		if (mMaxRollback == 0 || mInputDelay + mMaxRollback > kWindowSize / 4)
+		{
+			throw runtime_error("the input delay and the rollback window do not fit the tick ring");
+		}
+
+		for (auto& frame : mFrames)
+		{
+			frame.Tick = UINT32_MAX;
+		}
+
+		// nobody has input for the first ticks, every peer plays them idle
+		const uint32_t firstInputTick = mSimulation.CurrentTick() + mInputDelay;
+		for (uint32_t tick = mSimulation.CurrentTick(); tick < firstInputTick; ++tick)
+		{
+			GetFrame(tick).ConfirmedMask = UINT32_MAX;
+		}
+
+		for (uint32_t player = 0; player < PeerMessage::kMaxPeerCount; ++player)
+		{
+			mNextMissingTicks[player] = firstInputTick;
+			mRemoteNextMissingTicks[player] = firstInputTick;
+			mRemoteHashTicks[player] = UINT32_MAX;
+			mRemoteHashes[player] = 0;
+		}
+	}
+
+	/************************************************************************/
+	bool RollbackSession::AdvanceFrame(const PlayerInput& localInput)
+	{
+		++mMetrics.FrameCount;
+
+		ReceiveMessages();
+		Rollback();
+		CompareHashes();
+
+		// never predict a player further than the rollback window, wait for its inputs instead
+		const uint32_t tick = mSimulation.CurrentTick();
+		for (uint32_t player = 0; player < mPlayerCount; ++player)
+		{
+			if (player != mLocalPlayer && tick >= mNextMissingTicks[player] + mMaxRollback)
+			{
+				++mMetrics.StalledFrameCount;
+				SendInputs();
+				return false;
+			}
+		}
+
+		ConfirmInput(mLocalPlayer, tick + mInputDelay, localInput);
+		SendInputs();
+		SimulateTick();
+
+		return true;
+	}
+
+	/************************************************************************/
+	void RollbackSession::Poll()
+	{
+		ReceiveMessages();
+		Rollback();
+		CompareHashes();
+		SendInputs();
+	}
+
+	/************************************************************************/
+	uint32_t RollbackSession::CurrentTick() const
+	{
+		return mSimulation.CurrentTick();
+	}
+
+	/************************************************************************/
+	uint32_t RollbackSession::ConfirmedTick() const
+	{
+		uint32_t nextTick = mSimulation.CurrentTick();
+		for (uint32_t player = 0; player < mPlayerCount; ++player)
+		{
+			nextTick = mNextMissingTicks[player] < nextTick ? mNextMissingTicks[player] : nextTick;
+		}
+		return nextTick > 0 ? nextTick - 1 : UINT32_MAX;
+	}
+
+	/************************************************************************/
+	bool RollbackSession::HasDesynced() const
+	{
+		return mDesyncTick != UINT32_MAX;
+	}
+
+	/************************************************************************/
+	uint32_t RollbackSession::DesyncTick() const
+	{
+		return mDesyncTick;
+	}
+
+	/************************************************************************/
+	const RollbackMetrics& RollbackSession::Metrics() const
+	{
+		return mMetrics;
+	}
+
+	/************************************************************************/
+	RollbackSession::TickFrame& RollbackSession::GetFrame(uint32_t tick)
+	{
+		TickFrame& frame = mFrames[tick % kWindowSize];
+		if (frame.Tick != tick)
+		{
+			frame.Tick = tick;
+			frame.ConfirmedMask = 0;
+			for (auto& input : frame.Inputs)
+			{
+				input = PlayerInput();
+			}
+			frame.Snapshot.clear();
+			frame.StateHash = 0;
+		}
+		return frame;
+	}
+
+	/************************************************************************/
+	const RollbackSession::TickFrame& RollbackSession::GetSimulatedFrame(uint32_t tick) const
+	{
+		const TickFrame& frame = mFrames[tick % kWindowSize];
+		if (frame.Tick != tick)
+		{
+			throw runtime_error("tick " + to_string(tick) + " left the rollback ring, the peers drifted too far apart");
+		}
+		return frame;
+	}
+
+	/************************************************************************/
+	void RollbackSession::ReceiveMessages()
+	{
+		PeerMessage message;
+		while (mTransport.Receive(mLocalPlayer, message))
+		{
+			const uint32_t player = message.PlayerIndex;
+			if (player >= mPlayerCount || player == mLocalPlayer)
+			{
+				continue;
+			}
+
+			for (uint32_t i = 0; i < message.InputCount && i < PeerMessage::kMaxInputCount; ++i)
+			{
+				ConfirmInput(player, message.Tick + i, message.Inputs[i]);
+			}
+
+			// what that player already has of the local inputs, they are not sent again
+			if (message.NextMissingTicks[mLocalPlayer] > mRemoteNextMissingTicks[player])
+			{
+				mRemoteNextMissingTicks[player] = message.NextMissingTicks[mLocalPlayer];
+			}
+
+			if (message.HashTick != UINT32_MAX)
+			{
+				mRemoteHashTicks[player] = message.HashTick;
+				mRemoteHashes[player] = message.StateHash;
+			}
+		}
+	}
+
+	/************************************************************************/
+	void RollbackSession::ConfirmInput(uint32_t player, uint32_t tick, const PlayerInput& input)
+	{
+		// inputs are confirmed in order, repeated ones and ones after a gap are ignored
+		if (tick != mNextMissingTicks[player])
+		{
+			return;
+		}
+
+		TickFrame& frame = GetFrame(tick);
+		if (tick < mSimulation.CurrentTick() && frame.Inputs[player] != input && tick < mRollbackTick)
+		{
+			mRollbackTick = tick;
+		}
+
+		frame.Inputs[player] = input;
+		frame.ConfirmedMask |= 1u << player;
+		mLastConfirmedInputs[player] = input;
+		++mNextMissingTicks[player];
+	}
+
+	/************************************************************************/
+	void RollbackSession::Rollback()
+	{
+		if (mRollbackTick == UINT32_MAX)
+		{
+			return;
+		}
+
+		auto start = chrono::high_resolution_clock::now();
+
+		const uint32_t presentTick = mSimulation.CurrentTick();
+		const uint32_t depth = presentTick - mRollbackTick;
+		SnapshotCodec::GetInstance().Restore(GetSimulatedFrame(mRollbackTick).Snapshot, mSimulation);
+		mRollbackTick = UINT32_MAX;
+
+		while (mSimulation.CurrentTick() < presentTick)
+		{
+			SimulateTick();
+		}
+
+		chrono::duration<double_t> elapsed = chrono::high_resolution_clock::now() - start;
+		++mMetrics.RollbackCount;
+		mMetrics.ResimulatedTickCount += depth;
+		mMetrics.MaxRollbackDepth = depth > mMetrics.MaxRollbackDepth ? depth : mMetrics.MaxRollbackDepth;
+		mMetrics.ResimulationSeconds += elapsed.count();
+		mMetrics.WorstResimulationMilliseconds = max(mMetrics.WorstResimulationMilliseconds, elapsed.count() * 1000);
+	}
+
+	/************************************************************************/
+	void RollbackSession::SimulateTick()
+	{
+		TickFrame& frame = GetFrame(mSimulation.CurrentTick());
+
+		// predict the missing inputs, and keep a snapshot to come back to when a prediction turns out wrong
+		const uint32_t allPlayersMask = (1u << mPlayerCount) - 1;
+		if ((frame.ConfirmedMask & allPlayersMask) != allPlayersMask)
+		{
+			for (uint32_t player = 0; player < mPlayerCount; ++player)
+			{
+				if ((frame.ConfirmedMask & (1u << player)) == 0)
+				{
+					frame.Inputs[player] = mLastConfirmedInputs[player];
+				}
+			}
+			SnapshotCodec::GetInstance().Save(mSimulation, frame.Snapshot);
+		}
+
+		mSimulation.Tick(frame.Inputs);
+		frame.StateHash = mSimulation.GetStateHash();
+	}
+
+	/************************************************************************/
+	void RollbackSession::SendInputs()
+	{
+		PeerMessage message = {};
+		message.PlayerIndex = mLocalPlayer;
+
+		// every local input one of the other players is still missing, oldest first
+		uint32_t firstTick = mNextMissingTicks[mLocalPlayer];
+		for (uint32_t player = 0; player < mPlayerCount; ++player)
+		{
+			if (player != mLocalPlayer && mRemoteNextMissingTicks[player] < firstTick)
+			{
+				firstTick = mRemoteNextMissingTicks[player];
+			}
+		}
+
+		message.Tick = firstTick;
+		message.InputCount = mNextMissingTicks[mLocalPlayer] - firstTick;
+		if (message.InputCount > PeerMessage::kMaxInputCount)
+		{
+			message.InputCount = PeerMessage::kMaxInputCount;
+		}
+		for (uint32_t i = 0; i < message.InputCount; ++i)
+		{
+			message.Inputs[i] = GetSimulatedFrame(firstTick + i).Inputs[mLocalPlayer];
+		}
+
+		for (uint32_t player = 0; player < mPlayerCount; ++player)
+		{
+			message.NextMissingTicks[player] = mNextMissingTicks[player];
+		}
+
+		message.HashTick = ConfirmedTick();
+		message.StateHash = message.HashTick != UINT32_MAX ? GetSimulatedFrame(message.HashTick).StateHash : 0;
+
+		mTransport.Send(mLocalPlayer, message);
+	}
+
+	/************************************************************************/
+	void RollbackSession::CompareHashes()
+	{
+		const uint32_t confirmedTick = ConfirmedTick();
+		if (confirmedTick == UINT32_MAX)
+		{
+			return;
+		}
+
+		for (uint32_t player = 0; player < mPlayerCount; ++player)
+		{
+			const uint32_t tick = mRemoteHashTicks[player];
+			if (player == mLocalPlayer || tick == UINT32_MAX || tick > confirmedTick)
+			{
+				continue;
+			}
+
+			// too old to be checked, the next message brings a newer one
+			const TickFrame& frame = mFrames[tick % kWindowSize];
+			if (frame.Tick == tick)
+			{
+				if (frame.StateHash != mRemoteHashes[player] && tick < mDesyncTick)
+				{
+					mDesyncTick = tick;
+				}
+				++mMetrics.ComparedHashCount;
+			}
+			mRemoteHashTicks[player] = UINT32_MAX;
+		}
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "SnapshotCodec.h"
+#include "LoopbackTransport.h"
+
+namespace DirectXGame
+{
+	/** Structure holding what a rollback session did, to tune the input delay and the rollback window.
+	*/
+	struct RollbackMetrics
+	{
+		uint64_t FrameCount;
+		uint64_t StalledFrameCount;
+		uint64_t RollbackCount;
+		uint64_t ResimulatedTickCount;
+		uint64_t ComparedHashCount;
+		uint32_t MaxRollbackDepth;
+		std::double_t ResimulationSeconds;
+		std::double_t WorstResimulationMilliseconds; // restore and resimulation of the worst frame
+	};
+
+	/** Class keeping the simulation of one peer in sync with the others without waiting for their inputs.
+	 * Missing remote inputs are predicted by repeating the last one received. A snapshot is kept for every tick that
+	 * is not confirmed yet, and when a remote input differs from its prediction the simulation is restored to that
+	 * tick and played again up to the present, all within the frame.
+	 * A peer never predicts more than maxRollback ticks ahead: past that, frames stall until the inputs arrive.
+	 * Messages repeat every input the other peers have not acknowledged, so lost messages are recovered by later ones.
+	 *@see GameSimulation
+	 *@see SnapshotCodec
+	*/
+	class RollbackSession final
+	{
+	public:
+
+		RollbackSession(GameSimulation& simulation, LoopbackTransport& transport, uint32_t localPlayer,
+						uint32_t inputDelay = kDefaultInputDelay, uint32_t maxRollback = kDefaultMaxRollback);
+
+		bool AdvanceFrame(const PlayerInput& localInput);
+		void Poll();
+
+		uint32_t CurrentTick() const;
+		uint32_t ConfirmedTick() const;
+		bool HasDesynced() const;
+		uint32_t DesyncTick() const;
+		const RollbackMetrics& Metrics() const;
+
+		static const uint32_t kDefaultInputDelay = 1;
+		static const uint32_t kDefaultMaxRollback = 8;
+
+	private:
+
+		/** Structure holding everything known about one tick.
+		*/
+		struct TickFrame
+		{
+			uint32_t Tick;
+			uint32_t ConfirmedMask;
+			PlayerInput Inputs[PeerMessage::kMaxPeerCount];
+			std::vector<uint8_t> Snapshot; // state before the tick
+			uint64_t StateHash;            // state after the tick
+		};
+
+		TickFrame& GetFrame(uint32_t tick);
+		void ReceiveMessages();
+		void ConfirmInput(uint32_t player, uint32_t tick, const PlayerInput& input);
+		void Rollback();
+		void SimulateTick();
+		void SendInputs();
+		void CompareHashes();
+		const TickFrame& GetSimulatedFrame(uint32_t tick) const;
+
+		GameSimulation& mSimulation;
+		LoopbackTransport& mTransport;
+		uint32_t mLocalPlayer;
+		uint32_t mPlayerCount;
+		uint32_t mInputDelay;
+		uint32_t mMaxRollback;
+
+		// per player: first tick whose input is not confirmed, last confirmed input used as prediction,
+		// and first tick of the local inputs that player has not received
+		uint32_t mNextMissingTicks[PeerMessage::kMaxPeerCount];
+		PlayerInput mLastConfirmedInputs[PeerMessage::kMaxPeerCount];
+		uint32_t mRemoteNextMissingTicks[PeerMessage::kMaxPeerCount];
+
+		// last state hash received from each player, compared once the local simulation confirmed that tick
+		uint32_t mRemoteHashTicks[PeerMessage::kMaxPeerCount];
+		uint64_t mRemoteHashes[PeerMessage::kMaxPeerCount];
+
+		uint32_t mRollbackTick;
+		uint32_t mDesyncTick;
+		RollbackMetrics mMetrics;
+
+		// ring indexed by tick % kWindowSize
+		std::vector<TickFrame> mFrames;
+
+		static const uint32_t kWindowSize = 128;
+	};
+}
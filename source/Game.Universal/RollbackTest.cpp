@@ -0,0 +1,193 @@
+#include "pch.h"
+#include "RollbackTest.h"
+#include "RandomInputScript.h"
+#include "LevelGenerator.h"
+#include "MapParser.h"
+#include <chrono>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const double_t RollbackTest::kFrameBudgetMilliseconds = 1000.0 / 60;
+	const uint32_t RollbackTest::kFullRollbackSampleCount = 1000;
+	const uint32_t RollbackTest::kMaxFramesPerTick = 100; // past that the sessions are considered stuck
+
+	/************************************************************************/
+	RollbackTest& RollbackTest::GetInstance()
+	{
+		static RollbackTest sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	RollbackTestReport RollbackTest::Run(const RollbackTestOptions& options)
+	{
+		RollbackTestReport report = {};
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+
+		for (uint32_t round = 0; round < options.RoundCount; ++round)
+		{
+			RunRound(basicMap, options, options.FirstSeed + round, report);
+		}
+
+		MeasureFullRollback(basicMap, options, report);
+
+		// the rounds sum the resimulation times up
+		if (report.RollbackCount > 0)
+		{
+			report.MeanRollbackDepth = static_cast<double_t>(report.ResimulatedTickCount) / report.RollbackCount;
+			report.MillisecondsPerRollback /= report.RollbackCount;
+		}
+
+		return report;
+	}
+
+	/************************************************************************/
+	void RollbackTest::RunRound(const Map& basicMap, const RollbackTestOptions& options, uint32_t seed, RollbackTestReport& report)
+	{
+		GameSimulationOptions simulationOptions;
+		simulationOptions.Seed = seed;
+		simulationOptions.PlayerCount = options.PlayerCount;
+		simulationOptions.EnemyCount = options.EnemyCount;
+
+		// one peer per player, each with its own copy of the game
+		LoopbackTransport transport(options.PlayerCount, options.LatencyTicks, options.LossPercent, seed + 1);
+		vector<unique_ptr<GameSimulation>> simulations;
+		vector<unique_ptr<RollbackSession>> sessions;
+		vector<RandomInputScript> scripts;
+		vector<PlayerInput> pendingInputs;
+		for (uint32_t player = 0; player < options.PlayerCount; ++player)
+		{
+			simulations.push_back(make_unique<GameSimulation>());
+			simulations.back()->Initialize(basicMap, simulationOptions);
+			sessions.push_back(make_unique<RollbackSession>(*simulations.back(), transport, player, options.InputDelay, options.MaxRollback));
+			scripts.push_back(RandomInputScript(GetScriptSeed(seed, player)));
+			pendingInputs.push_back(scripts.back().Next());
+		}
+
+		// play every frame until each peer reached the end, then until each confirmed every input
+		const uint64_t maxFrameCount = static_cast<uint64_t>(options.TicksPerRound + 1) * kMaxFramesPerTick;
+		uint64_t frameCount = 0;
+		bool isPlaying = true;
+		while (isPlaying)
+		{
+			if (++frameCount > maxFrameCount)
+			{
+				throw runtime_error("rollback sessions stalled, inputs are not getting through");
+			}
+
+			transport.Advance();
+			isPlaying = false;
+			for (uint32_t player = 0; player < options.PlayerCount; ++player)
+			{
+				RollbackSession& session = *sessions[player];
+				if (session.CurrentTick() < options.TicksPerRound)
+				{
+					if (session.AdvanceFrame(pendingInputs[player]))
+					{
+						pendingInputs[player] = scripts[player].Next();
+					}
+				}
+				else
+				{
+					session.Poll();
+				}
+
+				const uint32_t confirmedTick = session.ConfirmedTick();
+				isPlaying = isPlaying || confirmedTick == UINT32_MAX || confirmedTick + 1 < options.TicksPerRound;
+			}
+		}
+
+		// the reference plays the same inputs without any network, delayed the same way
+		GameSimulation reference;
+		reference.Initialize(basicMap, simulationOptions);
+		for (uint32_t player = 0; player < options.PlayerCount; ++player)
+		{
+			scripts[player] = RandomInputScript(GetScriptSeed(seed, player));
+		}
+
+		vector<PlayerInput> inputs(options.PlayerCount);
+		for (uint32_t tick = 0; tick < options.TicksPerRound; ++tick)
+		{
+			for (uint32_t player = 0; player < options.PlayerCount; ++player)
+			{
+				inputs[player] = tick < options.InputDelay ? PlayerInput() : scripts[player].Next();
+			}
+			reference.Tick(inputs.data());
+		}
+
+		bool isDesynced = false;
+		bool isMismatched = false;
+		for (uint32_t player = 0; player < options.PlayerCount; ++player)
+		{
+			const RollbackMetrics& metrics = sessions[player]->Metrics();
+			report.FrameCount += metrics.FrameCount;
+			report.StalledFrameCount += metrics.StalledFrameCount;
+			report.RollbackCount += metrics.RollbackCount;
+			report.ResimulatedTickCount += metrics.ResimulatedTickCount;
+			report.ComparedHashCount += metrics.ComparedHashCount;
+			report.MaxRollbackDepth = metrics.MaxRollbackDepth > report.MaxRollbackDepth ? metrics.MaxRollbackDepth : report.MaxRollbackDepth;
+			report.WorstResimulationMilliseconds = max(report.WorstResimulationMilliseconds, metrics.WorstResimulationMilliseconds);
+			report.MillisecondsPerRollback += metrics.ResimulationSeconds * 1000;
+
+			isDesynced = isDesynced || sessions[player]->HasDesynced();
+			isMismatched = isMismatched || simulations[player]->GetStateHash() != reference.GetStateHash();
+		}
+
+		report.DesyncedRoundCount += isDesynced ? 1 : 0;
+		report.MismatchedRoundCount += isMismatched ? 1 : 0;
+		report.MessageCount += transport.SentCount();
+		report.DroppedMessageCount += transport.DroppedCount();
+	}
+
+	/************************************************************************/
+	void RollbackTest::MeasureFullRollback(const Map& basicMap, const RollbackTestOptions& options, RollbackTestReport& report)
+	{
+		GameSimulationOptions simulationOptions;
+		simulationOptions.Seed = options.FirstSeed;
+		simulationOptions.PlayerCount = options.PlayerCount;
+		simulationOptions.EnemyCount = options.EnemyCount;
+
+		GameSimulation simulation;
+		simulation.Initialize(basicMap, simulationOptions);
+
+		vector<RandomInputScript> scripts;
+		for (uint32_t player = 0; player < options.PlayerCount; ++player)
+		{
+			scripts.push_back(RandomInputScript(GetScriptSeed(options.FirstSeed, player)));
+		}
+
+		// every sample restores the snapshot of the previous one and plays a whole window from it, as a frame would
+		vector<uint8_t> snapshot;
+		vector<PlayerInput> inputs(options.PlayerCount);
+		chrono::duration<double_t> total(0);
+		for (uint32_t sample = 0; sample < kFullRollbackSampleCount; ++sample)
+		{
+			SnapshotCodec::GetInstance().Save(simulation, snapshot);
+
+			auto start = chrono::high_resolution_clock::now();
+			SnapshotCodec::GetInstance().Restore(snapshot, simulation);
+			for (uint32_t tick = 0; tick < options.MaxRollback; ++tick)
+			{
+				for (uint32_t player = 0; player < options.PlayerCount; ++player)
+				{
+					inputs[player] = scripts[player].Next();
+				}
+				simulation.Tick(inputs.data());
+			}
+			chrono::duration<double_t> elapsed = chrono::high_resolution_clock::now() - start;
+
+			total += elapsed;
+			report.WorstFullRollbackMilliseconds = max(report.WorstFullRollbackMilliseconds, elapsed.count() * 1000);
+		}
+
+		report.FullRollbackMilliseconds = total.count() * 1000 / kFullRollbackSampleCount;
+	}
+
+	/************************************************************************/
+	uint32_t RollbackTest::GetScriptSeed(uint32_t seed, uint32_t player)
+	{
+		return seed * LevelGenerator::kMaxPlayerCount + player + 1;
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "RollbackSession.h"
+
+namespace DirectXGame
+{
+	/** Structure holding the options of a rollback test run.
+	*/
+	struct RollbackTestOptions
+	{
+		RollbackTestOptions() :
+			FirstSeed(0), RoundCount(10), TicksPerRound(3600), PlayerCount(2), EnemyCount(6), LatencyTicks(4), LossPercent(5),
+			InputDelay(RollbackSession::kDefaultInputDelay), MaxRollback(RollbackSession::kDefaultMaxRollback)
+		{
+		}
+
+		uint32_t FirstSeed;
+		uint32_t RoundCount;
+		uint32_t TicksPerRound;
+		uint32_t PlayerCount;
+		uint32_t EnemyCount;
+		uint32_t LatencyTicks;
+		uint32_t LossPercent;
+		uint32_t InputDelay;
+		uint32_t MaxRollback;
+	};
+
+	/** Structure holding the results of a rollback test run.
+	*/
+	struct RollbackTestReport
+	{
+		uint64_t FrameCount;
+		uint64_t StalledFrameCount;
+		uint64_t RollbackCount;
+		uint64_t ResimulatedTickCount;
+		uint64_t ComparedHashCount;
+		uint64_t MessageCount;
+		uint64_t DroppedMessageCount;
+		uint32_t MaxRollbackDepth;
+		uint32_t DesyncedRoundCount;
+		uint32_t MismatchedRoundCount;
+		std::double_t MeanRollbackDepth;
+		std::double_t MillisecondsPerRollback;
+		std::double_t WorstResimulationMilliseconds;
+		std::double_t FullRollbackMilliseconds;      // restore and resimulation of a whole rollback window, on average
+		std::double_t WorstFullRollbackMilliseconds;
+	};
+
+	/** Singleton that checks rollback sessions converge to the game their inputs describe.
+	 * Every round, one simulation per player is driven by its own rollback session and a scripted bot, over a loopback
+	 * transport adding latency and losing messages. Once all inputs are confirmed, every peer must have the state of a
+	 * reference simulation played straight with the same inputs.
+	 * It also measures the worst case a frame can hit: restoring a snapshot and resimulating the whole rollback window.
+	 *@see RollbackSession
+	*/
+	class RollbackTest final
+	{
+	public:
+
+		RollbackTest(const RollbackTest& rhs) = delete;
+		RollbackTest(const RollbackTest&& rhs) = delete;
+		RollbackTest& operator=(const RollbackTest& rhs) = delete;
+		RollbackTest& operator=(const RollbackTest&& rhs) = delete;
+
+		static RollbackTest& GetInstance();
+
+		RollbackTestReport Run(const RollbackTestOptions& options);
+
+		static const std::double_t kFrameBudgetMilliseconds;
+
+	private:
+
+		RollbackTest() = default;
+		~RollbackTest() = default;
+
+		void RunRound(const Map& basicMap, const RollbackTestOptions& options, uint32_t seed, RollbackTestReport& report);
+		void MeasureFullRollback(const Map& basicMap, const RollbackTestOptions& options, RollbackTestReport& report);
+
+		static uint32_t GetScriptSeed(uint32_t seed, uint32_t player);
+
+		static const uint32_t kFullRollbackSampleCount;
+		static const uint32_t kMaxFramesPerTick;
+	};
+}
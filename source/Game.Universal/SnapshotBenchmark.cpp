@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "SnapshotBenchmark.h"
+#include "RandomInputScript.h"
+#include "LevelGenerator.h"
+#include "MapParser.h"
+#include <chrono>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	SnapshotBenchmark& SnapshotBenchmark::GetInstance()
+	{
+		static SnapshotBenchmark sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	SnapshotBenchmarkReport SnapshotBenchmark::Run(const SnapshotBenchmarkOptions& options)
+	{
+		SnapshotBenchmarkReport report = {};
+		const Map basicMap = MapParser::GetInstance().ParseMapSpriteSheet();
+		const SnapshotCodec& codec = SnapshotCodec::GetInstance();
+
+		uint64_t snapshotBytes = 0;
+		uint64_t deltaBytes = 0;
+		chrono::duration<double_t> saveTime(0);
+		chrono::duration<double_t> restoreTime(0);
+		chrono::duration<double_t> encodeTime(0);
+		chrono::duration<double_t> decodeTime(0);
+
+		vector<uint8_t> previous;
+		vector<uint8_t> snapshot;
+		vector<uint8_t> delta;
+		vector<uint8_t> decoded;
+		vector<PlayerInput> inputs(options.PlayerCount);
+
+		for (uint32_t level = 0; level < options.LevelCount; ++level)
+		{
+			GameSimulationOptions simulationOptions;
+			simulationOptions.Seed = options.FirstSeed + level;
+			simulationOptions.PlayerCount = options.PlayerCount;
+			simulationOptions.EnemyCount = options.EnemyCount;
+
+			GameSimulation simulation;
+			GameSimulation restored;
+			simulation.Initialize(basicMap, simulationOptions);
+
+			vector<RandomInputScript> scripts;
+			for (uint32_t player = 0; player < options.PlayerCount; ++player)
+			{
+				scripts.push_back(RandomInputScript(simulationOptions.Seed * LevelGenerator::kMaxPlayerCount + player + 1));
+			}
+
+			codec.Save(simulation, previous);
+			for (uint32_t tick = 0; tick < options.TicksPerLevel; ++tick)
+			{
+				for (uint32_t player = 0; player < options.PlayerCount; ++player)
+				{
+					inputs[player] = scripts[player].Next();
+				}
+				simulation.Tick(inputs.data());
+
+				auto start = chrono::high_resolution_clock::now();
+				codec.Save(simulation, snapshot);
+				auto saved = chrono::high_resolution_clock::now();
+				codec.EncodeDelta(previous, snapshot, delta);
+				auto encoded = chrono::high_resolution_clock::now();
+				codec.DecodeDelta(previous, delta, decoded);
+				auto decodedTime = chrono::high_resolution_clock::now();
+				codec.Restore(decoded, restored);
+				auto end = chrono::high_resolution_clock::now();
+
+				saveTime += saved - start;
+				encodeTime += encoded - saved;
+				decodeTime += decodedTime - encoded;
+				restoreTime += end - decodedTime;
+
+				if (restored.GetStateHash() != simulation.GetStateHash())
+				{
+					++report.MismatchCount;
+				}
+
+				snapshotBytes += snapshot.size();
+				deltaBytes += delta.size();
+				++report.SnapshotCount;
+				swap(previous, snapshot);
+			}
+		}
+
+		if (report.SnapshotCount > 0)
+		{
+			const double_t count = static_cast<double_t>(report.SnapshotCount);
+			report.BytesPerSnapshot = snapshotBytes / count;
+			report.BytesPerDelta = deltaBytes / count;
+			report.SavesPerSecond = saveTime.count() > 0 ? count / saveTime.count() : 0;
+			report.RestoresPerSecond = restoreTime.count() > 0 ? count / restoreTime.count() : 0;
+			report.DeltaEncodesPerSecond = encodeTime.count() > 0 ? count / encodeTime.count() : 0;
+			report.DeltaDecodesPerSecond = decodeTime.count() > 0 ? count / decodeTime.count() : 0;
+		}
+
+		return report;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "SnapshotCodec.h"
+
+namespace DirectXGame
+{
+	/** Structure holding the options of a snapshot benchmark run.
+	*/
+	struct SnapshotBenchmarkOptions
+	{
+		SnapshotBenchmarkOptions() :
+			FirstSeed(0), LevelCount(10), TicksPerLevel(3600), PlayerCount(2), EnemyCount(6)
+		{
+		}
+
+		uint32_t FirstSeed;
+		uint32_t LevelCount;
+		uint32_t TicksPerLevel;
+		uint32_t PlayerCount;
+		uint32_t EnemyCount;
+	};
+
+	/** Structure holding the numbers of a snapshot benchmark run.
+	*/
+	struct SnapshotBenchmarkReport
+	{
+		uint64_t SnapshotCount;
+		uint64_t MismatchCount;
+		std::double_t BytesPerSnapshot;
+		std::double_t BytesPerDelta;
+		std::double_t SavesPerSecond;
+		std::double_t RestoresPerSecond;
+		std::double_t DeltaEncodesPerSecond;
+		std::double_t DeltaDecodesPerSecond;
+	};
+
+	/** Singleton that measures the snapshot codec on real games.
+	 * Every generated level is played by scripted bots, and every tick the simulation is saved, delta encoded against
+	 * the snapshot of the previous tick, decoded back and restored into a second simulation whose hash must match.
+	 *@see SnapshotCodec
+	*/
+	class SnapshotBenchmark final
+	{
+	public:
+
+		SnapshotBenchmark(const SnapshotBenchmark& rhs) = delete;
+		SnapshotBenchmark(const SnapshotBenchmark&& rhs) = delete;
+		SnapshotBenchmark& operator=(const SnapshotBenchmark& rhs) = delete;
+		SnapshotBenchmark& operator=(const SnapshotBenchmark&& rhs) = delete;
+
+		static SnapshotBenchmark& GetInstance();
+
+		SnapshotBenchmarkReport Run(const SnapshotBenchmarkOptions& options);
+
+	private:
+
+		SnapshotBenchmark() = default;
+		~SnapshotBenchmark() = default;
+	};
+}
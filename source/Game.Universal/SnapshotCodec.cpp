@@ -0,0 +1,177 @@
+#include "pch.h"
+#include "SnapshotCodec.h"
+#include "StateHash.h"
+#include <cstring>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t SnapshotCodec::kSnapshotMagic = 0x50414E53; // "SNAP"
+	const uint32_t SnapshotCodec::kDeltaMagic = 0x544C4544; // "DELT"
+	const uint16_t SnapshotCodec::kVersion = 1;
+
+	/************************************************************************/
+	SnapshotCodec& SnapshotCodec::GetInstance()
+	{
+		static SnapshotCodec sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	void SnapshotCodec::Save(const GameSimulation& simulation, vector<uint8_t>& snapshot) const
+	{
+		snapshot.clear();
+
+		SnapshotWriter writer(snapshot);
+		writer.Write(kSnapshotMagic);
+		writer.Write(kVersion);
+		simulation.Save(writer);
+	}
+
+	/************************************************************************/
+	void SnapshotCodec::Restore(const vector<uint8_t>& snapshot, GameSimulation& simulation) const
+	{
+		SnapshotReader reader(snapshot.data(), snapshot.size());
+
+		uint32_t magic;
+		uint16_t version;
+		reader.Read(magic);
+		reader.Read(version);
+		if (magic != kSnapshotMagic)
+		{
+			throw runtime_error("not a game snapshot");
+		}
+		if (version != kVersion)
+		{
+			throw runtime_error("unsupported snapshot version " + to_string(version));
+		}
+
+		simulation.Restore(reader);
+		if (!reader.IsAtEnd())
+		{
+			throw runtime_error("snapshot has trailing bytes");
+		}
+	}
+
+	/************************************************************************/
+	void SnapshotCodec::EncodeDelta(const vector<uint8_t>& base, const vector<uint8_t>& snapshot, vector<uint8_t>& delta) const
+	{
+		delta.clear();
+
+		SnapshotWriter writer(delta);
+		writer.Write(kDeltaMagic);
+		writer.Write(kVersion);
+		writer.Write(Hash(base));
+		writer.Write(static_cast<uint32_t>(snapshot.size()));
+
+		// pairs of runs: bytes equal to the base, then bytes copied from the snapshot
+		const size_t size = snapshot.size();
+		size_t position = 0;
+		while (position < size)
+		{
+			size_t runStart = position;
+			while (position < size && position < base.size() && snapshot[position] == base[position])
+			{
+				++position;
+			}
+			WriteCount(delta, static_cast<uint32_t>(position - runStart));
+
+			runStart = position;
+			while (position < size && (position >= base.size() || snapshot[position] != base[position]))
+			{
+				++position;
+			}
+			WriteCount(delta, static_cast<uint32_t>(position - runStart));
+			delta.insert(delta.end(), snapshot.begin() + runStart, snapshot.begin() + position);
+		}
+	}
+
+	/************************************************************************/
+	void SnapshotCodec::DecodeDelta(const vector<uint8_t>& base, const vector<uint8_t>& delta, vector<uint8_t>& snapshot) const
+	{
+		SnapshotReader reader(delta.data(), delta.size());
+
+		uint32_t magic;
+		uint16_t version;
+		uint64_t baseHash;
+		uint32_t size;
+		reader.Read(magic);
+		reader.Read(version);
+		reader.Read(baseHash);
+		reader.Read(size);
+		if (magic != kDeltaMagic || version != kVersion)
+		{
+			throw runtime_error("not a snapshot delta of a supported version");
+		}
+		if (baseHash != Hash(base))
+		{
+			throw runtime_error("snapshot delta applied to the wrong base");
+		}
+
+		snapshot.resize(size);
+
+		size_t position = sizeof(magic) + sizeof(version) + sizeof(baseHash) + sizeof(size);
+		size_t output = 0;
+		while (output < size)
+		{
+			uint32_t sameCount = ReadCount(delta, position);
+			if (sameCount > size - output || output + sameCount > base.size())
+			{
+				throw runtime_error("snapshot delta corrupted");
+			}
+			memcpy(snapshot.data() + output, base.data() + output, sameCount);
+			output += sameCount;
+
+			uint32_t newCount = ReadCount(delta, position);
+			if (newCount > size - output || newCount > delta.size() - position)
+			{
+				throw runtime_error("snapshot delta corrupted");
+			}
+			memcpy(snapshot.data() + output, delta.data() + position, newCount);
+			output += newCount;
+			position += newCount;
+		}
+	}
+
+	/************************************************************************/
+	void SnapshotCodec::WriteCount(vector<uint8_t>& bytes, uint32_t count)
+	{
+		// 7 bits per byte, most runs fit in one byte
+		while (count >= 0x80)
+		{
+			bytes.push_back(static_cast<uint8_t>(count | 0x80));
+			count >>= 7;
+		}
+		bytes.push_back(static_cast<uint8_t>(count));
+	}
+
+	/************************************************************************/
+	uint32_t SnapshotCodec::ReadCount(const vector<uint8_t>& bytes, size_t& position)
+	{
+		uint32_t count = 0;
+		for (uint32_t shift = 0; shift < 35; shift += 7)
+		{
+			if (position >= bytes.size())
+			{
+				throw runtime_error("snapshot delta truncated");
+			}
+
+			uint8_t byte = bytes[position++];
+			count |= static_cast<uint32_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return count;
+			}
+		}
+		throw runtime_error("snapshot delta corrupted");
+	}
+
+	/************************************************************************/
+	uint64_t SnapshotCodec::Hash(const vector<uint8_t>& bytes)
+	{
+		StateHash hash;
+		hash.Add(bytes);
+		return hash.Value();
+	}
+}
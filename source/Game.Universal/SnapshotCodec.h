@@ -0,0 +1,44 @@
+#pragma once
+
+#include "GameSimulation.h"
+
+namespace DirectXGame
+{
+	/** Singleton that turns a whole game simulation into a versioned binary snapshot and back.
+	 * A snapshot starts with a magic number and a format version. Only snapshots of the current kVersion are read:
+	 * when the format changes kVersion goes up, and Restore throws on snapshots saved with any other version.
+	 * Deltas encode a snapshot against a previous one as runs of unchanged bytes and runs of new bytes, and carry a hash
+	 * of the snapshot they were made against, so a delta is never applied to the wrong base.
+	 *@see GameSimulation
+	*/
+	class SnapshotCodec final
+	{
+	public:
+
+		SnapshotCodec(const SnapshotCodec& rhs) = delete;
+		SnapshotCodec(const SnapshotCodec&& rhs) = delete;
+		SnapshotCodec& operator=(const SnapshotCodec& rhs) = delete;
+		SnapshotCodec& operator=(const SnapshotCodec&& rhs) = delete;
+
+		static SnapshotCodec& GetInstance();
+
+		void Save(const GameSimulation& simulation, std::vector<uint8_t>& snapshot) const;
+		void Restore(const std::vector<uint8_t>& snapshot, GameSimulation& simulation) const;
+
+		void EncodeDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& snapshot, std::vector<uint8_t>& delta) const;
+		void DecodeDelta(const std::vector<uint8_t>& base, const std::vector<uint8_t>& delta, std::vector<uint8_t>& snapshot) const;
+
+		static const uint32_t kSnapshotMagic;
+		static const uint32_t kDeltaMagic;
+		static const uint16_t kVersion;
+
+	private:
+
+		SnapshotCodec() = default;
+		~SnapshotCodec() = default;
+
+		static void WriteCount(std::vector<uint8_t>& bytes, uint32_t count);
+		static uint32_t ReadCount(const std::vector<uint8_t>& bytes, size_t& position);
+		static uint64_t Hash(const std::vector<uint8_t>& bytes);
+	};
+}
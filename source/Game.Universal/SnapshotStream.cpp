@@ -0,0 +1,45 @@
+#include "pch.h"
+#include "SnapshotStream.h"
+#include <cstring>
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	SnapshotWriter::SnapshotWriter(vector<uint8_t>& bytes) :
+		mBytes(bytes)
+	{
+	}
+
+	/************************************************************************/
+	void SnapshotWriter::Write(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		mBytes.insert(mBytes.end(), bytes, bytes + size);
+	}
+
+	/************************************************************************/
+	SnapshotReader::SnapshotReader(const uint8_t* data, size_t size) :
+		mData(data), mSize(size), mPosition(0)
+	{
+	}
+
+	/************************************************************************/
+	void SnapshotReader::Read(void* data, size_t size)
+	{
+		if (size > mSize - mPosition)
+		{
+			throw runtime_error("snapshot truncated");
+		}
+
+		memcpy(data, mData + mPosition, size);
+		mPosition += size;
+	}
+
+	/************************************************************************/
+	bool SnapshotReader::IsAtEnd() const
+	{
+		return mPosition == mSize;
+	}
+}
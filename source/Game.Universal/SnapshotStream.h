@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Class appending plain values to a binary snapshot.
+	 * Values are written with their in memory bytes, snapshots are only read back by the same platform.
+	 * Structures with padding must be written field by field, so that equal states give equal bytes.
+	 *@see SnapshotReader
+	*/
+	class SnapshotWriter final
+	{
+	public:
+
+		explicit SnapshotWriter(std::vector<uint8_t>& bytes);
+
+		void Write(const void* data, size_t size);
+
+		template <typename T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written through their bytes");
+			Write(&value, sizeof(T));
+		}
+
+		template <typename T>
+		void Write(const std::vector<T>& values)
+		{
+			Write(static_cast<uint32_t>(values.size()));
+			if (!values.empty())
+			{
+				Write(values.data(), values.size() * sizeof(T));
+			}
+		}
+
+	private:
+
+		std::vector<uint8_t>& mBytes;
+	};
+
+	/** Class reading back the values written by a SnapshotWriter, in the same order.
+	 * Reading past the end of the snapshot throws, a truncated snapshot never restores a partial state silently.
+	 *@see SnapshotWriter
+	*/
+	class SnapshotReader final
+	{
+	public:
+
+		SnapshotReader(const uint8_t* data, size_t size);
+
+		void Read(void* data, size_t size);
+		bool IsAtEnd() const;
+
+		template <typename T>
+		void Read(T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read through their bytes");
+			Read(&value, sizeof(T));
+		}
+
+		template <typename T>
+		void Read(std::vector<T>& values)
+		{
+			uint32_t size;
+			Read(size);
+			if (size > (mSize - mPosition) / sizeof(T))
+			{
+				throw std::runtime_error("snapshot truncated");
+			}
+
+			values.resize(size);
+			if (size > 0)
+			{
+				Read(values.data(), size * sizeof(T));
+			}
+		}
+
+	private:
+
+		const uint8_t* mData;
+		size_t mSize;
+		size_t mPosition;
+	};
+}
@@ -0,0 +1,220 @@
+#include "pch.h"
+#include "SpritePipeline.h"
+#include "Profiler.h"
+
+using namespace std;
+using namespace DX;
+using namespace DirectX;
+using namespace Microsoft::WRL;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	SpritePipeline& SpritePipeline::GetInstance()
+	{
+		static SpritePipeline sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	SpritePipeline::SpritePipeline() :
+		mIndexCount(0)
+	{
+	}
+
+	/************************************************************************/
+	void SpritePipeline::CreateDeviceDependentResources(ID3D11Device* device)
+	{
+		ProfileScope scope("SpritePipeline::CreateDeviceDependentResources");
+
+		mDevice = device;
+
+		auto loadVSTask = ReadDataAsync(L"SpriteRendererVS.cso");
+		auto loadPSTask = ReadDataAsync(L"SpriteRendererPS.cso");
+
+		mLoadingTask = (loadVSTask && loadPSTask).then([this](const std::vector<std::vector<byte>>& fileData)
+		{
+			CreateShaders(fileData[0], fileData[1]);
+			CreateStates();
+			CreateQuad();
+		});
+	}
+
+	/************************************************************************/
+	void SpritePipeline::ReleaseDeviceDependentResources()
+	{
+		mVertexShader.Reset();
+		mPixelShader.Reset();
+		mInputLayout.Reset();
+		mVertexBuffer.Reset();
+		mIndexBuffer.Reset();
+		mConstantBuffer.Reset();
+		mTextureSampler.Reset();
+		mAlphaBlending.Reset();
+
+		lock_guard<mutex> lock(mTexturesMutex);
+		mTextures.clear();
+		mDevice.Reset();
+	}
+
+	/************************************************************************/
+	Concurrency::task<void> SpritePipeline::WhenLoaded() const
+	{
+		return mLoadingTask;
+	}
+
+	/************************************************************************/
+	ID3D11VertexShader* SpritePipeline::VertexShader() const
+	{
+		return mVertexShader.Get();
+	}
+
+	/************************************************************************/
+	ID3D11PixelShader* SpritePipeline::PixelShader() const
+	{
+		return mPixelShader.Get();
+	}
+
+	/************************************************************************/
+	ID3D11InputLayout* SpritePipeline::InputLayout() const
+	{
+		return mInputLayout.Get();
+	}
+
+	/************************************************************************/
+	ID3D11Buffer* SpritePipeline::VertexBuffer() const
+	{
+		return mVertexBuffer.Get();
+	}
+
+	/************************************************************************/
+	ID3D11Buffer* SpritePipeline::IndexBuffer() const
+	{
+		return mIndexBuffer.Get();
+	}
+
+	/************************************************************************/
+	uint32_t SpritePipeline::IndexCount() const
+	{
+		return mIndexCount;
+	}
+
+	/************************************************************************/
+	ID3D11Buffer* SpritePipeline::ConstantBuffer() const
+	{
+		return mConstantBuffer.Get();
+	}
+
+	/************************************************************************/
+	ID3D11SamplerState* SpritePipeline::TextureSampler() const
+	{
+		return mTextureSampler.Get();
+	}
+
+	/************************************************************************/
+	ID3D11BlendState* SpritePipeline::AlphaBlending() const
+	{
+		return mAlphaBlending.Get();
+	}
+
+	/************************************************************************/
+	ComPtr<ID3D11ShaderResourceView> SpritePipeline::GetTexture(const wstring& path)
+	{
+		// renderables load their textures from the loading tasks, possibly at the same time
+		lock_guard<mutex> lock(mTexturesMutex);
+
+		ComPtr<ID3D11ShaderResourceView>& texture = mTextures[path];
+		if (texture == nullptr)
+		{
+			ProfileScope textureScope("SpritePipeline::LoadTexture");
+			ThrowIfFailed(CreateWICTextureFromFile(mDevice.Get(), path.c_str(), nullptr, texture.ReleaseAndGetAddressOf()));
+		}
+		return texture;
+	}
+
+	/************************************************************************/
+	void SpritePipeline::CreateShaders(const vector<byte>& vertexShaderData, const vector<byte>& pixelShaderData)
+	{
+		ThrowIfFailed(mDevice->CreateVertexShader(&vertexShaderData[0], vertexShaderData.size(), nullptr, mVertexShader.ReleaseAndGetAddressOf()));
+		ThrowIfFailed(
+			mDevice->CreateInputLayout(
+				VertexPositionTexture::InputElements,
+				VertexPositionTexture::InputElementCount,
+				&vertexShaderData[0],
+				vertexShaderData.size(),
+				mInputLayout.ReleaseAndGetAddressOf()
+			)
+		);
+
+		ThrowIfFailed(mDevice->CreatePixelShader(&pixelShaderData[0], pixelShaderData.size(), nullptr, mPixelShader.ReleaseAndGetAddressOf()));
+
+		CD3D11_BUFFER_DESC constantBufferDesc(sizeof(VSCBufferPerObject), D3D11_BIND_CONSTANT_BUFFER);
+		ThrowIfFailed(mDevice->CreateBuffer(&constantBufferDesc, nullptr, mConstantBuffer.ReleaseAndGetAddressOf()));
+	}
+
+	/************************************************************************/
+	void SpritePipeline::CreateStates()
+	{
+		D3D11_SAMPLER_DESC samplerStateDesc;
+		ZeroMemory(&samplerStateDesc, sizeof(samplerStateDesc));
+		samplerStateDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+		samplerStateDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+		samplerStateDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+		samplerStateDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+		samplerStateDesc.MinLOD = -FLT_MAX;
+		samplerStateDesc.MaxLOD = FLT_MAX;
+		samplerStateDesc.MipLODBias = 0.0f;
+		samplerStateDesc.MaxAnisotropy = 1;
+		samplerStateDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+		ThrowIfFailed(mDevice->CreateSamplerState(&samplerStateDesc, mTextureSampler.ReleaseAndGetAddressOf()));
+
+		D3D11_BLEND_DESC blendStateDesc = { 0 };
+		blendStateDesc.RenderTarget[0].BlendEnable = true;
+		blendStateDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+		blendStateDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+		blendStateDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+		blendStateDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ZERO;
+		blendStateDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+		blendStateDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+		blendStateDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+		ThrowIfFailed(mDevice->CreateBlendState(&blendStateDesc, mAlphaBlending.ReleaseAndGetAddressOf()));
+	}
+
+	/************************************************************************/
+	void SpritePipeline::CreateQuad()
+	{
+		VertexPositionTexture vertices[] =
+		{
+			VertexPositionTexture(XMFLOAT4(-1.0f, -1.0f, 0.0f, 1.0f), XMFLOAT2(0.0f, 1.0f)),
+			VertexPositionTexture(XMFLOAT4(-1.0f, 1.0f, 0.0f, 1.0f), XMFLOAT2(0.0f, 0.0f)),
+			VertexPositionTexture(XMFLOAT4(1.0f, 1.0f, 0.0f, 1.0f), XMFLOAT2(1.0f, 0.0f)),
+			VertexPositionTexture(XMFLOAT4(1.0f, -1.0f, 0.0f, 1.0f), XMFLOAT2(1.0f, 1.0f)),
+		};
+
+		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
+		vertexBufferDesc.ByteWidth = sizeof(VertexPositionTexture) * ARRAYSIZE(vertices);
+		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA vertexSubResourceData = { 0 };
+		vertexSubResourceData.pSysMem = vertices;
+		ThrowIfFailed(mDevice->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, mVertexBuffer.ReleaseAndGetAddressOf()));
+
+		const uint32_t indices[] =
+		{
+			0, 1, 2,
+			0, 2, 3
+		};
+
+		mIndexCount = ARRAYSIZE(indices);
+
+		D3D11_BUFFER_DESC indexBufferDesc = { 0 };
+		indexBufferDesc.ByteWidth = sizeof(uint32_t) * mIndexCount;
+		indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA indexSubResourceData = { 0 };
+		indexSubResourceData.pSysMem = indices;
+		ThrowIfFailed(mDevice->CreateBuffer(&indexBufferDesc, &indexSubResourceData, mIndexBuffer.ReleaseAndGetAddressOf()));
+	}
+}
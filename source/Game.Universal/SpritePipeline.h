@@ -0,0 +1,84 @@
+#pragma once
+
+#include <mutex>
+
+namespace DirectXGame
+{
+	/** Structure representing the constants of one sprite draw, as SpriteRendererVS reads them.
+	*/
+	struct VSCBufferPerObject
+	{
+		DirectX::XMFLOAT4X4 WorldViewProjection;
+		DirectX::XMFLOAT4 UVRect;
+
+		VSCBufferPerObject() :
+			WorldViewProjection(DX::MatrixHelper::Identity), UVRect(0, 0, 1, 1)
+		{
+		};
+
+		VSCBufferPerObject(const DirectX::XMFLOAT4X4& wvp, const DirectX::XMFLOAT4& uvRect) :
+			WorldViewProjection(wvp), UVRect(uvRect)
+		{
+		}
+	};
+
+	/** Singleton owning the GPU objects every renderable draws its sprites with, created once per device.
+	 * The shaders, input layout, quad buffers, sampler and blend state are the same for the players, the bombs, the
+	 * enemies and the map, and every sprite sheet texture is loaded once per path. Renderables keep COM pointers to
+	 * them, which are the reference counted handles: a bomb placed or exploding only adds or drops references, and
+	 * everything drawn with the same objects lets RenderStateCache skip the binds. GameMain creates the pipeline
+	 * before the components and releases it when the device is lost, OnDeviceRestored creates it again.
+	 *@see Renderable
+	*/
+	class SpritePipeline final
+	{
+	public:
+
+		SpritePipeline(const SpritePipeline& rhs) = delete;
+		SpritePipeline(const SpritePipeline&& rhs) = delete;
+		SpritePipeline& operator=(const SpritePipeline& rhs) = delete;
+		SpritePipeline& operator=(const SpritePipeline&& rhs) = delete;
+
+		static SpritePipeline& GetInstance();
+
+		void CreateDeviceDependentResources(ID3D11Device* device);
+		void ReleaseDeviceDependentResources();
+
+		Concurrency::task<void> WhenLoaded() const;
+
+		ID3D11VertexShader* VertexShader() const;
+		ID3D11PixelShader* PixelShader() const;
+		ID3D11InputLayout* InputLayout() const;
+		ID3D11Buffer* VertexBuffer() const;
+		ID3D11Buffer* IndexBuffer() const;
+		uint32_t IndexCount() const;
+		ID3D11Buffer* ConstantBuffer() const;
+		ID3D11SamplerState* TextureSampler() const;
+		ID3D11BlendState* AlphaBlending() const;
+
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> GetTexture(const std::wstring& path);
+
+	private:
+
+		SpritePipeline();
+		~SpritePipeline() = default;
+
+		void CreateShaders(const std::vector<byte>& vertexShaderData, const std::vector<byte>& pixelShaderData);
+		void CreateStates();
+		void CreateQuad();
+
+		Microsoft::WRL::ComPtr<ID3D11Device> mDevice;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader> mVertexShader;
+		Microsoft::WRL::ComPtr<ID3D11PixelShader> mPixelShader;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> mInputLayout;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mIndexBuffer;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mConstantBuffer; // for devices without constant buffer offsets
+		Microsoft::WRL::ComPtr<ID3D11SamplerState> mTextureSampler;
+		Microsoft::WRL::ComPtr<ID3D11BlendState> mAlphaBlending;
+		std::map<std::wstring, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>> mTextures;
+		std::mutex mTexturesMutex;
+		Concurrency::task<void> mLoadingTask;
+		uint32_t mIndexCount;
+	};
+}
@@ -1,11 +1,13 @@
 #include "pch.h"
 #include "SpriteSheetParser.h"
 #include "RenderingDataStructures.h"
+#include "Profiler.h"
 #include <document.h>
 #include <istreamwrapper.h>
 
 using namespace std;
 using namespace rapidjson;
+using namespace DirectX;
 
 namespace DirectXGame
 {
@@ -19,6 +21,8 @@ namespace DirectXGame
 	/************************************************************************/
 	SpriteSheet SpriteSheetParser::ParseSpriteSheet(const string& filePath)
 	{
+		ProfileScope scope("SpriteSheetParser::ParseSpriteSheet");
+
 		SpriteSheet spriteSheet;
 		float_t sortingLayer = -20.0f;
 
@@ -39,14 +43,15 @@ namespace DirectXGame
 
 		spriteSheet.Sprites.resize(frames.Size());
 
-		// note if sprite sheets with multiple rows are gonna be added, change this
-		spriteSheet.TextureXUnit = 1.0f / spriteSheet.Sprites.size();
-		spriteSheet.TextureYUnit = 1.0f;
+		// the texture may be the sheet image or the atlas, the sprite rectangles are relative to it
+		const Value& textureSize = jsonDoc["meta"]["size"];
+		spriteSheet.TextureXUnit = 1.0f / textureSize["w"].GetUint();
+		spriteSheet.TextureYUnit = 1.0f / textureSize["h"].GetUint();
 
 		// store sprites
 		for (uint32_t i = 0; i < spriteSheet.Sprites.size(); ++i) 
 		{
-			spriteSheet.Sprites[i] = PopulateASprite(frames, i, sortingLayer);
+			spriteSheet.Sprites[i] = PopulateASprite(frames, i, sortingLayer, spriteSheet.TextureXUnit, spriteSheet.TextureYUnit);
 		}
 
 		// store animations
@@ -65,19 +70,16 @@ namespace DirectXGame
 	}
 
 	/************************************************************************/
-	shared_ptr<Sprite> SpriteSheetParser::PopulateASprite(const Value& frames, uint32_t index, float_t sortingLayer)
+	shared_ptr<Sprite> SpriteSheetParser::PopulateASprite(const Value& frames, uint32_t index, float_t sortingLayer, float_t textureXUnit, float_t textureYUnit)
 	{
 		shared_ptr<Sprite> newSprite = make_shared<Sprite>();
 
 		newSprite->Width = frames[index]["frame"]["w"].GetUint();
 		newSprite->Height = frames[index]["frame"]["h"].GetUint();
 		newSprite->X = frames[index]["frame"]["x"].GetUint();
-		//newSprite->Y = frames[index]["frame"]["y"].GetUint();
-		newSprite->X = newSprite->X / newSprite->Width;
-		newSprite->Y = 0; //(newSprite->Y + newSprite->Height) / newSprite->Height;
+		newSprite->Y = frames[index]["frame"]["y"].GetUint();
 
-		newSprite->UVScalingFactor.x = 1.0f / frames.Size();
-		newSprite->UVScalingFactor.y = 1.0f;
+		newSprite->UVRect = XMFLOAT4(newSprite->X * textureXUnit, newSprite->Y * textureYUnit, newSprite->Width * textureXUnit, newSprite->Height * textureYUnit);
 		if (sortingLayer < -10)
 		{
 			newSprite->SortingLayer = frames[index]["sortingLayer"].GetFloat();
@@ -25,7 +25,7 @@ namespace DirectXGame
 		SpriteSheetParser() = default;
 		~SpriteSheetParser() = default;
 
-		std::shared_ptr<Sprite> PopulateASprite(const rapidjson::Value& frames, uint32_t index, float_t sortingLayer);
+		std::shared_ptr<Sprite> PopulateASprite(const rapidjson::Value& frames, uint32_t index, float_t sortingLayer, float_t textureXUnit, float_t textureYUnit);
 		std::shared_ptr<Animation> PopulateAnAnimation(const SpriteSheet& spriteSheet, const rapidjson::Value& animations, uint32_t index);
 	};
 }
\ No newline at end of file
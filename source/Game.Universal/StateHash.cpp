@@ -0,0 +1,31 @@
+#include "pch.h"
+#include "StateHash.h"
+
+namespace DirectXGame
+{
+	const uint64_t StateHash::kOffsetBasis = 14695981039346656037ULL;
+	const uint64_t StateHash::kPrime = 1099511628211ULL;
+
+	/************************************************************************/
+	StateHash::StateHash() :
+		mValue(kOffsetBasis)
+	{
+	}
+
+	/************************************************************************/
+	void StateHash::Add(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			mValue ^= bytes[i];
+			mValue *= kPrime;
+		}
+	}
+
+	/************************************************************************/
+	uint64_t StateHash::Value() const
+	{
+		return mValue;
+	}
+}
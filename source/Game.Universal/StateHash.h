@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace DirectXGame
+{
+	/** Class computing a 64 bits FNV-1a hash of a simulation state.
+	 * Values are hashed through their bytes, floats included, so two states only hash the same when they are bit identical.
+	*/
+	class StateHash final
+	{
+	public:
+
+		StateHash();
+
+		void Add(const void* data, size_t size);
+
+		template <typename T>
+		void Add(const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "only plain values can be hashed through their bytes");
+			Add(&value, sizeof(T));
+		}
+
+		template <typename T, typename Allocator>
+		void Add(const std::vector<T, Allocator>& values)
+		{
+			Add(static_cast<uint32_t>(values.size()));
+			if (!values.empty())
+			{
+				Add(values.data(), values.size() * sizeof(T));
+			}
+		}
+
+		uint64_t Value() const;
+
+	private:
+
+		uint64_t mValue;
+
+		static const uint64_t kOffsetBasis;
+		static const uint64_t kPrime;
+	};
+}
@@ -0,0 +1,253 @@
+#include "pch.h"
+#include "TileGrid.h"
+#include "MapLayout.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	// the two triangles of SpritePipeline::CreateQuad, unindexed
+	const XMFLOAT2 TileGrid::kCorners[kVerticesPerTile] =
+	{
+		XMFLOAT2(-1.0f, -1.0f), XMFLOAT2(-1.0f, 1.0f), XMFLOAT2(1.0f, 1.0f),
+		XMFLOAT2(-1.0f, -1.0f), XMFLOAT2(1.0f, 1.0f), XMFLOAT2(1.0f, -1.0f)
+	};
+	const XMFLOAT2 TileGrid::kTextureCoordinates[kVerticesPerTile] =
+	{
+		XMFLOAT2(0.0f, 1.0f), XMFLOAT2(0.0f, 0.0f), XMFLOAT2(1.0f, 0.0f),
+		XMFLOAT2(0.0f, 1.0f), XMFLOAT2(1.0f, 0.0f), XMFLOAT2(1.0f, 1.0f)
+	};
+	const uint8_t TileGrid::kHiddenBackgroundCell = 5; // todo fix the gray background problem
+
+	/************************************************************************/
+	TileGrid::TileGrid() :
+		mChunksGeneration(0), mIsPerkConsumed(false)
+	{
+		SetLayout(MapLayout());
+		mConstants.GridSize = XMUINT2(0, 0);
+		mConstants.VisibleTiles = { XMUINT2(0, 0), XMUINT2(0, 0) };
+	}
+
+	/************************************************************************/
+	void TileGrid::Update(const Map& map, bool isPerkConsumed)
+	{
+		SetLayout(MapLayout(map));
+
+		// a new size means new buffers, every cell goes up
+		const bool resized = map.MapWidth != mConstants.GridSize.x || map.MapHeight != mConstants.GridSize.y;
+		if (resized)
+		{
+			mConstants.GridSize = XMUINT2(map.MapWidth, map.MapHeight);
+			mConstants.VisibleTiles = { XMUINT2(0, 0), mConstants.GridSize };
+			mCells.assign(static_cast<uint32_t>(TileGridLayer::Count) * map.MapWidth * map.MapHeight, 0);
+			mChangedCells.clear();
+		}
+
+		// a map without chunks is compared whole every time
+		const MapChunks& chunks = map.Chunks;
+		if (chunks.Generation() == 0)
+		{
+			UpdateTiles(map, isPerkConsumed, XMUINT2(0, 0), XMUINT2(map.MapWidth, map.MapHeight), resized);
+			mChunksGeneration = 0;
+			return;
+		}
+
+		// a new generation is a new map, otherwise only the chunks changed since the last update are compared
+		const bool isNewMap = resized || chunks.Generation() != mChunksGeneration;
+		if (isNewMap)
+		{
+			mChunksGeneration = chunks.Generation();
+			mChunkVersions.assign(chunks.ChunkCount(), 0);
+		}
+
+		const uint32_t perkChunk = isPerkConsumed != mIsPerkConsumed ? chunks.GetChunkIndex(map.PerkTile.Tile) : chunks.ChunkCount();
+		mIsPerkConsumed = isPerkConsumed;
+
+		for (uint32_t chunk = 0; chunk < chunks.ChunkCount(); ++chunk)
+		{
+			if (!isNewMap && chunk != perkChunk && chunks.ChunkVersion(chunk) == mChunkVersions[chunk])
+			{
+				continue;
+			}
+
+			mChunkVersions[chunk] = chunks.ChunkVersion(chunk);
+			const XMUINT2 first((chunk % chunks.ChunkCounts().x) * MapChunks::kChunkSize, (chunk / chunks.ChunkCounts().x) * MapChunks::kChunkSize);
+			const XMUINT2 last(first.x + MapChunks::kChunkSize < map.MapWidth ? first.x + MapChunks::kChunkSize : map.MapWidth,
+							   first.y + MapChunks::kChunkSize < map.MapHeight ? first.y + MapChunks::kChunkSize : map.MapHeight);
+			UpdateTiles(map, isPerkConsumed, first, last, resized);
+		}
+	}
+
+	/************************************************************************/
+	const vector<uint8_t>& TileGrid::Cells() const
+	{
+		return mCells;
+	}
+
+	/************************************************************************/
+	const vector<uint32_t>& TileGrid::ChangedCells() const
+	{
+		return mChangedCells;
+	}
+
+	/************************************************************************/
+	void TileGrid::ClearChangedCells()
+	{
+		mChangedCells.clear();
+	}
+
+	/************************************************************************/
+	const TileGridConstants& TileGrid::Constants() const
+	{
+		return mConstants;
+	}
+
+	/************************************************************************/
+	uint32_t TileGrid::CellCount() const
+	{
+		return static_cast<uint32_t>(mCells.size());
+	}
+
+	/************************************************************************/
+	void TileGrid::SetVisibleTiles(const TileRange& visibleTiles)
+	{
+		mConstants.VisibleTiles = visibleTiles;
+	}
+
+	/************************************************************************/
+	uint32_t TileGrid::InstanceCount() const
+	{
+		return static_cast<uint32_t>(TileGridLayer::Count) * mConstants.VisibleTiles.Size.x * mConstants.VisibleTiles.Size.y;
+	}
+
+	/************************************************************************/
+	TileVertex TileGrid::GetVertex(uint32_t vertexId, uint32_t instanceId, const vector<XMFLOAT4>& spriteRects) const
+	{
+		// keep in sync with Content/Shaders/TileGridVS.hlsl
+		TileVertex vertex = { XMFLOAT2(0.0f, 0.0f), XMFLOAT2(0.0f, 0.0f) };
+
+		const uint32_t cellIndex = GetCellIndex(instanceId);
+		const uint8_t cell = mCells[cellIndex];
+		if (cell == 0)
+		{
+			return vertex;
+		}
+
+		const uint32_t tileInLayer = cellIndex % (mConstants.GridSize.x * mConstants.GridSize.y);
+		const XMFLOAT2 tile(static_cast<float_t>(tileInLayer % mConstants.GridSize.x), static_cast<float_t>(tileInLayer / mConstants.GridSize.x));
+		const XMFLOAT2& corner = kCorners[vertexId];
+		const XMFLOAT2& textureCoordinates = kTextureCoordinates[vertexId];
+		const XMFLOAT4& spriteRect = spriteRects[cell - 1];
+
+		vertex.Position.x = mConstants.Origin.x + tile.x * mConstants.TileStep.x + corner.x * mConstants.TileExtent.x;
+		vertex.Position.y = mConstants.Origin.y + tile.y * mConstants.TileStep.y + corner.y * mConstants.TileExtent.y;
+		vertex.TextureCoordinates.x = spriteRect.x + textureCoordinates.x * spriteRect.z;
+		vertex.TextureCoordinates.y = spriteRect.y + textureCoordinates.y * spriteRect.w;
+
+		return vertex;
+	}
+
+	/************************************************************************/
+	void TileGrid::GenerateVertices(const vector<XMFLOAT4>& spriteRects, vector<TileVertex>& vertices) const
+	{
+		// the shader also runs for empty cells, their triangles collapse to a point and draw nothing
+		const uint32_t instanceCount = InstanceCount();
+		for (uint32_t instanceId = 0; instanceId < instanceCount; ++instanceId)
+		{
+			if (mCells[GetCellIndex(instanceId)] == 0)
+			{
+				continue;
+			}
+
+			for (uint32_t vertexId = 0; vertexId < kVerticesPerTile; ++vertexId)
+			{
+				vertices.push_back(GetVertex(vertexId, instanceId, spriteRects));
+			}
+		}
+	}
+
+	/************************************************************************/
+	vector<XMFLOAT4> TileGrid::GetSpriteRects(const SpriteSheet& spriteSheet)
+	{
+		vector<XMFLOAT4> spriteRects;
+		spriteRects.reserve(spriteSheet.Sprites.size());
+		for (auto& sprite : spriteSheet.Sprites)
+		{
+			spriteRects.push_back(sprite->UVRect);
+		}
+		return spriteRects;
+	}
+
+	/************************************************************************/
+	void TileGrid::UpdateTiles(const Map& map, bool isPerkConsumed, const XMUINT2& first, const XMUINT2& last, bool resized)
+	{
+		for (uint32_t layer = 0; layer < static_cast<uint32_t>(TileGridLayer::Count); ++layer)
+		{
+			for (uint32_t y = first.y; y < last.y; ++y)
+			{
+				uint32_t cell = (layer * map.MapHeight + y) * map.MapWidth + first.x;
+				for (uint32_t x = first.x; x < last.x; ++x, ++cell)
+				{
+					const uint8_t value = GetCell(map, isPerkConsumed, static_cast<TileGridLayer>(layer), x, y);
+					if (resized || mCells[cell] != value)
+					{
+						mCells[cell] = value;
+						mChangedCells.push_back(cell);
+					}
+				}
+			}
+		}
+	}
+
+	/************************************************************************/
+	void TileGrid::SetLayout(const MapLayout& mapLayout)
+	{
+		mConstants.Origin = mapLayout.GetPositionFromTile(XMUINT2(0, 0));
+		mConstants.TileStep = mapLayout.TileStep();
+		mConstants.TileExtent = mapLayout.TileExtent();
+	}
+
+	/************************************************************************/
+	uint32_t TileGrid::GetCellIndex(uint32_t instanceId) const
+	{
+		// instances go over the visible tiles of each layer
+		const TileRange& visibleTiles = mConstants.VisibleTiles;
+		const uint32_t layer = instanceId / (visibleTiles.Size.x * visibleTiles.Size.y);
+		const uint32_t tileInRange = instanceId % (visibleTiles.Size.x * visibleTiles.Size.y);
+		const uint32_t x = visibleTiles.First.x + tileInRange % visibleTiles.Size.x;
+		const uint32_t y = visibleTiles.First.y + tileInRange / visibleTiles.Size.x;
+
+		return (layer * mConstants.GridSize.y + y) * mConstants.GridSize.x + x;
+	}
+
+	/************************************************************************/
+	uint8_t TileGrid::GetCell(const Map& map, bool isPerkConsumed, TileGridLayer layer, uint32_t x, uint32_t y)
+	{
+		switch (layer)
+		{
+			case TileGridLayer::Background:
+			{
+				const uint8_t background = map.BackgroundLayer[x][y];
+				return background == kHiddenBackgroundCell ? static_cast<uint8_t>(0) : background;
+			}
+
+			case TileGridLayer::Items:
+				if (!isPerkConsumed && map.PerkTile.Tile.x == x && map.PerkTile.Tile.y == y)
+				{
+					return static_cast<uint8_t>(map.PerkTile.SpriteIndex + 1);
+				}
+				if (map.DoorTile.Tile.x == x && map.DoorTile.Tile.y == y)
+				{
+					return static_cast<uint8_t>(map.DoorTile.SpriteIndex + 1);
+				}
+				return 0;
+
+			case TileGridLayer::Blocks:
+				return map.BlocksLayer[x][y];
+
+			default:
+				return 0;
+		}
+	}
+}
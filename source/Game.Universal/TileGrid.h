@@ -0,0 +1,100 @@
+#pragma once
+
+#include "RenderingDataStructures.h"
+
+namespace DirectXGame
+{
+	class MapLayout;
+
+	/** Enumeration representing the layers of the tile grid, in drawing order.
+	*/
+	enum class TileGridLayer : uint32_t
+	{
+		Background,
+		Items,      // the perk and the door, under the blocks that hide them
+		Blocks,
+		Count
+	};
+
+	/** Structure representing a rectangle of tiles, the same in every layer.
+	*@see ViewCulling
+	*/
+	struct TileRange
+	{
+		DirectX::XMUINT2 First;
+		DirectX::XMUINT2 Size; // no tile when either is 0
+	};
+
+	/** Structure holding what the tile grid vertex shader needs to place the tiles, besides the camera.
+	 * Its layout matches the end of the constant buffer of TileGridVS.
+	*/
+	struct TileGridConstants
+	{
+		DirectX::XMFLOAT2 Origin;     // center of the tile (0, 0)
+		DirectX::XMFLOAT2 TileStep;   // distance between the centers of neighboring tiles
+		DirectX::XMFLOAT2 TileExtent; // half size of a tile quad
+		DirectX::XMUINT2 GridSize;    // tiles per row, rows per layer
+		TileRange VisibleTiles;       // the tiles drawn, one instance each per layer
+	};
+
+	/** Structure representing a vertex of a tile quad, in world space.
+	*/
+	struct TileVertex
+	{
+		DirectX::XMFLOAT2 Position;
+		DirectX::XMFLOAT2 TextureCoordinates;
+	};
+
+	/** Class holding the map layers as one byte per tile, the way TileGridVS reads them.
+	 * Each tile stores the index of its sprite in the props sprite sheet plus one, zero meaning nothing is drawn, so
+	 * the whole map is one instanced draw of kVerticesPerTile vertices per visible tile and layer. Update compares
+	 * the map with the cells and records the cells that changed, only those are uploaded again; the cells of a chunk
+	 * of the map are its render cache, they are only compared again once MapChunks says the chunk changed.
+	 * GetVertex is the vertex shader on the CPU, so the geometry can be checked without a graphics device.
+	 *@see MapRenderable
+	 *@see TileGridValidator
+	*/
+	class TileGrid final
+	{
+	public:
+
+		TileGrid();
+
+		void Update(const Map& map, bool isPerkConsumed);
+
+		const std::vector<uint8_t>& Cells() const;
+		const std::vector<uint32_t>& ChangedCells() const;
+		void ClearChangedCells();
+
+		const TileGridConstants& Constants() const;
+		uint32_t CellCount() const;
+
+		void SetVisibleTiles(const TileRange& visibleTiles);
+		uint32_t InstanceCount() const;
+
+		TileVertex GetVertex(uint32_t vertexId, uint32_t instanceId, const std::vector<DirectX::XMFLOAT4>& spriteRects) const;
+		void GenerateVertices(const std::vector<DirectX::XMFLOAT4>& spriteRects, std::vector<TileVertex>& vertices) const;
+
+		static std::vector<DirectX::XMFLOAT4> GetSpriteRects(const SpriteSheet& spriteSheet);
+
+		static const uint32_t kVerticesPerTile = 6;
+
+	private:
+
+		void UpdateTiles(const Map& map, bool isPerkConsumed, const DirectX::XMUINT2& first, const DirectX::XMUINT2& last, bool resized);
+		void SetLayout(const MapLayout& mapLayout);
+		uint32_t GetCellIndex(uint32_t instanceId) const;
+		static uint8_t GetCell(const Map& map, bool isPerkConsumed, TileGridLayer layer, uint32_t x, uint32_t y);
+
+		static const DirectX::XMFLOAT2 kCorners[kVerticesPerTile];
+		static const DirectX::XMFLOAT2 kTextureCoordinates[kVerticesPerTile];
+		static const uint8_t kHiddenBackgroundCell;
+
+		TileGridConstants mConstants;
+		std::vector<uint8_t> mCells;         // layer after layer, row after row
+		std::vector<uint32_t> mChangedCells;
+		uint64_t mChunksGeneration;          // of the map chunks last compared, 0 for none
+		std::vector<uint32_t> mChunkVersions; // the version of each chunk when it was last compared
+		bool mIsPerkConsumed;
+	};
+}
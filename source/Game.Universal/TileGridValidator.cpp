@@ -0,0 +1,228 @@
+#include "pch.h"
+#include "TileGridValidator.h"
+#include "LevelGenerator.h"
+#include "SpriteSheetParser.h"
+#include "Renderable.h"
+#include "ViewCulling.h"
+
+using namespace std;
+using namespace DirectX;
+using namespace DX;
+
+namespace DirectXGame
+{
+	const string TileGridValidator::kSpriteSheetJSONPath = "Assets/JSONS/Atlas/Props.json"; // the sprite sheet of MapRenderable
+	const uint32_t TileGridValidator::kDestroyedBlocksPerLevel = 24;
+	const float_t TileGridValidator::kTolerance = 1e-4f;
+	const uint32_t TileGridValidator::kLargeMapSize = 128; // 16384 tiles per layer
+	const uint32_t TileGridValidator::kCulledViewsPerLevel = 8;
+
+	// the sprite quad of SpritePipeline::CreateQuad
+	const XMFLOAT2 TileGridValidator::kQuadCorners[4] = { XMFLOAT2(-1.0f, -1.0f), XMFLOAT2(-1.0f, 1.0f), XMFLOAT2(1.0f, 1.0f), XMFLOAT2(1.0f, -1.0f) };
+	const XMFLOAT2 TileGridValidator::kQuadTextureCoordinates[4] = { XMFLOAT2(0.0f, 1.0f), XMFLOAT2(0.0f, 0.0f), XMFLOAT2(1.0f, 0.0f), XMFLOAT2(1.0f, 1.0f) };
+	const uint32_t TileGridValidator::kQuadIndices[TileGrid::kVerticesPerTile] = { 0, 1, 2, 0, 2, 3 };
+
+	/************************************************************************/
+	TileGridValidator& TileGridValidator::GetInstance()
+	{
+		static TileGridValidator sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	TileGridValidationReport TileGridValidator::Validate(const Map& basicMap, uint32_t levelCount, uint32_t firstSeed)
+	{
+		TileGridValidationReport report = { levelCount, 0, 0, 0, 0, 0.0f, 0, 0, 0, 0 };
+
+		const SpriteSheet spriteSheet = SpriteSheetParser::GetInstance().ParseSpriteSheet(kSpriteSheetJSONPath);
+		const vector<XMFLOAT4> spriteRects = TileGrid::GetSpriteRects(spriteSheet);
+
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			default_random_engine generator(firstSeed + level);
+			Map map = LevelGenerator::GetInstance().GenerateLevel(basicMap, generator);
+
+			TileGrid tileGrid;
+			tileGrid.Update(map, false);
+			tileGrid.ClearChangedCells();
+			Check(tileGrid, map, false, spriteSheet, spriteRects, report);
+
+			// later in the round: the perk is consumed and some soft blocks are gone
+			uint32_t changedCellCount = 1;
+			for (uint32_t x = 0; x < map.MapWidth && changedCellCount <= kDestroyedBlocksPerLevel; ++x)
+			{
+				for (uint32_t y = 0; y < map.MapHeight && changedCellCount <= kDestroyedBlocksPerLevel; ++y)
+				{
+					if (map.BlocksLayer[x][y] == static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock))
+					{
+						map.BlocksLayer[x][y] = static_cast<uint8_t>(SpriteIndicesInMap::None);
+						map.Chunks.OnBlockChanged(map, XMUINT2(x, y));
+						++changedCellCount;
+					}
+				}
+			}
+
+			tileGrid.Update(map, true);
+			report.ChangedCellCount += changedCellCount;
+			report.UploadedCellCount += tileGrid.ChangedCells().size();
+			Check(tileGrid, map, true, spriteSheet, spriteRects, report);
+
+			CheckCulling(generator, report);
+		}
+
+		return report;
+	}
+
+	/************************************************************************/
+	void TileGridValidator::Check(const TileGrid& tileGrid, const Map& map, bool isPerkConsumed, const SpriteSheet& spriteSheet,
+								  const vector<XMFLOAT4>& spriteRects, TileGridValidationReport& report)
+	{
+		for (uint32_t x = 0; x < map.MapWidth; ++x)
+		{
+			for (uint32_t y = 0; y < map.MapHeight; ++y)
+			{
+				const uint8_t block = map.BlocksLayer[x][y];
+				const bool isBlock = block == static_cast<uint8_t>(SpriteIndicesInMap::SoftBlock) || block == static_cast<uint8_t>(SpriteIndicesInMap::SolidBlock);
+				report.OccupancyMismatchCount += map.Chunks.IsBlocked(XMUINT2(x, y)) != isBlock ? 1 : 0;
+			}
+		}
+
+		vector<TileVertex> expected;
+		GenerateSpriteVertices(map, isPerkConsumed, spriteSheet, expected);
+
+		vector<TileVertex> actual;
+		tileGrid.GenerateVertices(spriteRects, actual);
+
+		const size_t tileCount = expected.size() / TileGrid::kVerticesPerTile;
+		report.TileCount += tileCount;
+		if (actual.size() != expected.size())
+		{
+			// the tiles are not the same, nothing lines up after the first missing one
+			report.MismatchCount += tileCount;
+			return;
+		}
+
+		for (size_t tile = 0; tile < tileCount; ++tile)
+		{
+			float_t tileError = 0.0f;
+			for (size_t i = tile * TileGrid::kVerticesPerTile; i < (tile + 1) * TileGrid::kVerticesPerTile; ++i)
+			{
+				const float_t errors[] =
+				{
+					fabsf(actual[i].Position.x - expected[i].Position.x),
+					fabsf(actual[i].Position.y - expected[i].Position.y),
+					fabsf(actual[i].TextureCoordinates.x - expected[i].TextureCoordinates.x),
+					fabsf(actual[i].TextureCoordinates.y - expected[i].TextureCoordinates.y)
+				};
+				for (float_t error : errors)
+				{
+					tileError = error > tileError ? error : tileError;
+				}
+			}
+
+			report.MaxError = tileError > report.MaxError ? tileError : report.MaxError;
+			report.MismatchCount += tileError > kTolerance ? 1 : 0;
+		}
+	}
+
+	/************************************************************************/
+	void TileGridValidator::CheckCulling(default_random_engine& generator, TileGridValidationReport& report)
+	{
+		TileGridConstants grid = TileGrid().Constants();
+		grid.GridSize = XMUINT2(kLargeMapSize, kLargeMapSize);
+
+		// centers up to a view beyond the map, sizes from nothing to twice the default view
+		const XMFLOAT2 viewSize(OrthographicCamera::DefaultViewWidth, OrthographicCamera::DefaultViewHeight);
+		uniform_real_distribution<float_t> xDistribution(grid.Origin.x - viewSize.x, grid.Origin.x + grid.TileStep.x * kLargeMapSize + viewSize.x);
+		uniform_real_distribution<float_t> yDistribution(grid.Origin.y - viewSize.y, grid.Origin.y + grid.TileStep.y * kLargeMapSize + viewSize.y);
+		uniform_real_distribution<float_t> scaleDistribution(0.0f, 1.0f);
+
+		for (uint32_t view = 0; view < kCulledViewsPerLevel; ++view)
+		{
+			const XMFLOAT2 center(xDistribution(generator), yDistribution(generator));
+			const XMFLOAT2 halfSize(viewSize.x * scaleDistribution(generator), viewSize.y * scaleDistribution(generator));
+			const XMFLOAT4 visibleRectangle(center.x - halfSize.x, center.y - halfSize.y, center.x + halfSize.x, center.y + halfSize.y);
+			const TileRange visibleTiles = ViewCulling::GetInstance().GetVisibleTiles(visibleRectangle, grid);
+			++report.CulledViewCount;
+
+			// every tile quad against the rectangle, as the sprites are culled
+			for (uint32_t y = 0; y < kLargeMapSize; ++y)
+			{
+				for (uint32_t x = 0; x < kLargeMapSize; ++x)
+				{
+					const XMFLOAT2 tileCenter(grid.Origin.x + static_cast<float_t>(x) * grid.TileStep.x, grid.Origin.y + static_cast<float_t>(y) * grid.TileStep.y);
+					const bool isShowing = tileCenter.x + grid.TileExtent.x >= visibleRectangle.x && tileCenter.x - grid.TileExtent.x <= visibleRectangle.z &&
+						tileCenter.y + grid.TileExtent.y >= visibleRectangle.y && tileCenter.y - grid.TileExtent.y <= visibleRectangle.w;
+					const bool isInRange = x >= visibleTiles.First.x && x < visibleTiles.First.x + visibleTiles.Size.x &&
+						y >= visibleTiles.First.y && y < visibleTiles.First.y + visibleTiles.Size.y;
+
+					report.MissedTileCount += isShowing && !isInRange ? 1 : 0;
+					report.ExtraTileCount += isInRange && !isShowing ? 1 : 0;
+				}
+			}
+		}
+	}
+
+	/************************************************************************/
+	void TileGridValidator::GenerateSpriteVertices(const Map& map, bool isPerkConsumed, const SpriteSheet& spriteSheet, vector<TileVertex>& vertices)
+	{
+		// what MapRenderable drew, one sprite per tile: background, perk, door, blocks
+		for (uint32_t y = 0; y < map.MapHeight; ++y)
+		{
+			for (uint32_t x = 0; x < map.MapWidth; ++x)
+			{
+				const uint32_t spriteIndex = map.BackgroundLayer[x][y];
+				if (spriteIndex > 0 && spriteIndex != 5)
+				{
+					AddSpriteVertices(*spriteSheet.Sprites[spriteIndex - 1], XMUINT2(x, y), vertices);
+				}
+			}
+		}
+
+		// the perk and the door are in the same layer of the tile grid, which draws it row after row
+		const bool isPerkFirst = map.PerkTile.Tile.y < map.DoorTile.Tile.y || (map.PerkTile.Tile.y == map.DoorTile.Tile.y && map.PerkTile.Tile.x < map.DoorTile.Tile.x);
+		if (!isPerkConsumed && isPerkFirst)
+		{
+			AddSpriteVertices(*spriteSheet.Sprites[map.PerkTile.SpriteIndex], map.PerkTile.Tile, vertices);
+		}
+		AddSpriteVertices(*spriteSheet.Sprites[map.DoorTile.SpriteIndex], map.DoorTile.Tile, vertices);
+		if (!isPerkConsumed && !isPerkFirst)
+		{
+			AddSpriteVertices(*spriteSheet.Sprites[map.PerkTile.SpriteIndex], map.PerkTile.Tile, vertices);
+		}
+
+		for (uint32_t y = 0; y < map.MapHeight; ++y)
+		{
+			for (uint32_t x = 0; x < map.MapWidth; ++x)
+			{
+				const uint32_t spriteIndex = map.BlocksLayer[x][y];
+				if (spriteIndex > 0)
+				{
+					AddSpriteVertices(*spriteSheet.Sprites[spriteIndex - 1], XMUINT2(x, y), vertices);
+				}
+			}
+		}
+	}
+
+	/************************************************************************/
+	void TileGridValidator::AddSpriteVertices(const Sprite& sprite, const XMUINT2& tile, vector<TileVertex>& vertices)
+	{
+		// as Renderable::DrawSprite and SpriteRendererVS
+		const Transform2D transform(Renderable::GetPositionFromTile(tile), 0, Renderable::SpriteScale);
+		const XMMATRIX world = transform.WorldMatrix();
+
+		for (uint32_t index : kQuadIndices)
+		{
+			const XMFLOAT2& corner = kQuadCorners[index];
+			const XMFLOAT2& textureCoordinates = kQuadTextureCoordinates[index];
+
+			XMFLOAT4 position;
+			XMStoreFloat4(&position, XMVector4Transform(XMVectorSet(corner.x, corner.y, 0.0f, 1.0f), world));
+
+			TileVertex vertex;
+			vertex.Position = XMFLOAT2(position.x, position.y);
+			vertex.TextureCoordinates = XMFLOAT2(sprite.UVRect.x + textureCoordinates.x * sprite.UVRect.z, sprite.UVRect.y + textureCoordinates.y * sprite.UVRect.w);
+			vertices.push_back(vertex);
+		}
+	}
+}
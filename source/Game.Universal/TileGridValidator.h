@@ -0,0 +1,68 @@
+#pragma once
+
+#include "TileGrid.h"
+#include <random>
+#include <string>
+
+namespace DirectXGame
+{
+	/** Structure holding the outcome of a tile grid validation run.
+	*/
+	struct TileGridValidationReport
+	{
+		uint32_t LevelCount;
+		uint64_t TileCount;         // tiles the sprite path draws, over every level and state
+		uint64_t MismatchCount;     // tiles whose quad is not where the sprite path puts it
+		uint64_t ChangedCellCount;  // cells the levels changed after their first frame
+		uint64_t UploadedCellCount; // cells the tile grid uploaded again for those changes
+		std::float_t MaxError;      // largest difference of a position or texture coordinate
+		uint64_t OccupancyMismatchCount; // tiles whose bit in the map chunks disagrees with the blocks layer
+		uint64_t CulledViewCount;   // camera rectangles culled against the large map
+		uint64_t MissedTileCount;   // tiles showing in one of them but left out of its visible range
+		uint64_t ExtraTileCount;    // tiles in a visible range that do not show in its rectangle
+	};
+
+	/** Singleton checking, without a graphics device, that the tile grid draws the map as the sprite path did.
+	 * Every generated level is drawn both ways on the CPU: the tile grid through TileGrid::GetVertex, which mirrors
+	 * TileGridVS, and the map tiles as sprites through Transform2D and the sprite quad, as DrawSprite and
+	 * SpriteRendererVS do. Each level is checked as generated, then with some blocks destroyed and its perk consumed,
+	 * which must upload exactly the cells that changed, and the occupancy masks of the map chunks must follow.
+	 * The visible tile ranges of ViewCulling are checked against every tile of a map of kLargeMapSize tiles per side,
+	 * for cameras of random positions and sizes, some of them partly or completely off the map.
+	 *@see TileGrid
+	 *@see HeadlessTools
+	*/
+	class TileGridValidator final
+	{
+	public:
+
+		TileGridValidator(const TileGridValidator& rhs) = delete;
+		TileGridValidator(const TileGridValidator&& rhs) = delete;
+		TileGridValidator& operator=(const TileGridValidator& rhs) = delete;
+		TileGridValidator& operator=(const TileGridValidator&& rhs) = delete;
+
+		static TileGridValidator& GetInstance();
+
+		TileGridValidationReport Validate(const Map& basicMap, uint32_t levelCount, uint32_t firstSeed);
+
+	private:
+
+		TileGridValidator() = default;
+		~TileGridValidator() = default;
+
+		static void Check(const TileGrid& tileGrid, const Map& map, bool isPerkConsumed, const SpriteSheet& spriteSheet,
+						  const std::vector<DirectX::XMFLOAT4>& spriteRects, TileGridValidationReport& report);
+		static void CheckCulling(std::default_random_engine& generator, TileGridValidationReport& report);
+		static void GenerateSpriteVertices(const Map& map, bool isPerkConsumed, const SpriteSheet& spriteSheet, std::vector<TileVertex>& vertices);
+		static void AddSpriteVertices(const Sprite& sprite, const DirectX::XMUINT2& tile, std::vector<TileVertex>& vertices);
+
+		static const std::string kSpriteSheetJSONPath;
+		static const uint32_t kDestroyedBlocksPerLevel;
+		static const std::float_t kTolerance;
+		static const uint32_t kLargeMapSize;
+		static const uint32_t kCulledViewsPerLevel;
+		static const DirectX::XMFLOAT2 kQuadCorners[4];
+		static const DirectX::XMFLOAT2 kQuadTextureCoordinates[4];
+		static const uint32_t kQuadIndices[TileGrid::kVerticesPerTile];
+	};
+}
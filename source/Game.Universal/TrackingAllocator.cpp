@@ -0,0 +1,65 @@
+#include "pch.h"
+#include "TrackingAllocator.h"
+#include "MetricsRegistry.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	AllocationTracker& AllocationTracker::GetInstance()
+	{
+		static AllocationTracker sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	AllocationTracker::AllocationTracker()
+	{
+		for (uint32_t subsystem = 0; subsystem < kSubsystemCount; ++subsystem)
+		{
+			mAllocationCounts[subsystem] = 0;
+			mAllocatedBytes[subsystem] = 0;
+			mLiveBytes[subsystem] = 0;
+			mMetrics[subsystem] = MetricsRegistry::GetInstance().Register(GetName(static_cast<AllocationSubsystem>(subsystem)) + " allocations");
+		}
+	}
+
+	/************************************************************************/
+	void AllocationTracker::OnAllocate(AllocationSubsystem subsystem, size_t bytes)
+	{
+		const uint32_t index = static_cast<uint32_t>(subsystem);
+		mAllocationCounts[index].fetch_add(1, memory_order_relaxed);
+		mAllocatedBytes[index].fetch_add(bytes, memory_order_relaxed);
+		mLiveBytes[index].fetch_add(static_cast<int64_t>(bytes), memory_order_relaxed);
+		MetricsRegistry::GetInstance().Add(mMetrics[index]);
+	}
+
+	/************************************************************************/
+	void AllocationTracker::OnDeallocate(AllocationSubsystem subsystem, size_t bytes)
+	{
+		mLiveBytes[static_cast<uint32_t>(subsystem)].fetch_sub(static_cast<int64_t>(bytes), memory_order_relaxed);
+	}
+
+	/************************************************************************/
+	SubsystemAllocations AllocationTracker::GetAllocations(AllocationSubsystem subsystem) const
+	{
+		const uint32_t index = static_cast<uint32_t>(subsystem);
+
+		SubsystemAllocations allocations;
+		allocations.AllocationCount = mAllocationCounts[index].load(memory_order_relaxed);
+		allocations.AllocatedBytes = mAllocatedBytes[index].load(memory_order_relaxed);
+		allocations.LiveBytes = mLiveBytes[index].load(memory_order_relaxed);
+
+		return allocations;
+	}
+
+	/************************************************************************/
+	string AllocationTracker::GetName(AllocationSubsystem subsystem)
+	{
+		static const char* names[] = { "level", "bombs", "players", "collision" };
+		static_assert(sizeof(names) / sizeof(names[0]) == kSubsystemCount, "one name per subsystem");
+
+		return names[static_cast<uint32_t>(subsystem)];
+	}
+}
@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "UploadRing.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	UploadRing::UploadRing(uint32_t capacityBytes, uint32_t alignment) :
+		mCapacity(capacityBytes), mAlignment(alignment), mHead(0), mDiscardCount(0), mIsDiscardPending(true)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	}
+
+	/************************************************************************/
+	void UploadRing::BeginFrame()
+	{
+		mIsDiscardPending = true;
+	}
+
+	/************************************************************************/
+	bool UploadRing::Allocate(uint32_t size, UploadRingAllocation& allocation)
+	{
+		if (size == 0 || size > mCapacity)
+		{
+			return false;
+		}
+
+		const uint32_t start = (mHead + mAlignment - 1) & ~(mAlignment - 1);
+		const bool fits = start >= mHead && start <= mCapacity && size <= mCapacity - start;
+		if (mIsDiscardPending || !fits)
+		{
+			allocation.Offset = 0;
+			allocation.IsDiscard = true;
+			mIsDiscardPending = false;
+			++mDiscardCount;
+		}
+		else
+		{
+			allocation.Offset = start;
+			allocation.IsDiscard = false;
+		}
+
+		mHead = allocation.Offset + size;
+		return true;
+	}
+
+	/************************************************************************/
+	uint32_t UploadRing::CapacityBytes() const
+	{
+		return mCapacity;
+	}
+
+	/************************************************************************/
+	uint32_t UploadRing::Alignment() const
+	{
+		return mAlignment;
+	}
+
+	/************************************************************************/
+	uint32_t UploadRing::UsedBytes() const
+	{
+		return mHead;
+	}
+
+	/************************************************************************/
+	uint32_t UploadRing::FreeBytes() const
+	{
+		// what the next allocation can take without starting over, all of it when it starts over anyway
+		if (mIsDiscardPending)
+		{
+			return mCapacity;
+		}
+
+		const uint32_t start = (mHead + mAlignment - 1) & ~(mAlignment - 1);
+		return start >= mHead && start <= mCapacity ? mCapacity - start : 0;
+	}
+
+	/************************************************************************/
+	uint32_t UploadRing::DiscardCount() const
+	{
+		return mDiscardCount;
+	}
+}
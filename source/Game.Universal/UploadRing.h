@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DirectXGame
+{
+	/** Structure representing a place in the ring for data uploaded this frame.
+	*/
+	struct UploadRingAllocation
+	{
+		uint32_t Offset;  // in bytes from the start of the buffer
+		bool IsDiscard;   // the buffer must be mapped with WRITE_DISCARD, everything before is no longer written to
+	};
+
+	/** Class handing out aligned ranges of a GPU buffer that is written front to back, without knowing the buffer.
+	 * Direct3D 11 has no fences, so the ring never waits for the GPU: the first allocation of a frame, and the one
+	 * that no longer fits before the end, start over at offset 0 and ask for a WRITE_DISCARD map, the driver then
+	 * gives the buffer new memory while the GPU still reads the old one. Every other allocation comes after the ones
+	 * before it since the last discard and is written with NO_OVERWRITE, which neither copies nor waits.
+	 *@see ConstantRingBuffer
+	 *@see UploadRingValidator
+	*/
+	class UploadRing final
+	{
+	public:
+
+		UploadRing(uint32_t capacityBytes, uint32_t alignment);
+
+		void BeginFrame();
+		bool Allocate(uint32_t size, UploadRingAllocation& allocation);
+
+		uint32_t CapacityBytes() const;
+		uint32_t Alignment() const;
+		uint32_t UsedBytes() const;
+		uint32_t FreeBytes() const;
+		uint32_t DiscardCount() const;
+
+	private:
+
+		uint32_t mCapacity;
+		uint32_t mAlignment; // a power of 2
+		uint32_t mHead;      // end of the last allocation
+		uint32_t mDiscardCount;
+		bool mIsDiscardPending;
+	};
+}
@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "UploadRingValidator.h"
+
+using namespace std;
+
+namespace DirectXGame
+{
+	const uint32_t UploadRingValidator::kCapacityBytes = 16 * 1024; // small, so most frames start over a few times
+	const uint32_t UploadRingValidator::kAlignment = 256;
+	const uint32_t UploadRingValidator::kMaxAllocationsPerFrame = 200;
+	const uint32_t UploadRingValidator::kMaxAllocationSize = 1024;
+	const uint32_t UploadRingValidator::kOversizePercent = 1;
+
+	/************************************************************************/
+	UploadRingValidator& UploadRingValidator::GetInstance()
+	{
+		static UploadRingValidator sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	UploadRingValidationReport UploadRingValidator::Validate(uint32_t frameCount, uint32_t seed)
+	{
+		UploadRingValidationReport report = { frameCount, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+		default_random_engine generator(seed);
+		uniform_int_distribution<uint32_t> allocationCountDistribution(0, kMaxAllocationsPerFrame);
+		uniform_int_distribution<uint32_t> sizeDistribution(1, kMaxAllocationSize);
+		uniform_int_distribution<uint32_t> percentDistribution(0, 99);
+
+		UploadRing ring(kCapacityBytes, kAlignment);
+		uint32_t end = 0; // of the last allocation since the last discard
+
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			ring.BeginFrame();
+			bool isFirstAllocation = true;
+
+			const uint32_t allocationCount = allocationCountDistribution(generator);
+			for (uint32_t allocationIndex = 0; allocationIndex < allocationCount; ++allocationIndex)
+			{
+				const uint32_t size = percentDistribution(generator) < kOversizePercent ? kCapacityBytes + sizeDistribution(generator) : sizeDistribution(generator);
+
+				UploadRingAllocation allocation;
+				const bool isAllocated = ring.Allocate(size, allocation);
+				if (isAllocated != (size <= kCapacityBytes))
+				{
+					++report.WrongRejectionCount;
+				}
+				if (!isAllocated)
+				{
+					continue;
+				}
+
+				++report.AllocationCount;
+
+				if (allocation.IsDiscard)
+				{
+					++report.DiscardCount;
+
+					const uint32_t alignedEnd = (end + kAlignment - 1) & ~(kAlignment - 1);
+					if (!isFirstAllocation && alignedEnd + size <= kCapacityBytes)
+					{
+						++report.UnneededDiscardCount;
+					}
+					end = 0;
+				}
+				else if (isFirstAllocation)
+				{
+					++report.MissingDiscardCount;
+				}
+
+				if (allocation.Offset % kAlignment != 0)
+				{
+					++report.MisalignedCount;
+				}
+				if (allocation.Offset + size > kCapacityBytes)
+				{
+					++report.OutOfBoundsCount;
+				}
+				if (allocation.Offset < end)
+				{
+					++report.OverlapCount;
+				}
+
+				end = allocation.Offset + size;
+				isFirstAllocation = false;
+			}
+		}
+
+		return report;
+	}
+}
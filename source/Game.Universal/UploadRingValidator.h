@@ -0,0 +1,53 @@
+#pragma once
+
+#include "UploadRing.h"
+#include <random>
+
+namespace DirectXGame
+{
+	/** Structure holding the outcome of an upload ring validation run.
+	*/
+	struct UploadRingValidationReport
+	{
+		uint32_t FrameCount;
+		uint64_t AllocationCount;
+		uint64_t DiscardCount;
+		uint64_t MisalignedCount;       // allocations not starting on the alignment of the ring
+		uint64_t OutOfBoundsCount;      // allocations going past the end of the buffer
+		uint64_t OverlapCount;          // allocations overwriting one made since the last discard
+		uint64_t MissingDiscardCount;   // first allocations of a frame that did not discard
+		uint64_t UnneededDiscardCount;  // discards in the middle of a frame for an allocation that fit
+		uint64_t WrongRejectionCount;   // sizes refused although they fit the buffer, or accepted although they do not
+	};
+
+	/** Singleton checking UploadRing on its own, without a graphics device.
+	 * Random frames allocate random sizes, now and then a size larger than the whole ring, and every allocation is
+	 * checked against the rules a GPU buffer written with WRITE_DISCARD and NO_OVERWRITE relies on.
+	 *@see UploadRing
+	 *@see HeadlessTools
+	*/
+	class UploadRingValidator final
+	{
+	public:
+
+		UploadRingValidator(const UploadRingValidator& rhs) = delete;
+		UploadRingValidator(const UploadRingValidator&& rhs) = delete;
+		UploadRingValidator& operator=(const UploadRingValidator& rhs) = delete;
+		UploadRingValidator& operator=(const UploadRingValidator&& rhs) = delete;
+
+		static UploadRingValidator& GetInstance();
+
+		UploadRingValidationReport Validate(uint32_t frameCount, uint32_t seed);
+
+	private:
+
+		UploadRingValidator() = default;
+		~UploadRingValidator() = default;
+
+		static const uint32_t kCapacityBytes;
+		static const uint32_t kAlignment;
+		static const uint32_t kMaxAllocationsPerFrame;
+		static const uint32_t kMaxAllocationSize;
+		static const uint32_t kOversizePercent;
+	};
+}
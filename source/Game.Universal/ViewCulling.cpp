@@ -0,0 +1,62 @@
+#include "pch.h"
+#include "ViewCulling.h"
+
+using namespace std;
+using namespace DirectX;
+
+namespace DirectXGame
+{
+	/************************************************************************/
+	ViewCulling& ViewCulling::GetInstance()
+	{
+		static ViewCulling sInstance;
+		return sInstance;
+	}
+
+	/************************************************************************/
+	TileRange ViewCulling::GetVisibleTiles(const XMFLOAT4& visibleRectangle, const TileGridConstants& grid) const
+	{
+		TileRange visibleTiles;
+		GetVisibleSpan(visibleRectangle.x, visibleRectangle.z, grid.Origin.x, grid.TileStep.x, grid.TileExtent.x, grid.GridSize.x, visibleTiles.First.x, visibleTiles.Size.x);
+		GetVisibleSpan(visibleRectangle.y, visibleRectangle.w, grid.Origin.y, grid.TileStep.y, grid.TileExtent.y, grid.GridSize.y, visibleTiles.First.y, visibleTiles.Size.y);
+
+		if (visibleTiles.Size.x == 0 || visibleTiles.Size.y == 0)
+		{
+			visibleTiles.Size = XMUINT2(0, 0);
+		}
+
+		return visibleTiles;
+	}
+
+	/************************************************************************/
+	bool ViewCulling::IsVisible(const XMFLOAT4& visibleRectangle, const XMFLOAT2& center, const XMFLOAT2& extent) const
+	{
+		return center.x + extent.x >= visibleRectangle.x && center.x - extent.x <= visibleRectangle.z &&
+			center.y + extent.y >= visibleRectangle.y && center.y - extent.y <= visibleRectangle.w;
+	}
+
+	/************************************************************************/
+	void ViewCulling::GetVisibleSpan(float_t min, float_t max, float_t origin, float_t step, float_t extent, uint32_t tileCount, uint32_t& first, uint32_t& size)
+	{
+		first = 0;
+		size = 0;
+		if (tileCount == 0 || step <= 0.0f)
+		{
+			size = tileCount;
+			return;
+		}
+
+		// tile i covers origin + i * step - extent to origin + i * step + extent
+		const float_t firstTile = ceilf((min - origin - extent) / step);
+		const float_t lastTile = floorf((max - origin + extent) / step);
+		const float_t lastGridTile = static_cast<float_t>(tileCount - 1);
+		if (lastTile < 0.0f || firstTile > lastGridTile || firstTile > lastTile)
+		{
+			return;
+		}
+
+		first = firstTile < 0.0f ? 0 : static_cast<uint32_t>(firstTile);
+		const uint32_t last = lastTile > lastGridTile ? tileCount - 1 : static_cast<uint32_t>(lastTile);
+		size = last - first + 1;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "TileGrid.h"
+
+namespace DirectXGame
+{
+	/** Singleton holding the culling math of the renderers, against the visible rectangle of the camera.
+	 * Rectangles are left, bottom, right and top in world space, as DX::Camera::VisibleRectangle returns them.
+	 * Anything touching the rectangle is visible, so culling never removes a sprite that shows a single pixel.
+	 * Nothing here needs a graphics device.
+	 *@see TileGrid
+	 *@see Renderable
+	*/
+	class ViewCulling final
+	{
+	public:
+
+		ViewCulling(const ViewCulling& rhs) = delete;
+		ViewCulling(const ViewCulling&& rhs) = delete;
+		ViewCulling& operator=(const ViewCulling& rhs) = delete;
+		ViewCulling& operator=(const ViewCulling&& rhs) = delete;
+
+		static ViewCulling& GetInstance();
+
+		TileRange GetVisibleTiles(const DirectX::XMFLOAT4& visibleRectangle, const TileGridConstants& grid) const;
+		bool IsVisible(const DirectX::XMFLOAT4& visibleRectangle, const DirectX::XMFLOAT2& center, const DirectX::XMFLOAT2& extent) const;
+
+	private:
+
+		ViewCulling() = default;
+		~ViewCulling() = default;
+
+		static void GetVisibleSpan(std::float_t min, std::float_t max, std::float_t origin, std::float_t step, std::float_t extent, uint32_t tileCount,
+								   uint32_t& first, uint32_t& size);
+	};
+}
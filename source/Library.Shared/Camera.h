@@ -32,6 +32,9 @@ namespace DX
 		DirectX::XMMATRIX ProjectionMatrix() const;
 		DirectX::XMMATRIX ViewProjectionMatrix() const;
 
+		// left, bottom, right and top of the world the camera sees on the z = 0 plane
+		virtual DirectX::XMFLOAT4 VisibleRectangle() const = 0;
+
 		virtual void SetPosition(float x, float y, float z);
 		virtual void SetPosition(DirectX::FXMVECTOR position);
 		virtual void SetPosition(const DirectX::XMFLOAT3& position);
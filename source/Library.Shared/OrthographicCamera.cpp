@@ -41,6 +41,15 @@ namespace DX
 		}
 	}
 
+	XMFLOAT4 OrthographicCamera::VisibleRectangle() const
+	{
+		// the view around the camera position, bounded again when the camera is rolled
+		const float halfWidth = (fabsf(mRight.x) * mViewWidth + fabsf(mUp.x) * mViewHeight) * 0.5f;
+		const float halfHeight = (fabsf(mRight.y) * mViewWidth + fabsf(mUp.y) * mViewHeight) * 0.5f;
+
+		return XMFLOAT4(mPosition.x - halfWidth, mPosition.y - halfHeight, mPosition.x + halfWidth, mPosition.y + halfHeight);
+	}
+
     void OrthographicCamera::UpdateProjectionMatrix()
     {
 		XMMATRIX projectionMatrix = XMMatrixOrthographicRH(mViewWidth, mViewHeight, mNearPlaneDistance, mFarPlaneDistance);
@@ -20,6 +20,8 @@ namespace DX
 		float ViewHeight() const;
 		void SetViewHeight(float viewHeight);
 
+		virtual DirectX::XMFLOAT4 VisibleRectangle() const override;
+
         virtual void UpdateProjectionMatrix() override;
 
 		static const float DefaultViewWidth;